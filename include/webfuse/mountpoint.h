@@ -8,11 +8,34 @@
 
 #include <webfuse/api.h>
 
+#ifndef __cplusplus
+#include <stddef.h>
+#else
+#include <cstddef>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+#define WF_FUSE_CAP_ASYNC_READ       (1 << 0)  ///< Issue multiple reads per file concurrently.
+#define WF_FUSE_CAP_PARALLEL_DIROPS  (1 << 1)  ///< Allow concurrent lookup and readdir in a directory.
+#define WF_FUSE_CAP_READDIRPLUS      (1 << 2)  ///< Use readdirplus to fetch attributes with directory contents.
+#define WF_FUSE_CAP_READDIRPLUS_AUTO (1 << 3)  ///< Let the kernel choose between readdir and readdirplus.
+#define WF_FUSE_CAP_SPLICE           (1 << 4)  ///< Splice large replies to the fuse device (see below).
+
+/// Default fuse capabilities of a mountpoint.
+///
+/// WF_FUSE_CAP_SPLICE is not part of the defaults: read replies are decoded
+/// into heap buffers, so splicing them to the fuse device (vmsplice into a
+/// pipe, then splice) saves no copy compared to writing them, but takes
+/// more system calls. Enable it only if measurements on the target system
+/// show a benefit for large reads.
+#define WF_FUSE_CAP_DEFAULT ( \
+    WF_FUSE_CAP_ASYNC_READ | WF_FUSE_CAP_PARALLEL_DIROPS | \
+    WF_FUSE_CAP_READDIRPLUS | WF_FUSE_CAP_READDIRPLUS_AUTO)
+
 //------------------------------------------------------------------------------
 /// \struct wf_mountpoint
 /// \brief Mointpoint.
@@ -90,6 +113,202 @@ wf_mountpoint_add_mountoption(
     struct wf_mountpoint * mountpoint,
     char const * option);
 
+//------------------------------------------------------------------------------
+/// \brief Configures the attribute cache of the mountpoint.
+///
+/// The adapter caches file attributes and directory entries to reduce
+/// the number of requests sent to the provider. Entries, which are known
+/// not to exist, can be cached separately.
+///
+/// By default, attributes and entries are cached for 1 second, non-existing
+/// entries are not cached and the cache is limited to 4 MByte.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param timeout_ms time in milliseconds to cache attributes and entries;
+///                   0 disables the cache
+/// \param negative_timeout_ms time in milliseconds to cache non-existing
+///                            entries; 0 disables negative caching
+/// \param max_size max. number of bytes used by the cache
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_attr_cache(
+    struct wf_mountpoint * mountpoint,
+    int timeout_ms,
+    int negative_timeout_ms,
+    size_t max_size);
+
+//------------------------------------------------------------------------------
+/// \brief Configures read ahead of the mountpoint.
+///
+/// Once sequential access to an open file is detected, the adapter reads
+/// ahead of the consumer, so that subsequent reads are answered without
+/// waiting for the provider. Random access is not affected.
+///
+/// By default, up to 256 KByte are read ahead per open file.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param size max. number of bytes to read ahead per open file
+///             (limited to 1 MByte); 0 disables read ahead
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_readahead(
+    struct wf_mountpoint * mountpoint,
+    size_t size);
+
+//------------------------------------------------------------------------------
+/// \brief Sets the chunk size of read requests.
+///
+/// Reads larger than the chunk size are split into multiple read requests,
+/// which are sent to the provider in parallel.
+///
+/// By default, the chunk size is 256 KByte.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param size max. number of bytes per read request (limited to 1 MByte);
+///             0 uses the max. chunk size
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_read_chunk_size(
+    struct wf_mountpoint * mountpoint,
+    size_t size);
+
+//------------------------------------------------------------------------------
+/// \brief Sets the time the kernel caches attributes and directory entries.
+///
+/// Providers which notify the adapter about changes (see invalidate_inode
+/// and invalidate_entry in the protocol documentation) can use long
+/// timeouts to reduce the number of requests significantly.
+///
+/// By default, the kernel caches attributes and entries for 1 second.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param timeout_ms time in milliseconds
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_kernel_cache_timeout(
+    struct wf_mountpoint * mountpoint,
+    int timeout_ms);
+
+//------------------------------------------------------------------------------
+/// \brief Sets the capabilities requested from the kernel when mounted.
+///
+/// Capabilities not supported by the kernel are ignored. The negotiated
+/// capabilities are logged when the filesystem is initialized.
+///
+/// By default, WF_FUSE_CAP_DEFAULT is requested.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param capabilities bitwise or of WF_FUSE_CAP_* flags
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_fuse_capabilities(
+    struct wf_mountpoint * mountpoint,
+    int capabilities);
+
+//------------------------------------------------------------------------------
+/// \brief Sets fuse connection limits.
+///
+/// The kernel limits the number of pending background requests (such as
+/// read ahead and asynchronous reads) per filesystem and throttles
+/// callers once the congestion threshold is reached. Since requests are
+/// forwarded to a remote provider, higher limits keep more requests in
+/// flight on high latency links.
+///
+/// By default, up to 64 background requests are allowed and congestion
+/// starts at 48 requests; the kernel's max. read ahead is kept.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param max_readahead max. bytes the kernel reads ahead per file
+///                      (can only be lowered); 0 keeps the kernel default
+/// \param max_background max. number of pending background requests;
+///                       0 keeps the kernel default
+/// \param congestion_threshold number of pending background requests
+///                             which starts throttling; 0 uses 3/4 of
+///                             max_background
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_fuse_limits(
+    struct wf_mountpoint * mountpoint,
+    unsigned int max_readahead,
+    unsigned int max_background,
+    unsigned int congestion_threshold);
+
+//------------------------------------------------------------------------------
+/// \brief Limits the load a filesystem puts on the connection to the provider.
+///
+/// Once the number of requests waiting for a response or the number of
+/// bytes waiting to be sent reaches its limit, no further requests are
+/// received from the kernel. Receiving is resumed, when both have drained
+/// to half of their limits. Meanwhile, the kernel queues requests and
+/// throttles callers (see wf_mountpoint_set_fuse_limits).
+///
+/// Both limits are shared by all filesystems of a connection.
+///
+/// By default, up to 1024 requests and 4 MByte are allowed.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param max_in_flight max. number of requests waiting for a response;
+///                      0 disables the limit
+/// \param max_queued_bytes max. number of bytes waiting to be sent;
+///                         0 disables the limit
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_flow_control(
+    struct wf_mountpoint * mountpoint,
+    size_t max_in_flight,
+    size_t max_queued_bytes);
+
+//------------------------------------------------------------------------------
+/// \brief Sets the weights of outgoing message classes.
+///
+/// Messages to the provider are queued per filesystem and class. Filesystems
+/// are served round-robin; within a filesystem, up to weight messages of
+/// a class are sent before the next class is served. This way, metadata
+/// requests (such as lookup or getattr) are not stuck behind bulk reads.
+///
+/// By default, metadata requests are weighted 4, data requests (read)
+/// and notifications (close) are weighted 1.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param metadata weight of metadata requests
+/// \param data weight of data requests
+/// \param notification weight of notifications
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_message_weights(
+    struct wf_mountpoint * mountpoint,
+    unsigned int metadata,
+    unsigned int data,
+    unsigned int notification);
+
+//------------------------------------------------------------------------------
+/// \brief Sets the bounds of request timeouts.
+///
+/// Response times of the provider are tracked per method (such as getattr
+/// or read) and, for reads, per request size. Response times are measured
+/// from the moment a request is sent, so time spent in the send queue is
+/// not counted. Requests time out, when their response takes considerably
+/// longer than usual (exceeds average latency plus four times its deviation
+/// as well as the 99th percentile). Until enough responses are observed,
+/// requests time out after 10 seconds. Each timeout doubles the timeout of
+/// the method until the next response is received.
+///
+/// Timeouts are clamped to the given bounds. By default, requests time out
+/// after 10 seconds at the earliest and after 60 seconds at the latest, so
+/// that adaptive timeouts only extend the timeout of slow methods. Lower
+/// the minimum to detect unresponsive providers earlier on fast links.
+/// Setting both bounds to the same value disables adaptive timeouts.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param min_timeout_ms lower bound of timeouts in milliseconds
+/// \param max_timeout_ms upper bound of timeouts in milliseconds
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_request_timeout(
+    struct wf_mountpoint * mountpoint,
+    int min_timeout_ms,
+    int max_timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif
@@ -13,6 +13,7 @@
 #define WF_BAD_TIMEOUT        3     ///< A timeout occured.
 #define WF_BAD_BUSY           4     ///< Resource is busy, try again later.
 #define WF_BAD_FORMAT         5     ///< Invalid format.
+#define WF_BAD_INTERRUPTED    6     ///< Operation was interrupted.
 
 #define WF_BAD_NOENTRY 101          ///< Entry not found.
 #define WF_BAD_ACCESS_DENIED 102    ///< Access is denied.
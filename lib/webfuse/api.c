@@ -210,6 +210,86 @@ wf_mountpoint_add_mountoption(
     wf_impl_mountpoint_add_mountoption(mountpoint, option);
 }
 
+void
+wf_mountpoint_set_attr_cache(
+    struct wf_mountpoint * mountpoint,
+    int timeout_ms,
+    int negative_timeout_ms,
+    size_t max_size)
+{
+    wf_impl_mountpoint_set_attr_cache(mountpoint, timeout_ms, negative_timeout_ms, max_size);
+}
+
+void
+wf_mountpoint_set_readahead(
+    struct wf_mountpoint * mountpoint,
+    size_t size)
+{
+    wf_impl_mountpoint_set_readahead(mountpoint, size);
+}
+
+void
+wf_mountpoint_set_read_chunk_size(
+    struct wf_mountpoint * mountpoint,
+    size_t size)
+{
+    wf_impl_mountpoint_set_read_chunk_size(mountpoint, size);
+}
+
+void
+wf_mountpoint_set_kernel_cache_timeout(
+    struct wf_mountpoint * mountpoint,
+    int timeout_ms)
+{
+    wf_impl_mountpoint_set_kernel_cache_timeout(mountpoint, timeout_ms);
+}
+
+void
+wf_mountpoint_set_fuse_capabilities(
+    struct wf_mountpoint * mountpoint,
+    int capabilities)
+{
+    wf_impl_mountpoint_set_fuse_capabilities(mountpoint, capabilities);
+}
+
+void
+wf_mountpoint_set_fuse_limits(
+    struct wf_mountpoint * mountpoint,
+    unsigned int max_readahead,
+    unsigned int max_background,
+    unsigned int congestion_threshold)
+{
+    wf_impl_mountpoint_set_fuse_limits(mountpoint, max_readahead, max_background, congestion_threshold);
+}
+
+void
+wf_mountpoint_set_flow_control(
+    struct wf_mountpoint * mountpoint,
+    size_t max_in_flight,
+    size_t max_queued_bytes)
+{
+    wf_impl_mountpoint_set_flow_control(mountpoint, max_in_flight, max_queued_bytes);
+}
+
+void
+wf_mountpoint_set_message_weights(
+    struct wf_mountpoint * mountpoint,
+    unsigned int metadata,
+    unsigned int data,
+    unsigned int notification)
+{
+    wf_impl_mountpoint_set_message_weights(mountpoint, metadata, data, notification);
+}
+
+void
+wf_mountpoint_set_request_timeout(
+    struct wf_mountpoint * mountpoint,
+    int min_timeout_ms,
+    int max_timeout_ms)
+{
+    wf_impl_mountpoint_set_request_timeout(mountpoint, min_timeout_ms, max_timeout_ms);
+}
+
 // client
 
 struct wf_client *
@@ -0,0 +1,480 @@
+#include "webfuse/impl/attr_cache.h"
+#include "webfuse/impl/timer/timepoint.h"
+
+#include <libwebsockets.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define WF_IMPL_ATTR_CACHE_INITIAL_BUCKETS 64
+// invalidations are tracked in a fixed number of slots;
+// inodes sharing a slot only cause superfluous cache misses
+#define WF_IMPL_ATTR_CACHE_GENERATION_SLOTS 256
+
+struct wf_impl_attr_cache_entry
+{
+    struct wf_impl_attr_cache_entry * bucket_next;
+    struct wf_impl_attr_cache_entry * lru_prev;
+    struct wf_impl_attr_cache_entry * lru_next;
+    size_t hash;
+    fuse_ino_t key;
+    char * name;
+    fuse_ino_t inode;
+    struct stat attr;
+    wf_timer_timepoint expires;
+    size_t size;
+};
+
+struct wf_impl_attr_cache
+{
+    int timeout;
+    int negative_timeout;
+    size_t max_size;
+    struct wf_impl_attr_cache_entry * * buckets;
+    size_t bucket_count;
+    struct wf_impl_attr_cache_entry * lru_first;
+    struct wf_impl_attr_cache_entry * lru_last;
+    struct wf_impl_attr_cache_stats stats;
+    uint64_t generation;
+    uint64_t invalidated[WF_IMPL_ATTR_CACHE_GENERATION_SLOTS];
+};
+
+static size_t
+wf_impl_attr_cache_hash(
+    fuse_ino_t key,
+    char const * name)
+{
+    // FNV-1a
+    uint64_t hash = UINT64_C(14695981039346656037);
+    for(size_t i = 0; i < sizeof(key); i++)
+    {
+        hash ^= (uint8_t) (key >> (i * 8));
+        hash *= UINT64_C(1099511628211);
+    }
+
+    if (NULL != name)
+    {
+        for(char const * c = name; '\0' != *c; c++)
+        {
+            hash ^= (uint8_t) *c;
+            hash *= UINT64_C(1099511628211);
+        }
+    }
+
+    return (size_t) hash;
+}
+
+static void
+wf_impl_attr_cache_lru_unlink(
+    struct wf_impl_attr_cache * cache,
+    struct wf_impl_attr_cache_entry * entry)
+{
+    if (NULL != entry->lru_prev)
+    {
+        entry->lru_prev->lru_next = entry->lru_next;
+    }
+    else
+    {
+        cache->lru_first = entry->lru_next;
+    }
+
+    if (NULL != entry->lru_next)
+    {
+        entry->lru_next->lru_prev = entry->lru_prev;
+    }
+    else
+    {
+        cache->lru_last = entry->lru_prev;
+    }
+
+    entry->lru_prev = NULL;
+    entry->lru_next = NULL;
+}
+
+static void
+wf_impl_attr_cache_lru_push_front(
+    struct wf_impl_attr_cache * cache,
+    struct wf_impl_attr_cache_entry * entry)
+{
+    entry->lru_prev = NULL;
+    entry->lru_next = cache->lru_first;
+    if (NULL != cache->lru_first)
+    {
+        cache->lru_first->lru_prev = entry;
+    }
+    else
+    {
+        cache->lru_last = entry;
+    }
+    cache->lru_first = entry;
+}
+
+static struct wf_impl_attr_cache_entry * *
+wf_impl_attr_cache_find_slot(
+    struct wf_impl_attr_cache * cache,
+    size_t hash,
+    fuse_ino_t key,
+    char const * name)
+{
+    struct wf_impl_attr_cache_entry * * slot = &(cache->buckets[hash & (cache->bucket_count - 1)]);
+    while (NULL != *slot)
+    {
+        struct wf_impl_attr_cache_entry * entry = *slot;
+        if ((hash == entry->hash) && (key == entry->key))
+        {
+            bool const is_match = (NULL == name) ? (NULL == entry->name) :
+                ((NULL != entry->name) && (0 == strcmp(name, entry->name)));
+            if (is_match)
+            {
+                break;
+            }
+        }
+
+        slot = &(entry->bucket_next);
+    }
+
+    return slot;
+}
+
+static void
+wf_impl_attr_cache_remove(
+    struct wf_impl_attr_cache * cache,
+    struct wf_impl_attr_cache_entry * * slot)
+{
+    struct wf_impl_attr_cache_entry * entry = *slot;
+    *slot = entry->bucket_next;
+    wf_impl_attr_cache_lru_unlink(cache, entry);
+
+    cache->stats.count--;
+    cache->stats.size -= entry->size;
+
+    free(entry->name);
+    free(entry);
+}
+
+static void
+wf_impl_attr_cache_grow(
+    struct wf_impl_attr_cache * cache)
+{
+    size_t const bucket_count = cache->bucket_count * 2;
+    struct wf_impl_attr_cache_entry * * buckets = calloc(bucket_count, sizeof(struct wf_impl_attr_cache_entry *));
+
+    for(size_t i = 0; i < cache->bucket_count; i++)
+    {
+        struct wf_impl_attr_cache_entry * entry = cache->buckets[i];
+        while (NULL != entry)
+        {
+            struct wf_impl_attr_cache_entry * next = entry->bucket_next;
+            size_t const pos = entry->hash & (bucket_count - 1);
+            entry->bucket_next = buckets[pos];
+            buckets[pos] = entry;
+            entry = next;
+        }
+    }
+
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->bucket_count = bucket_count;
+}
+
+static void
+wf_impl_attr_cache_evict(
+    struct wf_impl_attr_cache * cache)
+{
+    while ((cache->stats.size > cache->max_size) && (NULL != cache->lru_last))
+    {
+        struct wf_impl_attr_cache_entry * entry = cache->lru_last;
+        struct wf_impl_attr_cache_entry * * slot = wf_impl_attr_cache_find_slot(cache, entry->hash, entry->key, entry->name);
+        wf_impl_attr_cache_remove(cache, slot);
+        cache->stats.evictions++;
+    }
+}
+
+static struct wf_impl_attr_cache_entry *
+wf_impl_attr_cache_put(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t key,
+    char const * name,
+    int timeout)
+{
+    size_t const hash = wf_impl_attr_cache_hash(key, name);
+    struct wf_impl_attr_cache_entry * * slot = wf_impl_attr_cache_find_slot(cache, hash, key, name);
+    struct wf_impl_attr_cache_entry * entry = *slot;
+
+    if (NULL != entry)
+    {
+        wf_impl_attr_cache_lru_unlink(cache, entry);
+    }
+    else
+    {
+        size_t const name_size = (NULL != name) ? (strlen(name) + 1) : 0;
+        entry = malloc(sizeof(struct wf_impl_attr_cache_entry));
+        entry->hash = hash;
+        entry->key = key;
+        entry->name = (NULL != name) ? strdup(name) : NULL;
+        entry->size = sizeof(struct wf_impl_attr_cache_entry) + name_size;
+        entry->bucket_next = NULL;
+        *slot = entry;
+
+        cache->stats.count++;
+        cache->stats.size += entry->size;
+    }
+
+    entry->inode = 0;
+    entry->expires = wf_impl_timer_timepoint_in_msec(timeout);
+    wf_impl_attr_cache_lru_push_front(cache, entry);
+
+    if (cache->stats.count > cache->bucket_count)
+    {
+        wf_impl_attr_cache_grow(cache);
+    }
+
+    return entry;
+}
+
+static struct wf_impl_attr_cache_entry *
+wf_impl_attr_cache_get(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t key,
+    char const * name)
+{
+    size_t const hash = wf_impl_attr_cache_hash(key, name);
+    struct wf_impl_attr_cache_entry * * slot = wf_impl_attr_cache_find_slot(cache, hash, key, name);
+    struct wf_impl_attr_cache_entry * entry = *slot;
+
+    if (NULL != entry)
+    {
+        if (wf_impl_timer_timepoint_is_elapsed(entry->expires))
+        {
+            wf_impl_attr_cache_remove(cache, slot);
+            entry = NULL;
+        }
+        else
+        {
+            wf_impl_attr_cache_lru_unlink(cache, entry);
+            wf_impl_attr_cache_lru_push_front(cache, entry);
+        }
+    }
+
+    return entry;
+}
+
+struct wf_impl_attr_cache *
+wf_impl_attr_cache_create(
+    int timeout_ms,
+    int negative_timeout_ms,
+    size_t max_size)
+{
+    struct wf_impl_attr_cache * cache = malloc(sizeof(struct wf_impl_attr_cache));
+    cache->timeout = timeout_ms;
+    cache->negative_timeout = negative_timeout_ms;
+    cache->max_size = max_size;
+    cache->bucket_count = WF_IMPL_ATTR_CACHE_INITIAL_BUCKETS;
+    cache->buckets = calloc(cache->bucket_count, sizeof(struct wf_impl_attr_cache_entry *));
+    cache->lru_first = NULL;
+    cache->lru_last = NULL;
+    memset(&cache->stats, 0, sizeof(struct wf_impl_attr_cache_stats));
+    cache->generation = 0;
+    memset(cache->invalidated, 0, sizeof(cache->invalidated));
+
+    return cache;
+}
+
+void
+wf_impl_attr_cache_dispose(
+    struct wf_impl_attr_cache * cache)
+{
+    struct wf_impl_attr_cache_entry * entry = cache->lru_first;
+    while (NULL != entry)
+    {
+        struct wf_impl_attr_cache_entry * next = entry->lru_next;
+        free(entry->name);
+        free(entry);
+        entry = next;
+    }
+
+    free(cache->buckets);
+    free(cache);
+}
+
+bool
+wf_impl_attr_cache_get_attr(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t inode,
+    struct stat * attr)
+{
+    struct wf_impl_attr_cache_entry * entry = wf_impl_attr_cache_get(cache, inode, NULL);
+    bool const result = (NULL != entry);
+    if (result)
+    {
+        memcpy(attr, &entry->attr, sizeof(struct stat));
+        cache->stats.hits++;
+    }
+    else
+    {
+        cache->stats.misses++;
+    }
+
+    return result;
+}
+
+void
+wf_impl_attr_cache_set_attr(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t inode,
+    struct stat const * attr)
+{
+    struct wf_impl_attr_cache_entry * entry = wf_impl_attr_cache_put(cache, inode, NULL, cache->timeout);
+    entry->inode = inode;
+    memcpy(&entry->attr, attr, sizeof(struct stat));
+
+    wf_impl_attr_cache_evict(cache);
+}
+
+enum wf_impl_attr_cache_result
+wf_impl_attr_cache_lookup(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t parent,
+    char const * name,
+    struct stat * attr)
+{
+    enum wf_impl_attr_cache_result result = WF_IMPL_ATTR_CACHE_MISS;
+
+    struct wf_impl_attr_cache_entry * entry = wf_impl_attr_cache_get(cache, parent, name);
+    if (NULL != entry)
+    {
+        if (0 == entry->inode)
+        {
+            result = WF_IMPL_ATTR_CACHE_NOT_FOUND;
+            cache->stats.negative_hits++;
+        }
+        else
+        {
+            struct wf_impl_attr_cache_entry * attr_entry = wf_impl_attr_cache_get(cache, entry->inode, NULL);
+            if (NULL != attr_entry)
+            {
+                memcpy(attr, &attr_entry->attr, sizeof(struct stat));
+                result = WF_IMPL_ATTR_CACHE_FOUND;
+                cache->stats.hits++;
+            }
+        }
+    }
+
+    if (WF_IMPL_ATTR_CACHE_MISS == result)
+    {
+        cache->stats.misses++;
+    }
+
+    return result;
+}
+
+void
+wf_impl_attr_cache_set_entry(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t parent,
+    char const * name,
+    fuse_ino_t inode)
+{
+    struct wf_impl_attr_cache_entry * entry = wf_impl_attr_cache_put(cache, parent, name, cache->timeout);
+    entry->inode = inode;
+
+    wf_impl_attr_cache_evict(cache);
+}
+
+void
+wf_impl_attr_cache_set_negative_entry(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t parent,
+    char const * name)
+{
+    if (0 < cache->negative_timeout)
+    {
+        wf_impl_attr_cache_put(cache, parent, name, cache->negative_timeout);
+        wf_impl_attr_cache_evict(cache);
+    }
+    else
+    {
+        wf_impl_attr_cache_invalidate_entry(cache, parent, name);
+    }
+}
+
+static void
+wf_impl_attr_cache_set_invalidated(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t inode)
+{
+    size_t const hash = wf_impl_attr_cache_hash(inode, NULL);
+    cache->generation++;
+    cache->invalidated[hash % WF_IMPL_ATTR_CACHE_GENERATION_SLOTS] = cache->generation;
+}
+
+uint64_t
+wf_impl_attr_cache_get_generation(
+    struct wf_impl_attr_cache * cache)
+{
+    return cache->generation;
+}
+
+bool
+wf_impl_attr_cache_is_invalidated(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t inode,
+    uint64_t generation)
+{
+    size_t const hash = wf_impl_attr_cache_hash(inode, NULL);
+    return (generation < cache->invalidated[hash % WF_IMPL_ATTR_CACHE_GENERATION_SLOTS]);
+}
+
+void
+wf_impl_attr_cache_invalidate_attr(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t inode)
+{
+    wf_impl_attr_cache_set_invalidated(cache, inode);
+
+    size_t const hash = wf_impl_attr_cache_hash(inode, NULL);
+    struct wf_impl_attr_cache_entry * * slot = wf_impl_attr_cache_find_slot(cache, hash, inode, NULL);
+    if (NULL != *slot)
+    {
+        wf_impl_attr_cache_remove(cache, slot);
+    }
+}
+
+void
+wf_impl_attr_cache_invalidate_entry(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t parent,
+    char const * name)
+{
+    // entries are tracked by their parent
+    wf_impl_attr_cache_set_invalidated(cache, parent);
+
+    size_t const hash = wf_impl_attr_cache_hash(parent, name);
+    struct wf_impl_attr_cache_entry * * slot = wf_impl_attr_cache_find_slot(cache, hash, parent, name);
+    if (NULL != *slot)
+    {
+        wf_impl_attr_cache_remove(cache, slot);
+    }
+}
+
+void
+wf_impl_attr_cache_get_stats(
+    struct wf_impl_attr_cache * cache,
+    struct wf_impl_attr_cache_stats * stats)
+{
+    memcpy(stats, &cache->stats, sizeof(struct wf_impl_attr_cache_stats));
+}
+
+void
+wf_impl_attr_cache_log_stats(
+    struct wf_impl_attr_cache * cache,
+    char const * name)
+{
+    struct wf_impl_attr_cache_stats const * stats = &cache->stats;
+    size_t const lookups = stats->hits + stats->negative_hits + stats->misses;
+    size_t const hit_rate = (0 < lookups) ? (((stats->hits + stats->negative_hits) * 100) / lookups) : 0;
+
+    lwsl_info("%s: attr cache: %zu hits, %zu negative hits, %zu misses (%zu%% hit rate), %zu evictions, %zu entries, %zu bytes\n",
+        name, stats->hits, stats->negative_hits, stats->misses, hit_rate, stats->evictions, stats->count, stats->size);
+}
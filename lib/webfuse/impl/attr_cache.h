@@ -0,0 +1,166 @@
+#ifndef WF_ADAPTER_IMPL_ATTR_CACHE_H
+#define WF_ADAPTER_IMPL_ATTR_CACHE_H
+
+#include "webfuse/impl/fuse_wrapper.h"
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <stdbool.h>
+#else
+#include <cstddef>
+#endif
+
+#include <stdint.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//------------------------------------------------------------------------------
+/// \brief Adapter side cache of file attributes and directory entries.
+///
+/// Attributes are cached by provider id (see inode_table.h), directory
+/// entries are cached by (parent, name). Entries which are known not to
+/// exist (negative entries) are cached with a separate timeout.
+///
+/// The cache is filled by lookup, getattr and readdir replies and
+/// is limited to a maximum size in bytes; least recently used entries
+/// are evicted first.
+///
+/// Replies to requests sent before an invalidation must not refill the
+/// cache. Therefore, each invalidation increments a generation, which
+/// is recorded for the invalidated inode (see
+/// wf_impl_attr_cache_is_invalidated).
+//------------------------------------------------------------------------------
+struct wf_impl_attr_cache;
+
+enum wf_impl_attr_cache_result
+{
+    WF_IMPL_ATTR_CACHE_MISS,
+    WF_IMPL_ATTR_CACHE_FOUND,
+    WF_IMPL_ATTR_CACHE_NOT_FOUND
+};
+
+struct wf_impl_attr_cache_stats
+{
+    size_t hits;
+    size_t negative_hits;
+    size_t misses;
+    size_t evictions;
+    size_t count;
+    size_t size;
+};
+
+extern struct wf_impl_attr_cache *
+wf_impl_attr_cache_create(
+    int timeout_ms,
+    int negative_timeout_ms,
+    size_t max_size);
+
+extern void
+wf_impl_attr_cache_dispose(
+    struct wf_impl_attr_cache * cache);
+
+extern bool
+wf_impl_attr_cache_get_attr(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t inode,
+    struct stat * attr);
+
+extern void
+wf_impl_attr_cache_set_attr(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t inode,
+    struct stat const * attr);
+
+//------------------------------------------------------------------------------
+/// \brief Looks up a directory entry.
+///
+/// The entry is found, if the name is known and the attributes
+/// of the referred inode are cached.
+///
+/// \param cache pointer to the cache
+/// \param parent inode of the parent directory
+/// \param name name of the entry
+/// \param attr receives the attributes of the entry if found
+/// \return WF_IMPL_ATTR_CACHE_FOUND, if the entry is cached,
+///         WF_IMPL_ATTR_CACHE_NOT_FOUND, if the entry is known not to exist,
+///         WF_IMPL_ATTR_CACHE_MISS otherwise
+//------------------------------------------------------------------------------
+extern enum wf_impl_attr_cache_result
+wf_impl_attr_cache_lookup(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t parent,
+    char const * name,
+    struct stat * attr);
+
+extern void
+wf_impl_attr_cache_set_entry(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t parent,
+    char const * name,
+    fuse_ino_t inode);
+
+extern void
+wf_impl_attr_cache_set_negative_entry(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t parent,
+    char const * name);
+
+//------------------------------------------------------------------------------
+/// \brief Returns the current invalidation generation.
+///
+/// The generation is recorded when a request is sent, which fills the
+/// cache with its reply.
+//------------------------------------------------------------------------------
+extern uint64_t
+wf_impl_attr_cache_get_generation(
+    struct wf_impl_attr_cache * cache);
+
+//------------------------------------------------------------------------------
+/// \brief Returns true, if attributes of an inode or entries of a directory
+///        were invalidated after a given generation.
+///
+/// Inodes are tracked in a fixed number of slots, so an invalidation may
+/// also be reported for other inodes sharing the slot.
+///
+/// \param cache pointer to the cache
+/// \param inode provider id of the inode or the parent directory
+/// \param generation generation recorded when the request was sent
+//------------------------------------------------------------------------------
+extern bool
+wf_impl_attr_cache_is_invalidated(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t inode,
+    uint64_t generation);
+
+extern void
+wf_impl_attr_cache_invalidate_attr(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t inode);
+
+extern void
+wf_impl_attr_cache_invalidate_entry(
+    struct wf_impl_attr_cache * cache,
+    fuse_ino_t parent,
+    char const * name);
+
+extern void
+wf_impl_attr_cache_get_stats(
+    struct wf_impl_attr_cache * cache,
+    struct wf_impl_attr_cache_stats * stats);
+
+extern void
+wf_impl_attr_cache_log_stats(
+    struct wf_impl_attr_cache * cache,
+    char const * name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -7,21 +7,35 @@
 #include "webfuse/impl/util/url.h"
 #include "webfuse/impl/util/util.h"
 #include "webfuse/impl/timer/manager.h"
+#include "webfuse/impl/timer_scheduler.h"
 #include "webfuse/impl/jsonrpc/response.h"
 #include "webfuse/impl/jsonrpc/proxy.h"
+#include "webfuse/impl/jsonrpc/server.h"
+#include "webfuse/impl/jsonrpc/request.h"
+#include "webfuse/impl/invalidation.h"
 #include "webfuse/impl/json/doc.h"
 #include "webfuse/impl/json/node.h"
+#include "webfuse/impl/json/writer.h"
 
 #include "webfuse/impl/message.h"
-#include "webfuse/impl/message_queue.h"
+#include "webfuse/impl/message_scheduler.h"
+#include "webfuse/impl/message_pool.h"
 #include "webfuse/impl/util/container_of.h"
 
 
 #include <stddef.h>
+#include <string.h>
 #include <libwebsockets.h>
 
 #define WF_DEFAULT_TIMEOUT (10 * 1000)
 #define WF_DEFAULT_MESSAGE_SIZE (10 * 1024)
+#define WF_DEFAULT_BATCH_SIZE (64 * 1024)
+#define WF_DEFAULT_RECV_CHUNK_COUNT 8
+#define WF_DEFAULT_RECV_MAX_SIZE (64 * 1024)
+#define WF_DEFAULT_FRAGMENT_SIZE (64 * 1024)
+#define WF_DEFAULT_POOL_BUFFER_SIZE 1024
+#define WF_DEFAULT_POOL_MAX_BUFFER_SIZE (64 * 1024)
+#define WF_DEFAULT_POOL_MAX_COUNT 256
 
 struct wf_impl_client_protocol_add_filesystem_context
 {
@@ -29,19 +43,50 @@ struct wf_impl_client_protocol_add_filesystem_context
     char * local_path;
 };
 
+static bool
+wf_impl_client_protocol_send(
+    struct wf_message * message,
+    void * user_data);
+
+static void
+wf_impl_client_protocol_dispatch(
+     struct wf_client_protocol * protocol,
+     struct wf_json const * message)
+{
+    if (wf_impl_jsonrpc_is_response(message))
+    {
+        wf_impl_jsonrpc_proxy_onresult(protocol->proxy, message);
+    }
+    else if ((wf_impl_jsonrpc_is_request(message)) || (wf_impl_jsonrpc_is_notification(message)))
+    {
+        wf_impl_jsonrpc_server_process(protocol->server, message, &wf_impl_client_protocol_send, protocol);
+    }
+}
+
 static void
 wf_impl_client_protocol_process(
      struct wf_client_protocol * protocol, 
      char * data,
      size_t length)
 {
-    struct wf_json_doc * doc = wf_impl_json_doc_loadb(data, length);
+    struct wf_json_doc * doc = wf_impl_json_doc_loadb_arena(&protocol->json_arena, data, length);
     if (NULL != doc)
     {
+        wf_impl_jsonrpc_attachment_apply(&protocol->attachment, doc);
+
         struct wf_json const * message = wf_impl_json_doc_root(doc);
-        if (wf_impl_jsonrpc_is_response(message))
+        if (wf_impl_json_is_array(message))
+        {
+            // batch: messages are dispatched in order
+            size_t const count = wf_impl_json_array_size(message);
+            for(size_t i = 0; i < count; i++)
+            {
+                wf_impl_client_protocol_dispatch(protocol, wf_impl_json_array_get(message, i));
+            }
+        }
+        else
         {
-            wf_impl_jsonrpc_proxy_onresult(protocol->proxy, message);
+            wf_impl_client_protocol_dispatch(protocol, message);
         }
 
         wf_impl_json_doc_dispose(doc);
@@ -53,29 +98,50 @@ wf_impl_client_protocol_receive(
      struct wf_client_protocol * protocol, 
      char * data,
      size_t length,
+     size_t remaining,
      bool is_final_fragment)
 {
     if (is_final_fragment)
     {
-        if (wf_impl_buffer_is_empty(&protocol->recv_buffer))
+        if (wf_impl_chunk_chain_is_empty(&protocol->recv_buffer))
         {
             wf_impl_client_protocol_process(protocol, data, length);
         }
         else
         {
-            wf_impl_buffer_append(&protocol->recv_buffer, data, length);
-            wf_impl_client_protocol_process(protocol,
-                wf_impl_buffer_data(&protocol->recv_buffer),
-                wf_impl_buffer_size(&protocol->recv_buffer));
-            wf_impl_buffer_clear(&protocol->recv_buffer);
+            size_t size;
+            char * message = wf_impl_chunk_chain_join(&protocol->recv_buffer, data, length, &size);
+            if (NULL != message)
+            {
+                wf_impl_client_protocol_process(protocol, message, size);
+            }
+            wf_impl_chunk_chain_clear(&protocol->recv_buffer);
         }        
     }
     else
     {
-        wf_impl_buffer_append(&protocol->recv_buffer, data, length);
+        // the remaining payload of the current frame is known
+        if (0 < remaining)
+        {
+            wf_impl_chunk_chain_reserve(&protocol->recv_buffer, length + remaining);
+        }
+        wf_impl_chunk_chain_append(&protocol->recv_buffer, data, length);
     }
 }
 
+static void
+wf_impl_client_protocol_receive_binary(
+     struct wf_client_protocol * protocol,
+     char const * data,
+     size_t length,
+     bool is_first_fragment,
+     bool is_final_fragment)
+{
+    if (protocol->is_binary_enabled)
+    {
+        wf_impl_jsonrpc_attachment_receive(&protocol->attachment, data, length, is_first_fragment, is_final_fragment);
+    }
+}
 
 static bool
 wf_impl_client_protocol_send(
@@ -87,7 +153,7 @@ wf_impl_client_protocol_send(
 
     if (NULL != protocol->wsi)
     {
-        wf_impl_slist_append(&protocol->messages, &message->item);
+        wf_impl_message_sender_enqueue(&protocol->sender, protocol->scheduler, message);
         lws_callback_on_writable(protocol->wsi);
         result = true;
     }
@@ -127,11 +193,17 @@ wf_impl_client_protocol_on_add_filesystem_finished(
         struct wf_json const * id = wf_impl_json_object_get(result, "id");
         if (wf_impl_json_is_string(id))
         {
-            char const * name = wf_impl_json_string_get(id);        
+            char const * name = wf_impl_json_string_get(id);
+            struct wf_json const * binary = wf_impl_json_object_get(result, "binary");
+            protocol->is_binary_enabled = (wf_impl_json_is_bool(binary)) && (wf_impl_json_bool_get(binary));
+            struct wf_json const * batch = wf_impl_json_object_get(result, "batch");
+            protocol->is_batch_enabled = (wf_impl_json_is_bool(batch)) && (wf_impl_json_bool_get(batch));
+
             struct wf_mountpoint * mountpoint = wf_impl_mountpoint_create(context->local_path);
             protocol->filesystem = wf_impl_filesystem_create(protocol->wsi,protocol->proxy, name, mountpoint);
             if (NULL != protocol->filesystem)
             {
+                wf_impl_message_scheduler_add_source(protocol->scheduler, protocol->filesystem, mountpoint->message_weights);
                 reason = WF_CLIENT_FILESYSTEM_ADDED;
             }
             else
@@ -146,6 +218,68 @@ wf_impl_client_protocol_on_add_filesystem_finished(
     protocol->callback(protocol->user_data, reason, NULL);
 }
 
+static struct wf_impl_filesystem *
+wf_impl_client_protocol_get_filesystem(
+    void * user_data,
+    char const * name)
+{
+    struct wf_client_protocol * protocol = user_data;
+    struct wf_impl_filesystem * filesystem = protocol->filesystem;
+
+    return ((NULL != filesystem) && (0 == strcmp(name, filesystem->user_data.name))) ? filesystem : NULL;
+}
+
+static void
+wf_impl_client_protocol_invalidate_inode(
+    struct wf_jsonrpc_request * request,
+    char const * WF_UNUSED_PARAM(method_name),
+    struct wf_json const * params,
+    void * user_data)
+{
+    wf_impl_invalidation_process_inode(request, params, &wf_impl_client_protocol_get_filesystem, user_data);
+}
+
+static void
+wf_impl_client_protocol_invalidate_entry(
+    struct wf_jsonrpc_request * request,
+    char const * WF_UNUSED_PARAM(method_name),
+    struct wf_json const * params,
+    void * user_data)
+{
+    wf_impl_invalidation_process_entry(request, params, &wf_impl_client_protocol_get_filesystem, user_data);
+}
+
+static void
+wf_impl_client_protocol_update_flow_control(
+    struct wf_client_protocol * protocol)
+{
+    // skipped while the connection is closed, since the filesystem is detached meanwhile
+    if ((NULL != protocol->filesystem) && (NULL != protocol->wsi))
+    {
+        wf_impl_filesystem_update_flow_control(protocol->filesystem,
+            wf_impl_jsonrpc_proxy_get_pending_count(protocol->proxy),
+            protocol->sender.queued_bytes);
+    }
+}
+
+// requests cancelled by timeout are not in flight anymore
+static void
+wf_impl_client_protocol_on_timeout(
+    void * user_data)
+{
+    struct wf_client_protocol * protocol = user_data;
+    wf_impl_client_protocol_update_flow_control(protocol);
+}
+
+static void
+wf_impl_client_protocol_on_message_taken(
+    void * user_data,
+    struct wf_message const * message)
+{
+    struct wf_client_protocol * protocol = user_data;
+    wf_impl_jsonrpc_proxy_onsent(protocol->proxy, message);
+}
+
 static int wf_impl_client_protocol_lws_callback(
 	struct lws * wsi,
 	enum lws_callback_reasons reason,
@@ -159,10 +293,11 @@ static int wf_impl_client_protocol_lws_callback(
 
     if (NULL != protocol)
     {
-        wf_impl_timer_manager_check(protocol->timer_manager);
-
         switch (reason)
         {
+            case LWS_CALLBACK_PROTOCOL_DESTROY:
+                wf_impl_timer_scheduler_stop(protocol->timer_scheduler);
+                break;
             case LWS_CALLBACK_CLIENT_ESTABLISHED:
                 protocol->is_connected = true;
                 protocol->callback(protocol->user_data, WF_CLIENT_CONNECTED, NULL);
@@ -178,7 +313,14 @@ static int wf_impl_client_protocol_lws_callback(
                 protocol->callback(protocol->user_data, WF_CLIENT_DISCONNECTED, NULL);
                 break;
             case LWS_CALLBACK_CLIENT_RECEIVE:
-                wf_impl_client_protocol_receive(protocol, in, len, lws_is_final_fragment(wsi));
+                if (lws_frame_is_binary(wsi))
+                {
+                    wf_impl_client_protocol_receive_binary(protocol, in, len, lws_is_first_fragment(wsi), lws_is_final_fragment(wsi));
+                }
+                else
+                {
+                    wf_impl_client_protocol_receive(protocol, in, len, lws_remaining_packet_payload(wsi), lws_is_final_fragment(wsi));
+                }
                 break;
             case LWS_CALLBACK_SERVER_WRITEABLE:
                 // fall-through
@@ -189,17 +331,11 @@ static int wf_impl_client_protocol_lws_callback(
                     {
                         result = 1;
                     }
-                    else if (!wf_impl_slist_empty(&protocol->messages))
+                    else
                     {
-                        struct wf_slist_item * item = wf_impl_slist_remove_first(&protocol->messages);
-                        struct wf_message * message = wf_container_of(item, struct wf_message, item);
-                        lws_write(wsi, (unsigned char*) message->data, message->length, LWS_WRITE_TEXT);
-                        wf_impl_message_dispose(message);
-
-                        if (!wf_impl_slist_empty(&protocol->messages))
-                        {
-                            lws_callback_on_writable(wsi);
-                        }
+                        size_t const batch_size = (protocol->is_batch_enabled) ? WF_DEFAULT_BATCH_SIZE : 0;
+                        bool const success = wf_impl_message_sender_write(&protocol->sender, protocol->scheduler, wsi, batch_size);
+                        result = (success) ? 0 : -1;
                     }
                 }
                 break;
@@ -208,9 +344,25 @@ static int wf_impl_client_protocol_lws_callback(
                 {
                     wf_impl_filesystem_process_request(protocol->filesystem);
                 }
+                break;
+            case LWS_CALLBACK_RAW_CLOSE_FILE:
+                if ((NULL != protocol->filesystem) && (wsi == protocol->filesystem->wsi))
+                {
+                    protocol->filesystem->wsi = NULL;
+                }
+                break;
             default:
                 break;
         }
+
+        bool const is_traffic = (LWS_CALLBACK_CLIENT_RECEIVE == reason) || (LWS_CALLBACK_CLIENT_WRITEABLE == reason) || (LWS_CALLBACK_RAW_RX_FILE == reason);
+        if (is_traffic)
+        {
+            wf_impl_client_protocol_update_flow_control(protocol);
+        }
+
+        // requests might be invoked, so their timeouts must be scheduled
+        wf_impl_timer_scheduler_update(protocol->timer_scheduler, lws_get_context(wsi));
     }
 
     return result;
@@ -229,10 +381,24 @@ wf_impl_client_protocol_init(
     protocol->user_data = user_data;
     protocol->filesystem = NULL;
 
-    wf_impl_buffer_init(&protocol->recv_buffer, WF_DEFAULT_MESSAGE_SIZE);
-    wf_impl_slist_init(&protocol->messages);
+    wf_impl_chunk_chain_init(&protocol->recv_buffer, WF_DEFAULT_MESSAGE_SIZE, WF_DEFAULT_RECV_CHUNK_COUNT, WF_DEFAULT_RECV_MAX_SIZE);
+    wf_impl_arena_init(&protocol->json_arena, WF_DEFAULT_MESSAGE_SIZE);
+    protocol->is_binary_enabled = false;
+    protocol->is_batch_enabled = false;
+    wf_impl_jsonrpc_attachment_init(&protocol->attachment);
+    protocol->scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_sender_init(&protocol->sender, WF_DEFAULT_FRAGMENT_SIZE);
     protocol->timer_manager = wf_impl_timer_manager_create();
+    protocol->timer_scheduler = wf_impl_timer_scheduler_create(protocol->timer_manager);
+    protocol->message_pool = wf_impl_message_pool_create(
+        WF_DEFAULT_POOL_BUFFER_SIZE, WF_DEFAULT_POOL_MAX_BUFFER_SIZE, WF_DEFAULT_POOL_MAX_COUNT);
     protocol->proxy = wf_impl_jsonrpc_proxy_create(protocol->timer_manager, WF_DEFAULT_TIMEOUT, &wf_impl_client_protocol_send, protocol);
+    wf_impl_jsonrpc_proxy_set_message_pool(protocol->proxy, protocol->message_pool);
+    wf_impl_jsonrpc_proxy_set_timeout_handler(protocol->proxy, &wf_impl_client_protocol_on_timeout, protocol);
+    wf_impl_message_scheduler_set_taken_handler(protocol->scheduler, &wf_impl_client_protocol_on_message_taken, protocol);
+    protocol->server = wf_impl_jsonrpc_server_create();
+    wf_impl_jsonrpc_server_add(protocol->server, "invalidate_inode", &wf_impl_client_protocol_invalidate_inode, protocol);
+    wf_impl_jsonrpc_server_add(protocol->server, "invalidate_entry", &wf_impl_client_protocol_invalidate_entry, protocol);
 
     protocol->callback(protocol->user_data, WF_CLIENT_INIT, NULL);
 }
@@ -243,9 +409,15 @@ wf_impl_client_protocol_cleanup(
 {
     protocol->callback(protocol->user_data, WF_CLIENT_CLEANUP, NULL);
 
+    wf_impl_jsonrpc_proxy_log_stats(protocol->proxy, "client");
     wf_impl_jsonrpc_proxy_dispose(protocol->proxy);
+    wf_impl_jsonrpc_server_dispose(protocol->server);
+    wf_impl_timer_scheduler_dispose(protocol->timer_scheduler);
     wf_impl_timer_manager_dispose(protocol->timer_manager);
-    wf_impl_message_queue_cleanup(&protocol->messages);
+    wf_impl_message_sender_log_stats(&protocol->sender, "client");
+    wf_impl_message_scheduler_log_stats(protocol->scheduler, "client");
+    wf_impl_message_sender_cleanup(&protocol->sender);
+    wf_impl_message_scheduler_dispose(protocol->scheduler);
 
     if (NULL != protocol->filesystem)
     {
@@ -253,7 +425,11 @@ wf_impl_client_protocol_cleanup(
         protocol->filesystem = NULL;
     }
 
-    wf_impl_buffer_cleanup(&protocol->recv_buffer);
+    wf_impl_chunk_chain_cleanup(&protocol->recv_buffer);
+    wf_impl_arena_cleanup(&protocol->json_arena);
+    wf_impl_jsonrpc_attachment_cleanup(&protocol->attachment);
+    wf_impl_message_pool_log_stats(protocol->message_pool, "client");
+    wf_impl_message_pool_dispose(protocol->message_pool);
 }
 
 void
@@ -343,6 +519,17 @@ wf_impl_client_protocol_authenticate(
     wf_impl_credentials_cleanup(&creds);
 }
 
+static void
+wf_impl_client_protocol_write_options(
+    struct wf_json_writer * writer,
+    void * WF_UNUSED_PARAM(data))
+{
+    wf_impl_json_write_object_begin(writer);
+    wf_impl_json_write_object_bool(writer, "binary", true);
+    wf_impl_json_write_object_bool(writer, "batch", true);
+    wf_impl_json_write_object_end(writer);
+}
+
 void
 wf_impl_client_protocol_add_filesystem(
     struct wf_client_protocol * protocol,
@@ -360,8 +547,8 @@ wf_impl_client_protocol_add_filesystem(
             &wf_impl_client_protocol_on_add_filesystem_finished,
             context,
             "add_filesystem",
-            "s",
-            name);
+            "sj",
+            name, &wf_impl_client_protocol_write_options, NULL);
     }
     else
     {
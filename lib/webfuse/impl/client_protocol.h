@@ -3,7 +3,10 @@
 
 #include "webfuse/client_callback.h"
 #include "webfuse/impl/util/slist.h"
-#include "webfuse/impl/util/buffer.h"
+#include "webfuse/impl/util/chunk_chain.h"
+#include "webfuse/impl/util/arena.h"
+#include "webfuse/impl/jsonrpc/attachment.h"
+#include "webfuse/impl/message_sender.h"
 
 #ifndef __cplusplus
 #include <stdbool.h>
@@ -18,8 +21,12 @@ struct lws_protocols;
 struct lws_context;
 
 struct wf_impl_filesystem;
+struct wf_message_scheduler;
+struct wf_message_pool;
 struct wf_jsonrpc_proxy;
+struct wf_jsonrpc_server;
 struct wf_timer_manager;
+struct wf_impl_timer_scheduler;
 
 typedef void
 wf_client_protocol_callback_fn(
@@ -36,9 +43,17 @@ struct wf_client_protocol
     struct wf_impl_filesystem * filesystem;
     void * user_data;
     struct wf_timer_manager * timer_manager;
+    struct wf_impl_timer_scheduler * timer_scheduler;
     struct wf_jsonrpc_proxy * proxy;
-    struct wf_slist messages;
-    struct wf_buffer recv_buffer;
+    struct wf_jsonrpc_server * server;
+    struct wf_message_scheduler * scheduler;
+    struct wf_message_sender sender;
+    struct wf_message_pool * message_pool;
+    struct wf_chunk_chain recv_buffer;
+    struct wf_arena json_arena;
+    bool is_binary_enabled;
+    bool is_batch_enabled;
+    struct wf_jsonrpc_attachment attachment;
 };
 
 extern void
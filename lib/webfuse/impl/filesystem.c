@@ -1,13 +1,24 @@
 #include "webfuse/impl/filesystem.h"
 #include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/operation/init.h"
 #include "webfuse/impl/operation/open.h"
 #include "webfuse/impl/operation/close.h"
 #include "webfuse/impl/operation/read.h"
+#include "webfuse/impl/operation/readahead.h"
+#include "webfuse/impl/operation/opendir.h"
 #include "webfuse/impl/operation/readdir.h"
+#include "webfuse/impl/operation/releasedir.h"
 #include "webfuse/impl/operation/getattr.h"
 #include "webfuse/impl/operation/lookup.h"
+#include "webfuse/impl/operation/singleflight.h"
+#include "webfuse/impl/operation/forget.h"
 #include "webfuse/impl/session.h"
 #include "webfuse/impl/mountpoint.h"
+#include "webfuse/impl/attr_cache.h"
+#include "webfuse/impl/inode_table.h"
+#include "webfuse/impl/notifier.h"
+#include "webfuse/impl/flow_control.h"
+#include "webfuse/impl/jsonrpc/proxy.h"
 
 #include <libwebsockets.h>
 
@@ -15,17 +26,28 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <dirent.h>
+#include <fcntl.h>
 
 #include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
 #include <errno.h>
 
+// max. number of requests processed per wakeup, so that a busy filesystem
+// does not stall other filesystems and connections
+#define WF_FILESYSTEM_BATCH_SIZE 16
+
 static struct fuse_lowlevel_ops const filesystem_operations =
 {
+	.init = &wf_impl_operation_init,
 	.lookup = &wf_impl_operation_lookup,
+	.forget = &wf_impl_operation_forget,
+	.forget_multi = &wf_impl_operation_forget_multi,
 	.getattr = &wf_impl_operation_getattr,
+	.opendir = &wf_impl_operation_opendir,
 	.readdir = &wf_impl_operation_readdir,
+	.readdirplus = &wf_impl_operation_readdirplus,
+	.releasedir = &wf_impl_operation_releasedir,
 	.open	= &wf_impl_operation_open,
 	.release = &wf_impl_operation_close,
 	.read	= &wf_impl_operation_read
@@ -34,6 +56,13 @@ static struct fuse_lowlevel_ops const filesystem_operations =
 static void wf_impl_filesystem_cleanup(
     struct wf_impl_filesystem * filesystem)
 {
+	// pending notifications are delivered while the filesystem is still mounted
+	if (NULL != filesystem->notifier)
+	{
+		wf_impl_notifier_dispose(filesystem->notifier);
+		filesystem->notifier = NULL;
+	}
+
 	fuse_session_reset(filesystem->session);
 	fuse_session_unmount(filesystem->session);
 	fuse_session_destroy(filesystem->session);
@@ -44,7 +73,23 @@ static void wf_impl_filesystem_cleanup(
 
 	wf_mountpoint_dispose(filesystem->mountpoint);
 
+	if (NULL != filesystem->user_data.cache)
+	{
+		wf_impl_attr_cache_log_stats(filesystem->user_data.cache, filesystem->user_data.name);
+		wf_impl_attr_cache_dispose(filesystem->user_data.cache);
+		filesystem->user_data.cache = NULL;
+	}
+
 	free(filesystem->user_data.name);
+
+	wf_impl_singleflight_dispose(filesystem->user_data.singleflight);
+	filesystem->user_data.singleflight = NULL;
+
+	wf_impl_inode_table_dispose(filesystem->user_data.inodes);
+	filesystem->user_data.inodes = NULL;
+
+	wf_impl_jsonrpc_proxy_dispose(filesystem->user_data.proxy);
+	wf_impl_jsonrpc_proxy_dispose(filesystem->user_data.data_proxy);
 }
 
 static bool wf_impl_filesystem_init(
@@ -60,12 +105,38 @@ static bool wf_impl_filesystem_init(
 	filesystem->args.argv = mountpoint->options.items;
 	filesystem->args.allocated = 0;
 
-	filesystem->user_data.proxy = proxy;
-	filesystem->user_data.timeout = 1.0;
+	// messages are tagged with the filesystem, so that they are scheduled
+	// per filesystem and class (see message_scheduler.h)
+	filesystem->user_data.proxy = wf_impl_jsonrpc_proxy_create_view(proxy, filesystem, WF_MESSAGE_CLASS_METADATA);
+	filesystem->user_data.data_proxy = wf_impl_jsonrpc_proxy_create_view(proxy, filesystem, WF_MESSAGE_CLASS_DATA);
+	wf_impl_jsonrpc_proxy_set_timeout(filesystem->user_data.proxy,
+		mountpoint->request_timeout.min_timeout, mountpoint->request_timeout.max_timeout);
+	wf_impl_jsonrpc_proxy_set_timeout(filesystem->user_data.data_proxy,
+		mountpoint->request_timeout.min_timeout, mountpoint->request_timeout.max_timeout);
+	filesystem->user_data.timeout = ((double) mountpoint->kernel_cache_timeout) / 1000.0;
 	filesystem->user_data.name = strdup(name);
+	filesystem->user_data.readahead = mountpoint->readahead;
+	filesystem->user_data.read_chunk_size = mountpoint->read_chunk_size;
+	filesystem->user_data.open_files = NULL;
+	filesystem->user_data.fuse_options = &mountpoint->fuse;
+	filesystem->user_data.cache = NULL;
+	if (0 < mountpoint->attr_cache.timeout)
+	{
+		filesystem->user_data.cache = wf_impl_attr_cache_create(
+			mountpoint->attr_cache.timeout,
+			mountpoint->attr_cache.negative_timeout,
+			mountpoint->attr_cache.max_size);
+	}
+	filesystem->user_data.singleflight = wf_impl_singleflight_create();
+	filesystem->user_data.inodes = wf_impl_inode_table_create();
 	memset(&filesystem->buffer, 0, sizeof(struct fuse_buf));
 
 	filesystem->mountpoint = mountpoint;
+	filesystem->wsi = NULL;
+	filesystem->notifier = NULL;
+	wf_impl_flow_control_init(&filesystem->flow_control,
+		mountpoint->flow_control.max_in_flight,
+		mountpoint->flow_control.max_queued_bytes);
 
 	filesystem->session = fuse_session_new(
         &filesystem->args,
@@ -80,18 +151,47 @@ static bool wf_impl_filesystem_init(
 
 	if (result)
 	{
-        lws_sock_file_fd_type fd;
-        fd.filefd = fuse_session_fd(filesystem->session);
-		struct lws_protocols const * protocol = lws_get_protocol(session_wsi);
-        filesystem->wsi = lws_adopt_descriptor_vhost(lws_get_vhost(session_wsi), LWS_ADOPT_RAW_FILE_DESC, fd, protocol->name, session_wsi);
+		// requests are received in batches until the channel is drained,
+		// so the channel must not block
+		int const fuse_fd = fuse_session_fd(filesystem->session);
+		int const flags = fcntl(fuse_fd, F_GETFL);
+		if ((0 <= flags) && (0 == fcntl(fuse_fd, F_SETFL, flags | O_NONBLOCK)))
+		{
+			lws_sock_file_fd_type fd;
+			fd.filefd = fuse_fd;
+			struct lws_protocols const * protocol = lws_get_protocol(session_wsi);
+			filesystem->wsi = lws_adopt_descriptor_vhost(lws_get_vhost(session_wsi), LWS_ADOPT_RAW_FILE_DESC, fd, protocol->name, session_wsi);
+		}
 
-		if (NULL == filesystem->wsi)
+		if (NULL != filesystem->wsi)
+		{
+			filesystem->notifier = wf_impl_notifier_create(filesystem->session);
+		}
+
+		if ((NULL == filesystem->wsi) || (NULL == filesystem->notifier))
 		{
 			wf_impl_filesystem_cleanup(filesystem);
 			result = false;
 		}
 
 	}
+	else
+	{
+		if (NULL != filesystem->user_data.cache)
+		{
+			wf_impl_attr_cache_dispose(filesystem->user_data.cache);
+			filesystem->user_data.cache = NULL;
+		}
+
+		wf_impl_singleflight_dispose(filesystem->user_data.singleflight);
+		filesystem->user_data.singleflight = NULL;
+
+		wf_impl_inode_table_dispose(filesystem->user_data.inodes);
+		filesystem->user_data.inodes = NULL;
+
+		wf_impl_jsonrpc_proxy_dispose(filesystem->user_data.proxy);
+		wf_impl_jsonrpc_proxy_dispose(filesystem->user_data.data_proxy);
+	}
 
 	return result;
 }
@@ -123,9 +223,75 @@ void wf_impl_filesystem_dispose(
 void wf_impl_filesystem_process_request(
     struct wf_impl_filesystem * filesystem)
 {
-	int const result = fuse_session_receive_buf(filesystem->session, &filesystem->buffer);
-	if (0 < result)
+	// requests left in the channel wake the service thread again
+	for(size_t i = 0; (i < WF_FILESYSTEM_BATCH_SIZE) && (!wf_impl_flow_control_is_paused(&filesystem->flow_control)); i++)
 	{
+		int const result = fuse_session_receive_buf(filesystem->session, &filesystem->buffer);
+		if (0 >= result)
+		{
+			break;
+		}
+
 		fuse_session_process_buf(filesystem->session, &filesystem->buffer);
 	}
 }
+
+void wf_impl_filesystem_invalidate_inode(
+    struct wf_impl_filesystem * filesystem,
+    uint64_t id,
+    off_t offset,
+    off_t length)
+{
+	if (NULL != filesystem->user_data.cache)
+	{
+		wf_impl_attr_cache_invalidate_attr(filesystem->user_data.cache, (fuse_ino_t) id);
+	}
+
+	// contents read ahead are dropped as a whole
+	if (0 <= offset)
+	{
+		wf_impl_readahead_invalidate(filesystem->user_data.open_files, id);
+	}
+
+	// the kernel does not cache inodes it does not know
+	fuse_ino_t const inode = wf_impl_inode_table_find(filesystem->user_data.inodes, id);
+	if (0 != inode)
+	{
+		wf_impl_notifier_inval_inode(filesystem->notifier, inode, offset, length);
+	}
+}
+
+void wf_impl_filesystem_invalidate_entry(
+    struct wf_impl_filesystem * filesystem,
+    uint64_t parent_id,
+    char const * name)
+{
+	if (NULL != filesystem->user_data.cache)
+	{
+		wf_impl_attr_cache_invalidate_entry(filesystem->user_data.cache, (fuse_ino_t) parent_id, name);
+	}
+
+	fuse_ino_t const parent = wf_impl_inode_table_find(filesystem->user_data.inodes, parent_id);
+	if (0 != parent)
+	{
+		wf_impl_notifier_inval_entry(filesystem->notifier, parent, name);
+	}
+}
+
+void wf_impl_filesystem_update_flow_control(
+    struct wf_impl_filesystem * filesystem,
+    size_t in_flight,
+    size_t queued_bytes)
+{
+	// the connection of the filesystem is closed before the session is
+	if ((NULL != filesystem->wsi) &&
+		(wf_impl_flow_control_update(&filesystem->flow_control, in_flight, queued_bytes)))
+	{
+		bool const is_paused = wf_impl_flow_control_is_paused(&filesystem->flow_control);
+		lwsl_info("%s: %s receiving requests (%zu in flight, %zu bytes queued)\n",
+			filesystem->user_data.name, (is_paused) ? "pause" : "resume", in_flight, queued_bytes);
+
+		// pending requests stay in the kernel meanwhile
+		lws_rx_flow_control(filesystem->wsi, (is_paused) ? 0 : 1);
+	}
+}
@@ -7,6 +7,7 @@
 
 #include "webfuse/impl/fuse_wrapper.h"
 #include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/flow_control.h"
 #include "webfuse/impl/util/slist.h"
 
 #ifdef __cplusplus
@@ -16,6 +17,7 @@ extern "C"
 
 struct wf_mountpoint;
 struct wf_jsonrpc_proxy;
+struct wf_impl_notifier;
 struct lws;
 
 struct wf_impl_filesystem
@@ -27,6 +29,8 @@ struct wf_impl_filesystem
 	struct wf_impl_operation_context user_data;
     struct lws * wsi;
     struct wf_mountpoint * mountpoint;
+    struct wf_impl_notifier * notifier;
+    struct wf_impl_flow_control flow_control;
 };
 
 extern struct wf_impl_filesystem * wf_impl_filesystem_create(
@@ -41,6 +45,51 @@ extern void wf_impl_filesystem_dispose(
 extern void wf_impl_filesystem_process_request(
     struct wf_impl_filesystem * filesystem);
 
+//------------------------------------------------------------------------------
+/// \brief Pauses or resumes receiving requests from the kernel according to
+///        the load of the connection (see wf_mountpoint_set_flow_control).
+///
+/// \param filesystem pointer to the filesystem
+/// \param in_flight number of requests waiting for a response
+/// \param queued_bytes number of bytes waiting to be sent
+//------------------------------------------------------------------------------
+extern void wf_impl_filesystem_update_flow_control(
+    struct wf_impl_filesystem * filesystem,
+    size_t in_flight,
+    size_t queued_bytes);
+
+//------------------------------------------------------------------------------
+/// \brief Invalidates cached attributes and contents of an inode.
+///
+/// Both, adapter side caches (attributes and contents read ahead) and
+/// kernel cache are invalidated. The kernel is only notified, if the inode
+/// is known to it.
+///
+/// \param filesystem pointer to the filesystem
+/// \param id provider id of the inode to invalidate
+/// \param offset offset of the contents to invalidate; negative values
+///               only invalidate attributes
+/// \param length length of the contents to invalidate; 0 invalidates
+///               up to the end of the file
+//------------------------------------------------------------------------------
+extern void wf_impl_filesystem_invalidate_inode(
+    struct wf_impl_filesystem * filesystem,
+    uint64_t id,
+    off_t offset,
+    off_t length);
+
+//------------------------------------------------------------------------------
+/// \brief Invalidates a directory entry.
+///
+/// Both, adapter side cache and kernel cache are invalidated.
+///
+/// \param parent_id provider id of the parent directory
+//------------------------------------------------------------------------------
+extern void wf_impl_filesystem_invalidate_entry(
+    struct wf_impl_filesystem * filesystem,
+    uint64_t parent_id,
+    char const * name);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,59 @@
+#include "webfuse/impl/flow_control.h"
+
+static bool
+wf_impl_flow_control_exceeds(
+    size_t value,
+    size_t limit)
+{
+    return (0 < limit) && (value >= limit);
+}
+
+static bool
+wf_impl_flow_control_drained(
+    size_t value,
+    size_t limit)
+{
+    return (0 == limit) || (value <= (limit / 2));
+}
+
+void
+wf_impl_flow_control_init(
+    struct wf_impl_flow_control * flow_control,
+    size_t max_in_flight,
+    size_t max_queued_bytes)
+{
+    flow_control->max_in_flight = max_in_flight;
+    flow_control->max_queued_bytes = max_queued_bytes;
+    flow_control->is_paused = false;
+}
+
+bool
+wf_impl_flow_control_update(
+    struct wf_impl_flow_control * flow_control,
+    size_t in_flight,
+    size_t queued_bytes)
+{
+    bool is_paused = flow_control->is_paused;
+    if (!is_paused)
+    {
+        is_paused = wf_impl_flow_control_exceeds(in_flight, flow_control->max_in_flight)
+            || wf_impl_flow_control_exceeds(queued_bytes, flow_control->max_queued_bytes);
+    }
+    else
+    {
+        is_paused = !(wf_impl_flow_control_drained(in_flight, flow_control->max_in_flight)
+            && wf_impl_flow_control_drained(queued_bytes, flow_control->max_queued_bytes));
+    }
+
+    bool const result = (is_paused != flow_control->is_paused);
+    flow_control->is_paused = is_paused;
+
+    return result;
+}
+
+bool
+wf_impl_flow_control_is_paused(
+    struct wf_impl_flow_control const * flow_control)
+{
+    return flow_control->is_paused;
+}
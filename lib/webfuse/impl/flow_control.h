@@ -0,0 +1,61 @@
+#ifndef WF_ADAPTER_IMPL_FLOW_CONTROL_H
+#define WF_ADAPTER_IMPL_FLOW_CONTROL_H
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <stdbool.h>
+#else
+#include <cstddef>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//------------------------------------------------------------------------------
+/// \brief Decides when to stop and resume receiving requests from the kernel.
+///
+/// Receiving is paused, once the number of requests in flight or the number
+/// of bytes queued for sending reaches its limit. It is resumed, when both
+/// drained to half of their limits, so that the state does not toggle with
+/// each completed request.
+///
+/// A limit of 0 disables the respective check.
+//------------------------------------------------------------------------------
+struct wf_impl_flow_control
+{
+    size_t max_in_flight;
+    size_t max_queued_bytes;
+    bool is_paused;
+};
+
+extern void
+wf_impl_flow_control_init(
+    struct wf_impl_flow_control * flow_control,
+    size_t max_in_flight,
+    size_t max_queued_bytes);
+
+//------------------------------------------------------------------------------
+/// \brief Updates the state according to the current load.
+///
+/// \param flow_control pointer to the flow control
+/// \param in_flight number of requests waiting for a response
+/// \param queued_bytes number of bytes waiting to be sent
+/// \return true, if the state changed, false otherwise
+//------------------------------------------------------------------------------
+extern bool
+wf_impl_flow_control_update(
+    struct wf_impl_flow_control * flow_control,
+    size_t in_flight,
+    size_t queued_bytes);
+
+extern bool
+wf_impl_flow_control_is_paused(
+    struct wf_impl_flow_control const * flow_control);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
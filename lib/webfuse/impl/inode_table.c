@@ -0,0 +1,267 @@
+#include "webfuse/impl/inode_table.h"
+
+#include <stdlib.h>
+
+#define WF_INODE_TABLE_INITIAL_CAPACITY 64
+#define WF_INODE_TABLE_NIL ((size_t) -1)
+#define WF_INODE_TABLE_ROOT_ID 1
+
+struct wf_impl_inode_table_entry
+{
+    uint64_t id;
+    uint64_t generation;
+    uint64_t nlookup;
+    // next entry in bucket chain (in use) or free list (released)
+    size_t next;
+    bool in_use;
+};
+
+struct wf_impl_inode_table
+{
+    struct wf_impl_inode_table_entry * entries;
+    size_t size;
+    size_t capacity;
+    size_t free_list;
+    size_t * buckets;
+    size_t bucket_count;
+    size_t count;
+};
+
+static size_t
+wf_impl_inode_table_bucket(
+    struct wf_impl_inode_table const * table,
+    uint64_t id)
+{
+    uint64_t hash = id * 0x9E3779B97F4A7C15ULL;
+    hash ^= (hash >> 32);
+
+    return (size_t) (hash & (table->bucket_count - 1));
+}
+
+static void
+wf_impl_inode_table_rehash(
+    struct wf_impl_inode_table * table,
+    size_t bucket_count)
+{
+    free(table->buckets);
+    table->bucket_count = bucket_count;
+    table->buckets = malloc(sizeof(size_t) * bucket_count);
+    for(size_t i = 0; i < bucket_count; i++)
+    {
+        table->buckets[i] = WF_INODE_TABLE_NIL;
+    }
+
+    for(size_t i = 0; i < table->size; i++)
+    {
+        struct wf_impl_inode_table_entry * entry = &table->entries[i];
+        if (entry->in_use)
+        {
+            size_t const bucket = wf_impl_inode_table_bucket(table, entry->id);
+            entry->next = table->buckets[bucket];
+            table->buckets[bucket] = i;
+        }
+    }
+}
+
+static size_t
+wf_impl_inode_table_lookup(
+    struct wf_impl_inode_table const * table,
+    uint64_t id)
+{
+    size_t index = table->buckets[wf_impl_inode_table_bucket(table, id)];
+    while ((WF_INODE_TABLE_NIL != index) && (table->entries[index].id != id))
+    {
+        index = table->entries[index].next;
+    }
+
+    return index;
+}
+
+static size_t
+wf_impl_inode_table_add(
+    struct wf_impl_inode_table * table,
+    uint64_t id)
+{
+    size_t index = table->free_list;
+    if (WF_INODE_TABLE_NIL != index)
+    {
+        // reused inodes are distinguished by their generation
+        table->free_list = table->entries[index].next;
+        table->entries[index].generation++;
+    }
+    else
+    {
+        if (table->size >= table->capacity)
+        {
+            table->capacity *= 2;
+            table->entries = realloc(table->entries, sizeof(struct wf_impl_inode_table_entry) * table->capacity);
+        }
+
+        index = table->size;
+        table->size++;
+        table->entries[index].generation = 0;
+    }
+
+    struct wf_impl_inode_table_entry * entry = &table->entries[index];
+    entry->id = id;
+    entry->nlookup = 0;
+    entry->in_use = true;
+
+    size_t const bucket = wf_impl_inode_table_bucket(table, id);
+    entry->next = table->buckets[bucket];
+    table->buckets[bucket] = index;
+    table->count++;
+
+    if (table->count > table->bucket_count)
+    {
+        wf_impl_inode_table_rehash(table, table->bucket_count * 2);
+    }
+
+    return index;
+}
+
+static void
+wf_impl_inode_table_remove(
+    struct wf_impl_inode_table * table,
+    size_t index)
+{
+    struct wf_impl_inode_table_entry * entry = &table->entries[index];
+    size_t * link = &table->buckets[wf_impl_inode_table_bucket(table, entry->id)];
+    while (index != *link)
+    {
+        link = &table->entries[*link].next;
+    }
+    *link = entry->next;
+
+    entry->in_use = false;
+    entry->next = table->free_list;
+    table->free_list = index;
+    table->count--;
+}
+
+struct wf_impl_inode_table *
+wf_impl_inode_table_create(void)
+{
+    struct wf_impl_inode_table * table = malloc(sizeof(struct wf_impl_inode_table));
+    table->capacity = WF_INODE_TABLE_INITIAL_CAPACITY;
+    table->entries = malloc(sizeof(struct wf_impl_inode_table_entry) * table->capacity);
+    table->size = 0;
+    table->free_list = WF_INODE_TABLE_NIL;
+    table->count = 0;
+    table->buckets = NULL;
+    wf_impl_inode_table_rehash(table, WF_INODE_TABLE_INITIAL_CAPACITY);
+
+    // root is added first, so it is mapped to FUSE_ROOT_ID
+    size_t const root = wf_impl_inode_table_add(table, WF_INODE_TABLE_ROOT_ID);
+    table->entries[root].nlookup = 1;
+
+    return table;
+}
+
+void
+wf_impl_inode_table_dispose(
+    struct wf_impl_inode_table * table)
+{
+    if (NULL != table)
+    {
+        free(table->buckets);
+        free(table->entries);
+        free(table);
+    }
+}
+
+fuse_ino_t
+wf_impl_inode_table_ref(
+    struct wf_impl_inode_table * table,
+    uint64_t id,
+    uint64_t * generation)
+{
+    if (NULL == table)
+    {
+        if (NULL != generation) { *generation = 0; }
+        return (fuse_ino_t) id;
+    }
+
+    size_t index = wf_impl_inode_table_lookup(table, id);
+    if (WF_INODE_TABLE_NIL == index)
+    {
+        index = wf_impl_inode_table_add(table, id);
+    }
+
+    struct wf_impl_inode_table_entry * entry = &table->entries[index];
+    if (0 != index)
+    {
+        entry->nlookup++;
+    }
+
+    if (NULL != generation) { *generation = entry->generation; }
+    return (fuse_ino_t) (index + 1);
+}
+
+fuse_ino_t
+wf_impl_inode_table_find(
+    struct wf_impl_inode_table * table,
+    uint64_t id)
+{
+    if (NULL == table)
+    {
+        return (fuse_ino_t) id;
+    }
+
+    size_t const index = wf_impl_inode_table_lookup(table, id);
+    return (WF_INODE_TABLE_NIL != index) ? ((fuse_ino_t) (index + 1)) : 0;
+}
+
+bool
+wf_impl_inode_table_get_id(
+    struct wf_impl_inode_table * table,
+    fuse_ino_t inode,
+    uint64_t * id)
+{
+    if (NULL == table)
+    {
+        *id = (uint64_t) inode;
+        return true;
+    }
+
+    bool const result = (0 < inode) && (inode <= table->size) && (table->entries[inode - 1].in_use);
+    if (result)
+    {
+        *id = table->entries[inode - 1].id;
+    }
+
+    return result;
+}
+
+bool
+wf_impl_inode_table_forget(
+    struct wf_impl_inode_table * table,
+    fuse_ino_t inode,
+    uint64_t nlookup,
+    uint64_t * id)
+{
+    // root is never released
+    if ((NULL == table) || (inode <= 1) || (inode > table->size) || (!table->entries[inode - 1].in_use))
+    {
+        return false;
+    }
+
+    size_t const index = inode - 1;
+    struct wf_impl_inode_table_entry * entry = &table->entries[index];
+    entry->nlookup -= (nlookup < entry->nlookup) ? nlookup : entry->nlookup;
+    if (0 < entry->nlookup)
+    {
+        return false;
+    }
+
+    if (NULL != id) { *id = entry->id; }
+    wf_impl_inode_table_remove(table, index);
+    return true;
+}
+
+size_t
+wf_impl_inode_table_count(
+    struct wf_impl_inode_table * table)
+{
+    return (NULL != table) ? table->count : 0;
+}
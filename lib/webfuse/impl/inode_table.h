@@ -0,0 +1,109 @@
+#ifndef WF_ADAPTER_IMPL_INODE_TABLE_H
+#define WF_ADAPTER_IMPL_INODE_TABLE_H
+
+#include "webfuse/impl/fuse_wrapper.h"
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#else
+#include <cstddef>
+#include <cstdint>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//------------------------------------------------------------------------------
+/// \brief Maps 64-bit provider ids to kernel inodes.
+///
+/// Each provider id known to the kernel is assigned a kernel inode along
+/// with a lookup count, which is incremented for each entry replied to
+/// the kernel (lookup, readdirplus) and decremented by forget. Once the
+/// lookup count drops to zero, the kernel inode is released and may be
+/// reused with an incremented generation number.
+///
+/// The root directory (provider id 1) is always mapped to FUSE_ROOT_ID
+/// and never released.
+///
+/// All functions accept a NULL table, which maps provider ids and
+/// kernel inodes 1:1 without tracking lookup counts.
+//------------------------------------------------------------------------------
+struct wf_impl_inode_table;
+
+extern struct wf_impl_inode_table *
+wf_impl_inode_table_create(void);
+
+extern void
+wf_impl_inode_table_dispose(
+    struct wf_impl_inode_table * table);
+
+//------------------------------------------------------------------------------
+/// \brief Returns the kernel inode of a provider id and increments its
+///        lookup count.
+///
+/// The provider id is mapped to a new kernel inode, if it is not known yet.
+///
+/// \param table pointer to the table (may be NULL)
+/// \param id provider id
+/// \param generation receives the generation of the kernel inode (may be NULL)
+/// \return kernel inode
+//------------------------------------------------------------------------------
+extern fuse_ino_t
+wf_impl_inode_table_ref(
+    struct wf_impl_inode_table * table,
+    uint64_t id,
+    uint64_t * generation);
+
+//------------------------------------------------------------------------------
+/// \brief Returns the kernel inode of a provider id without referencing it.
+///
+/// \return kernel inode or 0, if the provider id is not known to the kernel
+//------------------------------------------------------------------------------
+extern fuse_ino_t
+wf_impl_inode_table_find(
+    struct wf_impl_inode_table * table,
+    uint64_t id);
+
+//------------------------------------------------------------------------------
+/// \brief Returns the provider id of a kernel inode.
+///
+/// \return true, if the kernel inode is known, false otherwise
+//------------------------------------------------------------------------------
+extern bool
+wf_impl_inode_table_get_id(
+    struct wf_impl_inode_table * table,
+    fuse_ino_t inode,
+    uint64_t * id);
+
+//------------------------------------------------------------------------------
+/// \brief Decrements the lookup count of a kernel inode.
+///
+/// \param table pointer to the table (may be NULL)
+/// \param inode kernel inode
+/// \param nlookup number of lookups to forget
+/// \param id receives the provider id of a released inode (may be NULL)
+/// \return true, if the kernel inode was released, false otherwise
+//------------------------------------------------------------------------------
+extern bool
+wf_impl_inode_table_forget(
+    struct wf_impl_inode_table * table,
+    fuse_ino_t inode,
+    uint64_t nlookup,
+    uint64_t * id);
+
+//------------------------------------------------------------------------------
+/// \brief Returns the number of mapped kernel inodes (including root).
+//------------------------------------------------------------------------------
+extern size_t
+wf_impl_inode_table_count(
+    struct wf_impl_inode_table * table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,106 @@
+#include "webfuse/impl/invalidation.h"
+#include "webfuse/impl/filesystem.h"
+#include "webfuse/impl/jsonrpc/request.h"
+#include "webfuse/impl/json/node.h"
+#include "webfuse/impl/status.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+static struct wf_impl_filesystem *
+wf_impl_invalidation_get_filesystem(
+    struct wf_json const * params,
+    wf_impl_invalidation_get_filesystem_fn * get_filesystem,
+    void * user_data)
+{
+    struct wf_json const * name_holder = wf_impl_json_array_get(params, 0);
+    if (!wf_impl_json_is_string(name_holder))
+    {
+        return NULL;
+    }
+
+    return get_filesystem(user_data, wf_impl_json_string_get(name_holder));
+}
+
+static void
+wf_impl_invalidation_respond(
+    struct wf_jsonrpc_request * request,
+    wf_status status)
+{
+    if (WF_GOOD == status)
+    {
+        wf_impl_jsonrpc_respond(request);
+    }
+    else
+    {
+        wf_impl_jsonrpc_respond_error(request, status, wf_impl_status_tostring(status));
+    }
+}
+
+void
+wf_impl_invalidation_process_inode(
+    struct wf_jsonrpc_request * request,
+    struct wf_json const * params,
+    wf_impl_invalidation_get_filesystem_fn * get_filesystem,
+    void * user_data)
+{
+    wf_status status = WF_BAD_FORMAT;
+
+    struct wf_json const * inode_holder = wf_impl_json_array_get(params, 1);
+    struct wf_json const * offset_holder = wf_impl_json_array_get(params, 2);
+    struct wf_json const * length_holder = wf_impl_json_array_get(params, 3);
+
+    if ((wf_impl_json_is_int(inode_holder)) &&
+        (wf_impl_json_is_int(offset_holder)) &&
+        (wf_impl_json_is_int(length_holder)))
+    {
+        struct wf_impl_filesystem * filesystem = wf_impl_invalidation_get_filesystem(params, get_filesystem, user_data);
+        if (NULL != filesystem)
+        {
+            uint64_t const inode = (uint64_t) wf_impl_json_int64_get(inode_holder);
+            off_t const offset = (off_t) wf_impl_json_int64_get(offset_holder);
+            off_t const length = (off_t) wf_impl_json_int64_get(length_holder);
+
+            wf_impl_filesystem_invalidate_inode(filesystem, inode, offset, length);
+            status = WF_GOOD;
+        }
+        else
+        {
+            status = WF_BAD_NOENTRY;
+        }
+    }
+
+    wf_impl_invalidation_respond(request, status);
+}
+
+void
+wf_impl_invalidation_process_entry(
+    struct wf_jsonrpc_request * request,
+    struct wf_json const * params,
+    wf_impl_invalidation_get_filesystem_fn * get_filesystem,
+    void * user_data)
+{
+    wf_status status = WF_BAD_FORMAT;
+
+    struct wf_json const * parent_holder = wf_impl_json_array_get(params, 1);
+    struct wf_json const * name_holder = wf_impl_json_array_get(params, 2);
+
+    if ((wf_impl_json_is_int(parent_holder)) && (wf_impl_json_is_string(name_holder)))
+    {
+        struct wf_impl_filesystem * filesystem = wf_impl_invalidation_get_filesystem(params, get_filesystem, user_data);
+        if (NULL != filesystem)
+        {
+            uint64_t const parent = (uint64_t) wf_impl_json_int64_get(parent_holder);
+            char const * name = wf_impl_json_string_get(name_holder);
+
+            wf_impl_filesystem_invalidate_entry(filesystem, parent, name);
+            status = WF_GOOD;
+        }
+        else
+        {
+            status = WF_BAD_NOENTRY;
+        }
+    }
+
+    wf_impl_invalidation_respond(request, status);
+}
@@ -0,0 +1,56 @@
+#ifndef WF_ADAPTER_IMPL_INVALIDATION_H
+#define WF_ADAPTER_IMPL_INVALIDATION_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct wf_impl_filesystem;
+struct wf_jsonrpc_request;
+struct wf_json;
+
+typedef struct wf_impl_filesystem *
+wf_impl_invalidation_get_filesystem_fn(
+    void * user_data,
+    char const * name);
+
+//------------------------------------------------------------------------------
+/// \brief Processes an invalidate_inode request or notification.
+///
+/// params: [<filesystem>, <inode>, <offset>, <length>]
+///
+/// \param request request to respond to
+/// \param params parameters of the request
+/// \param get_filesystem function to get a filesystem by name
+/// \param user_data user data of get_filesystem
+//------------------------------------------------------------------------------
+extern void
+wf_impl_invalidation_process_inode(
+    struct wf_jsonrpc_request * request,
+    struct wf_json const * params,
+    wf_impl_invalidation_get_filesystem_fn * get_filesystem,
+    void * user_data);
+
+//------------------------------------------------------------------------------
+/// \brief Processes an invalidate_entry request or notification.
+///
+/// params: [<filesystem>, <parent>, <name>]
+///
+/// \param request request to respond to
+/// \param params parameters of the request
+/// \param get_filesystem function to get a filesystem by name
+/// \param user_data user data of get_filesystem
+//------------------------------------------------------------------------------
+extern void
+wf_impl_invalidation_process_entry(
+    struct wf_jsonrpc_request * request,
+    struct wf_json const * params,
+    wf_impl_invalidation_get_filesystem_fn * get_filesystem,
+    void * user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
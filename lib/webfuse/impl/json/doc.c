@@ -2,38 +2,90 @@
 #include "webfuse/impl/json/node_intern.h"
 #include "webfuse/impl/json/reader.h"
 #include "webfuse/impl/json/parser.h"
+#include "webfuse/impl/util/arena.h"
 
 #include <stdlib.h>
+#include <string.h>
+
+#define WF_JSON_DOC_ARENA_BLOCK_SIZE (4 * 1024)
 
 struct wf_json_doc
 {
     struct wf_json root;
+    struct wf_arena * arena;
+    struct wf_arena own_arena;
 };
 
-struct wf_json_doc *
-wf_impl_json_doc_loadb(
+static struct wf_json_doc *
+wf_impl_json_doc_parse(
+    struct wf_arena * arena,
     char * data,
     size_t length)
 {
     struct wf_json_reader reader;
     wf_impl_json_reader_init(&reader, data, length);
 
-    struct wf_json_doc * doc = malloc(sizeof(struct wf_json_doc));
-    if (!wf_impl_json_parse_value(&reader, &doc->root))
+    struct wf_json_doc * doc = wf_impl_arena_alloc(arena, sizeof(struct wf_json_doc));
+    doc->arena = arena;
+    if (!wf_impl_json_parse_value(&reader, arena, &doc->root))
     {
-        free(doc);
         doc = NULL;
     }
 
-    return doc;    
+    return doc;
+}
+
+struct wf_json_doc *
+wf_impl_json_doc_loadb(
+    char * data,
+    size_t length)
+{
+    struct wf_arena arena;
+    wf_impl_arena_init(&arena, WF_JSON_DOC_ARENA_BLOCK_SIZE);
+
+    // the document is allocated from its own arena
+    struct wf_json_doc * doc = wf_impl_json_doc_parse(&arena, data, length);
+    if (NULL != doc)
+    {
+        doc->own_arena = arena;
+        doc->arena = &doc->own_arena;
+    }
+    else
+    {
+        wf_impl_arena_cleanup(&arena);
+    }
+
+    return doc;
+}
+
+struct wf_json_doc *
+wf_impl_json_doc_loadb_arena(
+    struct wf_arena * arena,
+    char * data,
+    size_t length)
+{
+    struct wf_json_doc * doc = wf_impl_json_doc_parse(arena, data, length);
+    if (NULL == doc)
+    {
+        wf_impl_arena_reset(arena);
+    }
+
+    return doc;
 }
 
 void
 wf_impl_json_doc_dispose(
     struct wf_json_doc * doc)
 {
-    wf_impl_json_cleanup(&doc->root);
-    free(doc);
+    if (doc->arena == &doc->own_arena)
+    {
+        struct wf_arena arena = doc->own_arena;
+        wf_impl_arena_cleanup(&arena);
+    }
+    else
+    {
+        wf_impl_arena_reset(doc->arena);
+    }
 }
 
 struct wf_json const *
@@ -42,3 +94,44 @@ wf_impl_json_doc_root(
 {
     return &doc->root;
 }
+
+void
+wf_impl_json_doc_set_string(
+    struct wf_json_doc * doc,
+    struct wf_json const * object,
+    char const * key,
+    char * data,
+    size_t size)
+{
+    // nodes are owned by the document, so it is safe to modify them here
+    struct wf_json * json = (struct wf_json *) object;
+    if (WF_JSON_TYPE_OBJECT != json->type)
+    {
+        return;
+    }
+
+    struct wf_json_object * items = &json->value.o;
+    struct wf_json * member = NULL;
+    for(size_t i = 0; i < items->size; i++)
+    {
+        if (0 == strcmp(key, items->items[i].key))
+        {
+            member = &items->items[i].json;
+            break;
+        }
+    }
+
+    if (NULL == member)
+    {
+        items->items = wf_impl_arena_realloc(doc->arena, items->items,
+            items->size * sizeof(struct wf_json_object_item),
+            (items->size + 1) * sizeof(struct wf_json_object_item));
+        items->items[items->size].key = (char *) key;
+        member = &items->items[items->size].json;
+        items->size++;
+    }
+
+    member->type = WF_JSON_TYPE_STRING;
+    member->value.s.data = data;
+    member->value.s.size = size;
+}
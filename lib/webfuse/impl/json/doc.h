@@ -14,12 +14,26 @@ extern "C"
 
 struct wf_json_doc;
 struct wf_json;
+struct wf_arena;
 
 extern struct wf_json_doc *
 wf_impl_json_doc_loadb(
     char * data,
     size_t length);
 
+//------------------------------------------------------------------------------
+/// \brief Loads a document using an external arena.
+///
+/// The arena is reset when the document is disposed, so at most one
+/// document can be loaded into an arena at a time. Reusing the arena
+/// avoids allocations for subsequent documents.
+//------------------------------------------------------------------------------
+extern struct wf_json_doc *
+wf_impl_json_doc_loadb_arena(
+    struct wf_arena * arena,
+    char * data,
+    size_t length);
+
 extern void
 wf_impl_json_doc_dispose(
     struct wf_json_doc * doc);
@@ -28,6 +42,26 @@ extern struct wf_json const *
 wf_impl_json_doc_root(
     struct wf_json_doc * doc);
 
+//------------------------------------------------------------------------------
+/// \brief Sets a string member of an object of the document.
+///
+/// An existing member is replaced, otherwise the member is added.
+/// Neither key nor data are copied; both must outlive the document.
+///
+/// \param doc pointer to the document
+/// \param object object node of the document
+/// \param key name of the member
+/// \param data contents of the string (need not be null-terminated)
+/// \param size size of data in bytes
+//------------------------------------------------------------------------------
+extern void
+wf_impl_json_doc_set_string(
+    struct wf_json_doc * doc,
+    struct wf_json const * object,
+    char const * key,
+    char * data,
+    size_t size);
+
 
 #ifdef __cplusplus
 }
@@ -2,6 +2,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 static struct wf_json const wf_json_undefined =
 {
@@ -75,6 +76,23 @@ wf_impl_json_is_object(
 int
 wf_impl_json_int_get(
     struct wf_json const * json)
+{
+    int64_t const value = wf_impl_json_int64_get(json);
+    if (INT_MAX < value)
+    {
+        return INT_MAX;
+    }
+    else if (value < INT_MIN)
+    {
+        return INT_MIN;
+    }
+
+    return (int) value;
+}
+
+int64_t
+wf_impl_json_int64_get(
+    struct wf_json const * json)
 {
     return (WF_JSON_TYPE_INT == json->type) ? json->value.i : 0;
 }
@@ -171,36 +189,3 @@ wf_impl_json_object_value(
     return result;
 
 }
-
-void
-wf_impl_json_cleanup(
-    struct wf_json * json)
-{
-    switch (json->type)
-    {
-        case WF_JSON_TYPE_ARRAY:
-            {
-                size_t const count = json->value.a.size;
-                for(size_t i = 0; i < count; i++)
-                {
-                    struct wf_json * actual = &(json->value.a.items[i]);
-                    wf_impl_json_cleanup(actual);
-                }
-                free(json->value.a.items);
-            }
-            break;
-        case WF_JSON_TYPE_OBJECT:
-            {
-                size_t const count = json->value.o.size;
-                for(size_t i = 0; i < count; i++)
-                {
-                    struct wf_json * actual = &(json->value.o.items[i].json);
-                    wf_impl_json_cleanup(actual);
-                }
-                free(json->value.o.items);
-            }
-            break;
-        default:
-            break;
-    }
-}
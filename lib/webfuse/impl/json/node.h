@@ -4,8 +4,10 @@
 #ifndef __cplusplus
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #else
 #include <cstddef>
+#include <cstdint>
 #endif
 
 #ifdef __cplusplus
@@ -62,10 +64,20 @@ extern bool
 wf_impl_json_bool_get(
     struct wf_json const * json);
 
+//------------------------------------------------------------------------------
+/// \brief Returns the value of an integer node as int.
+///
+/// Values outside the range of int are clamped to INT_MIN / INT_MAX;
+/// use wf_impl_json_int64_get for offsets, sizes and times.
+//------------------------------------------------------------------------------
 extern int
 wf_impl_json_int_get(
     struct wf_json const * json);
 
+extern int64_t
+wf_impl_json_int64_get(
+    struct wf_json const * json);
+
 extern char const *
 wf_impl_json_string_get(
     struct wf_json const * json);
@@ -3,6 +3,12 @@
 
 #include "webfuse/impl/json/node.h"
 
+#ifndef __cplusplus
+#include <stdint.h>
+#else
+#include <cstdint>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -31,7 +37,7 @@ struct wf_json_object
 union wf_json_value
 {
     bool b;
-    int i;
+    int64_t i;
     struct wf_json_string s;
     struct wf_json_array a;
     struct wf_json_object o;
@@ -49,10 +55,6 @@ struct wf_json_object_item
     char * key;
 };
 
-extern void
-wf_impl_json_cleanup(
-    struct wf_json * json);
-
 #ifdef __cplusplus
 }
 #endif
@@ -1,8 +1,7 @@
 #include "webfuse/impl/json/parser.h"
 #include "webfuse/impl/json/reader.h"
 #include "webfuse/impl/json/node_intern.h"
-
-#include <stdlib.h>
+#include "webfuse/impl/util/arena.h"
 
 #define WF_JSON_PARSER_INITIAL_CAPACITY 4
 
@@ -34,11 +33,13 @@ wf_impl_json_parse_string(
 static bool
 wf_impl_json_parse_array(
     struct wf_json_reader * reader,
+    struct wf_arena * arena,
     struct wf_json * json);
 
 static bool
 wf_impl_json_parse_object(
     struct wf_json_reader * reader,
+    struct wf_arena * arena,
     struct wf_json * json);
 
 // --
@@ -46,6 +47,7 @@ wf_impl_json_parse_object(
 bool
 wf_impl_json_parse_value(
     struct wf_json_reader * reader,
+    struct wf_arena * arena,
     struct wf_json * json)
 {
     bool result = false;
@@ -66,10 +68,10 @@ wf_impl_json_parse_value(
             result = wf_impl_json_parse_string(reader, json);
             break;
         case '[':
-            result = wf_impl_json_parse_array(reader, json);
+            result = wf_impl_json_parse_array(reader, arena, json);
             break;
         case '{':
-            result = wf_impl_json_parse_object(reader, json);
+            result = wf_impl_json_parse_object(reader, arena, json);
             break;
         case '-': // fall-through
         case '0': // fall-through
@@ -144,8 +146,8 @@ wf_impl_json_parse_int(
     struct wf_json_reader * reader,
     struct wf_json * json)
 {
-    int value;
-    bool const result = wf_impl_json_reader_read_int(reader, &value);
+    int64_t value;
+    bool const result = wf_impl_json_reader_read_int64(reader, &value);
     if (result)
     {
         json->type = WF_JSON_TYPE_INT;
@@ -176,6 +178,7 @@ wf_impl_json_parse_string(
 static bool
 wf_impl_json_parse_array(
     struct wf_json_reader * reader,
+    struct wf_arena * arena,
     struct wf_json * json)
 {
     wf_impl_json_reader_skip_whitespace(reader);
@@ -184,7 +187,7 @@ wf_impl_json_parse_array(
 
     size_t capacity = WF_JSON_PARSER_INITIAL_CAPACITY;
     json->type = WF_JSON_TYPE_ARRAY;
-    json->value.a.items = malloc(sizeof(struct wf_json) * capacity);
+    json->value.a.items = wf_impl_arena_alloc(arena, sizeof(struct wf_json) * capacity);
     json->value.a.size = 0;
 
     c = wf_impl_json_reader_skip_whitespace(reader);
@@ -199,11 +202,12 @@ wf_impl_json_parse_array(
     {
         if (json->value.a.size >= capacity)
         {
+            json->value.a.items = wf_impl_arena_realloc(arena, json->value.a.items,
+                sizeof(struct wf_json) * capacity, sizeof(struct wf_json) * capacity * 2);
             capacity *= 2;
-            json->value.a.items = realloc(json->value.a.items, sizeof(struct wf_json) * capacity);
         }
 
-        result = wf_impl_json_parse_value(reader, &(json->value.a.items[json->value.a.size]));
+        result = wf_impl_json_parse_value(reader, arena, &(json->value.a.items[json->value.a.size]));
         if (result)
         {
             json->value.a.size++;
@@ -217,17 +221,13 @@ wf_impl_json_parse_array(
         result = false;
     }
 
-    if (!result)
-    {
-        wf_impl_json_cleanup(json);
-    }
-
     return result;
 }
 
 static bool
 wf_impl_json_parse_object(
     struct wf_json_reader * reader,
+    struct wf_arena * arena,
     struct wf_json * json)
 {
     wf_impl_json_reader_skip_whitespace(reader);
@@ -236,7 +236,7 @@ wf_impl_json_parse_object(
 
     size_t capacity = WF_JSON_PARSER_INITIAL_CAPACITY;
     json->type = WF_JSON_TYPE_OBJECT;
-    json->value.o.items = malloc(sizeof(struct wf_json_object_item) * capacity);
+    json->value.o.items = wf_impl_arena_alloc(arena, sizeof(struct wf_json_object_item) * capacity);
     json->value.o.size = 0;
 
     c = wf_impl_json_reader_skip_whitespace(reader);
@@ -251,8 +251,9 @@ wf_impl_json_parse_object(
     {
         if (json->value.o.size >= capacity)
         {
+            json->value.o.items = wf_impl_arena_realloc(arena, json->value.o.items,
+                sizeof(struct wf_json_object_item) * capacity, sizeof(struct wf_json_object_item) * capacity * 2);
             capacity *= 2;
-            json->value.o.items = realloc(json->value.o.items, sizeof(struct wf_json_object_item) * capacity);
         }
 
         struct wf_json_object_item * item = &(json->value.o.items[json->value.o.size]);
@@ -266,7 +267,7 @@ wf_impl_json_parse_object(
 
         if (result)
         {
-            result = wf_impl_json_parse_value(reader, &(item->json));
+            result = wf_impl_json_parse_value(reader, arena, &(item->json));
         }
 
         if (result)
@@ -282,10 +283,5 @@ wf_impl_json_parse_object(
         result = false;
     }
 
-    if (!result)
-    {
-        wf_impl_json_cleanup(json);
-    }
-
     return result;
 }
\ No newline at end of file
@@ -12,10 +12,18 @@ extern "C"
 
 struct wf_json_reader;
 struct wf_json;
+struct wf_arena;
 
+//------------------------------------------------------------------------------
+/// \brief Parses a JSON value.
+///
+/// Arrays and objects are allocated from the arena; they are released
+/// along with the arena.
+//------------------------------------------------------------------------------
 extern bool
 wf_impl_json_parse_value(
     struct wf_json_reader * reader,
+    struct wf_arena * arena,
     struct wf_json * json);
 
 #ifdef __cplusplus
@@ -1,6 +1,7 @@
 #include "webfuse/impl/json/reader.h"
 
 #include <string.h>
+#include <limits.h>
 
 static char
 wf_impl_json_unescape(
@@ -87,6 +88,22 @@ bool
 wf_impl_json_reader_read_int(
     struct wf_json_reader * reader,
     int * value)
+{
+    int64_t v;
+    bool const result = wf_impl_json_reader_read_int64(reader, &v)
+        && (INT_MIN <= v) && (v <= INT_MAX);
+    if (result)
+    {
+        *value = (int) v;
+    }
+
+    return result;
+}
+
+bool
+wf_impl_json_reader_read_int64(
+    struct wf_json_reader * reader,
+    int64_t * value)
 {
     char c = wf_impl_json_reader_get_char(reader);
     bool const is_signed = ('-' == c);
@@ -95,20 +112,33 @@ wf_impl_json_reader_read_int(
         c = wf_impl_json_reader_get_char(reader);
     }
 
-    bool const result = (('0' <= c) && (c <= '9'));
+    // magnitude is accumulated unsigned, since |INT64_MIN| > INT64_MAX
+    uint64_t const limit = (is_signed) ? ((uint64_t) INT64_MAX) + 1 : (uint64_t) INT64_MAX;
+    bool result = (('0' <= c) && (c <= '9'));
     if (result)
     {
-        int v = c - '0';
+        uint64_t v = (uint64_t) (c - '0');
         c = wf_impl_json_reader_peek(reader);
         while (('0' <= c) && (c <= '9'))
         {
-            v *= 10;
-            v += c - '0';
+            uint64_t const digit = (uint64_t) (c - '0');
+            if (v > ((limit - digit) / 10))
+            {
+                result = false;
+            }
+            else
+            {
+                v *= 10;
+                v += digit;
+            }
             reader->pos++;
             c = wf_impl_json_reader_peek(reader);
         }
 
-        *value = (is_signed) ? -v : v;
+        if (result)
+        {
+            *value = (is_signed) ? (int64_t) (0 - v) : (int64_t) v;
+        }
     }
 
     return result;
@@ -4,8 +4,10 @@
 #ifndef __cplusplus
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #else
 #include <cstddef>
+#include <cstdint>
 #endif
 
 #ifdef __cplusplus
@@ -53,6 +55,17 @@ wf_impl_json_reader_read_int(
     struct wf_json_reader * reader,
     int * value);
 
+//------------------------------------------------------------------------------
+/// \brief Reads a signed 64-bit integer.
+///
+/// \return true on success, false if there is no integer or the
+///         integer does not fit into int64_t
+//------------------------------------------------------------------------------
+extern bool
+wf_impl_json_reader_read_int64(
+    struct wf_json_reader * reader,
+    int64_t * value);
+
 extern bool
 wf_impl_json_reader_read_string(
     struct wf_json_reader * reader,
@@ -135,6 +135,26 @@ wf_impl_json_writer_take(
     return writer->data;
 }
 
+void
+wf_impl_json_writer_attach(
+    struct wf_json_writer * writer,
+    char * data,
+    size_t capacity)
+{
+    free(writer->raw_data);
+    writer->raw_data = data - writer->pre;
+    writer->data = data;
+    writer->capacity = capacity;
+    wf_impl_json_writer_reset(writer);
+}
+
+size_t
+wf_impl_json_writer_get_capacity(
+    struct wf_json_writer * writer)
+{
+    return writer->capacity;
+}
+
 void
 wf_impl_json_write_null(
     struct wf_json_writer * writer)
@@ -169,32 +189,31 @@ void
 wf_impl_json_write_int(
     struct wf_json_writer * writer,
     int value)
+{
+    wf_impl_json_write_int64(writer, value);
+}
+
+void
+wf_impl_json_write_int64(
+    struct wf_json_writer * writer,
+    int64_t value)
 {
     wf_impl_json_reserve(writer, WF_JSON_WRITER_INT_SIZE);
     wf_impl_json_begin_value(writer);
 
     bool const is_signed = (0 > value);
+    // magnitude is computed unsigned, since |INT64_MIN| > INT64_MAX
+    uint64_t magnitude = (is_signed) ? (0 - (uint64_t) value) : (uint64_t) value;
     char buffer[WF_JSON_WRITER_INT_SIZE];
     size_t offset = WF_JSON_WRITER_INT_SIZE;
     buffer[--offset] = '\0';
-    if (is_signed)
-    {
-        if (INT_MIN == value)
-        {
-            char const actual = (char) abs(value % 10);
-            buffer[--offset] = (char) ('0' + actual);
-            value /= 10;
-        }
-
-        value =- value;
-    }
 
     do 
     {
-        char const actual = (char) (value % 10);
+        char const actual = (char) (magnitude % 10);
         buffer[--offset] = (char) ('0' + actual);
-        value /= 10;
-    } while (0 != value);
+        magnitude /= 10;
+    } while (0 != magnitude);
 
     if (is_signed)
     {
@@ -366,6 +385,16 @@ wf_impl_json_write_object_int(
     wf_impl_json_write_int(writer, value);
 }
 
+void
+wf_impl_json_write_object_int64(
+    struct wf_json_writer * writer,
+    char const * key,
+    int64_t value)
+{
+    wf_impl_json_write_object_key(writer, key);
+    wf_impl_json_write_int64(writer, value);
+}
+
 void
 wf_impl_json_write_object_string(
     struct wf_json_writer * writer,
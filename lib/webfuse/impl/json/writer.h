@@ -4,8 +4,10 @@
 #ifndef __cplusplus
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #else
 #include <cstddef>
+#include <cstdint>
 #endif
 
 #ifdef __cplusplus
@@ -33,6 +35,30 @@ wf_impl_json_writer_take(
     struct wf_json_writer * writer,
     size_t * size);
 
+//------------------------------------------------------------------------------
+/// \brief Resets the writer to write into the given buffer.
+///
+/// The writer takes ownership of the buffer and reallocates it, if it is too
+/// small. The buffer must provide pre bytes in front of data (see
+/// wf_impl_json_writer_create). A buffer not yet taken is released.
+///
+/// \param writer pointer to the writer
+/// \param data pointer to the buffer, pre bytes after its start
+/// \param capacity size of the buffer without pre bytes (must not be 0)
+//------------------------------------------------------------------------------
+extern void
+wf_impl_json_writer_attach(
+    struct wf_json_writer * writer,
+    char * data,
+    size_t capacity);
+
+//------------------------------------------------------------------------------
+/// \brief Returns the size of the current buffer without pre bytes.
+//------------------------------------------------------------------------------
+extern size_t
+wf_impl_json_writer_get_capacity(
+    struct wf_json_writer * writer);
+
 extern void
 wf_impl_json_write_null(
     struct wf_json_writer * writer);
@@ -47,6 +73,11 @@ wf_impl_json_write_int(
     struct wf_json_writer * writer,
     int value);
 
+extern void
+wf_impl_json_write_int64(
+    struct wf_json_writer * writer,
+    int64_t value);
+
 extern void
 wf_impl_json_write_string(
     struct wf_json_writer * writer,
@@ -101,6 +132,12 @@ wf_impl_json_write_object_int(
     char const * key,
     int value);
 
+extern void
+wf_impl_json_write_object_int64(
+    struct wf_json_writer * writer,
+    char const * key,
+    int64_t value);
+
 extern void
 wf_impl_json_write_object_string(
     struct wf_json_writer * writer,
@@ -0,0 +1,109 @@
+#include "webfuse/impl/jsonrpc/attachment.h"
+#include "webfuse/impl/jsonrpc/response.h"
+#include "webfuse/impl/json/doc.h"
+#include "webfuse/impl/json/node.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define WF_ATTACHMENT_DEFAULT_SIZE (64 * 1024)
+#define WF_ATTACHMENT_HEADER_SIZE 4
+
+void
+wf_impl_jsonrpc_attachment_init(
+    struct wf_jsonrpc_attachment * attachment)
+{
+    wf_impl_buffer_init(&attachment->buffer, WF_ATTACHMENT_DEFAULT_SIZE);
+    attachment->is_complete = false;
+}
+
+void
+wf_impl_jsonrpc_attachment_cleanup(
+    struct wf_jsonrpc_attachment * attachment)
+{
+    wf_impl_buffer_cleanup(&attachment->buffer);
+}
+
+void
+wf_impl_jsonrpc_attachment_receive(
+    struct wf_jsonrpc_attachment * attachment,
+    char const * data,
+    size_t length,
+    bool is_first_fragment,
+    bool is_final_fragment)
+{
+    if (is_first_fragment)
+    {
+        wf_impl_buffer_clear(&attachment->buffer);
+    }
+
+    wf_impl_buffer_append(&attachment->buffer, data, length);
+    attachment->is_complete = is_final_fragment;
+}
+
+static bool
+wf_impl_jsonrpc_attachment_apply_to(
+    struct wf_jsonrpc_attachment * attachment,
+    struct wf_json_doc * doc,
+    struct wf_json const * message,
+    uint32_t id,
+    size_t size)
+{
+    if (!wf_impl_jsonrpc_is_response(message))
+    {
+        return false;
+    }
+
+    struct wf_json const * id_holder = wf_impl_json_object_get(message, "id");
+    struct wf_json const * result = wf_impl_json_object_get(message, "result");
+    struct wf_json const * format = wf_impl_json_object_get(result, "format");
+
+    bool const is_match = ((id == (uint32_t) wf_impl_json_int_get(id_holder)) &&
+        (wf_impl_json_is_string(format)) &&
+        (0 == strcmp("binary", wf_impl_json_string_get(format))));
+    if (is_match)
+    {
+        wf_impl_json_doc_set_string(doc, result, "data",
+            &(wf_impl_buffer_data(&attachment->buffer)[WF_ATTACHMENT_HEADER_SIZE]),
+            size - WF_ATTACHMENT_HEADER_SIZE);
+    }
+
+    return is_match;
+}
+
+void
+wf_impl_jsonrpc_attachment_apply(
+    struct wf_jsonrpc_attachment * attachment,
+    struct wf_json_doc * doc)
+{
+    if (!attachment->is_complete)
+    {
+        return;
+    }
+
+    // an attachment belongs to the immediately following message only
+    attachment->is_complete = false;
+
+    size_t const size = wf_impl_buffer_size(&attachment->buffer);
+    if (WF_ATTACHMENT_HEADER_SIZE > size)
+    {
+        return;
+    }
+
+    uint8_t const * header = (uint8_t const *) wf_impl_buffer_data(&attachment->buffer);
+    uint32_t const id = ((uint32_t) header[0] << 24) | ((uint32_t) header[1] << 16)
+        | ((uint32_t) header[2] << 8) | ((uint32_t) header[3]);
+
+    // the following message might be a batch, which contains the response
+    struct wf_json const * root = wf_impl_json_doc_root(doc);
+    bool const is_batch = wf_impl_json_is_array(root);
+    size_t const count = (is_batch) ? wf_impl_json_array_size(root) : 1;
+    for(size_t i = 0; i < count; i++)
+    {
+        struct wf_json const * message = (is_batch) ? wf_impl_json_array_get(root, i) : root;
+        if (wf_impl_jsonrpc_attachment_apply_to(attachment, doc, message, id, size))
+        {
+            break;
+        }
+    }
+}
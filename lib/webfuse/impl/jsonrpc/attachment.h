@@ -0,0 +1,70 @@
+#ifndef WF_IMPL_JSONRPC_ATTACHMENT_H
+#define WF_IMPL_JSONRPC_ATTACHMENT_H
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#include <stddef.h>
+#else
+#include <cstddef>
+#endif
+
+#include "webfuse/impl/util/buffer.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct wf_json_doc;
+
+//------------------------------------------------------------------------------
+/// \brief Binary payload of a response.
+///
+/// In binary mode, a provider sends the payload of a response as a binary
+/// WebSocket frame right before the (JSON) response itself. The frame starts
+/// with the id of the response (32 bit, big endian), followed by the payload.
+///
+/// The payload is injected as "data" member into the result of the
+/// following response, if the response has the same id and its "format"
+/// is "binary". If the following message is a batch, the attachment is
+/// injected into the matching response of the batch. Afterwards, the
+/// attachment is discarded.
+//------------------------------------------------------------------------------
+struct wf_jsonrpc_attachment
+{
+    struct wf_buffer buffer;
+    bool is_complete;
+};
+
+extern void
+wf_impl_jsonrpc_attachment_init(
+    struct wf_jsonrpc_attachment * attachment);
+
+extern void
+wf_impl_jsonrpc_attachment_cleanup(
+    struct wf_jsonrpc_attachment * attachment);
+
+extern void
+wf_impl_jsonrpc_attachment_receive(
+    struct wf_jsonrpc_attachment * attachment,
+    char const * data,
+    size_t length,
+    bool is_first_fragment,
+    bool is_final_fragment);
+
+//------------------------------------------------------------------------------
+/// \brief Applies a received attachment to the following message.
+///
+/// The attachment must outlive the document, since the payload
+/// is not copied.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_jsonrpc_attachment_apply(
+    struct wf_jsonrpc_attachment * attachment,
+    struct wf_json_doc * doc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,178 @@
+#include "webfuse/impl/jsonrpc/latency.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// histogram is halved, when it holds this number of samples
+#define WF_JSONRPC_LATENCY_WINDOW 1024
+
+// timeouts in a row are backed off up to 2^6
+#define WF_JSONRPC_LATENCY_MAX_BACKOFF 6
+
+struct wf_jsonrpc_latency *
+wf_impl_jsonrpc_latency_create(
+    char const * method,
+    size_t max_size)
+{
+    struct wf_jsonrpc_latency * latency = malloc(sizeof(struct wf_jsonrpc_latency));
+    latency->next = NULL;
+    latency->method = strdup(method);
+    latency->max_size = max_size;
+    latency->samples = 0;
+    latency->timeouts = 0;
+    latency->average = 0;
+    latency->deviation = 0;
+    latency->max = 0;
+    latency->backoff = 0;
+    for(size_t i = 0; i < WF_JSONRPC_LATENCY_HISTOGRAM_SIZE; i++)
+    {
+        latency->histogram[i] = 0;
+    }
+    latency->histogram_count = 0;
+
+    return latency;
+}
+
+void
+wf_impl_jsonrpc_latency_dispose(
+    struct wf_jsonrpc_latency * latency)
+{
+    free(latency->method);
+    free(latency);
+}
+
+size_t
+wf_impl_jsonrpc_latency_get_size_class(
+    size_t size)
+{
+    if (0 == size)
+    {
+        return 0;
+    }
+
+    size_t max_size = WF_JSONRPC_LATENCY_MIN_CLASS_SIZE;
+    while (max_size < size)
+    {
+        if (WF_JSONRPC_LATENCY_MAX_CLASS_SIZE <= max_size)
+        {
+            return SIZE_MAX;
+        }
+
+        max_size *= 4;
+    }
+
+    return max_size;
+}
+
+void
+wf_impl_jsonrpc_latency_add_sample(
+    struct wf_jsonrpc_latency * latency,
+    uint64_t duration)
+{
+    if (0 == latency->samples)
+    {
+        latency->average = duration << 3;
+        latency->deviation = duration << 1;
+    }
+    else
+    {
+        int64_t error = ((int64_t) duration) - ((int64_t) (latency->average >> 3));
+        latency->average = (uint64_t) (((int64_t) latency->average) + error);
+        error = (error < 0) ? -error : error;
+        error -= (int64_t) (latency->deviation >> 2);
+        latency->deviation = (uint64_t) (((int64_t) latency->deviation) + error);
+    }
+
+    latency->samples++;
+    latency->max = (duration > latency->max) ? duration : latency->max;
+    latency->backoff = 0;
+
+    size_t bucket = 0;
+    while ((bucket < (WF_JSONRPC_LATENCY_HISTOGRAM_SIZE - 1)) && ((duration >> bucket) > 0))
+    {
+        bucket++;
+    }
+    latency->histogram[bucket]++;
+    latency->histogram_count++;
+
+    if (WF_JSONRPC_LATENCY_WINDOW <= latency->histogram_count)
+    {
+        latency->histogram_count = 0;
+        for(size_t i = 0; i < WF_JSONRPC_LATENCY_HISTOGRAM_SIZE; i++)
+        {
+            latency->histogram[i] /= 2;
+            latency->histogram_count += latency->histogram[i];
+        }
+    }
+}
+
+void
+wf_impl_jsonrpc_latency_add_timeout(
+    struct wf_jsonrpc_latency * latency)
+{
+    latency->timeouts++;
+    if (latency->backoff < WF_JSONRPC_LATENCY_MAX_BACKOFF)
+    {
+        latency->backoff++;
+    }
+}
+
+// Returns the upper bound of the bucket containing the 99th percentile.
+static uint64_t
+wf_impl_jsonrpc_latency_get_percentile_99(
+    struct wf_jsonrpc_latency const * latency)
+{
+    uint64_t count = 0;
+    for(size_t i = 0; i < WF_JSONRPC_LATENCY_HISTOGRAM_SIZE; i++)
+    {
+        count += latency->histogram[i];
+        if ((0 < count) && ((count * 100) >= (latency->histogram_count * 99)))
+        {
+            return ((uint64_t) 1) << i;
+        }
+    }
+
+    return 0;
+}
+
+int
+wf_impl_jsonrpc_latency_get_timeout(
+    struct wf_jsonrpc_latency const * latency,
+    int default_timeout,
+    int min_timeout,
+    int max_timeout)
+{
+    uint64_t timeout = (uint64_t) default_timeout;
+    if (WF_JSONRPC_LATENCY_MIN_SAMPLES <= latency->samples)
+    {
+        timeout = (latency->average >> 3) + latency->deviation;
+        uint64_t const percentile = wf_impl_jsonrpc_latency_get_percentile_99(latency);
+        timeout = (percentile > timeout) ? percentile : timeout;
+    }
+    timeout <<= latency->backoff;
+
+    if (timeout > (uint64_t) max_timeout)
+    {
+        timeout = (uint64_t) max_timeout;
+    }
+    if (timeout < (uint64_t) min_timeout)
+    {
+        timeout = (uint64_t) min_timeout;
+    }
+
+    return (int) timeout;
+}
+
+void
+wf_impl_jsonrpc_latency_get_stats(
+    struct wf_jsonrpc_latency const * latency,
+    struct wf_jsonrpc_latency_stats * stats)
+{
+    stats->samples = latency->samples;
+    stats->timeouts = latency->timeouts;
+    stats->average = latency->average >> 3;
+    stats->deviation = latency->deviation >> 2;
+    stats->percentile_99 = wf_impl_jsonrpc_latency_get_percentile_99(latency);
+    stats->max = latency->max;
+}
@@ -0,0 +1,126 @@
+#ifndef WF_IMPL_JSONRPC_LATENCY_H
+#define WF_IMPL_JSONRPC_LATENCY_H
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <inttypes.h>
+#else
+#include <cstddef>
+#include <cinttypes>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define WF_JSONRPC_LATENCY_HISTOGRAM_SIZE 20
+
+// number of responses, before the timeout is derived from observed latency
+#define WF_JSONRPC_LATENCY_MIN_SAMPLES 16
+
+// requests transferring up to 4 KiB form the smallest size class; each
+// further class covers four times the size of the previous one
+#define WF_JSONRPC_LATENCY_MIN_CLASS_SIZE (4 * 1024)
+#define WF_JSONRPC_LATENCY_MAX_CLASS_SIZE (16 * 1024 * 1024)
+
+//------------------------------------------------------------------------------
+/// \brief State of a latency estimator; all durations are in milliseconds.
+//------------------------------------------------------------------------------
+struct wf_jsonrpc_latency_stats
+{
+    uint64_t samples;
+    uint64_t timeouts;
+    uint64_t average;
+    uint64_t deviation;
+    uint64_t percentile_99;
+    uint64_t max;
+};
+
+//------------------------------------------------------------------------------
+/// \brief Estimates the latency of a method to derive its timeout.
+///
+/// Requests of a method, which transfer payload (such as read), are
+/// tracked per size class, so that small requests do not shrink the
+/// timeout of large ones (see wf_impl_jsonrpc_latency_get_size_class).
+///
+/// Response times are tracked as exponentially weighted moving average and
+/// mean deviation (as TCP does for round trip times) and in a histogram of
+/// power of two buckets, which is halved regularly to follow recent changes.
+///
+/// The timeout is the larger of average + 4 * deviation and the 99th
+/// percentile. It is doubled on each timeout, until the next response is
+/// received, so that a method which became slower is not timed out forever.
+//------------------------------------------------------------------------------
+struct wf_jsonrpc_latency
+{
+    struct wf_jsonrpc_latency * next;
+    char * method;
+    // upper bound of the size class; 0 for requests without payload
+    size_t max_size;
+    uint64_t samples;
+    uint64_t timeouts;
+    // scaled by 8 (average) and 4 (deviation) to keep precision
+    uint64_t average;
+    uint64_t deviation;
+    uint64_t max;
+    unsigned int backoff;
+    uint64_t histogram[WF_JSONRPC_LATENCY_HISTOGRAM_SIZE];
+    uint64_t histogram_count;
+};
+
+extern struct wf_jsonrpc_latency *
+wf_impl_jsonrpc_latency_create(
+    char const * method,
+    size_t max_size);
+
+extern void
+wf_impl_jsonrpc_latency_dispose(
+    struct wf_jsonrpc_latency * latency);
+
+//------------------------------------------------------------------------------
+/// \brief Returns the size class of a request.
+///
+/// \param size number of bytes transferred by the request; 0 if unknown
+/// \return upper bound of the size class (a power of 4 times 4 KiB up to
+///         16 MiB, SIZE_MAX above) or 0, if size is 0
+//------------------------------------------------------------------------------
+extern size_t
+wf_impl_jsonrpc_latency_get_size_class(
+    size_t size);
+
+extern void
+wf_impl_jsonrpc_latency_add_sample(
+    struct wf_jsonrpc_latency * latency,
+    uint64_t duration);
+
+extern void
+wf_impl_jsonrpc_latency_add_timeout(
+    struct wf_jsonrpc_latency * latency);
+
+//------------------------------------------------------------------------------
+/// \brief Returns the timeout of the next request.
+///
+/// \param latency pointer to the estimator
+/// \param default_timeout timeout used until enough responses are observed
+/// \param min_timeout lower bound of the timeout
+/// \param max_timeout upper bound of the timeout
+/// \return timeout in milliseconds
+//------------------------------------------------------------------------------
+extern int
+wf_impl_jsonrpc_latency_get_timeout(
+    struct wf_jsonrpc_latency const * latency,
+    int default_timeout,
+    int min_timeout,
+    int max_timeout);
+
+extern void
+wf_impl_jsonrpc_latency_get_stats(
+    struct wf_jsonrpc_latency const * latency,
+    struct wf_jsonrpc_latency_stats * stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2,14 +2,19 @@
 #include "webfuse/impl/jsonrpc/proxy_request_manager.h"
 #include "webfuse/impl/jsonrpc/response_intern.h"
 #include "webfuse/impl/jsonrpc/error.h"
+#include "webfuse/impl/jsonrpc/latency.h"
 #include "webfuse/impl/json/writer.h"
 #include "webfuse/impl/message.h"
+#include "webfuse/impl/message_pool.h"
 #include "webfuse/status.h"
 
 #include <libwebsockets.h>
 
 #include <stdlib.h>
+#include <stdio.h>
 #include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
 
 #define WF_JSONRPC_PROXY_DEFAULT_MESSAGE_SIZE 1024
 
@@ -33,15 +38,65 @@ void wf_impl_jsonrpc_proxy_dispose(
     free(proxy);
 }
 
+struct wf_jsonrpc_proxy *
+wf_impl_jsonrpc_proxy_create_view(
+    struct wf_jsonrpc_proxy * proxy,
+    void const * source,
+    enum wf_message_class message_class)
+{
+    struct wf_jsonrpc_proxy * view = malloc(sizeof(struct wf_jsonrpc_proxy));
+    view->request_manager = proxy->request_manager;
+    view->send = proxy->send;
+    view->user_data = proxy->user_data;
+    view->is_view = true;
+    view->source = source;
+    view->message_class = message_class;
+    view->timeout = proxy->timeout;
+    view->min_timeout = proxy->min_timeout;
+    view->max_timeout = proxy->max_timeout;
+    view->pool = proxy->pool;
+
+    return view;
+}
+
+void
+wf_impl_jsonrpc_proxy_set_timeout(
+    struct wf_jsonrpc_proxy * proxy,
+    int min_timeout,
+    int max_timeout)
+{
+    proxy->min_timeout = min_timeout;
+    proxy->max_timeout = max_timeout;
+}
+
+void
+wf_impl_jsonrpc_proxy_set_message_pool(
+    struct wf_jsonrpc_proxy * proxy,
+    struct wf_message_pool * pool)
+{
+    proxy->pool = pool;
+}
+
+void
+wf_impl_jsonrpc_proxy_set_timeout_handler(
+    struct wf_jsonrpc_proxy * proxy,
+    wf_jsonrpc_proxy_timeout_fn * on_timeout,
+    void * user_data)
+{
+    wf_impl_jsonrpc_proxy_request_manager_set_timeout_handler(proxy->request_manager, on_timeout, user_data);
+}
+
 
 static struct wf_message * 
 wf_impl_jsonrpc_request_create(
+    struct wf_message_pool * pool,
 	char const * method,
 	int id,
 	char const * param_info,
 	va_list args)
 {
-    struct wf_json_writer * writer = wf_impl_json_writer_create(WF_JSONRPC_PROXY_DEFAULT_MESSAGE_SIZE, LWS_PRE);
+    struct wf_json_writer * writer = (NULL != pool) ? wf_impl_message_pool_get_writer(pool) :
+        wf_impl_json_writer_create(WF_JSONRPC_PROXY_DEFAULT_MESSAGE_SIZE, LWS_PRE);
     wf_impl_json_write_object_begin(writer);
     wf_impl_json_write_object_string(writer, "method", method);
     wf_impl_json_write_object_begin_array(writer, "params");
@@ -62,6 +117,12 @@ wf_impl_jsonrpc_request_create(
                 wf_impl_json_write_int(writer, value);
 			}
 			break;
+			case 'I':
+			{
+				int64_t const value = va_arg(args, int64_t);
+                wf_impl_json_write_int64(writer, value);
+			}
+			break;
             case 'j':
             {
                 wf_jsonrpc_custom_write_fn * write = va_arg(args, wf_jsonrpc_custom_write_fn *);
@@ -82,6 +143,11 @@ wf_impl_jsonrpc_request_create(
 	}
     
     wf_impl_json_write_object_end(writer);
+
+    if (NULL != pool)
+    {
+        return wf_impl_message_pool_take(pool, writer);
+    }
 	
     size_t length;
     char * message = wf_impl_json_writer_take(writer, &length);
@@ -99,15 +165,24 @@ void wf_impl_jsonrpc_proxy_init(
 {
     proxy->send = send;
     proxy->user_data = user_data;
+    proxy->is_view = false;
+    proxy->source = NULL;
+    proxy->message_class = WF_MESSAGE_CLASS_METADATA;
+    proxy->timeout = timeout;
+    proxy->min_timeout = timeout;
+    proxy->max_timeout = timeout;
+    proxy->pool = NULL;
 
-    proxy->request_manager = wf_impl_jsonrpc_proxy_request_manager_create(
-        timeout_manager, timeout);
+    proxy->request_manager = wf_impl_jsonrpc_proxy_request_manager_create(timeout_manager);
 }
 
 void wf_impl_jsonrpc_proxy_cleanup(
     struct wf_jsonrpc_proxy * proxy)
 {
-    wf_impl_jsonrpc_proxy_request_manager_dispose(proxy->request_manager);
+    if (!proxy->is_view)
+    {
+        wf_impl_jsonrpc_proxy_request_manager_dispose(proxy->request_manager);
+    }
 }
 
 void wf_impl_jsonrpc_proxy_vinvoke(
@@ -118,10 +193,34 @@ void wf_impl_jsonrpc_proxy_vinvoke(
 	char const * param_info,
 	va_list args)
 {
+    wf_impl_jsonrpc_proxy_vinvoke_sized(proxy, finished, user_data, 0, method_name, param_info, args);
+}
+
+void wf_impl_jsonrpc_proxy_vinvoke_sized(
+	struct wf_jsonrpc_proxy * proxy,
+	wf_jsonrpc_proxy_finished_fn * finished,
+	void * user_data,
+	size_t size,
+	char const * method_name,
+	char const * param_info,
+	va_list args)
+{
+    struct wf_jsonrpc_latency * latency = wf_impl_jsonrpc_proxy_request_manager_get_latency(
+            proxy->request_manager, method_name, size);
+    int const timeout = wf_impl_jsonrpc_latency_get_timeout(
+            latency, proxy->timeout, proxy->min_timeout, proxy->max_timeout);
     int id = wf_impl_jsonrpc_proxy_request_manager_add_request(
-            proxy->request_manager, finished, user_data);
+            proxy->request_manager, latency, timeout, finished, user_data);
+    if (0 == id)
+    {
+        // request was already finished (proxy is disposed)
+        return;
+    }
 
-    struct wf_message * request = wf_impl_jsonrpc_request_create(method_name, id, param_info, args);
+    struct wf_message * request = wf_impl_jsonrpc_request_create(proxy->pool, method_name, id, param_info, args);
+    request->message_class = proxy->message_class;
+    request->source = proxy->source;
+    request->request_id = id;
     bool const is_send = proxy->send(request, proxy->user_data);
     if (!is_send)
     {
@@ -136,10 +235,27 @@ extern void wf_impl_jsonrpc_proxy_vnotify(
 	char const * param_info,
 	va_list args)
 {
-    struct wf_message * request = wf_impl_jsonrpc_request_create(method_name, 0, param_info, args);
+    struct wf_message * request = wf_impl_jsonrpc_request_create(proxy->pool, method_name, 0, param_info, args);
+    request->message_class = WF_MESSAGE_CLASS_NOTIFICATION;
+    request->source = proxy->source;
     proxy->send(request, proxy->user_data);
 }
 
+void wf_impl_jsonrpc_proxy_cancel(
+	struct wf_jsonrpc_proxy * proxy,
+	wf_jsonrpc_proxy_finished_fn * finished,
+	void * user_data)
+{
+    int id = wf_impl_jsonrpc_proxy_request_manager_find_request(proxy->request_manager, finished, user_data);
+    while (0 != id)
+    {
+        wf_impl_jsonrpc_proxy_notify(proxy, "cancel", "i", id);
+        wf_impl_jsonrpc_proxy_request_manager_cancel_request(
+            proxy->request_manager, id, WF_BAD_INTERRUPTED, "Bad: request interrupted");
+
+        id = wf_impl_jsonrpc_proxy_request_manager_find_request(proxy->request_manager, finished, user_data);
+    }
+}
 
 void wf_impl_jsonrpc_proxy_onresult(
     struct wf_jsonrpc_proxy * proxy,
@@ -153,3 +269,68 @@ void wf_impl_jsonrpc_proxy_onresult(
 
     wf_impl_jsonrpc_response_cleanup(&response);
 }
+
+void wf_impl_jsonrpc_proxy_onsent(
+    struct wf_jsonrpc_proxy * proxy,
+    struct wf_message const * message)
+{
+    if (0 != message->request_id)
+    {
+        wf_impl_jsonrpc_proxy_request_manager_set_sent(proxy->request_manager, message->request_id);
+    }
+}
+
+size_t wf_impl_jsonrpc_proxy_get_pending_count(
+    struct wf_jsonrpc_proxy * proxy)
+{
+    return wf_impl_jsonrpc_proxy_request_manager_get_count(proxy->request_manager);
+}
+
+bool wf_impl_jsonrpc_proxy_get_latency_stats(
+    struct wf_jsonrpc_proxy * proxy,
+    char const * method_name,
+    size_t size,
+    struct wf_jsonrpc_latency_stats * stats)
+{
+    size_t const max_size = wf_impl_jsonrpc_latency_get_size_class(size);
+    struct wf_jsonrpc_latency const * latency = wf_impl_jsonrpc_proxy_request_manager_get_latencies(proxy->request_manager);
+    while (NULL != latency)
+    {
+        if ((max_size == latency->max_size) && (0 == strcmp(method_name, latency->method)))
+        {
+            wf_impl_jsonrpc_latency_get_stats(latency, stats);
+            return true;
+        }
+
+        latency = latency->next;
+    }
+
+    return false;
+}
+
+void wf_impl_jsonrpc_proxy_log_stats(
+    struct wf_jsonrpc_proxy * proxy,
+    char const * name)
+{
+    struct wf_jsonrpc_latency const * latency = wf_impl_jsonrpc_proxy_request_manager_get_latencies(proxy->request_manager);
+    while (NULL != latency)
+    {
+        struct wf_jsonrpc_latency_stats stats;
+        wf_impl_jsonrpc_latency_get_stats(latency, &stats);
+        int const timeout = wf_impl_jsonrpc_latency_get_timeout(
+            latency, proxy->timeout, proxy->min_timeout, proxy->max_timeout);
+
+        // requests of size classes are logged along with their max. size
+        char size_class[32] = "";
+        if (0 < latency->max_size)
+        {
+            snprintf(size_class, sizeof(size_class), " (<= %zu bytes)", latency->max_size);
+        }
+
+        lwsl_info("%s: %s%s: %" PRIu64 " responses, %" PRIu64 " timeouts, latency avg %" PRIu64 " ms, deviation %" PRIu64 " ms, 99th percentile <= %" PRIu64 " ms, max %" PRIu64 " ms, timeout %d ms\n",
+            name, latency->method, size_class, stats.samples, stats.timeouts, stats.average, stats.deviation,
+            stats.percentile_99, stats.max, timeout);
+
+        latency = latency->next;
+    }
+}
@@ -13,12 +13,14 @@ using std::size_t;
 
 #include "webfuse/impl/jsonrpc/send_fn.h"
 #include "webfuse/impl/jsonrpc/proxy_finished_fn.h"
+#include "webfuse/impl/message.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct wf_jsonrpc_proxy;
+struct wf_jsonrpc_latency_stats;
 struct wf_timer_manager;
 struct wf_json_writer;
 struct wf_json;
@@ -28,6 +30,18 @@ wf_jsonrpc_custom_write_fn(
 	struct wf_json_writer * writer,
 	void * data);
 
+//------------------------------------------------------------------------------
+/// \brief Creates a proxy.
+///
+/// Requests time out after timeout milliseconds. To derive timeouts from
+/// observed latency instead, bounds must be set using
+/// wf_impl_jsonrpc_proxy_set_timeout.
+///
+/// \param manager timer manager
+/// \param timeout timeout of requests in milliseconds
+/// \param send function to send messages
+/// \param user_data user data of send
+//------------------------------------------------------------------------------
 extern struct wf_jsonrpc_proxy *
 wf_impl_jsonrpc_proxy_create(
     struct wf_timer_manager * manager,
@@ -38,6 +52,85 @@ wf_impl_jsonrpc_proxy_create(
 extern void wf_impl_jsonrpc_proxy_dispose(
     struct wf_jsonrpc_proxy * proxy);
 
+//------------------------------------------------------------------------------
+/// \brief Creates a view of a proxy.
+///
+/// A view sends its messages using the send function of the proxy and
+/// shares its pending requests, so that responses are dispatched by
+/// wf_impl_jsonrpc_proxy_onresult of the proxy. Messages sent by a view
+/// are tagged with source and class (see wf_message); notifications are
+/// always tagged as WF_MESSAGE_CLASS_NOTIFICATION.
+///
+/// A view must be disposed before the proxy it was created from.
+///
+/// \param proxy pointer to proxy instance
+/// \param source opaque tag of the messages' source
+/// \param message_class class of requests sent by the view
+//------------------------------------------------------------------------------
+extern struct wf_jsonrpc_proxy *
+wf_impl_jsonrpc_proxy_create_view(
+    struct wf_jsonrpc_proxy * proxy,
+    void const * source,
+    enum wf_message_class message_class);
+
+//------------------------------------------------------------------------------
+/// \brief Sets the bounds of request timeouts.
+///
+/// Latency is tracked per method (and size class, see
+/// wf_impl_jsonrpc_proxy_invoke_sized) and shared by a proxy and its views
+/// (see wf_jsonrpc_latency). The timeout of a request is derived from the
+/// latency of its method and clamped to [min_timeout, max_timeout]. Until
+/// enough responses are observed, the timeout passed to
+/// wf_impl_jsonrpc_proxy_create is used (clamped as well).
+///
+/// By default, both bounds are set to the timeout passed to
+/// wf_impl_jsonrpc_proxy_create, which disables adaptation. Views
+/// inherit the bounds of the proxy they are created from.
+///
+/// \param proxy pointer to proxy instance
+/// \param min_timeout lower bound of timeouts in milliseconds
+/// \param max_timeout upper bound of timeouts in milliseconds
+//------------------------------------------------------------------------------
+extern void
+wf_impl_jsonrpc_proxy_set_timeout(
+    struct wf_jsonrpc_proxy * proxy,
+    int min_timeout,
+    int max_timeout);
+
+//------------------------------------------------------------------------------
+/// \brief Sets a pool to create requests and notifications from.
+///
+/// The pool is not owned by the proxy; since messages return their buffers
+/// to the pool, it must be disposed after the proxy (see
+/// wf_impl_message_pool_dispose). Views inherit the pool of the proxy they
+/// are created from.
+///
+/// \param proxy pointer to proxy instance
+/// \param pool pool of message buffers or NULL to disable pooling
+//------------------------------------------------------------------------------
+extern void
+wf_impl_jsonrpc_proxy_set_message_pool(
+    struct wf_jsonrpc_proxy * proxy,
+    struct wf_message_pool * pool);
+
+//------------------------------------------------------------------------------
+/// \brief Sets a function, which is called after a request timed out.
+///
+/// Timeouts are detected by the timer manager, i.e. outside of the
+/// callbacks of the connection which owns the proxy. The function allows
+/// the owner to react on requests finished meanwhile (e.g. to update
+/// flow control). It is shared by a proxy and its views.
+///
+/// \param proxy pointer to proxy instance
+/// \param on_timeout function called after a request timed out
+/// \param user_data user data of on_timeout
+//------------------------------------------------------------------------------
+extern void
+wf_impl_jsonrpc_proxy_set_timeout_handler(
+    struct wf_jsonrpc_proxy * proxy,
+    wf_jsonrpc_proxy_timeout_fn * on_timeout,
+    void * user_data);
+
 //------------------------------------------------------------------------------
 /// \brief Invokes a method.
 ///
@@ -49,7 +142,8 @@ extern void wf_impl_jsonrpc_proxy_dispose(
 /// \param finished function which is called exactly once, either on success or
 ///                 on failure.
 /// \param method_name name of the method to invoke
-/// \param param_info types of the param (s = string, i = integer, j = json)
+/// \param param_info types of the param (s = string, i = integer,
+///                   I = 64-bit integer (int64_t), j = json)
 /// \param ... params
 //------------------------------------------------------------------------------
 extern void wf_impl_jsonrpc_proxy_invoke(
@@ -61,6 +155,42 @@ extern void wf_impl_jsonrpc_proxy_invoke(
 	...
 );
 
+//------------------------------------------------------------------------------
+/// \brief Invokes a method, which transfers payload of a given size.
+///
+/// Same as wf_impl_jsonrpc_proxy_invoke, but latency is tracked per size
+/// class of the method (see wf_impl_jsonrpc_latency_get_size_class), so
+/// that the timeout of large requests is not derived from small ones.
+///
+/// \param size number of bytes transferred by the request
+//------------------------------------------------------------------------------
+extern void wf_impl_jsonrpc_proxy_invoke_sized(
+	struct wf_jsonrpc_proxy * proxy,
+	wf_jsonrpc_proxy_finished_fn * finished,
+	void * user_data,
+	size_t size,
+	char const * method_name,
+	char const * param_info,
+	...
+);
+
+//------------------------------------------------------------------------------
+/// \brief Cancels pending method invokations.
+///
+/// All pending invokations with matching finished function and user data
+/// are finished with error WF_BAD_INTERRUPTED. For each of them, a cancel
+/// notification containing the id of the request is sent, so that the
+/// receiver may abort processing. A late response is ignored.
+///
+/// \param proxy pointer to proxy instance
+/// \param finished finished function, as passed to invoke
+/// \param user_data user data, as passed to invoke
+//------------------------------------------------------------------------------
+extern void wf_impl_jsonrpc_proxy_cancel(
+	struct wf_jsonrpc_proxy * proxy,
+	wf_jsonrpc_proxy_finished_fn * finished,
+	void * user_data);
+
 extern void wf_impl_jsonrpc_proxy_notify(
 	struct wf_jsonrpc_proxy * proxy,
 	char const * method_name,
@@ -72,6 +202,47 @@ extern void wf_impl_jsonrpc_proxy_onresult(
     struct wf_jsonrpc_proxy * proxy,
     struct wf_json const * message);
 
+//------------------------------------------------------------------------------
+/// \brief Notifies the proxy that a message is taken from the send queue.
+///
+/// Response time and timeout of the request carried by the message are
+/// measured from now on, so that neither includes the time the request
+/// was queued (see wf_impl_message_scheduler_set_taken_handler). Messages
+/// of other proxies or without request are ignored.
+//------------------------------------------------------------------------------
+extern void wf_impl_jsonrpc_proxy_onsent(
+    struct wf_jsonrpc_proxy * proxy,
+    struct wf_message const * message);
+
+//------------------------------------------------------------------------------
+/// \brief Returns the number of invoked methods waiting for a response.
+//------------------------------------------------------------------------------
+extern size_t wf_impl_jsonrpc_proxy_get_pending_count(
+    struct wf_jsonrpc_proxy * proxy);
+
+//------------------------------------------------------------------------------
+/// \brief Returns the state of the latency estimator of a method.
+///
+/// \param proxy pointer to proxy instance
+/// \param method_name name of the method
+/// \param size size passed to wf_impl_jsonrpc_proxy_invoke_sized; 0 for
+///             methods invoked by wf_impl_jsonrpc_proxy_invoke
+/// \param stats [out] state of the estimator
+/// \return true, if the method was invoked before, false otherwise
+//------------------------------------------------------------------------------
+extern bool wf_impl_jsonrpc_proxy_get_latency_stats(
+    struct wf_jsonrpc_proxy * proxy,
+    char const * method_name,
+    size_t size,
+    struct wf_jsonrpc_latency_stats * stats);
+
+//------------------------------------------------------------------------------
+/// \brief Logs latency and timeout per method.
+//------------------------------------------------------------------------------
+extern void wf_impl_jsonrpc_proxy_log_stats(
+    struct wf_jsonrpc_proxy * proxy,
+    char const * name);
+
 #ifdef __cplusplus
 }
 #endif
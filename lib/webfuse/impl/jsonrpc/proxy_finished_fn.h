@@ -14,6 +14,9 @@ typedef void wf_jsonrpc_proxy_finished_fn(
 	struct wf_json const * result,
     struct wf_jsonrpc_error const * error);
 
+typedef void wf_jsonrpc_proxy_timeout_fn(
+	void * user_data);
+
 #ifdef __cplusplus
 }
 #endif
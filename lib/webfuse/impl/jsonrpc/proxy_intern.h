@@ -4,6 +4,7 @@
 #include "webfuse/impl/jsonrpc/proxy.h"
 #include "webfuse/impl/jsonrpc/proxy_finished_fn.h"
 #include "webfuse/impl/jsonrpc/send_fn.h"
+#include "webfuse/impl/message.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -11,12 +12,23 @@ extern "C"
 #endif
 
 struct wf_jsonrpc_proxy_request_manager;
+struct wf_message_pool;
 
 struct wf_jsonrpc_proxy
 {
     struct wf_jsonrpc_proxy_request_manager * request_manager;
     wf_jsonrpc_send_fn * send;
     void * user_data;
+    // views share the request manager of the proxy they are created from
+    bool is_view;
+    void const * source;
+    enum wf_message_class message_class;
+    // timeout until latency is known and its bounds (see wf_jsonrpc_latency)
+    int timeout;
+    int min_timeout;
+    int max_timeout;
+    // optional pool of request buffers (not owned)
+    struct wf_message_pool * pool;
 };
 
 extern void 
@@ -39,6 +51,15 @@ extern void wf_impl_jsonrpc_proxy_vinvoke(
 	char const * param_info,
 	va_list args);
 
+extern void wf_impl_jsonrpc_proxy_vinvoke_sized(
+	struct wf_jsonrpc_proxy * proxy,
+	wf_jsonrpc_proxy_finished_fn * finished,
+	void * user_data,
+	size_t size,
+	char const * method_name,
+	char const * param_info,
+	va_list args);
+
 extern void wf_impl_jsonrpc_proxy_vnotify(
 	struct wf_jsonrpc_proxy * proxy,
 	char const * method_name,
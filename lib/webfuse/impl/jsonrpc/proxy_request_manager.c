@@ -1,30 +1,44 @@
 #include "webfuse/impl/jsonrpc/proxy_request_manager.h"
 #include "webfuse/status.h"
-#include "webfuse/impl/timer/timer.h"
+#include "webfuse/impl/timer/timer_intern.h"
 #include "webfuse/impl/jsonrpc/response_intern.h"
 #include "webfuse/impl/jsonrpc/error.h"
+#include "webfuse/impl/jsonrpc/latency.h"
+#include "webfuse/impl/util/container_of.h"
 
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
 #include <limits.h>
+#include <string.h>
 
-struct wf_timer;
+#define WF_JSONRPC_PROXY_REQUEST_MANAGER_INITIAL_CAPACITY 64
 
+// Pending requests are stored in a table of slots indexed by (id mod capacity).
+// Ids are assigned, such that the slot of a new request is free. A slot
+// holds a pending request, if its id matches; id 0 marks a free slot.
 struct wf_jsonrpc_proxy_request
 {
-    struct wf_jsonrpc_proxy_request_manager * manager;
     int id;
     wf_jsonrpc_proxy_finished_fn * finished;
     void * user_data;
-    struct wf_timer * timer;
-    struct wf_jsonrpc_proxy_request * next;
+    struct wf_jsonrpc_latency * latency;
+    int timeout;
+    wf_timer_timepoint started;
+    struct wf_timer timer;
 };
 
 struct wf_jsonrpc_proxy_request_manager
 {
     struct wf_timer_manager * timer_manager;
-    int timeout;
     int id;
     struct wf_jsonrpc_proxy_request * requests;
+    size_t capacity;
+    size_t count;
+    struct wf_jsonrpc_latency * latencies;
+    wf_jsonrpc_proxy_timeout_fn * on_timeout;
+    void * on_timeout_user_data;
+    bool is_disposing;
 };
 
 static void
@@ -32,42 +46,116 @@ wf_impl_jsonrpc_proxy_request_on_timeout(
     struct wf_timer * timer,
     void * user_data)
 {
-    struct wf_jsonrpc_proxy_request * request = user_data;
+    struct wf_jsonrpc_proxy_request_manager * manager = user_data;
+    struct wf_jsonrpc_proxy_request * request = wf_container_of(timer, struct wf_jsonrpc_proxy_request, timer);
 
+    wf_impl_jsonrpc_latency_add_timeout(request->latency);
     wf_impl_jsonrpc_proxy_request_manager_cancel_request(
-        request->manager,
+        manager,
         request->id,
         WF_BAD_TIMEOUT,
         "Timeout");
+
+    if (NULL != manager->on_timeout)
+    {
+        manager->on_timeout(manager->on_timeout_user_data);
+    }
 }
 
-static int
-wf_impl_jsonrpc_proxy_request_manager_next_id(
+static struct wf_jsonrpc_proxy_request *
+wf_impl_jsonrpc_proxy_request_manager_get(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    int id)
+{
+    struct wf_jsonrpc_proxy_request * request = &manager->requests[((size_t) id) & (manager->capacity - 1)];
+    return ((0 < id) && (id == request->id)) ? request : NULL;
+}
+
+static void
+wf_impl_jsonrpc_proxy_request_manager_init_requests(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    size_t capacity)
+{
+    manager->capacity = capacity;
+    manager->requests = malloc(sizeof(struct wf_jsonrpc_proxy_request) * capacity);
+    for(size_t i = 0; i < capacity; i++)
+    {
+        struct wf_jsonrpc_proxy_request * request = &manager->requests[i];
+        request->id = 0;
+        wf_impl_timer_init(&request->timer, manager->timer_manager,
+            &wf_impl_jsonrpc_proxy_request_on_timeout, manager);
+    }
+}
+
+static void
+wf_impl_jsonrpc_proxy_request_manager_grow(
     struct wf_jsonrpc_proxy_request_manager * manager)
 {
-    if (manager->id < INT_MAX)
+    struct wf_jsonrpc_proxy_request * requests = manager->requests;
+    size_t const capacity = manager->capacity;
+
+    // distinct slots in the old table map to distinct slots in the new one
+    wf_impl_jsonrpc_proxy_request_manager_init_requests(manager, capacity * 2);
+    for(size_t i = 0; i < capacity; i++)
     {
-        manager->id++;
+        struct wf_jsonrpc_proxy_request * old_request = &requests[i];
+        if (0 != old_request->id)
+        {
+            struct wf_jsonrpc_proxy_request * request = &manager->requests[((size_t) old_request->id) & (manager->capacity - 1)];
+            request->id = old_request->id;
+            request->finished = old_request->finished;
+            request->user_data = old_request->user_data;
+            request->latency = old_request->latency;
+            request->timeout = old_request->timeout;
+            request->started = old_request->started;
+
+            // timers are referenced by the timer manager and cannot be moved
+            if (wf_impl_timer_is_running(&old_request->timer))
+            {
+                wf_timer_timepoint const timeout = old_request->timer.timeout;
+                wf_impl_timer_cleanup(&old_request->timer);
+                wf_impl_timer_start_at(&request->timer, timeout);
+            }
+        }
     }
-    else
+
+    free(requests);
+}
+
+static int
+wf_impl_jsonrpc_proxy_request_manager_next_id(
+    struct wf_jsonrpc_proxy_request_manager * manager)
+{
+    do
     {
-        manager->id = 1;
+        if (manager->id < INT_MAX)
+        {
+            manager->id++;
+        }
+        else
+        {
+            manager->id = 1;
+        }
     }
-    
+    while (0 != manager->requests[((size_t) manager->id) & (manager->capacity - 1)].id);
+
     return manager->id;
 }
 
-
 struct wf_jsonrpc_proxy_request_manager *
 wf_impl_jsonrpc_proxy_request_manager_create(
-    struct wf_timer_manager * timer_manager,
-    int timeout)
+    struct wf_timer_manager * timer_manager)
 {
     struct wf_jsonrpc_proxy_request_manager * manager = malloc(sizeof(struct wf_jsonrpc_proxy_request_manager));
     manager->id = 1;
     manager->timer_manager = timer_manager;
-    manager->timeout = timeout;
-    manager->requests = NULL;
+    manager->count = 0;
+    manager->latencies = NULL;
+    manager->on_timeout = NULL;
+    manager->on_timeout_user_data = NULL;
+    manager->is_disposing = false;
+    wf_impl_jsonrpc_proxy_request_manager_init_requests(manager,
+        WF_JSONRPC_PROXY_REQUEST_MANAGER_INITIAL_CAPACITY);
 
     return manager;
 }
@@ -76,42 +164,78 @@ void
 wf_impl_jsonrpc_proxy_request_manager_dispose(
     struct wf_jsonrpc_proxy_request_manager * manager)
 {
-    struct wf_jsonrpc_proxy_request * request = manager->requests;
-    while (NULL != request)
+    // finished functions must not add requests while the table is torn down
+    manager->is_disposing = true;
+
+    for(size_t i = 0; i < manager->capacity; i++)
     {
-        struct wf_jsonrpc_proxy_request * next = request->next;
+        struct wf_jsonrpc_proxy_request * request = &manager->requests[i];
+        if (0 != request->id)
+        {
+            wf_impl_timer_cancel(&request->timer);
+            request->id = 0;
 
-        wf_impl_jsonrpc_propate_error(
-            request->finished, request->user_data,
-            WF_BAD, "Bad: cancelled pending request during shutdown");
-        wf_impl_timer_cancel(request->timer);
-        wf_impl_timer_dispose(request->timer);
-        free(request);
-        request = next;
+            wf_impl_jsonrpc_propate_error(
+                request->finished, request->user_data,
+                WF_BAD, "Bad: cancelled pending request during shutdown");
+        }
+    }
+
+    struct wf_jsonrpc_latency * latency = manager->latencies;
+    while (NULL != latency)
+    {
+        struct wf_jsonrpc_latency * next = latency->next;
+        wf_impl_jsonrpc_latency_dispose(latency);
+        latency = next;
     }
-    
+
+    free(manager->requests);
     free(manager);
 }
 
+void
+wf_impl_jsonrpc_proxy_request_manager_set_timeout_handler(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    wf_jsonrpc_proxy_timeout_fn * on_timeout,
+    void * user_data)
+{
+    manager->on_timeout = on_timeout;
+    manager->on_timeout_user_data = user_data;
+}
+
 int
 wf_impl_jsonrpc_proxy_request_manager_add_request(
     struct wf_jsonrpc_proxy_request_manager * manager,
+    struct wf_jsonrpc_latency * latency,
+    int timeout,
     wf_jsonrpc_proxy_finished_fn * finished,
     void * user_data)
 {
-    struct wf_jsonrpc_proxy_request * request = malloc(sizeof(struct wf_jsonrpc_proxy_request));
+    if (manager->is_disposing)
+    {
+        wf_impl_jsonrpc_propate_error(finished, user_data,
+            WF_BAD, "Bad: cancelled pending request during shutdown");
+        return 0;
+    }
+
+    // keep load factor below 1/2, so that free slots are found quickly
+    if ((2 * (manager->count + 1)) > manager->capacity)
+    {
+        wf_impl_jsonrpc_proxy_request_manager_grow(manager);
+    }
+
+    int const id = wf_impl_jsonrpc_proxy_request_manager_next_id(manager);
+    struct wf_jsonrpc_proxy_request * request = &manager->requests[((size_t) id) & (manager->capacity - 1)];
+    request->id = id;
     request->finished = finished;
     request->user_data = user_data;
-    request->manager = manager;
-    request->id = wf_impl_jsonrpc_proxy_request_manager_next_id(manager);
-    request->timer = wf_impl_timer_create(manager->timer_manager,
-        &wf_impl_jsonrpc_proxy_request_on_timeout ,request);
-    wf_impl_timer_start(request->timer, manager->timeout);
+    request->latency = latency;
+    request->timeout = timeout;
+    request->started = wf_impl_timer_timepoint_now();
+    wf_impl_timer_start(&request->timer, timeout);
+    manager->count++;
 
-    request->next = manager->requests;
-    manager->requests = request;
-
-    return request->id;
+    return id;
 }
 
 void
@@ -121,34 +245,52 @@ wf_impl_jsonrpc_proxy_request_manager_cancel_request(
     int error_code,
     char const * error_message)
 {
-    struct wf_jsonrpc_proxy_request * prev = NULL;
-    struct wf_jsonrpc_proxy_request * request = manager->requests;
-    while (request != NULL)
+    struct wf_jsonrpc_proxy_request * request = wf_impl_jsonrpc_proxy_request_manager_get(manager, id);
+    if (NULL != request)
+    {
+        wf_jsonrpc_proxy_finished_fn * finished = request->finished;
+        void * user_data = request->user_data;
+
+        wf_impl_timer_cancel(&request->timer);
+        request->id = 0;
+        manager->count--;
+
+        wf_impl_jsonrpc_propate_error(finished, user_data, error_code, error_message);
+    }
+}
+
+void
+wf_impl_jsonrpc_proxy_request_manager_set_sent(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    int id)
+{
+    struct wf_jsonrpc_proxy_request * request = wf_impl_jsonrpc_proxy_request_manager_get(manager, id);
+    if (NULL != request)
     {
-        struct wf_jsonrpc_proxy_request * next = request->next;
-        if (id == request->id)
+        // time spent in the send queue is neither latency nor a reason to time out
+        request->started = wf_impl_timer_timepoint_now();
+        wf_impl_timer_cancel(&request->timer);
+        wf_impl_timer_start(&request->timer, request->timeout);
+    }
+}
+
+int
+wf_impl_jsonrpc_proxy_request_manager_find_request(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    wf_jsonrpc_proxy_finished_fn * finished,
+    void * user_data)
+{
+    // linear search is fine, since requests are only looked up to cancel them
+    for(size_t i = 0; i < manager->capacity; i++)
+    {
+        struct wf_jsonrpc_proxy_request * request = &manager->requests[i];
+        if ((0 != request->id) && (finished == request->finished) && (user_data == request->user_data))
         {
-            wf_impl_jsonrpc_propate_error(
-                request->finished, request->user_data,
-                error_code, error_message);
-            wf_impl_timer_cancel(request->timer);
-            wf_impl_timer_dispose(request->timer);
-            free(request);
-            
-            if (NULL != prev)
-            {
-                prev->next = next;
-            }
-            else
-            {
-                manager->requests = next;
-            }
-            break;
+            return request->id;
         }
-
-        prev = request;
-        request = next;
     }
+
+    return 0;
 }
 
 void
@@ -156,34 +298,56 @@ wf_impl_jsonrpc_proxy_request_manager_finish_request(
     struct wf_jsonrpc_proxy_request_manager * manager,
     struct wf_jsonrpc_response * response)
 {
-    struct wf_jsonrpc_proxy_request * prev = NULL;
-    struct wf_jsonrpc_proxy_request * request = manager->requests;
-    while (request != NULL)
+    struct wf_jsonrpc_proxy_request * request = wf_impl_jsonrpc_proxy_request_manager_get(manager, response->id);
+    if (NULL != request)
     {
-        struct wf_jsonrpc_proxy_request * next = request->next;
-        if (response->id == request->id)
-        {
-            wf_jsonrpc_proxy_finished_fn * finished = request->finished;
-            void * user_data = request->user_data;
-
-            wf_impl_timer_cancel(request->timer);
-            wf_impl_timer_dispose(request->timer);
-            free(request);
-            
-            if (NULL != prev)
-            {
-                prev->next = next;
-            }
-            else
-            {
-                manager->requests = next;
-            }
+        wf_jsonrpc_proxy_finished_fn * finished = request->finished;
+        void * user_data = request->user_data;
 
-            finished(user_data, response->result, response->error);
-            break;
-        }
+        wf_impl_timer_cancel(&request->timer);
+        request->id = 0;
+        manager->count--;
+
+        wf_timer_timepoint const now = wf_impl_timer_timepoint_now();
+        wf_impl_jsonrpc_latency_add_sample(request->latency, (now > request->started) ? (now - request->started) : 0);
+
+        finished(user_data, response->result, response->error);
+    }
+}
+
+size_t
+wf_impl_jsonrpc_proxy_request_manager_get_count(
+    struct wf_jsonrpc_proxy_request_manager * manager)
+{
+    return manager->count;
+}
+
+struct wf_jsonrpc_latency *
+wf_impl_jsonrpc_proxy_request_manager_get_latency(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    char const * method_name,
+    size_t size)
+{
+    size_t const max_size = wf_impl_jsonrpc_latency_get_size_class(size);
+    struct wf_jsonrpc_latency * latency = manager->latencies;
+    while ((NULL != latency) && ((max_size != latency->max_size) || (0 != strcmp(method_name, latency->method))))
+    {
+        latency = latency->next;
+    }
 
-        prev = request;
-        request = next;
+    if (NULL == latency)
+    {
+        latency = wf_impl_jsonrpc_latency_create(method_name, max_size);
+        latency->next = manager->latencies;
+        manager->latencies = latency;
     }
+
+    return latency;
+}
+
+struct wf_jsonrpc_latency const *
+wf_impl_jsonrpc_proxy_request_manager_get_latencies(
+    struct wf_jsonrpc_proxy_request_manager * manager)
+{
+    return manager->latencies;
 }
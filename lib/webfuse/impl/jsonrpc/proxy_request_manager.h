@@ -3,6 +3,12 @@
 
 #include "webfuse/impl/jsonrpc/proxy_finished_fn.h"
 
+#ifndef __cplusplus
+#include <stddef.h>
+#else
+#include <cstddef>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -10,20 +16,51 @@ extern "C"
 
 struct wf_jsonrpc_proxy_request_manager;
 struct wf_jsonrpc_response;
+struct wf_jsonrpc_latency;
 struct wf_timer_manager;
 
 extern struct wf_jsonrpc_proxy_request_manager *
 wf_impl_jsonrpc_proxy_request_manager_create(
-    struct wf_timer_manager * timer_manager,
-    int timeout);
+    struct wf_timer_manager * timer_manager);
 
 extern void
 wf_impl_jsonrpc_proxy_request_manager_dispose(
     struct wf_jsonrpc_proxy_request_manager * manager);
 
+//------------------------------------------------------------------------------
+/// \brief Sets a function called after a request timed out.
+///
+/// The function is called after the finished function of the request.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_jsonrpc_proxy_request_manager_set_timeout_handler(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    wf_jsonrpc_proxy_timeout_fn * on_timeout,
+    void * user_data);
+
+//------------------------------------------------------------------------------
+/// \brief Adds a pending request.
+///
+/// The response time of the request is added to latency, once it is
+/// finished; a timeout is accounted as well. Response time and timeout are
+/// measured from the time the request is sent, if it is reported (see
+/// wf_impl_jsonrpc_proxy_request_manager_set_sent).
+///
+/// While the manager is disposed, no request is added: finished is called
+/// immediately with WF_BAD and 0 is returned.
+///
+/// \param manager pointer to the request manager
+/// \param latency latency estimator of the requested method
+/// \param timeout timeout of the request in milliseconds
+/// \param finished function called when the request is finished
+/// \param user_data user data of finished
+/// \return id of the request or 0, if the request was not added
+//------------------------------------------------------------------------------
 extern int
 wf_impl_jsonrpc_proxy_request_manager_add_request(
     struct wf_jsonrpc_proxy_request_manager * manager,
+    struct wf_jsonrpc_latency * latency,
+    int timeout,
     wf_jsonrpc_proxy_finished_fn * finished,
     void * user_data);
 
@@ -34,11 +71,59 @@ wf_impl_jsonrpc_proxy_request_manager_cancel_request(
     int error_code,
     char const * error_message);
 
+//------------------------------------------------------------------------------
+/// \brief Restarts response time and timeout of a request, once the
+///        request is taken from the send queue.
+///
+/// Has no effect, if no request with the given id is pending.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_jsonrpc_proxy_request_manager_set_sent(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    int id);
+
+//------------------------------------------------------------------------------
+/// \brief Returns the id of a pending request.
+///
+/// \return id of the first pending request with matching finished function
+///         and user data or 0, if no such request is pending
+//------------------------------------------------------------------------------
+extern int
+wf_impl_jsonrpc_proxy_request_manager_find_request(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    wf_jsonrpc_proxy_finished_fn * finished,
+    void * user_data);
+
 extern void
 wf_impl_jsonrpc_proxy_request_manager_finish_request(
     struct wf_jsonrpc_proxy_request_manager * manager,
     struct wf_jsonrpc_response * response);
 
+extern size_t
+wf_impl_jsonrpc_proxy_request_manager_get_count(
+    struct wf_jsonrpc_proxy_request_manager * manager);
+
+//------------------------------------------------------------------------------
+/// \brief Returns the latency estimator of a method and size class
+///        (created on first use).
+///
+/// \param manager pointer to the request manager
+/// \param method_name name of the method
+/// \param size number of bytes transferred by the request; 0 if unknown
+///             (see wf_impl_jsonrpc_latency_get_size_class)
+//------------------------------------------------------------------------------
+extern struct wf_jsonrpc_latency *
+wf_impl_jsonrpc_proxy_request_manager_get_latency(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    char const * method_name,
+    size_t size);
+
+//------------------------------------------------------------------------------
+/// \brief Returns the list of latency estimators (see wf_jsonrpc_latency).
+//------------------------------------------------------------------------------
+extern struct wf_jsonrpc_latency const *
+wf_impl_jsonrpc_proxy_request_manager_get_latencies(
+    struct wf_jsonrpc_proxy_request_manager * manager);
 
 #ifdef __cplusplus
 }
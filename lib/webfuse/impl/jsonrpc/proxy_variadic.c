@@ -14,6 +14,21 @@ void wf_impl_jsonrpc_proxy_invoke(
     va_end(args);
 }
 
+void wf_impl_jsonrpc_proxy_invoke_sized(
+	struct wf_jsonrpc_proxy * proxy,
+	wf_jsonrpc_proxy_finished_fn * finished,
+	void * user_data,
+	size_t size,
+	char const * method_name,
+	char const * param_info,
+	...)
+{
+    va_list args;
+    va_start(args, param_info);
+    wf_impl_jsonrpc_proxy_vinvoke_sized(proxy, finished, user_data, size, method_name, param_info, args);
+    va_end(args);
+}
+
 extern void wf_impl_jsonrpc_proxy_notify(
 	struct wf_jsonrpc_proxy * proxy,
 	char const * method_name,
@@ -30,6 +30,19 @@ wf_impl_jsonrpc_is_request(
             ( (wf_impl_json_is_array(params)) || (wf_impl_json_is_object(params)) ));
 }
 
+bool
+wf_impl_jsonrpc_is_notification(
+    struct wf_json const * message)
+{
+    if (NULL == message) { return false; }
+
+    struct wf_json const * id = wf_impl_json_object_get(message, "id");
+    struct wf_json const * method = wf_impl_json_object_get(message, "method");
+    struct wf_json const * params = wf_impl_json_object_get(message, "params");
+
+    return ( (wf_impl_json_is_undefined(id)) && (wf_impl_json_is_string(method)) &&
+            ( (wf_impl_json_is_array(params)) || (wf_impl_json_is_object(params)) ));
+}
 
 struct wf_jsonrpc_request *
 wf_impl_jsonrpc_request_create(
@@ -73,9 +86,12 @@ void
 wf_impl_jsonrpc_respond(
     struct wf_jsonrpc_request * request)
 {
-    struct wf_message * response = wf_impl_jsonrpc_response_writer_take_message(request->writer);
+    if (NULL != request->send)
+    {
+        struct wf_message * response = wf_impl_jsonrpc_response_writer_take_message(request->writer);
+        request->send(response, request->user_data);
+    }
 
-    request->send(response, request->user_data);
     wf_impl_jsonrpc_request_dispose(request);
 }
 
@@ -84,6 +100,12 @@ void wf_impl_jsonrpc_respond_error(
     int code,
     char const * message)
 {
+    if (NULL == request->send)
+    {
+        wf_impl_jsonrpc_request_dispose(request);
+        return;
+    }
+
     struct wf_json_writer * writer = wf_impl_json_writer_create(128, LWS_PRE);
     wf_impl_json_write_object_begin(writer);
     wf_impl_json_write_object_begin_object(writer, "error");
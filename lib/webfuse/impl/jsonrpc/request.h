@@ -25,6 +25,15 @@ struct wf_json;
 extern bool wf_impl_jsonrpc_is_request(
     struct wf_json const * message);
 
+extern bool wf_impl_jsonrpc_is_notification(
+    struct wf_json const * message);
+
+//------------------------------------------------------------------------------
+/// \brief Creates a request.
+///
+/// Notifications are created without send function (NULL);
+/// responses to notifications are discarded.
+//------------------------------------------------------------------------------
 extern struct wf_jsonrpc_request *
 wf_impl_jsonrpc_request_create(
     int id,
@@ -57,6 +57,15 @@ wf_impl_jsonrpc_response_add_int(
     wf_impl_json_write_object_int(writer->json_writer, key, value);
 }
 
+void
+wf_impl_jsonrpc_response_add_bool(
+    struct wf_jsonrpc_response_writer * writer,
+    char const * key,
+    bool value)
+{
+    wf_impl_json_write_object_bool(writer->json_writer, key, value);
+}
+
 void
 wf_impl_jsonrpc_response_add_string(
     struct wf_jsonrpc_response_writer * writer,
@@ -1,6 +1,10 @@
 #ifndef WF_IMPL_JSONRPC_RESPONSE_WRITER_H
 #define WF_IMPL_JSONRPC_RESPONSE_WRITER_H
 
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -26,6 +30,12 @@ wf_impl_jsonrpc_response_add_int(
     char const * key,
     int value);
 
+extern void
+wf_impl_jsonrpc_response_add_bool(
+    struct wf_jsonrpc_response_writer * writer,
+    char const * key,
+    bool value);
+
 extern void
 wf_impl_jsonrpc_response_add_string(
     struct wf_jsonrpc_response_writer * writer,
@@ -123,6 +123,14 @@ void wf_impl_jsonrpc_server_process(
         struct wf_jsonrpc_request * request = wf_impl_jsonrpc_request_create(id, send, user_data);
         struct wf_jsonrpc_method const * method = wf_impl_jsonrpc_server_get_method(server, method_name);
 
+        method->invoke(request, method_name, params, method->user_data);
+    }
+    else if (wf_impl_jsonrpc_is_notification(request_data))
+    {
+        char const * method_name = wf_impl_json_string_get(method_holder);
+        struct wf_jsonrpc_request * request = wf_impl_jsonrpc_request_create(-1, NULL, user_data);
+        struct wf_jsonrpc_method const * method = wf_impl_jsonrpc_server_get_method(server, method_name);
+
         method->invoke(request, method_name, params, method->user_data);
     }
 }
@@ -1,4 +1,5 @@
 #include "webfuse/impl/message.h"
+#include "webfuse/impl/message_pool.h"
 
 #include <stdlib.h>
 #include <libwebsockets.h>
@@ -11,6 +12,12 @@ wf_impl_message_create(
     struct wf_message * message = malloc(sizeof(struct wf_message));
     message->data = data;
     message->length = length;
+    message->message_class = WF_MESSAGE_CLASS_METADATA;
+    message->source = NULL;
+    message->request_id = 0;
+    message->enqueued = 0;
+    message->pool = NULL;
+    message->capacity = length;
 
     return message;
 }
@@ -19,7 +26,13 @@ void
 wf_impl_message_dispose(
     struct wf_message * message)
 {
+    if (NULL != message->pool)
+    {
+        wf_impl_message_pool_release(message->pool, message);
+        return;
+    }
+
     char * raw_data = message->data - LWS_PRE;
     free(raw_data);
-    free(message);    
+    free(message);
 }
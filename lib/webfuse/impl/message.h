@@ -9,12 +9,37 @@ using std::size_t;
 #endif
 
 #include "webfuse/impl/util/slist.h"
+#include "webfuse/impl/timer/timepoint.h"
+
+//------------------------------------------------------------------------------
+/// \brief Classes of outgoing messages, which are scheduled separately
+///        (see message_scheduler.h).
+//------------------------------------------------------------------------------
+enum wf_message_class
+{
+    WF_MESSAGE_CLASS_METADATA,
+    WF_MESSAGE_CLASS_DATA,
+    WF_MESSAGE_CLASS_NOTIFICATION
+};
+
+#define WF_MESSAGE_CLASS_COUNT 3
+
+struct wf_message_pool;
 
 struct wf_message
 {
     struct wf_slist_item item;
     char * data;
     size_t length;
+    enum wf_message_class message_class;
+    // opaque tag of the sender (e.g. filesystem); NULL for the connection
+    void const * source;
+    // id of the JSON-RPC request carried by the message; 0 otherwise
+    int request_id;
+    wf_timer_timepoint enqueued;
+    // pool the message is returned to on dispose (see message_pool.h)
+    struct wf_message_pool * pool;
+    size_t capacity;
 };
 
 #ifdef __cplusplus
@@ -27,6 +52,9 @@ wf_impl_message_create(
     char * value,
     size_t length);
 
+//------------------------------------------------------------------------------
+/// \brief Disposes a message or returns it to its pool.
+//------------------------------------------------------------------------------
 extern void
 wf_impl_message_dispose(
     struct wf_message * message);
@@ -0,0 +1,182 @@
+#include "webfuse/impl/message_pool.h"
+#include "webfuse/impl/message.h"
+#include "webfuse/impl/json/writer.h"
+#include "webfuse/impl/util/slist.h"
+#include "webfuse/impl/util/container_of.h"
+
+#include <libwebsockets.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+struct wf_message_pool
+{
+    struct wf_json_writer * writer;
+    // message whose buffer is attached to writer
+    struct wf_message * current;
+    struct wf_slist available;
+    size_t available_count;
+    size_t buffer_size;
+    size_t max_buffer_size;
+    size_t max_count;
+    size_t in_use;
+    bool is_disposed;
+    uint64_t allocations;
+    uint64_t reuses;
+};
+
+static void
+wf_impl_message_pool_free_message(
+    struct wf_message * message)
+{
+    free(message->data - LWS_PRE);
+    free(message);
+}
+
+struct wf_message_pool *
+wf_impl_message_pool_create(
+    size_t buffer_size,
+    size_t max_buffer_size,
+    size_t max_count)
+{
+    struct wf_message_pool * pool = malloc(sizeof(struct wf_message_pool));
+    pool->writer = wf_impl_json_writer_create(buffer_size, LWS_PRE);
+    pool->current = NULL;
+    wf_impl_slist_init(&pool->available);
+    pool->available_count = 0;
+    pool->buffer_size = buffer_size;
+    pool->max_buffer_size = max_buffer_size;
+    pool->max_count = max_count;
+    pool->in_use = 0;
+    pool->is_disposed = false;
+    pool->allocations = 0;
+    pool->reuses = 0;
+
+    return pool;
+}
+
+void
+wf_impl_message_pool_dispose(
+    struct wf_message_pool * pool)
+{
+    struct wf_slist_item * item = wf_impl_slist_remove_first(&pool->available);
+    while (NULL != item)
+    {
+        wf_impl_message_pool_free_message(wf_container_of(item, struct wf_message, item));
+        item = wf_impl_slist_remove_first(&pool->available);
+    }
+    pool->available_count = 0;
+
+    if (0 == pool->in_use)
+    {
+        wf_impl_json_writer_dispose(pool->writer);
+        free(pool);
+    }
+    else
+    {
+        pool->is_disposed = true;
+    }
+}
+
+struct wf_json_writer *
+wf_impl_message_pool_get_writer(
+    struct wf_message_pool * pool)
+{
+    // the pooled writer is in use, e.g. by a custom writer of a parameter
+    if (NULL != pool->current)
+    {
+        return wf_impl_json_writer_create(pool->buffer_size, LWS_PRE);
+    }
+
+    struct wf_slist_item * item = wf_impl_slist_remove_first(&pool->available);
+    if (NULL != item)
+    {
+        pool->current = wf_container_of(item, struct wf_message, item);
+        pool->available_count--;
+        pool->reuses++;
+    }
+    else
+    {
+        char * data = malloc(LWS_PRE + pool->buffer_size);
+        pool->current = malloc(sizeof(struct wf_message));
+        pool->current->data = &data[LWS_PRE];
+        pool->current->capacity = pool->buffer_size;
+        pool->allocations++;
+    }
+
+    wf_impl_json_writer_attach(pool->writer, pool->current->data, pool->current->capacity);
+    return pool->writer;
+}
+
+struct wf_message *
+wf_impl_message_pool_take(
+    struct wf_message_pool * pool,
+    struct wf_json_writer * writer)
+{
+    if (writer != pool->writer)
+    {
+        size_t length;
+        char * data = wf_impl_json_writer_take(writer, &length);
+        wf_impl_json_writer_dispose(writer);
+
+        return wf_impl_message_create(data, length);
+    }
+
+    struct wf_message * message = pool->current;
+    pool->current = NULL;
+
+    message->data = wf_impl_json_writer_take(writer, &message->length);
+    message->capacity = wf_impl_json_writer_get_capacity(writer);
+    message->message_class = WF_MESSAGE_CLASS_METADATA;
+    message->source = NULL;
+    message->request_id = 0;
+    message->enqueued = 0;
+    message->pool = pool;
+    pool->in_use++;
+
+    return message;
+}
+
+void
+wf_impl_message_pool_release(
+    struct wf_message_pool * pool,
+    struct wf_message * message)
+{
+    pool->in_use--;
+
+    if ((!pool->is_disposed) && (pool->available_count < pool->max_count) &&
+        (message->capacity <= pool->max_buffer_size))
+    {
+        wf_impl_slist_append(&pool->available, &message->item);
+        pool->available_count++;
+    }
+    else
+    {
+        wf_impl_message_pool_free_message(message);
+
+        if ((pool->is_disposed) && (0 == pool->in_use))
+        {
+            wf_impl_json_writer_dispose(pool->writer);
+            free(pool);
+        }
+    }
+}
+
+void
+wf_impl_message_pool_get_stats(
+    struct wf_message_pool * pool,
+    struct wf_message_pool_stats * stats)
+{
+    stats->allocations = pool->allocations;
+    stats->reuses = pool->reuses;
+    stats->in_use = pool->in_use;
+    stats->available = pool->available_count;
+}
+
+void
+wf_impl_message_pool_log_stats(
+    struct wf_message_pool * pool,
+    char const * name)
+{
+    lwsl_info("%s: message pool: %" PRIu64 " allocations, %" PRIu64 " reuses, %zu available\n",
+        name, pool->allocations, pool->reuses, pool->available_count);
+}
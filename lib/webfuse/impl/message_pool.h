@@ -0,0 +1,99 @@
+#ifndef WF_IMPL_MESSAGE_POOL_H
+#define WF_IMPL_MESSAGE_POOL_H
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <inttypes.h>
+#else
+#include <cstddef>
+#include <cinttypes>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct wf_message_pool;
+struct wf_message;
+struct wf_json_writer;
+
+struct wf_message_pool_stats
+{
+    uint64_t allocations;
+    uint64_t reuses;
+    size_t in_use;
+    size_t available;
+};
+
+//------------------------------------------------------------------------------
+/// \brief Recycles outgoing messages along with their buffers.
+///
+/// Messages are written using a writer provided by the pool, which writes
+/// directly into a recycled buffer with LWS_PRE headroom. Disposed messages
+/// are returned to the pool (see wf_impl_message_dispose), so that no
+/// allocation is needed in steady state.
+///
+/// Buffers grown beyond max_buffer_size are not recycled.
+//------------------------------------------------------------------------------
+extern struct wf_message_pool *
+wf_impl_message_pool_create(
+    size_t buffer_size,
+    size_t max_buffer_size,
+    size_t max_count);
+
+//------------------------------------------------------------------------------
+/// \brief Disposes the pool.
+///
+/// Disposal is deferred, until all messages taken from the pool are
+/// disposed.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_message_pool_dispose(
+    struct wf_message_pool * pool);
+
+//------------------------------------------------------------------------------
+/// \brief Returns a writer to create a message.
+///
+/// The writer must be passed to wf_impl_message_pool_take, when writing is
+/// done.
+//------------------------------------------------------------------------------
+extern struct wf_json_writer *
+wf_impl_message_pool_get_writer(
+    struct wf_message_pool * pool);
+
+//------------------------------------------------------------------------------
+/// \brief Returns a message containing the contents of writer.
+///
+/// \param pool pointer to the pool
+/// \param writer writer returned by wf_impl_message_pool_get_writer
+/// \return message (dispose using wf_impl_message_dispose)
+//------------------------------------------------------------------------------
+extern struct wf_message *
+wf_impl_message_pool_take(
+    struct wf_message_pool * pool,
+    struct wf_json_writer * writer);
+
+//------------------------------------------------------------------------------
+/// \brief Returns a message to the pool (called by wf_impl_message_dispose).
+//------------------------------------------------------------------------------
+extern void
+wf_impl_message_pool_release(
+    struct wf_message_pool * pool,
+    struct wf_message * message);
+
+extern void
+wf_impl_message_pool_get_stats(
+    struct wf_message_pool * pool,
+    struct wf_message_pool_stats * stats);
+
+extern void
+wf_impl_message_pool_log_stats(
+    struct wf_message_pool * pool,
+    char const * name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2,6 +2,10 @@
 #include "webfuse/impl/message.h"
 #include "webfuse/impl/util/container_of.h"
 
+#include <libwebsockets.h>
+#include <stdlib.h>
+#include <string.h>
+
 void wf_impl_message_queue_cleanup(
     struct wf_slist * queue)
 {
@@ -15,3 +19,59 @@ void wf_impl_message_queue_cleanup(
     }
     wf_impl_slist_init(queue);
 }
+
+struct wf_message * wf_impl_message_queue_take_batch(
+    struct wf_slist * queue,
+    size_t max_size,
+    size_t * size)
+{
+    if (wf_impl_slist_empty(queue))
+    {
+        return NULL;
+    }
+
+    // batch := "[" message ("," message)* "]"
+    size_t count = 0;
+    size_t length = 1;
+    struct wf_slist_item * item = wf_impl_slist_first(queue);
+    while (NULL != item)
+    {
+        struct wf_message * message = wf_container_of(item, struct wf_message, item);
+        if ((length + message->length + 1) > max_size)
+        {
+            break;
+        }
+
+        length += message->length + 1;
+        count++;
+        item = item->next;
+    }
+
+    if (2 > count)
+    {
+        item = wf_impl_slist_remove_first(queue);
+        struct wf_message * message = wf_container_of(item, struct wf_message, item);
+        if (NULL != size) { *size = message->length; }
+        return message;
+    }
+
+    char * data = malloc(LWS_PRE + length);
+    char * batch = &data[LWS_PRE];
+    size_t position = 0;
+    for(size_t i = 0; i < count; i++)
+    {
+        item = wf_impl_slist_remove_first(queue);
+        struct wf_message * message = wf_container_of(item, struct wf_message, item);
+
+        batch[position++] = (0 == i) ? '[' : ',';
+        memcpy(&batch[position], message->data, message->length);
+        position += message->length;
+
+        wf_impl_message_dispose(message);
+    }
+    batch[position] = ']';
+
+    if (NULL != size) { *size = length - count - 1; }
+
+    return wf_impl_message_create(batch, length);
+}
@@ -1,16 +1,39 @@
 #ifndef WF_IMPL_MESSAGE_QUEUE_H
 #define WF_IMPL_MESSAGE_QUEUE_H
 
+#ifndef __cplusplus
+#include <stddef.h>
+#else
+#include <cstddef>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
 struct wf_slist;
+struct wf_message;
 
 extern void wf_impl_message_queue_cleanup(
     struct wf_slist * queue);
 
+//------------------------------------------------------------------------------
+/// \brief Removes the next frame to send from the queue.
+///
+/// Subsequent messages are packed into a JSON array (batch), as long as
+/// the batch does not exceed max_size bytes. A single message is taken
+/// as is, even if it exceeds max_size.
+///
+/// \param queue queue of messages
+/// \param max_size maximum size of a batch in bytes
+/// \param size receives the total size of the taken messages (may be NULL)
+/// \return message to send (owned by the caller) or NULL, if queue is empty
+//------------------------------------------------------------------------------
+extern struct wf_message * wf_impl_message_queue_take_batch(
+    struct wf_slist * queue,
+    size_t max_size,
+    size_t * size);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,336 @@
+#include "webfuse/impl/message_scheduler.h"
+#include "webfuse/impl/message_queue.h"
+#include "webfuse/impl/util/slist.h"
+#include "webfuse/impl/util/container_of.h"
+
+#include <libwebsockets.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#define WF_MESSAGE_SCHEDULER_INITIAL_CAPACITY 4
+
+struct wf_message_scheduler_channel
+{
+    void const * source;
+    struct wf_slist queues[WF_MESSAGE_CLASS_COUNT];
+    unsigned int weights[WF_MESSAGE_CLASS_COUNT];
+    size_t count;
+    // class currently served and number of messages it may still send
+    size_t current;
+    unsigned int credit;
+};
+
+struct wf_message_scheduler
+{
+    // channels are allocated individually, since lists must not be moved
+    struct wf_message_scheduler_channel * * channels;
+    size_t channel_count;
+    size_t capacity;
+    size_t current;
+    size_t count;
+    struct wf_message_scheduler_stats stats[WF_MESSAGE_CLASS_COUNT];
+    wf_message_scheduler_taken_fn * taken;
+    void * taken_user_data;
+};
+
+static char const * const wf_message_scheduler_class_names[WF_MESSAGE_CLASS_COUNT] =
+{
+    "metadata",
+    "data",
+    "notification"
+};
+
+static struct wf_message_scheduler_channel *
+wf_impl_message_scheduler_get_channel(
+    struct wf_message_scheduler * scheduler,
+    void const * source)
+{
+    for(size_t i = 0; i < scheduler->channel_count; i++)
+    {
+        if (source == scheduler->channels[i]->source)
+        {
+            return scheduler->channels[i];
+        }
+    }
+
+    return NULL;
+}
+
+static struct wf_message_scheduler_channel *
+wf_impl_message_scheduler_add_channel(
+    struct wf_message_scheduler * scheduler,
+    void const * source)
+{
+    if (scheduler->channel_count >= scheduler->capacity)
+    {
+        scheduler->capacity *= 2;
+        scheduler->channels = realloc(scheduler->channels, sizeof(struct wf_message_scheduler_channel *) * scheduler->capacity);
+    }
+
+    struct wf_message_scheduler_channel * channel = malloc(sizeof(struct wf_message_scheduler_channel));
+    channel->source = source;
+    for(size_t i = 0; i < WF_MESSAGE_CLASS_COUNT; i++)
+    {
+        wf_impl_slist_init(&channel->queues[i]);
+        channel->weights[i] = 1;
+    }
+    channel->count = 0;
+    channel->current = 0;
+    channel->credit = channel->weights[0];
+
+    scheduler->channels[scheduler->channel_count] = channel;
+    scheduler->channel_count++;
+
+    return channel;
+}
+
+// Returns the queue to take the next message from. Empty queues and
+// classes without credit are skipped, so that subsequent calls without
+// taking a message return the same queue.
+static struct wf_slist *
+wf_impl_message_scheduler_select(
+    struct wf_message_scheduler * scheduler,
+    struct wf_message_scheduler_channel * * selected)
+{
+    if (0 == scheduler->count)
+    {
+        return NULL;
+    }
+
+    struct wf_message_scheduler_channel * channel = scheduler->channels[scheduler->current];
+    while (0 == channel->count)
+    {
+        scheduler->current = (scheduler->current + 1) % scheduler->channel_count;
+        channel = scheduler->channels[scheduler->current];
+    }
+
+    struct wf_slist * queue = &channel->queues[channel->current];
+    while ((0 == channel->credit) || (wf_impl_slist_empty(queue)))
+    {
+        channel->current = (channel->current + 1) % WF_MESSAGE_CLASS_COUNT;
+        channel->credit = channel->weights[channel->current];
+        queue = &channel->queues[channel->current];
+    }
+
+    *selected = channel;
+    return queue;
+}
+
+static struct wf_message *
+wf_impl_message_scheduler_peek(
+    struct wf_message_scheduler * scheduler)
+{
+    struct wf_message_scheduler_channel * channel;
+    struct wf_slist * queue = wf_impl_message_scheduler_select(scheduler, &channel);
+
+    return (NULL != queue) ? wf_container_of(wf_impl_slist_first(queue), struct wf_message, item) : NULL;
+}
+
+static void
+wf_impl_message_scheduler_record_delay(
+    struct wf_message_scheduler_stats * stats,
+    uint64_t delay)
+{
+    size_t bucket = 0;
+    while ((bucket < (WF_MESSAGE_SCHEDULER_HISTOGRAM_SIZE - 1)) && ((delay >> bucket) > 0))
+    {
+        bucket++;
+    }
+
+    stats->messages++;
+    stats->total_delay += delay;
+    stats->max_delay = (delay > stats->max_delay) ? delay : stats->max_delay;
+    stats->histogram[bucket]++;
+}
+
+static struct wf_message *
+wf_impl_message_scheduler_take(
+    struct wf_message_scheduler * scheduler)
+{
+    struct wf_message_scheduler_channel * channel;
+    struct wf_slist * queue = wf_impl_message_scheduler_select(scheduler, &channel);
+    if (NULL == queue)
+    {
+        return NULL;
+    }
+
+    struct wf_message * message = wf_container_of(wf_impl_slist_remove_first(queue), struct wf_message, item);
+    channel->credit--;
+    channel->count--;
+    scheduler->count--;
+    scheduler->current = (scheduler->current + 1) % scheduler->channel_count;
+
+    wf_timer_timepoint const now = wf_impl_timer_timepoint_now();
+    uint64_t const delay = (now > message->enqueued) ? (now - message->enqueued) : 0;
+    wf_impl_message_scheduler_record_delay(&scheduler->stats[message->message_class], delay);
+
+    if (NULL != scheduler->taken)
+    {
+        scheduler->taken(scheduler->taken_user_data, message);
+    }
+
+    return message;
+}
+
+struct wf_message_scheduler *
+wf_impl_message_scheduler_create(void)
+{
+    struct wf_message_scheduler * scheduler = malloc(sizeof(struct wf_message_scheduler));
+    scheduler->capacity = WF_MESSAGE_SCHEDULER_INITIAL_CAPACITY;
+    scheduler->channels = malloc(sizeof(struct wf_message_scheduler_channel *) * scheduler->capacity);
+    scheduler->channel_count = 0;
+    scheduler->current = 0;
+    scheduler->count = 0;
+    scheduler->taken = NULL;
+    scheduler->taken_user_data = NULL;
+
+    for(size_t i = 0; i < WF_MESSAGE_CLASS_COUNT; i++)
+    {
+        struct wf_message_scheduler_stats * stats = &scheduler->stats[i];
+        stats->messages = 0;
+        stats->total_delay = 0;
+        stats->max_delay = 0;
+        for(size_t j = 0; j < WF_MESSAGE_SCHEDULER_HISTOGRAM_SIZE; j++)
+        {
+            stats->histogram[j] = 0;
+        }
+    }
+
+    // connection's own messages
+    wf_impl_message_scheduler_add_channel(scheduler, NULL);
+
+    return scheduler;
+}
+
+void
+wf_impl_message_scheduler_dispose(
+    struct wf_message_scheduler * scheduler)
+{
+    for(size_t i = 0; i < scheduler->channel_count; i++)
+    {
+        struct wf_message_scheduler_channel * channel = scheduler->channels[i];
+        for(size_t j = 0; j < WF_MESSAGE_CLASS_COUNT; j++)
+        {
+            wf_impl_message_queue_cleanup(&channel->queues[j]);
+        }
+        free(channel);
+    }
+
+    free(scheduler->channels);
+    free(scheduler);
+}
+
+void
+wf_impl_message_scheduler_set_taken_handler(
+    struct wf_message_scheduler * scheduler,
+    wf_message_scheduler_taken_fn * taken,
+    void * user_data)
+{
+    scheduler->taken = taken;
+    scheduler->taken_user_data = user_data;
+}
+
+void
+wf_impl_message_scheduler_add_source(
+    struct wf_message_scheduler * scheduler,
+    void const * source,
+    unsigned int const weights[WF_MESSAGE_CLASS_COUNT])
+{
+    struct wf_message_scheduler_channel * channel = wf_impl_message_scheduler_get_channel(scheduler, source);
+    if (NULL == channel)
+    {
+        channel = wf_impl_message_scheduler_add_channel(scheduler, source);
+    }
+
+    for(size_t i = 0; i < WF_MESSAGE_CLASS_COUNT; i++)
+    {
+        channel->weights[i] = (0 < weights[i]) ? weights[i] : 1;
+    }
+    channel->credit = channel->weights[channel->current];
+}
+
+void
+wf_impl_message_scheduler_add(
+    struct wf_message_scheduler * scheduler,
+    struct wf_message * message)
+{
+    struct wf_message_scheduler_channel * channel = wf_impl_message_scheduler_get_channel(scheduler, message->source);
+    if (NULL == channel)
+    {
+        channel = scheduler->channels[0];
+    }
+
+    message->enqueued = wf_impl_timer_timepoint_now();
+    wf_impl_slist_append(&channel->queues[message->message_class], &message->item);
+    channel->count++;
+    scheduler->count++;
+}
+
+bool
+wf_impl_message_scheduler_empty(
+    struct wf_message_scheduler * scheduler)
+{
+    return (0 == scheduler->count);
+}
+
+struct wf_message *
+wf_impl_message_scheduler_take_batch(
+    struct wf_message_scheduler * scheduler,
+    size_t max_size,
+    size_t * size)
+{
+    // collect messages in scheduling order, as long as they fit into
+    // a batch (see wf_impl_message_queue_take_batch) and pack them
+    struct wf_slist batch;
+    wf_impl_slist_init(&batch);
+
+    size_t length = 1;
+    struct wf_message * message = wf_impl_message_scheduler_peek(scheduler);
+    while (NULL != message)
+    {
+        if ((!wf_impl_slist_empty(&batch)) && ((length + message->length + 1) > max_size))
+        {
+            break;
+        }
+
+        length += message->length + 1;
+        wf_impl_slist_append(&batch, &wf_impl_message_scheduler_take(scheduler)->item);
+        message = wf_impl_message_scheduler_peek(scheduler);
+    }
+
+    return wf_impl_message_queue_take_batch(&batch, max_size, size);
+}
+
+struct wf_message_scheduler_stats const *
+wf_impl_message_scheduler_get_stats(
+    struct wf_message_scheduler * scheduler,
+    enum wf_message_class message_class)
+{
+    return &scheduler->stats[message_class];
+}
+
+void
+wf_impl_message_scheduler_log_stats(
+    struct wf_message_scheduler * scheduler,
+    char const * name)
+{
+    for(size_t i = 0; i < WF_MESSAGE_CLASS_COUNT; i++)
+    {
+        struct wf_message_scheduler_stats const * stats = &scheduler->stats[i];
+        if (0 < stats->messages)
+        {
+            // buckets are logged up to the largest delay
+            char histogram[(WF_MESSAGE_SCHEDULER_HISTOGRAM_SIZE * 21) + 1];
+            size_t position = 0;
+            for(size_t j = 0; (j < WF_MESSAGE_SCHEDULER_HISTOGRAM_SIZE) && (((uint64_t) 1 << j) <= (2 * stats->max_delay + 1)); j++)
+            {
+                position += (size_t) snprintf(&histogram[position], sizeof(histogram) - position, " %" PRIu64, stats->histogram[j]);
+            }
+            histogram[position] = '\0';
+
+            lwsl_info("%s: %s: %" PRIu64 " messages, queue delay avg %" PRIu64 " ms, max %" PRIu64 " ms, histogram (<1, <2, <4, ... ms):%s\n",
+                name, wf_message_scheduler_class_names[i], stats->messages,
+                stats->total_delay / stats->messages, stats->max_delay, histogram);
+        }
+    }
+}
@@ -0,0 +1,140 @@
+#ifndef WF_IMPL_MESSAGE_SCHEDULER_H
+#define WF_IMPL_MESSAGE_SCHEDULER_H
+
+#include "webfuse/impl/message.h"
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#else
+#include <cstddef>
+#include <cinttypes>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define WF_MESSAGE_SCHEDULER_HISTOGRAM_SIZE 16
+
+//------------------------------------------------------------------------------
+/// \brief Queue delay statistics of a message class.
+///
+/// histogram[0] counts delays below 1 ms, histogram[i] counts delays
+/// within [2^(i-1), 2^i) ms; the last bucket also counts all larger delays.
+//------------------------------------------------------------------------------
+struct wf_message_scheduler_stats
+{
+    uint64_t messages;
+    uint64_t total_delay;
+    uint64_t max_delay;
+    uint64_t histogram[WF_MESSAGE_SCHEDULER_HISTOGRAM_SIZE];
+};
+
+//------------------------------------------------------------------------------
+/// \brief Orders outgoing messages of a connection.
+///
+/// Messages are queued per source (see wf_message) and class. Sources are
+/// served round-robin, one message at a time, so that a busy filesystem
+/// does not delay others. Within a source, classes are served weighted
+/// round-robin: up to weight messages of a class are taken, before the
+/// next class is served. This way, metadata requests are not stuck behind
+/// bulk reads.
+///
+/// Messages of unknown sources are queued with the connection's own
+/// messages (source NULL).
+//------------------------------------------------------------------------------
+struct wf_message_scheduler;
+
+typedef void
+wf_message_scheduler_taken_fn(
+    void * user_data,
+    struct wf_message const * message);
+
+extern struct wf_message_scheduler *
+wf_impl_message_scheduler_create(void);
+
+//------------------------------------------------------------------------------
+/// \brief Disposes the scheduler along with all queued messages.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_message_scheduler_dispose(
+    struct wf_message_scheduler * scheduler);
+
+//------------------------------------------------------------------------------
+/// \brief Registers a source or updates its weights.
+///
+/// \param scheduler pointer to the scheduler
+/// \param source opaque tag of the source
+/// \param weights weight per message class; 0 is treated as 1
+//------------------------------------------------------------------------------
+extern void
+wf_impl_message_scheduler_add_source(
+    struct wf_message_scheduler * scheduler,
+    void const * source,
+    unsigned int const weights[WF_MESSAGE_CLASS_COUNT]);
+
+//------------------------------------------------------------------------------
+/// \brief Sets a function, which is called for each message taken from the
+///        scheduler (before it is packed into a batch).
+///
+/// \param scheduler pointer to the scheduler
+/// \param taken function to call or NULL
+/// \param user_data user data of taken
+//------------------------------------------------------------------------------
+extern void
+wf_impl_message_scheduler_set_taken_handler(
+    struct wf_message_scheduler * scheduler,
+    wf_message_scheduler_taken_fn * taken,
+    void * user_data);
+
+//------------------------------------------------------------------------------
+/// \brief Queues a message (takes ownership).
+//------------------------------------------------------------------------------
+extern void
+wf_impl_message_scheduler_add(
+    struct wf_message_scheduler * scheduler,
+    struct wf_message * message);
+
+extern bool
+wf_impl_message_scheduler_empty(
+    struct wf_message_scheduler * scheduler);
+
+//------------------------------------------------------------------------------
+/// \brief Removes the next frame to send.
+///
+/// Messages are taken in scheduling order and packed into a batch as
+/// described by wf_impl_message_queue_take_batch.
+///
+/// \param scheduler pointer to the scheduler
+/// \param max_size maximum size of a batch in bytes; 0 disables batches
+/// \param size receives the total size of the taken messages (may be NULL)
+/// \return message to send (owned by the caller) or NULL, if no message
+///         is queued
+//------------------------------------------------------------------------------
+extern struct wf_message *
+wf_impl_message_scheduler_take_batch(
+    struct wf_message_scheduler * scheduler,
+    size_t max_size,
+    size_t * size);
+
+extern struct wf_message_scheduler_stats const *
+wf_impl_message_scheduler_get_stats(
+    struct wf_message_scheduler * scheduler,
+    enum wf_message_class message_class);
+
+//------------------------------------------------------------------------------
+/// \brief Logs queue delays per message class.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_message_scheduler_log_stats(
+    struct wf_message_scheduler * scheduler,
+    char const * name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
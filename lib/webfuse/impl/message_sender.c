@@ -0,0 +1,152 @@
+#include "webfuse/impl/message_sender.h"
+#include "webfuse/impl/message_scheduler.h"
+#include "webfuse/impl/message.h"
+#include "webfuse/impl/timer/timepoint.h"
+
+#include <libwebsockets.h>
+#include <stddef.h>
+
+void
+wf_impl_message_sender_init(
+    struct wf_message_sender * sender,
+    size_t fragment_size)
+{
+    sender->current = NULL;
+    sender->offset = 0;
+    sender->fragment_size = fragment_size;
+    sender->queued_bytes = 0;
+
+    sender->stats.messages = 0;
+    sender->stats.frames = 0;
+    sender->stats.bytes = 0;
+    sender->stats.writable_callbacks = 0;
+    sender->stats.choked = 0;
+    sender->stats.first_write = 0;
+    sender->stats.last_write = 0;
+}
+
+void
+wf_impl_message_sender_cleanup(
+    struct wf_message_sender * sender)
+{
+    if (NULL != sender->current)
+    {
+        wf_impl_message_dispose(sender->current);
+        sender->current = NULL;
+    }
+
+    sender->queued_bytes = 0;
+}
+
+void
+wf_impl_message_sender_enqueue(
+    struct wf_message_sender * sender,
+    struct wf_message_scheduler * scheduler,
+    struct wf_message * message)
+{
+    wf_impl_message_scheduler_add(scheduler, message);
+    sender->queued_bytes += message->length;
+}
+
+static void
+wf_impl_message_sender_unqueue(
+    struct wf_message_sender * sender,
+    size_t size)
+{
+    // messages added to the scheduler directly are not accounted
+    sender->queued_bytes -= (size < sender->queued_bytes) ? size : sender->queued_bytes;
+}
+
+bool
+wf_impl_message_sender_write(
+    struct wf_message_sender * sender,
+    struct wf_message_scheduler * scheduler,
+    struct lws * wsi,
+    size_t batch_size)
+{
+    sender->stats.writable_callbacks++;
+
+    bool result = true;
+    while (result)
+    {
+        if (NULL == sender->current)
+        {
+            size_t size = 0;
+            sender->current = wf_impl_message_scheduler_take_batch(scheduler, batch_size, &size);
+            sender->offset = 0;
+            if (NULL == sender->current)
+            {
+                break;
+            }
+
+            // a batch is accounted by its own size until it is written
+            wf_impl_message_sender_unqueue(sender, size);
+            sender->queued_bytes += sender->current->length;
+        }
+
+        if (lws_send_pipe_choked(wsi))
+        {
+            sender->stats.choked++;
+            break;
+        }
+
+        struct wf_message * message = sender->current;
+        size_t const remaining = message->length - sender->offset;
+        size_t const length = ((0 < sender->fragment_size) && (sender->fragment_size < remaining)) ? sender->fragment_size : remaining;
+        bool const is_final = (length == remaining);
+
+        int protocol = (0 == sender->offset) ? LWS_WRITE_TEXT : LWS_WRITE_CONTINUATION;
+        if (!is_final)
+        {
+            protocol |= LWS_WRITE_NO_FIN;
+        }
+
+        // LWS_PRE bytes in front of a fragment belong to data already sent,
+        // so lws may use them for the frame header; a partially sent frame
+        // is buffered by lws, which reports the pipe as choked meanwhile
+        int const written = lws_write(wsi, (unsigned char *) &message->data[sender->offset], length, (enum lws_write_protocol) protocol);
+        if (0 > written)
+        {
+            result = false;
+            break;
+        }
+
+        wf_timer_timepoint const now = wf_impl_timer_timepoint_now();
+        if (0 == sender->stats.frames)
+        {
+            sender->stats.first_write = now;
+        }
+        sender->stats.last_write = now;
+        sender->stats.frames++;
+        sender->stats.bytes += length;
+        sender->offset += length;
+        wf_impl_message_sender_unqueue(sender, length);
+
+        if (is_final)
+        {
+            sender->stats.messages++;
+            wf_impl_message_dispose(message);
+            sender->current = NULL;
+        }
+    }
+
+    if ((result) && ((NULL != sender->current) || (!wf_impl_message_scheduler_empty(scheduler))))
+    {
+        lws_callback_on_writable(wsi);
+    }
+
+    return result;
+}
+
+void
+wf_impl_message_sender_log_stats(
+    struct wf_message_sender const * sender,
+    char const * name)
+{
+    struct wf_message_sender_stats const * stats = &sender->stats;
+    uint64_t const duration = stats->last_write - stats->first_write;
+    uint64_t const throughput = (0 < duration) ? ((stats->bytes * 1000) / duration) : stats->bytes;
+
+    lwsl_info("%s: sent %" PRIu64 " bytes in %" PRIu64 " messages (%" PRIu64 " frames, %" PRIu64 " writable callbacks, %" PRIu64 " choked), %" PRIu64 " bytes/s\n",
+        name, stats->bytes, stats->messages, stats->frames, stats->writable_callbacks, stats->choked, throughput);
+}
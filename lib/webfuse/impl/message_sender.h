@@ -0,0 +1,104 @@
+#ifndef WF_IMPL_MESSAGE_SENDER_H
+#define WF_IMPL_MESSAGE_SENDER_H
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#include <stddef.h>
+#include <inttypes.h>
+#else
+#include <cstddef>
+#include <cinttypes>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct wf_message_scheduler;
+struct wf_message;
+struct lws;
+
+struct wf_message_sender_stats
+{
+    uint64_t messages;
+    uint64_t frames;
+    uint64_t bytes;
+    uint64_t writable_callbacks;
+    uint64_t choked;
+    // monotonic time of first and last write in milliseconds
+    uint64_t first_write;
+    uint64_t last_write;
+};
+
+//------------------------------------------------------------------------------
+/// \brief Writes queued messages to a WebSocket connection.
+///
+/// Each writable callback drains the queue as long as the connection
+/// accepts data (see lws_send_pipe_choked). Messages larger than the
+/// fragment size are split into continuation frames; a partially sent
+/// message is continued on the next writable callback.
+///
+/// Messages added by wf_impl_message_sender_enqueue are accounted in
+/// queued_bytes until they are written.
+//------------------------------------------------------------------------------
+struct wf_message_sender
+{
+    struct wf_message * current;
+    size_t offset;
+    size_t fragment_size;
+    size_t queued_bytes;
+    struct wf_message_sender_stats stats;
+};
+
+extern void
+wf_impl_message_sender_init(
+    struct wf_message_sender * sender,
+    size_t fragment_size);
+
+extern void
+wf_impl_message_sender_cleanup(
+    struct wf_message_sender * sender);
+
+//------------------------------------------------------------------------------
+/// \brief Queues a message and accounts its size.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_message_sender_enqueue(
+    struct wf_message_sender * sender,
+    struct wf_message_scheduler * scheduler,
+    struct wf_message * message);
+
+//------------------------------------------------------------------------------
+/// \brief Writes queued messages until the queue is empty or the
+///        connection is choked.
+///
+/// Another writable callback is requested, if messages remain.
+///
+/// \param sender pointer to the sender
+/// \param scheduler queued messages to send
+/// \param wsi connection to write to
+/// \param batch_size maximum size of a batch (see
+///                   wf_impl_message_scheduler_take_batch); 0 disables batches
+/// \return true on success, false if the connection failed
+//------------------------------------------------------------------------------
+extern bool
+wf_impl_message_sender_write(
+    struct wf_message_sender * sender,
+    struct wf_message_scheduler * scheduler,
+    struct lws * wsi,
+    size_t batch_size);
+
+//------------------------------------------------------------------------------
+/// \brief Logs message and byte counts as well as the send throughput.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_message_sender_log_stats(
+    struct wf_message_sender const * sender,
+    char const * name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,6 +4,21 @@
 #include <string.h>
 
 #define WF_MOUNTOPTIONS_INITIAL_CAPACITY 8
+#define WF_ATTR_CACHE_DEFAULT_TIMEOUT (1000)
+#define WF_ATTR_CACHE_DEFAULT_NEGATIVE_TIMEOUT (0)
+#define WF_ATTR_CACHE_DEFAULT_MAX_SIZE (4 * 1024 * 1024)
+#define WF_READAHEAD_DEFAULT_SIZE (256 * 1024)
+#define WF_READ_CHUNK_DEFAULT_SIZE (256 * 1024)
+#define WF_KERNEL_CACHE_DEFAULT_TIMEOUT (1000)
+#define WF_FUSE_DEFAULT_MAX_BACKGROUND (64)
+#define WF_FUSE_DEFAULT_CONGESTION_THRESHOLD (48)
+#define WF_FLOW_CONTROL_DEFAULT_MAX_IN_FLIGHT (1024)
+#define WF_FLOW_CONTROL_DEFAULT_MAX_QUEUED_BYTES (4 * 1024 * 1024)
+#define WF_MESSAGE_DEFAULT_METADATA_WEIGHT (4)
+#define WF_MESSAGE_DEFAULT_DATA_WEIGHT (1)
+#define WF_MESSAGE_DEFAULT_NOTIFICATION_WEIGHT (1)
+#define WF_REQUEST_DEFAULT_MIN_TIMEOUT (10 * 1000)
+#define WF_REQUEST_DEFAULT_MAX_TIMEOUT (60 * 1000)
 
 struct wf_mountpoint *
 wf_impl_mountpoint_create(
@@ -18,6 +33,23 @@ wf_impl_mountpoint_create(
     mountpoint->options.items = malloc(sizeof(char*) * mountpoint->options.capacity);
     mountpoint->options.items[0] = strdup("");
     mountpoint->options.items[1] = NULL;
+    mountpoint->attr_cache.timeout = WF_ATTR_CACHE_DEFAULT_TIMEOUT;
+    mountpoint->attr_cache.negative_timeout = WF_ATTR_CACHE_DEFAULT_NEGATIVE_TIMEOUT;
+    mountpoint->attr_cache.max_size = WF_ATTR_CACHE_DEFAULT_MAX_SIZE;
+    mountpoint->readahead = WF_READAHEAD_DEFAULT_SIZE;
+    mountpoint->read_chunk_size = WF_READ_CHUNK_DEFAULT_SIZE;
+    mountpoint->kernel_cache_timeout = WF_KERNEL_CACHE_DEFAULT_TIMEOUT;
+    mountpoint->fuse.capabilities = WF_FUSE_CAP_DEFAULT;
+    mountpoint->fuse.max_readahead = 0;
+    mountpoint->fuse.max_background = WF_FUSE_DEFAULT_MAX_BACKGROUND;
+    mountpoint->fuse.congestion_threshold = WF_FUSE_DEFAULT_CONGESTION_THRESHOLD;
+    mountpoint->flow_control.max_in_flight = WF_FLOW_CONTROL_DEFAULT_MAX_IN_FLIGHT;
+    mountpoint->flow_control.max_queued_bytes = WF_FLOW_CONTROL_DEFAULT_MAX_QUEUED_BYTES;
+    mountpoint->message_weights[WF_MESSAGE_CLASS_METADATA] = WF_MESSAGE_DEFAULT_METADATA_WEIGHT;
+    mountpoint->message_weights[WF_MESSAGE_CLASS_DATA] = WF_MESSAGE_DEFAULT_DATA_WEIGHT;
+    mountpoint->message_weights[WF_MESSAGE_CLASS_NOTIFICATION] = WF_MESSAGE_DEFAULT_NOTIFICATION_WEIGHT;
+    mountpoint->request_timeout.min_timeout = WF_REQUEST_DEFAULT_MIN_TIMEOUT;
+    mountpoint->request_timeout.max_timeout = WF_REQUEST_DEFAULT_MAX_TIMEOUT;
 
     return mountpoint;
 }
@@ -74,3 +106,91 @@ wf_impl_mountpoint_add_mountoption(
     mountpoint->options.items[mountpoint->options.size + 1] = NULL;
     mountpoint->options.size++;
 }
+
+void
+wf_impl_mountpoint_set_attr_cache(
+    struct wf_mountpoint * mountpoint,
+    int timeout_ms,
+    int negative_timeout_ms,
+    size_t max_size)
+{
+    mountpoint->attr_cache.timeout = timeout_ms;
+    mountpoint->attr_cache.negative_timeout = negative_timeout_ms;
+    mountpoint->attr_cache.max_size = max_size;
+}
+
+void
+wf_impl_mountpoint_set_readahead(
+    struct wf_mountpoint * mountpoint,
+    size_t size)
+{
+    mountpoint->readahead = size;
+}
+
+void
+wf_impl_mountpoint_set_read_chunk_size(
+    struct wf_mountpoint * mountpoint,
+    size_t size)
+{
+    mountpoint->read_chunk_size = size;
+}
+
+void
+wf_impl_mountpoint_set_kernel_cache_timeout(
+    struct wf_mountpoint * mountpoint,
+    int timeout_ms)
+{
+    mountpoint->kernel_cache_timeout = timeout_ms;
+}
+
+void
+wf_impl_mountpoint_set_fuse_capabilities(
+    struct wf_mountpoint * mountpoint,
+    int capabilities)
+{
+    mountpoint->fuse.capabilities = capabilities;
+}
+
+void
+wf_impl_mountpoint_set_fuse_limits(
+    struct wf_mountpoint * mountpoint,
+    unsigned int max_readahead,
+    unsigned int max_background,
+    unsigned int congestion_threshold)
+{
+    mountpoint->fuse.max_readahead = max_readahead;
+    mountpoint->fuse.max_background = max_background;
+    mountpoint->fuse.congestion_threshold = congestion_threshold;
+}
+
+void
+wf_impl_mountpoint_set_flow_control(
+    struct wf_mountpoint * mountpoint,
+    size_t max_in_flight,
+    size_t max_queued_bytes)
+{
+    mountpoint->flow_control.max_in_flight = max_in_flight;
+    mountpoint->flow_control.max_queued_bytes = max_queued_bytes;
+}
+
+void
+wf_impl_mountpoint_set_message_weights(
+    struct wf_mountpoint * mountpoint,
+    unsigned int metadata,
+    unsigned int data,
+    unsigned int notification)
+{
+    mountpoint->message_weights[WF_MESSAGE_CLASS_METADATA] = metadata;
+    mountpoint->message_weights[WF_MESSAGE_CLASS_DATA] = data;
+    mountpoint->message_weights[WF_MESSAGE_CLASS_NOTIFICATION] = notification;
+}
+
+void
+wf_impl_mountpoint_set_request_timeout(
+    struct wf_mountpoint * mountpoint,
+    int min_timeout_ms,
+    int max_timeout_ms)
+{
+    mountpoint->request_timeout.min_timeout = min_timeout_ms;
+    mountpoint->request_timeout.max_timeout = max_timeout_ms;
+}
@@ -2,6 +2,7 @@
 #define WF_IMPL_MOUNTPOINT_H
 
 #include "webfuse/mountpoint.h"
+#include "webfuse/impl/message.h"
 
 #ifndef __cplusplus
 #include <stddef.h>
@@ -21,12 +22,48 @@ struct wf_mountoptions
     size_t capacity;
 };
 
+struct wf_mountpoint_attr_cache_options
+{
+    int timeout;
+    int negative_timeout;
+    size_t max_size;
+};
+
+struct wf_mountpoint_fuse_options
+{
+    int capabilities;
+    unsigned int max_readahead;
+    unsigned int max_background;
+    unsigned int congestion_threshold;
+};
+
+struct wf_mountpoint_flow_control_options
+{
+    size_t max_in_flight;
+    size_t max_queued_bytes;
+};
+
+struct wf_mountpoint_request_timeout_options
+{
+    int min_timeout;
+    int max_timeout;
+};
+
 struct wf_mountpoint
 {
     char * path;
     void * user_data;
     wf_mountpoint_userdata_dispose_fn * dispose;
     struct wf_mountoptions options;
+    struct wf_mountpoint_attr_cache_options attr_cache;
+    size_t readahead;
+    size_t read_chunk_size;
+    int kernel_cache_timeout;
+    struct wf_mountpoint_fuse_options fuse;
+    struct wf_mountpoint_flow_control_options flow_control;
+    // indexed by wf_message_class
+    unsigned int message_weights[WF_MESSAGE_CLASS_COUNT];
+    struct wf_mountpoint_request_timeout_options request_timeout;
 };
 
 extern struct wf_mountpoint *
@@ -52,6 +89,59 @@ wf_impl_mountpoint_add_mountoption(
     struct wf_mountpoint * mountpoint,
     char const * option);
 
+extern void
+wf_impl_mountpoint_set_attr_cache(
+    struct wf_mountpoint * mountpoint,
+    int timeout_ms,
+    int negative_timeout_ms,
+    size_t max_size);
+
+extern void
+wf_impl_mountpoint_set_readahead(
+    struct wf_mountpoint * mountpoint,
+    size_t size);
+
+extern void
+wf_impl_mountpoint_set_read_chunk_size(
+    struct wf_mountpoint * mountpoint,
+    size_t size);
+
+extern void
+wf_impl_mountpoint_set_kernel_cache_timeout(
+    struct wf_mountpoint * mountpoint,
+    int timeout_ms);
+
+extern void
+wf_impl_mountpoint_set_fuse_capabilities(
+    struct wf_mountpoint * mountpoint,
+    int capabilities);
+
+extern void
+wf_impl_mountpoint_set_fuse_limits(
+    struct wf_mountpoint * mountpoint,
+    unsigned int max_readahead,
+    unsigned int max_background,
+    unsigned int congestion_threshold);
+
+extern void
+wf_impl_mountpoint_set_flow_control(
+    struct wf_mountpoint * mountpoint,
+    size_t max_in_flight,
+    size_t max_queued_bytes);
+
+extern void
+wf_impl_mountpoint_set_message_weights(
+    struct wf_mountpoint * mountpoint,
+    unsigned int metadata,
+    unsigned int data,
+    unsigned int notification);
+
+extern void
+wf_impl_mountpoint_set_request_timeout(
+    struct wf_mountpoint * mountpoint,
+    int min_timeout_ms,
+    int max_timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif
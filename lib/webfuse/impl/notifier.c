@@ -0,0 +1,169 @@
+#include "webfuse/impl/notifier.h"
+#include "webfuse/impl/util/slist.h"
+#include "webfuse/impl/util/container_of.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum wf_impl_notification_type
+{
+    WF_IMPL_NOTIFICATION_INVAL_INODE,
+    WF_IMPL_NOTIFICATION_INVAL_ENTRY
+};
+
+struct wf_impl_notification
+{
+    struct wf_slist_item item;
+    enum wf_impl_notification_type type;
+    fuse_ino_t inode;
+    off_t offset;
+    off_t length;
+    char * name;
+};
+
+struct wf_impl_notifier
+{
+    struct fuse_session * session;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct wf_slist notifications;
+    bool is_shutdown_requested;
+};
+
+static void
+wf_impl_notifier_deliver(
+    struct wf_impl_notifier * notifier,
+    struct wf_impl_notification * notification)
+{
+    switch (notification->type)
+    {
+        case WF_IMPL_NOTIFICATION_INVAL_INODE:
+            fuse_lowlevel_notify_inval_inode(notifier->session, notification->inode,
+                notification->offset, notification->length);
+            break;
+        case WF_IMPL_NOTIFICATION_INVAL_ENTRY:
+            fuse_lowlevel_notify_inval_entry(notifier->session, notification->inode,
+                notification->name, strlen(notification->name));
+            break;
+        default:
+            break;
+    }
+
+    free(notification->name);
+    free(notification);
+}
+
+static void *
+wf_impl_notifier_run(
+    void * arg)
+{
+    struct wf_impl_notifier * notifier = arg;
+
+    pthread_mutex_lock(&notifier->lock);
+    while (true)
+    {
+        while ((!notifier->is_shutdown_requested) && (wf_impl_slist_empty(&notifier->notifications)))
+        {
+            pthread_cond_wait(&notifier->cond, &notifier->lock);
+        }
+
+        struct wf_slist_item * item = wf_impl_slist_remove_first(&notifier->notifications);
+        if (NULL == item)
+        {
+            // shutdown requested and no pending notifications left
+            break;
+        }
+
+        pthread_mutex_unlock(&notifier->lock);
+        wf_impl_notifier_deliver(notifier, wf_container_of(item, struct wf_impl_notification, item));
+        pthread_mutex_lock(&notifier->lock);
+    }
+    pthread_mutex_unlock(&notifier->lock);
+
+    return NULL;
+}
+
+static void
+wf_impl_notifier_add(
+    struct wf_impl_notifier * notifier,
+    struct wf_impl_notification * notification)
+{
+    pthread_mutex_lock(&notifier->lock);
+    wf_impl_slist_append(&notifier->notifications, &notification->item);
+    pthread_cond_signal(&notifier->cond);
+    pthread_mutex_unlock(&notifier->lock);
+}
+
+struct wf_impl_notifier *
+wf_impl_notifier_create(
+    struct fuse_session * session)
+{
+    struct wf_impl_notifier * notifier = malloc(sizeof(struct wf_impl_notifier));
+    notifier->session = session;
+    notifier->is_shutdown_requested = false;
+    wf_impl_slist_init(&notifier->notifications);
+    pthread_mutex_init(&notifier->lock, NULL);
+    pthread_cond_init(&notifier->cond, NULL);
+
+    if (0 != pthread_create(&notifier->thread, NULL, &wf_impl_notifier_run, notifier))
+    {
+        pthread_cond_destroy(&notifier->cond);
+        pthread_mutex_destroy(&notifier->lock);
+        free(notifier);
+        notifier = NULL;
+    }
+
+    return notifier;
+}
+
+void
+wf_impl_notifier_dispose(
+    struct wf_impl_notifier * notifier)
+{
+    pthread_mutex_lock(&notifier->lock);
+    notifier->is_shutdown_requested = true;
+    pthread_cond_signal(&notifier->cond);
+    pthread_mutex_unlock(&notifier->lock);
+
+    pthread_join(notifier->thread, NULL);
+
+    pthread_cond_destroy(&notifier->cond);
+    pthread_mutex_destroy(&notifier->lock);
+    free(notifier);
+}
+
+void
+wf_impl_notifier_inval_inode(
+    struct wf_impl_notifier * notifier,
+    fuse_ino_t inode,
+    off_t offset,
+    off_t length)
+{
+    struct wf_impl_notification * notification = malloc(sizeof(struct wf_impl_notification));
+    notification->type = WF_IMPL_NOTIFICATION_INVAL_INODE;
+    notification->inode = inode;
+    notification->offset = offset;
+    notification->length = length;
+    notification->name = NULL;
+
+    wf_impl_notifier_add(notifier, notification);
+}
+
+void
+wf_impl_notifier_inval_entry(
+    struct wf_impl_notifier * notifier,
+    fuse_ino_t parent,
+    char const * name)
+{
+    struct wf_impl_notification * notification = malloc(sizeof(struct wf_impl_notification));
+    notification->type = WF_IMPL_NOTIFICATION_INVAL_ENTRY;
+    notification->inode = parent;
+    notification->offset = 0;
+    notification->length = 0;
+    notification->name = strdup(name);
+
+    wf_impl_notifier_add(notifier, notification);
+}
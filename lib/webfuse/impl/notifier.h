@@ -0,0 +1,60 @@
+#ifndef WF_ADAPTER_IMPL_NOTIFIER_H
+#define WF_ADAPTER_IMPL_NOTIFIER_H
+
+#include "webfuse/impl/fuse_wrapper.h"
+
+#ifndef __cplusplus
+#include <stddef.h>
+#else
+#include <cstddef>
+#endif
+
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//------------------------------------------------------------------------------
+/// \brief Delivers invalidation notifications to the kernel.
+///
+/// fuse_lowlevel_notify_inval_inode and fuse_lowlevel_notify_inval_entry
+/// may block until pending requests of the same filesystem are answered.
+/// Since requests are answered by the thread which receives notifications
+/// from the provider, notifications are delivered by a separate thread.
+//------------------------------------------------------------------------------
+struct wf_impl_notifier;
+
+extern struct wf_impl_notifier *
+wf_impl_notifier_create(
+    struct fuse_session * session);
+
+//------------------------------------------------------------------------------
+/// \brief Disposes the notifier.
+///
+/// Pending notifications are delivered before the notifier stops,
+/// so the fuse session must still be mounted.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_notifier_dispose(
+    struct wf_impl_notifier * notifier);
+
+extern void
+wf_impl_notifier_inval_inode(
+    struct wf_impl_notifier * notifier,
+    fuse_ino_t inode,
+    off_t offset,
+    off_t length);
+
+extern void
+wf_impl_notifier_inval_entry(
+    struct wf_impl_notifier * notifier,
+    fuse_ino_t parent,
+    char const * name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,8 +1,11 @@
 #include "webfuse/impl/operation/close.h"
 #include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/operation/readahead.h"
+#include "webfuse/impl/inode_table.h"
 
-#include <limits.h>
 #include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "webfuse/impl/jsonrpc/proxy.h"
 
@@ -14,11 +17,18 @@ void wf_impl_operation_close(
     struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
     struct wf_jsonrpc_proxy * rpc = wf_impl_operation_context_get_proxy(user_data);
 
-	if (NULL != rpc)
+	struct wf_impl_readahead * readahead = (struct wf_impl_readahead *) (uintptr_t) file_info->fh;
+	if (NULL != readahead)
 	{
-		int handle = (int) (file_info->fh & INT_MAX);
-		wf_impl_jsonrpc_proxy_notify(rpc, "close", "siii", user_data->name, inode, handle, file_info->flags);
+		uint64_t id;
+		if ((NULL != rpc) && (wf_impl_inode_table_get_id(user_data->inodes, inode, &id)))
+		{
+			wf_impl_jsonrpc_proxy_notify(rpc, "close", "sIii", user_data->name, (int64_t) id, readahead->handle, file_info->flags);
+		}
+
+		wf_impl_readahead_release(readahead);
+		file_info->fh = 0;
 	}
-	
+
 	fuse_reply_err(request, 0);
 }
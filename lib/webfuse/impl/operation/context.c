@@ -8,3 +8,9 @@ struct wf_jsonrpc_proxy * wf_impl_operation_context_get_proxy(
 {
     return context->proxy;
 }
+
+struct wf_jsonrpc_proxy * wf_impl_operation_context_get_data_proxy(
+	struct wf_impl_operation_context * context)
+{
+    return context->data_proxy;
+}
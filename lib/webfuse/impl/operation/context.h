@@ -3,22 +3,50 @@
 
 #include "webfuse/impl/fuse_wrapper.h"
 
+#ifndef __cplusplus
+#include <stddef.h>
+#else
+#include <cstddef>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct wf_jsonrpc_proxy;
+struct wf_impl_attr_cache;
+struct wf_impl_singleflight;
+struct wf_impl_inode_table;
+struct wf_impl_readahead;
+struct wf_mountpoint_fuse_options;
 
 struct wf_impl_operation_context
 {
 	struct wf_jsonrpc_proxy * proxy;
+	struct wf_jsonrpc_proxy * data_proxy;
 	double timeout;
 	char * name;
+	struct wf_impl_attr_cache * cache;
+	struct wf_impl_singleflight * singleflight;
+	struct wf_impl_inode_table * inodes;
+	size_t readahead;
+	size_t read_chunk_size;
+	struct wf_impl_readahead * open_files;
+	struct wf_mountpoint_fuse_options const * fuse_options;
 };
 
 extern struct wf_jsonrpc_proxy * wf_impl_operation_context_get_proxy(
 	struct wf_impl_operation_context * context);
 
+//------------------------------------------------------------------------------
+/// \brief Returns the proxy used to transfer file contents.
+///
+/// Requests sent by the data proxy are scheduled separately, so that
+/// they do not delay metadata requests (see message_scheduler.h).
+//------------------------------------------------------------------------------
+extern struct wf_jsonrpc_proxy * wf_impl_operation_context_get_data_proxy(
+	struct wf_impl_operation_context * context);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,217 @@
+#include "webfuse/impl/operation/dirbuffer.h"
+#include "webfuse/impl/inode_table.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define WF_DIRBUFFER_INITIAL_COUNT 16
+#define WF_DIRBUFFER_INITIAL_NAMES_SIZE 1024
+
+struct wf_impl_dirbuffer *
+wf_impl_dirbuffer_create(void)
+{
+	struct wf_impl_dirbuffer * buffer = malloc(sizeof(struct wf_impl_dirbuffer));
+	wf_impl_dirbuffer_init(buffer);
+
+	return buffer;
+}
+
+void
+wf_impl_dirbuffer_dispose(
+	struct wf_impl_dirbuffer * buffer)
+{
+	wf_impl_dirbuffer_cleanup(buffer);
+	free(buffer);
+}
+
+void
+wf_impl_dirbuffer_init(
+	struct wf_impl_dirbuffer * buffer)
+{
+	buffer->entries = malloc(WF_DIRBUFFER_INITIAL_COUNT * sizeof(struct wf_impl_dirbuffer_entry));
+	buffer->count = 0;
+	buffer->capacity = WF_DIRBUFFER_INITIAL_COUNT;
+	buffer->names = malloc(WF_DIRBUFFER_INITIAL_NAMES_SIZE);
+	buffer->names_size = 0;
+	buffer->names_capacity = WF_DIRBUFFER_INITIAL_NAMES_SIZE;
+}
+
+void
+wf_impl_dirbuffer_cleanup(
+	struct wf_impl_dirbuffer * buffer)
+{
+	free(buffer->entries);
+	free(buffer->names);
+}
+
+void
+wf_impl_dirbuffer_clear(
+	struct wf_impl_dirbuffer * buffer)
+{
+	buffer->count = 0;
+	buffer->names_size = 0;
+}
+
+static struct wf_impl_dirbuffer_entry *
+wf_impl_dirbuffer_add_entry(
+	struct wf_impl_dirbuffer * buffer,
+	char const * name)
+{
+	if (buffer->count >= buffer->capacity)
+	{
+		buffer->capacity *= 2;
+		buffer->entries = realloc(buffer->entries, buffer->capacity * sizeof(struct wf_impl_dirbuffer_entry));
+	}
+
+	size_t const name_size = strlen(name) + 1;
+	while ((buffer->names_capacity - buffer->names_size) < name_size)
+	{
+		buffer->names_capacity *= 2;
+		buffer->names = realloc(buffer->names, buffer->names_capacity);
+	}
+
+	struct wf_impl_dirbuffer_entry * entry = &buffer->entries[buffer->count];
+	entry->name_offset = buffer->names_size;
+	memcpy(&buffer->names[buffer->names_size], name, name_size);
+	buffer->names_size += name_size;
+	buffer->count++;
+
+	return entry;
+}
+
+void
+wf_impl_dirbuffer_add(
+	struct wf_impl_dirbuffer * buffer,
+	char const * name,
+	fuse_ino_t inode)
+{
+	struct wf_impl_dirbuffer_entry * entry = wf_impl_dirbuffer_add_entry(buffer, name);
+	memset(&entry->attr, 0, sizeof(struct stat));
+	entry->attr.st_ino = inode;
+	entry->has_attr = false;
+}
+
+void
+wf_impl_dirbuffer_add_plus(
+	struct wf_impl_dirbuffer * buffer,
+	char const * name,
+	struct stat const * attr)
+{
+	struct wf_impl_dirbuffer_entry * entry = wf_impl_dirbuffer_add_entry(buffer, name);
+	memcpy(&entry->attr, attr, sizeof(struct stat));
+	entry->has_attr = true;
+}
+
+// Entries, which are not known to the kernel, have no inode number yet;
+// provider ids must not be reported, since they may equal the kernel inode
+// of another file.
+static ino_t
+wf_impl_dirbuffer_get_inode(
+	struct wf_impl_inode_table * inodes,
+	ino_t id)
+{
+	fuse_ino_t const inode = wf_impl_inode_table_find(inodes, (uint64_t) id);
+	return (0 != inode) ? ((ino_t) inode) : FUSE_UNKNOWN_INO;
+}
+
+static void
+wf_impl_dirbuffer_reply_entries(
+	fuse_req_t request,
+	struct wf_impl_dirbuffer * buffer,
+	size_t size,
+	off_t offset,
+	bool is_plus,
+	double timeout,
+	struct wf_impl_inode_table * inodes)
+{
+	if ((offset < 0) || (((size_t) offset) >= buffer->count))
+	{
+		fuse_reply_buf(request, NULL, 0);
+		return;
+	}
+
+	char * data = malloc(size);
+	size_t position = 0;
+	for(size_t i = (size_t) offset; i < buffer->count; i++)
+	{
+		struct wf_impl_dirbuffer_entry const * entry = &buffer->entries[i];
+		char const * name = &buffer->names[entry->name_offset];
+		size_t const remaining = size - position;
+		size_t entry_size;
+
+		if (is_plus)
+		{
+			// the kernel counts a lookup for each replied entry except "." and "..",
+			// so the inode must only be referenced once the entry is known to fit
+			entry_size = fuse_add_direntry_plus(request, NULL, 0, name, NULL, (off_t) (i + 1));
+			if (entry_size > remaining)
+			{
+				break;
+			}
+
+			struct fuse_entry_param entry_param;
+			memset(&entry_param, 0, sizeof(struct fuse_entry_param));
+			memcpy(&entry_param.attr, &entry->attr, sizeof(struct stat));
+			bool const is_special = (0 == strcmp(".", name)) || (0 == strcmp("..", name));
+			if (is_special)
+			{
+				entry_param.attr.st_ino = wf_impl_dirbuffer_get_inode(inodes, entry->attr.st_ino);
+			}
+			else if (entry->has_attr)
+			{
+				uint64_t generation;
+				entry_param.ino = wf_impl_inode_table_ref(inodes, (uint64_t) entry->attr.st_ino, &generation);
+				entry_param.generation = generation;
+				entry_param.attr.st_ino = entry_param.ino;
+				entry_param.attr_timeout = timeout;
+				entry_param.entry_timeout = timeout;
+			}
+			else
+			{
+				entry_param.attr.st_ino = wf_impl_dirbuffer_get_inode(inodes, entry->attr.st_ino);
+			}
+
+			fuse_add_direntry_plus(request, &data[position], remaining, name, &entry_param, (off_t) (i + 1));
+		}
+		else
+		{
+			struct stat attr;
+			memcpy(&attr, &entry->attr, sizeof(struct stat));
+			attr.st_ino = wf_impl_dirbuffer_get_inode(inodes, entry->attr.st_ino);
+
+			entry_size = fuse_add_direntry(request, &data[position], remaining, name, &attr, (off_t) (i + 1));
+			if (entry_size > remaining)
+			{
+				break;
+			}
+		}
+
+		position += entry_size;
+	}
+
+	fuse_reply_buf(request, data, position);
+	free(data);
+}
+
+void
+wf_impl_dirbuffer_reply(
+	fuse_req_t request,
+	struct wf_impl_dirbuffer * buffer,
+	size_t size,
+	off_t offset,
+	struct wf_impl_inode_table * inodes)
+{
+	wf_impl_dirbuffer_reply_entries(request, buffer, size, offset, false, 0.0, inodes);
+}
+
+void
+wf_impl_dirbuffer_reply_plus(
+	fuse_req_t request,
+	struct wf_impl_dirbuffer * buffer,
+	size_t size,
+	off_t offset,
+	double timeout,
+	struct wf_impl_inode_table * inodes)
+{
+	wf_impl_dirbuffer_reply_entries(request, buffer, size, offset, true, timeout, inodes);
+}
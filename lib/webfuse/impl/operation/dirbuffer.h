@@ -0,0 +1,129 @@
+#ifndef WF_ADAPTER_IMPL_OPERATION_DIRBUFFER_H
+#define WF_ADAPTER_IMPL_OPERATION_DIRBUFFER_H
+
+#include "webfuse/impl/fuse_wrapper.h"
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <stdbool.h>
+#else
+#include <cstddef>
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+// inode number of directory entries unknown to the kernel;
+// same value as used by the high-level libfuse API
+#ifndef FUSE_UNKNOWN_INO
+#define FUSE_UNKNOWN_INO 0xffffffff
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct wf_impl_inode_table;
+
+struct wf_impl_dirbuffer_entry
+{
+	size_t name_offset;
+	struct stat attr;
+	bool has_attr;
+};
+
+//------------------------------------------------------------------------------
+/// \brief Contents of a directory.
+///
+/// Entries are stored once and serialized on reply, either as plain
+/// directory entries (readdir) or with attributes (readdirplus).
+/// The offset of an entry is its index + 1, so both kinds of replies
+/// can be mixed on the same directory handle.
+//------------------------------------------------------------------------------
+struct wf_impl_dirbuffer
+{
+	struct wf_impl_dirbuffer_entry * entries;
+	size_t count;
+	size_t capacity;
+	char * names;
+	size_t names_size;
+	size_t names_capacity;
+};
+
+extern struct wf_impl_dirbuffer *
+wf_impl_dirbuffer_create(void);
+
+extern void
+wf_impl_dirbuffer_dispose(
+	struct wf_impl_dirbuffer * buffer);
+
+extern void
+wf_impl_dirbuffer_init(
+	struct wf_impl_dirbuffer * buffer);
+
+extern void
+wf_impl_dirbuffer_cleanup(
+	struct wf_impl_dirbuffer * buffer);
+
+extern void
+wf_impl_dirbuffer_clear(
+	struct wf_impl_dirbuffer * buffer);
+
+extern void
+wf_impl_dirbuffer_add(
+	struct wf_impl_dirbuffer * buffer,
+	char const * name,
+	fuse_ino_t inode);
+
+//------------------------------------------------------------------------------
+/// \brief Adds an entry with known attributes.
+///
+/// The inode of the entry is taken from attr->st_ino.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_dirbuffer_add_plus(
+	struct wf_impl_dirbuffer * buffer,
+	char const * name,
+	struct stat const * attr);
+
+//------------------------------------------------------------------------------
+/// \brief Replies the entries starting at offset, limited to size bytes.
+///
+/// An empty reply is sent, if offset is beyond the last entry.
+///
+/// \param inodes table to map provider ids to kernel inodes (may be NULL)
+//------------------------------------------------------------------------------
+extern void
+wf_impl_dirbuffer_reply(
+	fuse_req_t request,
+	struct wf_impl_dirbuffer * buffer,
+	size_t size,
+	off_t offset,
+	struct wf_impl_inode_table * inodes);
+
+//------------------------------------------------------------------------------
+/// \brief Replies the entries starting at offset including their attributes.
+///
+/// Entries without known attributes are replied with inode 0, so that
+/// the kernel looks them up on demand. Each other replied entry, except
+/// "." and "..", is referenced in the inode table, since the kernel
+/// counts it as lookup.
+///
+/// \param timeout time in seconds the kernel caches entries and attributes
+/// \param inodes table to map provider ids to kernel inodes (may be NULL)
+//------------------------------------------------------------------------------
+extern void
+wf_impl_dirbuffer_reply_plus(
+	fuse_req_t request,
+	struct wf_impl_dirbuffer * buffer,
+	size_t size,
+	off_t offset,
+	double timeout,
+	struct wf_impl_inode_table * inodes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
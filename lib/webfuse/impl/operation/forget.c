@@ -0,0 +1,46 @@
+#include "webfuse/impl/operation/forget.h"
+#include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/inode_table.h"
+#include "webfuse/impl/attr_cache.h"
+
+#include <stddef.h>
+
+static void wf_impl_operation_forget_inode(
+	struct wf_impl_operation_context * user_data,
+	fuse_ino_t inode,
+	uint64_t nlookup)
+{
+	uint64_t id;
+	if ((NULL != user_data) && (wf_impl_inode_table_forget(user_data->inodes, inode, nlookup, &id)))
+	{
+		if (NULL != user_data->cache)
+		{
+			wf_impl_attr_cache_invalidate_attr(user_data->cache, (fuse_ino_t) id);
+		}
+	}
+}
+
+void wf_impl_operation_forget(
+	fuse_req_t request,
+	fuse_ino_t inode,
+	uint64_t nlookup)
+{
+	struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
+	wf_impl_operation_forget_inode(user_data, inode, nlookup);
+
+	fuse_reply_none(request);
+}
+
+void wf_impl_operation_forget_multi(
+	fuse_req_t request,
+	size_t count,
+	struct fuse_forget_data * forgets)
+{
+	struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
+	for(size_t i = 0; i < count; i++)
+	{
+		wf_impl_operation_forget_inode(user_data, (fuse_ino_t) forgets[i].ino, forgets[i].nlookup);
+	}
+
+	fuse_reply_none(request);
+}
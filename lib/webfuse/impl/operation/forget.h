@@ -0,0 +1,39 @@
+#ifndef WF_ADAPTER_IMPL_OPERATION_FORGET_H
+#define WF_ADAPTER_IMPL_OPERATION_FORGET_H
+
+#include "webfuse/impl/fuse_wrapper.h"
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <stdint.h>
+#else
+#include <cstddef>
+#include <cstdint>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//------------------------------------------------------------------------------
+/// \brief Decrements the lookup count of an inode.
+///
+/// Once the kernel forgot all lookups of an inode, the inode is released
+/// from the inode table and its cached attributes are dropped.
+//------------------------------------------------------------------------------
+extern void wf_impl_operation_forget(
+	fuse_req_t request,
+	fuse_ino_t inode,
+	uint64_t nlookup);
+
+extern void wf_impl_operation_forget_multi(
+	fuse_req_t request,
+	size_t count,
+	struct fuse_forget_data * forgets);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
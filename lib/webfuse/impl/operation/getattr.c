@@ -1,5 +1,8 @@
 #include "webfuse/impl/operation/getattr.h"
 #include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/operation/singleflight.h"
+#include "webfuse/impl/attr_cache.h"
+#include "webfuse/impl/inode_table.h"
 
 #include <errno.h>
 #include <string.h>
@@ -31,7 +34,7 @@ void wf_impl_operation_getattr_finished(
 		{
             memset(&buffer, 0, sizeof(struct stat));
 
-			buffer.st_ino = context->inode;
+			buffer.st_ino = (ino_t) context->id;
 			buffer.st_mode = wf_impl_json_int_get(mode_holder) & 0555;
 			char const * type = wf_impl_json_string_get(type_holder);
 			if (0 == strcmp("file", type)) 
@@ -46,10 +49,10 @@ void wf_impl_operation_getattr_finished(
             buffer.st_uid = context->uid;
             buffer.st_gid = context->gid;
             buffer.st_nlink = 1;
-			buffer.st_size = wf_impl_json_get_int(result, "size", 0);
-			buffer.st_atime = wf_impl_json_get_int(result, "atime", 0);
-			buffer.st_mtime = wf_impl_json_get_int(result, "mtime", 0);
-			buffer.st_ctime = wf_impl_json_get_int(result, "ctime", 0);
+			buffer.st_size = wf_impl_json_get_int64(result, "size", 0);
+			buffer.st_atime = wf_impl_json_get_int64(result, "atime", 0);
+			buffer.st_mtime = wf_impl_json_get_int64(result, "mtime", 0);
+			buffer.st_ctime = wf_impl_json_get_int64(result, "ctime", 0);
 		}
 		else
 		{
@@ -57,8 +60,16 @@ void wf_impl_operation_getattr_finished(
 		}
 	}
 
+    // replies to requests sent before an invalidation are not cached
+    if ((WF_GOOD == status) && (NULL != context->cache) &&
+        (!wf_impl_attr_cache_is_invalidated(context->cache, context->id, context->generation)))
+    {
+        wf_impl_attr_cache_set_attr(context->cache, context->id, &buffer);
+    }
+
     if (WF_GOOD == status)
     {
+        buffer.st_ino = context->inode;
         fuse_reply_attr(context->request, &buffer, context->timeout);
     }
     else
@@ -78,16 +89,51 @@ void wf_impl_operation_getattr (
     struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
     struct wf_jsonrpc_proxy * rpc = wf_impl_operation_context_get_proxy(user_data);
 
-	if (NULL != rpc)
+	uint64_t id = 0;
+	bool const is_known = (NULL != rpc) && (wf_impl_inode_table_get_id(user_data->inodes, inode, &id));
+
+	struct stat attr;
+	bool const is_cached = (is_known) && (NULL != user_data->cache) &&
+		(wf_impl_attr_cache_get_attr(user_data->cache, id, &attr));
+
+	if (is_cached)
+	{
+		attr.st_ino = inode;
+		attr.st_uid = context->uid;
+		attr.st_gid = context->gid;
+		fuse_reply_attr(request, &attr, user_data->timeout);
+	}
+	else if (is_known)
 	{
 		struct wf_impl_operation_getattr_context * getattr_context = malloc(sizeof(struct wf_impl_operation_getattr_context));
 		getattr_context->request = request;
-		getattr_context->inode = inode;		
+		getattr_context->inode = inode;
+		getattr_context->id = id;
 		getattr_context->uid = context->uid;
 		getattr_context->gid = context->gid;
 		getattr_context->timeout = user_data->timeout;
+		getattr_context->cache = user_data->cache;
+		getattr_context->generation = (NULL != user_data->cache) ? wf_impl_attr_cache_get_generation(user_data->cache) : 0;
 
-		wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_getattr_finished, getattr_context, "getattr", "si", user_data->name, inode);
+		if (NULL == user_data->singleflight)
+		{
+			wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_getattr_finished, getattr_context, "getattr", "sI", user_data->name, (int64_t) id);
+		}
+		else
+		{
+			struct wf_impl_singleflight_call * call = wf_impl_singleflight_add(user_data->singleflight,
+				"getattr", id, NULL, &wf_impl_operation_getattr_finished, getattr_context);
+			if (NULL != call)
+			{
+				wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_singleflight_finished, call, "getattr", "sI", user_data->name, (int64_t) id);
+			}
+			else
+			{
+				// the reply may predate the recorded generation;
+				// it is cached by the request, which was sent
+				getattr_context->cache = NULL;
+			}
+		}
 	}
 	else
 	{
@@ -5,6 +5,12 @@
 
 #include <sys/types.h>
 
+#ifndef __cplusplus
+#include <stdint.h>
+#else
+#include <cstdint>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -12,14 +18,19 @@ extern "C"
 
 struct wf_jsonrpc_error;
 struct wf_json;
+struct wf_impl_attr_cache;
 
 struct wf_impl_operation_getattr_context
 {
 	fuse_req_t request;
 	fuse_ino_t inode;
+	uint64_t id;
 	double timeout;
 	uid_t uid;
 	gid_t gid;
+	struct wf_impl_attr_cache * cache;
+	// invalidation generation of the cache when the request was sent
+	uint64_t generation;
 };
 
 extern void wf_impl_operation_getattr_finished(
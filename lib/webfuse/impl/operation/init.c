@@ -0,0 +1,94 @@
+#include "webfuse/impl/operation/init.h"
+#include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/mountpoint.h"
+
+#include <libwebsockets.h>
+#include <stddef.h>
+
+struct wf_impl_operation_init_capability
+{
+	int flag;
+	unsigned int fuse_caps;
+	char const * name;
+};
+
+// Splice read is not offered: the adapter is read-only, so requests
+// are small and splicing them would only add a pipe round trip.
+static struct wf_impl_operation_init_capability const wf_impl_operation_init_capabilities[] =
+{
+	{WF_FUSE_CAP_ASYNC_READ, FUSE_CAP_ASYNC_READ, "async_read"},
+	{WF_FUSE_CAP_PARALLEL_DIROPS, FUSE_CAP_PARALLEL_DIROPS, "parallel_dirops"},
+	{WF_FUSE_CAP_READDIRPLUS, FUSE_CAP_READDIRPLUS, "readdirplus"},
+	{WF_FUSE_CAP_READDIRPLUS_AUTO, FUSE_CAP_READDIRPLUS_AUTO, "readdirplus_auto"},
+	{WF_FUSE_CAP_SPLICE, FUSE_CAP_SPLICE_WRITE | FUSE_CAP_SPLICE_MOVE, "splice"}
+};
+
+#define WF_IMPL_OPERATION_INIT_CAPABILITY_COUNT \
+	(sizeof(wf_impl_operation_init_capabilities) / sizeof(wf_impl_operation_init_capabilities[0]))
+
+static void wf_impl_operation_init_log(
+	struct fuse_conn_info const * conn)
+{
+	char names[256];
+	size_t length = 0;
+	names[0] = '\0';
+
+	for(size_t i = 0; i < WF_IMPL_OPERATION_INIT_CAPABILITY_COUNT; i++)
+	{
+		struct wf_impl_operation_init_capability const * capability = &wf_impl_operation_init_capabilities[i];
+		if ((capability->fuse_caps & conn->want) == capability->fuse_caps)
+		{
+			int count = lws_snprintf(&names[length], sizeof(names) - length, "%s%s",
+				(0 < length) ? " " : "", capability->name);
+			length += (size_t) count;
+		}
+	}
+
+	lwsl_notice("fuse init: protocol %u.%u, capabilities [%s], want 0x%x (capable 0x%x), "
+		"max_readahead %u, max_background %u, congestion_threshold %u\n",
+		conn->proto_major, conn->proto_minor, names, conn->want, conn->capable,
+		conn->max_readahead, conn->max_background, conn->congestion_threshold);
+}
+
+void wf_impl_operation_init(
+	void * user_data,
+	struct fuse_conn_info * conn)
+{
+	struct wf_impl_operation_context * context = user_data;
+	struct wf_mountpoint_fuse_options const * options = (NULL != context) ? context->fuse_options : NULL;
+
+	if (NULL != options)
+	{
+		for(size_t i = 0; i < WF_IMPL_OPERATION_INIT_CAPABILITY_COUNT; i++)
+		{
+			struct wf_impl_operation_init_capability const * capability = &wf_impl_operation_init_capabilities[i];
+			if (0 != (options->capabilities & capability->flag))
+			{
+				conn->want |= (conn->capable & capability->fuse_caps);
+			}
+			else
+			{
+				conn->want &= ~capability->fuse_caps;
+			}
+		}
+
+		// read ahead can only be lowered
+		if ((0 < options->max_readahead) && (options->max_readahead < conn->max_readahead))
+		{
+			conn->max_readahead = options->max_readahead;
+		}
+
+		if (0 < options->max_background)
+		{
+			conn->max_background = options->max_background;
+			conn->congestion_threshold = (0 < options->congestion_threshold) ?
+				options->congestion_threshold : ((options->max_background * 3) / 4);
+		}
+		else if (0 < options->congestion_threshold)
+		{
+			conn->congestion_threshold = options->congestion_threshold;
+		}
+	}
+
+	wf_impl_operation_init_log(conn);
+}
@@ -0,0 +1,30 @@
+#ifndef WF_ADAPTER_IMPL_OPERATION_INIT_H
+#define WF_ADAPTER_IMPL_OPERATION_INIT_H
+
+#include "webfuse/impl/fuse_wrapper.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//------------------------------------------------------------------------------
+/// \brief Negotiates connection capabilities and limits with the kernel.
+///
+/// Capabilities and limits are taken from the fuse options of the
+/// mountpoint (see wf_mountpoint_set_fuse_capabilities and
+/// wf_mountpoint_set_fuse_limits); capabilities not supported by the
+/// kernel are ignored. The negotiated set is logged.
+///
+/// \param user_data operation context
+/// \param conn connection info
+//------------------------------------------------------------------------------
+extern void wf_impl_operation_init(
+	void * user_data,
+	struct fuse_conn_info * conn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,7 +1,9 @@
 #include "webfuse/impl/operation/lookup.h"
 #include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/operation/singleflight.h"
+#include "webfuse/impl/attr_cache.h"
+#include "webfuse/impl/inode_table.h"
 
-#include <limits.h>
 #include <errno.h>
 #include <string.h>
 
@@ -16,6 +18,27 @@
 #include "webfuse/impl/util/json_util.h"
 #include "webfuse/impl/util/util.h"
 
+// attr->st_ino holds the provider id, which is mapped to a kernel inode
+static void wf_impl_operation_lookup_reply(
+	fuse_req_t request,
+	struct stat const * attr,
+	double timeout,
+	struct wf_impl_inode_table * inodes)
+{
+    struct fuse_entry_param buffer;
+	memset(&buffer, 0, sizeof(struct fuse_entry_param));
+
+	uint64_t generation;
+	buffer.ino = wf_impl_inode_table_ref(inodes, (uint64_t) attr->st_ino, &generation);
+	buffer.generation = generation;
+	buffer.attr_timeout = timeout;
+	buffer.entry_timeout = timeout;
+	memcpy(&buffer.attr, attr, sizeof(struct stat));
+	buffer.attr.st_ino = buffer.ino;
+
+	fuse_reply_entry(request, &buffer);
+}
+
 void wf_impl_operation_lookup_finished(
 	void * user_data,
 	struct wf_json const * result,
@@ -24,7 +47,7 @@ void wf_impl_operation_lookup_finished(
 {
 	wf_status status = wf_impl_jsonrpc_get_status(error);
 	struct wf_impl_operation_lookup_context * context = user_data; 	
-    struct fuse_entry_param buffer;
+    struct stat buffer;
 
 	if (NULL != result)
 	{
@@ -37,29 +60,25 @@ void wf_impl_operation_lookup_finished(
 		{
             memset(&buffer, 0, sizeof(struct stat));
 
-			buffer.ino = wf_impl_json_int_get(inode_holder);
-			buffer.attr.st_ino = buffer.ino;
-			buffer.attr.st_mode = wf_impl_json_int_get(mode_holder) & 0555;
+			buffer.st_ino = (ino_t) wf_impl_json_int64_get(inode_holder);
+			buffer.st_mode = wf_impl_json_int_get(mode_holder) & 0555;
 			char const * type = wf_impl_json_string_get(type_holder);
 			if (0 == strcmp("file", type)) 
 			{
-				buffer.attr.st_mode |= S_IFREG;
+				buffer.st_mode |= S_IFREG;
 			}
 			else if (0 == strcmp("dir", type))
 			{
-				buffer.attr.st_mode |= S_IFDIR;
+				buffer.st_mode |= S_IFDIR;
 			}
 
-
-			buffer.attr_timeout = context->timeout;
-			buffer.entry_timeout = context->timeout;
-            buffer.attr.st_uid = context->uid;
-            buffer.attr.st_gid = context->gid;
-            buffer.attr.st_nlink = 1;
-			buffer.attr.st_size = wf_impl_json_get_int(result, "size", 0);
-			buffer.attr.st_atime = wf_impl_json_get_int(result, "atime", 0);
-			buffer.attr.st_mtime = wf_impl_json_get_int(result, "mtime", 0);
-			buffer.attr.st_ctime = wf_impl_json_get_int(result, "ctime", 0);
+            buffer.st_uid = context->uid;
+            buffer.st_gid = context->gid;
+            buffer.st_nlink = 1;
+			buffer.st_size = wf_impl_json_get_int64(result, "size", 0);
+			buffer.st_atime = wf_impl_json_get_int64(result, "atime", 0);
+			buffer.st_mtime = wf_impl_json_get_int64(result, "mtime", 0);
+			buffer.st_ctime = wf_impl_json_get_int64(result, "ctime", 0);
 		}
 		else
 		{
@@ -67,15 +86,34 @@ void wf_impl_operation_lookup_finished(
 		}
 	}
 
+    if (NULL != context->cache)
+    {
+        // replies to requests sent before an invalidation are not cached
+        bool const is_parent_valid = !wf_impl_attr_cache_is_invalidated(context->cache, context->parent, context->generation);
+        if ((WF_GOOD == status) && (!wf_impl_attr_cache_is_invalidated(context->cache, buffer.st_ino, context->generation)))
+        {
+            wf_impl_attr_cache_set_attr(context->cache, buffer.st_ino, &buffer);
+            if (is_parent_valid)
+            {
+                wf_impl_attr_cache_set_entry(context->cache, context->parent, context->name, buffer.st_ino);
+            }
+        }
+        else if ((WF_BAD_NOENTRY == status) && (is_parent_valid))
+        {
+            wf_impl_attr_cache_set_negative_entry(context->cache, context->parent, context->name);
+        }
+    }
+
     if (WF_GOOD == status)
     {
-        fuse_reply_entry(context->request, &buffer);
+        wf_impl_operation_lookup_reply(context->request, &buffer, context->timeout, context->inodes);
     }
     else
     {
 	    fuse_reply_err(context->request, ENOENT);
     }
 
+	free(context->name);
 	free(context);
 }
 
@@ -88,15 +126,58 @@ void wf_impl_operation_lookup (
     struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
     struct wf_jsonrpc_proxy * rpc = wf_impl_operation_context_get_proxy(user_data);
 
-	if (NULL != rpc)
+	uint64_t parent_id = 0;
+	bool const is_known = (NULL != rpc) && (wf_impl_inode_table_get_id(user_data->inodes, parent, &parent_id));
+
+	struct stat attr;
+	enum wf_impl_attr_cache_result cache_result = WF_IMPL_ATTR_CACHE_MISS;
+	if ((is_known) && (NULL != user_data->cache))
+	{
+		cache_result = wf_impl_attr_cache_lookup(user_data->cache, parent_id, name, &attr);
+	}
+
+	if (WF_IMPL_ATTR_CACHE_FOUND == cache_result)
+	{
+		attr.st_uid = context->uid;
+		attr.st_gid = context->gid;
+		wf_impl_operation_lookup_reply(request, &attr, user_data->timeout, user_data->inodes);
+	}
+	else if (WF_IMPL_ATTR_CACHE_NOT_FOUND == cache_result)
+	{
+		fuse_reply_err(request, ENOENT);
+	}
+	else if (is_known)
 	{
 		struct wf_impl_operation_lookup_context * lookup_context = malloc(sizeof(struct wf_impl_operation_lookup_context));
 		lookup_context->request = request;
 		lookup_context->uid = context->uid;
 		lookup_context->gid = context->gid;
 		lookup_context->timeout = user_data->timeout;
+		lookup_context->parent = parent_id;
+		lookup_context->name = (NULL != user_data->cache) ? strdup(name) : NULL;
+		lookup_context->cache = user_data->cache;
+		lookup_context->generation = (NULL != user_data->cache) ? wf_impl_attr_cache_get_generation(user_data->cache) : 0;
+		lookup_context->inodes = user_data->inodes;
 
-		wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_lookup_finished, lookup_context, "lookup", "sis", user_data->name, (int) (parent & INT_MAX), name);
+		if (NULL == user_data->singleflight)
+		{
+			wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_lookup_finished, lookup_context, "lookup", "sIs", user_data->name, (int64_t) parent_id, name);
+		}
+		else
+		{
+			struct wf_impl_singleflight_call * call = wf_impl_singleflight_add(user_data->singleflight,
+				"lookup", parent_id, name, &wf_impl_operation_lookup_finished, lookup_context);
+			if (NULL != call)
+			{
+				wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_singleflight_finished, call, "lookup", "sIs", user_data->name, (int64_t) parent_id, name);
+			}
+			else
+			{
+				// the reply may predate the recorded generation;
+				// it is cached by the request, which was sent
+				lookup_context->cache = NULL;
+			}
+		}
 	}
 	else
 	{
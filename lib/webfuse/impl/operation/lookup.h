@@ -5,6 +5,12 @@
 
 #include <sys/types.h>
 
+#ifndef __cplusplus
+#include <stdint.h>
+#else
+#include <cstdint>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -12,6 +18,8 @@ extern "C"
 
 struct wf_jsonrpc_error;
 struct wf_json;
+struct wf_impl_attr_cache;
+struct wf_impl_inode_table;
 
 struct wf_impl_operation_lookup_context
 {
@@ -19,6 +27,12 @@ struct wf_impl_operation_lookup_context
 	double timeout;
 	uid_t uid;
 	gid_t gid;
+	uint64_t parent;
+	char * name;
+	struct wf_impl_attr_cache * cache;
+	// invalidation generation of the cache when the request was sent
+	uint64_t generation;
+	struct wf_impl_inode_table * inodes;
 };
 
 extern void wf_impl_operation_lookup_finished(
@@ -1,5 +1,7 @@
 #include "webfuse/impl/operation/open.h"
 #include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/operation/readahead.h"
+#include "webfuse/impl/inode_table.h"
 
 #include "webfuse/impl/jsonrpc/proxy.h"
 #include "webfuse/impl/json/node.h"
@@ -7,8 +9,11 @@
 #include "webfuse/status.h"
 #include "webfuse/impl/util/json_util.h"
 
+#include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <errno.h>
+#include <limits.h>
 
 void wf_impl_operation_open_finished(
 	void * user_data,
@@ -16,7 +21,7 @@ void wf_impl_operation_open_finished(
 	struct wf_jsonrpc_error const * error)
 {
 	wf_status status = wf_impl_jsonrpc_get_status(error);
-	fuse_req_t request = user_data;
+	struct wf_impl_operation_open_context * context = user_data;
 	struct fuse_file_info file_info;
 	memset(&file_info, 0, sizeof(struct fuse_file_info));
 
@@ -35,13 +40,19 @@ void wf_impl_operation_open_finished(
 
 	if (WF_GOOD == status)
 	{
-		fuse_reply_open(request, &file_info);		
+		int const handle = (int) (file_info.fh & INT_MAX);
+		struct wf_impl_readahead * readahead = wf_impl_readahead_create(handle, context->id, context->readahead);
+		wf_impl_readahead_link(readahead, context->open_files);
+		file_info.fh = (uint64_t) (uintptr_t) readahead;
+
+		fuse_reply_open(context->request, &file_info);
 	}
 	else
 	{
-		fuse_reply_err(request, ENOENT);
+		fuse_reply_err(context->request, ENOENT);
 	}
 
+	free(context);
 }
 
 void wf_impl_operation_open(
@@ -52,9 +63,16 @@ void wf_impl_operation_open(
     struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
     struct wf_jsonrpc_proxy * rpc = wf_impl_operation_context_get_proxy(user_data);
 
-	if (NULL != rpc)
+	uint64_t id;
+	if ((NULL != rpc) && (wf_impl_inode_table_get_id(user_data->inodes, inode, &id)))
 	{
-		wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_open_finished, request, "open", "sii", user_data->name, inode, file_info->flags);
+		struct wf_impl_operation_open_context * open_context = malloc(sizeof(struct wf_impl_operation_open_context));
+		open_context->request = request;
+		open_context->id = id;
+		open_context->readahead = user_data->readahead;
+		open_context->open_files = &user_data->open_files;
+
+		wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_open_finished, open_context, "open", "sIi", user_data->name, (int64_t) id, file_info->flags);
 	}
 	else
 	{
@@ -3,6 +3,14 @@
 
 #include "webfuse/impl/fuse_wrapper.h"
 
+#ifndef __cplusplus
+#include <stddef.h>
+#include <inttypes.h>
+#else
+#include <cstddef>
+#include <cinttypes>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -10,6 +18,15 @@ extern "C"
 
 struct wf_jsonrpc_error;
 struct wf_json;
+struct wf_impl_readahead;
+
+struct wf_impl_operation_open_context
+{
+	fuse_req_t request;
+	uint64_t id;
+	size_t readahead;
+	struct wf_impl_readahead * * open_files;
+};
 
 extern void wf_impl_operation_open(
 	fuse_req_t request,
@@ -0,0 +1,19 @@
+#include "webfuse/impl/operation/opendir.h"
+#include "webfuse/impl/operation/dirbuffer.h"
+#include "webfuse/impl/util/util.h"
+
+#include <stdint.h>
+
+void wf_impl_operation_opendir(
+	fuse_req_t request,
+	fuse_ino_t WF_UNUSED_PARAM(inode),
+	struct fuse_file_info * file_info)
+{
+	// The directory handle holds the directory contents, which are filled
+	// by the first readdir call. This avoids to fetch the whole directory
+	// for each offset requested by the kernel.
+	struct wf_impl_dirbuffer * buffer = wf_impl_dirbuffer_create();
+	file_info->fh = (uint64_t) (uintptr_t) buffer;
+
+	fuse_reply_open(request, file_info);
+}
@@ -1,19 +1,45 @@
 #include "webfuse/impl/operation/read.h"
 #include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/operation/readahead.h"
+#include "webfuse/impl/inode_table.h"
 
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <stdint.h>
 
 #include "webfuse/impl/jsonrpc/proxy.h"
 #include "webfuse/impl/json/node.h"
 #include "webfuse/impl/util/base64.h"
 #include "webfuse/impl/util/json_util.h"
+#include "webfuse/impl/util/util.h"
 
 // do not read chunks larger than 1 MByte
 #define WF_MAX_READ_LENGTH (1024 * 1024)
 
+// libfuse does not splice replies smaller than two pages
+#define WF_READ_SPLICE_MIN_SIZE (2 * 4096)
+
+struct wf_impl_operation_read_chunk
+{
+	struct wf_impl_operation_read_gather * gather;
+	size_t offset;
+	size_t size;
+};
+
+struct wf_impl_operation_read_gather
+{
+	fuse_req_t request;
+	struct wf_jsonrpc_proxy * rpc;
+	char * data;
+	size_t size;
+	size_t pending;
+	wf_status status;
+	struct wf_impl_operation_read_chunk * chunks;
+	size_t chunk_count;
+};
+
 char * wf_impl_operation_read_transform(
 	char * data,
 	size_t data_size,
@@ -26,7 +52,8 @@ char * wf_impl_operation_read_transform(
 
 	if (0 < count)
 	{
-		if (0 == strcmp("identity", format))
+		// binary: data was transferred as binary frame (see jsonrpc/attachment.h)
+		if ((0 == strcmp("identity", format)) || (0 == strcmp("binary", format)))
 		{
 			if (count != data_size)
 			{
@@ -50,16 +77,64 @@ char * wf_impl_operation_read_transform(
 	return buffer;
 }
 
-void wf_impl_operation_read_finished(
-	void * user_data, 
+static wf_status wf_impl_operation_read_decode_to(
+	char const * data,
+	size_t data_size,
+	char const * format,
+	size_t count,
+	char * target,
+	size_t target_size)
+{
+	wf_status status = WF_GOOD;
+
+	if (target_size < count)
+	{
+		status = WF_BAD_FORMAT;
+	}
+	else if (0 < count)
+	{
+		if ((0 == strcmp("identity", format)) || (0 == strcmp("binary", format)))
+		{
+			if (count == data_size)
+			{
+				memcpy(target, data, count);
+			}
+			else
+			{
+				status = WF_BAD;
+			}
+		}
+		else if (0 == strcmp("base64", format))
+		{
+			size_t result = wf_impl_base64_decode(data, data_size, (uint8_t *) target, count);
+			if (result != count)
+			{
+				status = WF_BAD;
+			}
+		}
+		else
+		{
+			status = WF_BAD;
+		}
+	}
+
+	return status;
+}
+
+static wf_status wf_impl_operation_read_parse(
 	struct wf_json const * result,
-	struct wf_jsonrpc_error const * error)
+	struct wf_jsonrpc_error const * error,
+	char * * data,
+	size_t * data_size,
+	char const * * format,
+	size_t * count)
 {
 	wf_status status = wf_impl_jsonrpc_get_status(error);
-	fuse_req_t request = user_data;
+	*data = NULL;
+	*data_size = 0;
+	*format = NULL;
+	*count = 0;
 
-	char * buffer = NULL;	
-	size_t length = 0;
 	if (NULL != result)
 	{
 		struct wf_json const * data_holder = wf_impl_json_object_get(result, "data");
@@ -70,12 +145,10 @@ void wf_impl_operation_read_finished(
         	(wf_impl_json_is_string(format_holder)) &&
             (wf_impl_json_is_int(count_holder)))
 		{
-			char * const data = (char*) wf_impl_json_string_get(data_holder);
-			size_t const data_size = wf_impl_json_string_size(data_holder);
-			char const * const format = wf_impl_json_string_get(format_holder);
-			length = (size_t) wf_impl_json_int_get(count_holder);
-
-			buffer = wf_impl_operation_read_transform(data, data_size, format, length, &status);
+			*data = (char*) wf_impl_json_string_get(data_holder);
+			*data_size = wf_impl_json_string_size(data_holder);
+			*format = wf_impl_json_string_get(format_holder);
+			*count = (size_t) wf_impl_json_int64_get(count_holder);
 		}
 		else
 		{
@@ -83,13 +156,262 @@ void wf_impl_operation_read_finished(
 		}
 	}
 
+	return status;
+}
+
+static wf_status wf_impl_operation_read_get_data(
+	struct wf_json const * result,
+	struct wf_jsonrpc_error const * error,
+	char * * buffer,
+	size_t * length)
+{
+	char * data;
+	size_t data_size;
+	char const * format;
+	wf_status status = wf_impl_operation_read_parse(result, error, &data, &data_size, &format, length);
+	*buffer = NULL;
+
+	if ((WF_GOOD == status) && (NULL != data))
+	{
+		*buffer = wf_impl_operation_read_transform(data, data_size, format, *length, &status);
+	}
+
+	return status;
+}
+
+static void wf_impl_operation_read_reply_err(
+	fuse_req_t request,
+	wf_status status)
+{
+	fuse_reply_err(request, (WF_BAD_INTERRUPTED == status) ? EINTR : ENOENT);
+}
+
+static void wf_impl_operation_read_reply(
+	fuse_req_t request,
+	char const * data,
+	size_t size)
+{
+	if (size < WF_READ_SPLICE_MIN_SIZE)
+	{
+		fuse_reply_buf(request, data, size);
+	}
+	else
+	{
+		// lets libfuse splice the payload to the fuse device,
+		// if FUSE_CAP_SPLICE_WRITE was negotiated (see operation/init.h);
+		// otherwise the buffer is written like by fuse_reply_buf
+		struct fuse_bufvec buffer = FUSE_BUFVEC_INIT(size);
+		buffer.buf[0].mem = (void *) data;
+		fuse_reply_data(request, &buffer, FUSE_BUF_SPLICE_MOVE);
+	}
+}
+
+void wf_impl_operation_read_finished(
+	void * user_data, 
+	struct wf_json const * result,
+	struct wf_jsonrpc_error const * error)
+{
+	fuse_req_t request = user_data;
+
+	char * buffer;
+	size_t length;
+	wf_status const status = wf_impl_operation_read_get_data(result, error, &buffer, &length);
+
+	if (WF_GOOD == status)
+	{
+		wf_impl_operation_read_reply(request, buffer, length);
+	}
+	else
+	{
+		wf_impl_operation_read_reply_err(request, status);
+	}
+}
+
+// Cancels the pending request, which answers the fuse request with EINTR.
+static void wf_impl_operation_read_interrupt(
+	fuse_req_t request,
+	void * user_data)
+{
+	struct wf_jsonrpc_proxy * rpc = user_data;
+	wf_impl_jsonrpc_proxy_cancel(rpc, &wf_impl_operation_read_finished, request);
+}
+
+static void wf_impl_operation_read_gather_release(
+	struct wf_impl_operation_read_gather * gather)
+{
+	gather->pending--;
+	if (0 == gather->pending)
+	{
+		if (WF_GOOD == gather->status)
+		{
+			wf_impl_operation_read_reply(gather->request, gather->data, gather->size);
+		}
+		else
+		{
+			wf_impl_operation_read_reply_err(gather->request, gather->status);
+		}
+
+		free(gather->chunks);
+		free(gather->data);
+		free(gather);
+	}
+}
+
+void wf_impl_operation_read_chunk_finished(
+	void * user_data,
+	struct wf_json const * result,
+	struct wf_jsonrpc_error const * error)
+{
+	struct wf_impl_operation_read_chunk * chunk = user_data;
+	struct wf_impl_operation_read_gather * gather = chunk->gather;
+
+	char * data;
+	size_t data_size;
+	char const * format;
+	size_t length;
+	wf_status status = wf_impl_operation_read_parse(result, error, &data, &data_size, &format, &length);
+
+	if ((WF_GOOD == status) && (NULL != data))
+	{
+		// decode directly into the reply buffer to avoid an intermediate copy
+		status = wf_impl_operation_read_decode_to(data, data_size, format, length,
+			&gather->data[chunk->offset], chunk->size);
+	}
+
 	if (WF_GOOD == status)
 	{
-		fuse_reply_buf(request, buffer, length);
+		// short read: end of file is reached within this chunk
+		if ((length < chunk->size) && ((chunk->offset + length) < gather->size))
+		{
+			gather->size = chunk->offset + length;
+		}
 	}
 	else
 	{
-   		fuse_reply_err(request, ENOENT);
+		gather->status = status;
+	}
+
+	wf_impl_operation_read_gather_release(gather);
+}
+
+static void wf_impl_operation_read_gather_interrupt(
+	fuse_req_t WF_UNUSED_PARAM(request),
+	void * user_data)
+{
+	struct wf_impl_operation_read_gather * gather = user_data;
+
+	// keep gather alive, since it is released when the last chunk is cancelled
+	gather->pending++;
+	for(size_t i = 0; i < gather->chunk_count; i++)
+	{
+		wf_impl_jsonrpc_proxy_cancel(gather->rpc, &wf_impl_operation_read_chunk_finished, &gather->chunks[i]);
+	}
+
+	wf_impl_operation_read_gather_release(gather);
+}
+
+static void wf_impl_operation_read_invoke(
+	struct wf_jsonrpc_proxy * rpc,
+	struct wf_impl_operation_context * user_data,
+	fuse_req_t request,
+	uint64_t id,
+	int handle,
+	size_t size,
+	off_t offset)
+{
+	size_t chunk_size = user_data->read_chunk_size;
+	if ((0 == chunk_size) || (WF_MAX_READ_LENGTH < chunk_size))
+	{
+		chunk_size = WF_MAX_READ_LENGTH;
+	}
+
+	// interrupt handlers are registered before invokation, since a failed
+	// invokation answers the fuse request immediately
+	if (size <= chunk_size)
+	{
+		fuse_req_interrupt_func(request, &wf_impl_operation_read_interrupt, rpc);
+		wf_impl_jsonrpc_proxy_invoke_sized(rpc, &wf_impl_operation_read_finished, request, size, "read", "sIiIi", user_data->name, (int64_t) id, handle, (int64_t) offset, (int) size);
+		return;
+	}
+
+	struct wf_impl_operation_read_gather * gather = malloc(sizeof(struct wf_impl_operation_read_gather));
+	gather->request = request;
+	gather->rpc = rpc;
+	gather->data = malloc(size);
+	gather->size = size;
+	gather->status = WF_GOOD;
+	gather->chunk_count = (size + chunk_size - 1) / chunk_size;
+	gather->chunks = malloc(sizeof(struct wf_impl_operation_read_chunk) * gather->chunk_count);
+	// keep one reference while chunks are issued, since a chunk might finish immediately
+	gather->pending = 1;
+
+	fuse_req_interrupt_func(request, &wf_impl_operation_read_gather_interrupt, gather);
+	for(size_t i = 0; i < gather->chunk_count; i++)
+	{
+		struct wf_impl_operation_read_chunk * chunk = &gather->chunks[i];
+		size_t const chunk_offset = i * chunk_size;
+		chunk->gather = gather;
+		chunk->offset = chunk_offset;
+		chunk->size = ((size - chunk_offset) < chunk_size) ? (size - chunk_offset) : chunk_size;
+
+		gather->pending++;
+		wf_impl_jsonrpc_proxy_invoke_sized(rpc, &wf_impl_operation_read_chunk_finished, chunk, chunk->size, "read", "sIiIi",
+			user_data->name, (int64_t) id, handle, (int64_t) (offset + chunk_offset), (int) chunk->size);
+	}
+
+	wf_impl_operation_read_gather_release(gather);
+}
+
+void wf_impl_operation_read_ahead_finished(
+	void * user_data,
+	struct wf_json const * result,
+	struct wf_jsonrpc_error const * error)
+{
+	struct wf_impl_readahead * readahead = user_data;
+
+	char * buffer;
+	size_t length;
+	wf_status const status = wf_impl_operation_read_get_data(result, error, &buffer, &length);
+
+	if (WF_GOOD == status)
+	{
+		wf_impl_readahead_fill(readahead, buffer, length);
+	}
+	else
+	{
+		wf_impl_readahead_fail(readahead);
+	}
+
+	fuse_req_t request;
+	off_t offset;
+	size_t size;
+	while (wf_impl_readahead_pop_waiting(readahead, &request, &offset, &size))
+	{
+		char const * data;
+		if ((WF_GOOD == status) && (wf_impl_readahead_get(readahead, offset, size, &data, &length)))
+		{
+			wf_impl_operation_read_reply(request, data, length);
+		}
+		else
+		{
+			// a failed (or short) speculative read must not fail the request:
+			// fall back to a regular read
+			struct wf_impl_operation_context * context = fuse_req_userdata(request);
+			struct wf_jsonrpc_proxy * rpc = wf_impl_operation_context_get_data_proxy(context);
+			if (NULL != rpc)
+			{
+				wf_impl_operation_read_invoke(rpc, context, request, readahead->id, readahead->handle, size, offset);
+			}
+			else
+			{
+				fuse_reply_err(request, ENOENT);
+			}
+		}
+	}
+
+	if (readahead->is_released)
+	{
+		wf_impl_readahead_dispose(readahead);
 	}
 }
 
@@ -101,17 +423,31 @@ void wf_impl_operation_read(
 	struct fuse_file_info * file_info)
 {
     struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
-    struct wf_jsonrpc_proxy * rpc = wf_impl_operation_context_get_proxy(user_data);
+    struct wf_jsonrpc_proxy * rpc = wf_impl_operation_context_get_data_proxy(user_data);
 
-	if ((NULL != rpc) && (size <= WF_MAX_READ_LENGTH))
+	uint64_t id;
+	if ((NULL != rpc) && (wf_impl_inode_table_get_id(user_data->inodes, inode, &id)))
 	{
-		int const length = (int) size;
-		int handle = (file_info->fh & INT_MAX);
-		wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_read_finished, request, "read", "siiii", user_data->name, (int) inode, handle, (int) offset, length);
-	}
-	else if (size > WF_MAX_READ_LENGTH)
-	{
-		fuse_reply_err(request, ENOMEM);
+		struct wf_impl_readahead * readahead = (struct wf_impl_readahead *) (uintptr_t) file_info->fh;
+		wf_impl_readahead_access(readahead, offset, size);
+
+		char const * data;
+		size_t length;
+		if (wf_impl_readahead_get(readahead, offset, size, &data, &length))
+		{
+			wf_impl_operation_read_reply(request, data, length);
+		}
+		else if (!wf_impl_readahead_wait(readahead, request, offset, size))
+		{
+			wf_impl_operation_read_invoke(rpc, user_data, request, id, readahead->handle, size, offset);
+		}
+
+		off_t next_offset;
+		size_t next_size;
+		if (wf_impl_readahead_next(readahead, &next_offset, &next_size))
+		{
+			wf_impl_jsonrpc_proxy_invoke_sized(rpc, &wf_impl_operation_read_ahead_finished, readahead, next_size, "read", "sIiIi", user_data->name, (int64_t) id, readahead->handle, (int64_t) next_offset, (int) next_size);
+		}
 	}
 	else
 	{
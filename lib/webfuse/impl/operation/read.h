@@ -29,6 +29,15 @@ extern void wf_impl_operation_read_finished(
 	struct wf_json const * result,
 	struct wf_jsonrpc_error const * error);
 
+extern void wf_impl_operation_read_chunk_finished(
+	void * user_data,
+	struct wf_json const * result,
+	struct wf_jsonrpc_error const * error);
+
+extern void wf_impl_operation_read_ahead_finished(
+	void * user_data,
+	struct wf_json const * result,
+	struct wf_jsonrpc_error const * error);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,319 @@
+#include "webfuse/impl/operation/readahead.h"
+#include "webfuse/impl/util/container_of.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// speculative reads are limited by the max. size of a single read request
+#define WF_READAHEAD_MAX_WINDOW (1024 * 1024)
+#define WF_READAHEAD_MIN_SEQUENTIAL 2
+
+struct wf_impl_readahead_request
+{
+	struct wf_slist_item item;
+	fuse_req_t request;
+	off_t offset;
+	size_t size;
+};
+
+struct wf_impl_readahead *
+wf_impl_readahead_create(
+	int handle,
+	uint64_t id,
+	size_t window)
+{
+	struct wf_impl_readahead * readahead = malloc(sizeof(struct wf_impl_readahead));
+	readahead->handle = handle;
+	readahead->id = id;
+	readahead->window = (window < WF_READAHEAD_MAX_WINDOW) ? window : WF_READAHEAD_MAX_WINDOW;
+	readahead->next_offset = 0;
+	readahead->sequential_count = 0;
+	readahead->data = NULL;
+	readahead->data_offset = 0;
+	readahead->data_size = 0;
+	readahead->data_capacity = 0;
+	readahead->is_eof = false;
+	readahead->is_pending = false;
+	readahead->pending_offset = 0;
+	readahead->pending_size = 0;
+	wf_impl_slist_init(&readahead->waiting);
+	readahead->is_released = false;
+	readahead->is_discarded = false;
+	readahead->next = NULL;
+	readahead->prev_next = NULL;
+
+	return readahead;
+}
+
+static void
+wf_impl_readahead_unlink(
+	struct wf_impl_readahead * readahead)
+{
+	if (NULL != readahead->prev_next)
+	{
+		*(readahead->prev_next) = readahead->next;
+		if (NULL != readahead->next)
+		{
+			readahead->next->prev_next = readahead->prev_next;
+		}
+
+		readahead->next = NULL;
+		readahead->prev_next = NULL;
+	}
+}
+
+void
+wf_impl_readahead_dispose(
+	struct wf_impl_readahead * readahead)
+{
+	struct wf_slist_item * item = wf_impl_slist_remove_first(&readahead->waiting);
+	while (NULL != item)
+	{
+		struct wf_impl_readahead_request * request = wf_container_of(item, struct wf_impl_readahead_request, item);
+		free(request);
+		item = wf_impl_slist_remove_first(&readahead->waiting);
+	}
+
+	wf_impl_readahead_unlink(readahead);
+	free(readahead->data);
+	free(readahead);
+}
+
+void
+wf_impl_readahead_link(
+	struct wf_impl_readahead * readahead,
+	struct wf_impl_readahead * * list)
+{
+	readahead->next = *list;
+	if (NULL != readahead->next)
+	{
+		readahead->next->prev_next = &readahead->next;
+	}
+
+	readahead->prev_next = list;
+	*list = readahead;
+}
+
+void
+wf_impl_readahead_invalidate(
+	struct wf_impl_readahead * list,
+	uint64_t id)
+{
+	for (struct wf_impl_readahead * readahead = list; NULL != readahead; readahead = readahead->next)
+	{
+		if (id == readahead->id)
+		{
+			readahead->data_size = 0;
+			readahead->is_eof = false;
+			readahead->is_discarded = readahead->is_pending;
+		}
+	}
+}
+
+bool
+wf_impl_readahead_release(
+	struct wf_impl_readahead * readahead)
+{
+	wf_impl_readahead_unlink(readahead);
+
+	bool const result = !readahead->is_pending;
+	if (result)
+	{
+		wf_impl_readahead_dispose(readahead);
+	}
+	else
+	{
+		readahead->is_released = true;
+	}
+
+	return result;
+}
+
+void
+wf_impl_readahead_access(
+	struct wf_impl_readahead * readahead,
+	off_t offset,
+	size_t size)
+{
+	if (offset == readahead->next_offset)
+	{
+		readahead->sequential_count++;
+	}
+	else
+	{
+		readahead->sequential_count = 0;
+		readahead->data_size = 0;
+		readahead->is_eof = false;
+	}
+
+	readahead->next_offset = offset + size;
+}
+
+bool
+wf_impl_readahead_get(
+	struct wf_impl_readahead * readahead,
+	off_t offset,
+	size_t size,
+	char const * * data,
+	size_t * length)
+{
+	off_t const data_end = readahead->data_offset + readahead->data_size;
+	bool const result = (0 < readahead->data_size) &&
+		(readahead->data_offset <= offset) &&
+		(((off_t) (offset + size) <= data_end) || ((readahead->is_eof) && (offset <= data_end)));
+
+	if (result)
+	{
+		size_t const available = data_end - offset;
+		*data = &readahead->data[offset - readahead->data_offset];
+		*length = (size < available) ? size : available;
+	}
+
+	return result;
+}
+
+bool
+wf_impl_readahead_wait(
+	struct wf_impl_readahead * readahead,
+	fuse_req_t request,
+	off_t offset,
+	size_t size)
+{
+	bool const result = (readahead->is_pending) && (!readahead->is_discarded) &&
+		(readahead->pending_offset <= offset) &&
+		((off_t) (offset + size) <= (off_t) (readahead->pending_offset + readahead->pending_size));
+
+	if (result)
+	{
+		struct wf_impl_readahead_request * waiting = malloc(sizeof(struct wf_impl_readahead_request));
+		waiting->item.next = NULL;
+		waiting->request = request;
+		waiting->offset = offset;
+		waiting->size = size;
+		wf_impl_slist_append(&readahead->waiting, &waiting->item);
+	}
+
+	return result;
+}
+
+bool
+wf_impl_readahead_pop_waiting(
+	struct wf_impl_readahead * readahead,
+	fuse_req_t * request,
+	off_t * offset,
+	size_t * size)
+{
+	struct wf_slist_item * item = wf_impl_slist_remove_first(&readahead->waiting);
+	if (NULL != item)
+	{
+		struct wf_impl_readahead_request * waiting = wf_container_of(item, struct wf_impl_readahead_request, item);
+		*request = waiting->request;
+		*offset = waiting->offset;
+		*size = waiting->size;
+		free(waiting);
+	}
+
+	return (NULL != item);
+}
+
+bool
+wf_impl_readahead_next(
+	struct wf_impl_readahead * readahead,
+	off_t * offset,
+	size_t * size)
+{
+	if ((0 == readahead->window) || (readahead->is_pending) ||
+		(readahead->sequential_count < WF_READAHEAD_MIN_SEQUENTIAL))
+	{
+		return false;
+	}
+
+	off_t start = readahead->next_offset;
+	off_t const data_end = readahead->data_offset + readahead->data_size;
+	if ((readahead->data_offset <= start) && (start <= data_end))
+	{
+		if (readahead->is_eof)
+		{
+			return false;
+		}
+
+		start = data_end;
+	}
+
+	// keep at least half of the window buffered ahead of the consumer
+	if ((size_t) (start - readahead->next_offset) >= (readahead->window / 2))
+	{
+		return false;
+	}
+
+	readahead->is_pending = true;
+	readahead->pending_offset = start;
+	readahead->pending_size = readahead->window;
+
+	*offset = start;
+	*size = readahead->window;
+	return true;
+}
+
+void
+wf_impl_readahead_fill(
+	struct wf_impl_readahead * readahead,
+	char const * data,
+	size_t size)
+{
+	if (readahead->is_discarded)
+	{
+		// data was read before the inode was invalidated
+		readahead->is_discarded = false;
+		readahead->is_pending = false;
+		return;
+	}
+
+	off_t const data_end = readahead->data_offset + readahead->data_size;
+	bool const is_contiguous = (0 < readahead->data_size) &&
+		(readahead->pending_offset == data_end);
+
+	if (is_contiguous)
+	{
+		// drop data which is already consumed
+		off_t keep_offset = readahead->next_offset;
+		if (keep_offset < readahead->data_offset)
+		{
+			keep_offset = readahead->data_offset;
+		}
+		else if (keep_offset > data_end)
+		{
+			keep_offset = data_end;
+		}
+
+		size_t const consumed = keep_offset - readahead->data_offset;
+		memmove(readahead->data, &readahead->data[consumed], readahead->data_size - consumed);
+		readahead->data_offset = keep_offset;
+		readahead->data_size -= consumed;
+	}
+	else
+	{
+		readahead->data_offset = readahead->pending_offset;
+		readahead->data_size = 0;
+	}
+
+	size_t const capacity = readahead->data_size + size;
+	if (capacity > readahead->data_capacity)
+	{
+		readahead->data = realloc(readahead->data, capacity);
+		readahead->data_capacity = capacity;
+	}
+
+	memcpy(&readahead->data[readahead->data_size], data, size);
+	readahead->data_size += size;
+	readahead->is_eof = (size < readahead->pending_size);
+	readahead->is_pending = false;
+}
+
+void
+wf_impl_readahead_fail(
+	struct wf_impl_readahead * readahead)
+{
+	readahead->is_discarded = false;
+	readahead->is_pending = false;
+}
@@ -0,0 +1,172 @@
+#ifndef WF_ADAPTER_IMPL_OPERATION_READAHEAD_H
+#define WF_ADAPTER_IMPL_OPERATION_READAHEAD_H
+
+#include "webfuse/impl/fuse_wrapper.h"
+#include "webfuse/impl/util/slist.h"
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#else
+#include <cstddef>
+#include <cinttypes>
+#endif
+
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//------------------------------------------------------------------------------
+/// \brief State of an open file handle.
+///
+/// Tracks the access pattern of a file handle. Once sequential access is
+/// detected, data is read ahead of the consumer and buffered, so that
+/// subsequent reads are served without a round trip to the provider.
+///
+/// At most one speculative read is pending per handle. Reads which are
+/// covered by the pending range wait for its completion.
+///
+/// Open handles of a filesystem are linked, so that buffered data can be
+/// dropped when the provider invalidates an inode.
+//------------------------------------------------------------------------------
+struct wf_impl_readahead
+{
+	int handle;
+	uint64_t id;
+	size_t window;
+	off_t next_offset;
+	size_t sequential_count;
+	char * data;
+	off_t data_offset;
+	size_t data_size;
+	size_t data_capacity;
+	bool is_eof;
+	bool is_pending;
+	off_t pending_offset;
+	size_t pending_size;
+	struct wf_slist waiting;
+	bool is_released;
+	bool is_discarded;
+	struct wf_impl_readahead * next;
+	struct wf_impl_readahead * * prev_next;
+};
+
+extern struct wf_impl_readahead *
+wf_impl_readahead_create(
+	int handle,
+	uint64_t id,
+	size_t window);
+
+extern void
+wf_impl_readahead_dispose(
+	struct wf_impl_readahead * readahead);
+
+//------------------------------------------------------------------------------
+/// \brief Adds a handle to the list of open handles.
+///
+/// The handle is removed from the list when it is released or disposed.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_readahead_link(
+	struct wf_impl_readahead * readahead,
+	struct wf_impl_readahead * * list);
+
+//------------------------------------------------------------------------------
+/// \brief Drops buffered data of all open handles of an inode.
+///
+/// The result of a pending speculative read is discarded; reads waiting
+/// for it are not served from the buffer.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_readahead_invalidate(
+	struct wf_impl_readahead * list,
+	uint64_t id);
+
+//------------------------------------------------------------------------------
+/// \brief Releases a handle.
+///
+/// The handle is disposed immediately, unless a speculative read is
+/// pending. In this case, it is disposed when the read is finished.
+///
+/// \return true, if the handle was disposed
+//------------------------------------------------------------------------------
+extern bool
+wf_impl_readahead_release(
+	struct wf_impl_readahead * readahead);
+
+//------------------------------------------------------------------------------
+/// \brief Records a read access.
+///
+/// Buffered data is dropped on non-sequential access.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_readahead_access(
+	struct wf_impl_readahead * readahead,
+	off_t offset,
+	size_t size);
+
+//------------------------------------------------------------------------------
+/// \brief Returns buffered data of the range [offset, offset + size).
+///
+/// \return true, if the range is buffered; length might be less than size
+///         at end of file
+//------------------------------------------------------------------------------
+extern bool
+wf_impl_readahead_get(
+	struct wf_impl_readahead * readahead,
+	off_t offset,
+	size_t size,
+	char const * * data,
+	size_t * length);
+
+//------------------------------------------------------------------------------
+/// \brief Queues a request, if its range is covered by the pending read.
+///
+/// \return true, if the request was queued
+//------------------------------------------------------------------------------
+extern bool
+wf_impl_readahead_wait(
+	struct wf_impl_readahead * readahead,
+	fuse_req_t request,
+	off_t offset,
+	size_t size);
+
+extern bool
+wf_impl_readahead_pop_waiting(
+	struct wf_impl_readahead * readahead,
+	fuse_req_t * request,
+	off_t * offset,
+	size_t * size);
+
+//------------------------------------------------------------------------------
+/// \brief Determines the next speculative read.
+///
+/// On success, the range is marked as pending.
+///
+/// \return true, if a speculative read should be issued
+//------------------------------------------------------------------------------
+extern bool
+wf_impl_readahead_next(
+	struct wf_impl_readahead * readahead,
+	off_t * offset,
+	size_t * size);
+
+extern void
+wf_impl_readahead_fill(
+	struct wf_impl_readahead * readahead,
+	char const * data,
+	size_t size);
+
+extern void
+wf_impl_readahead_fail(
+	struct wf_impl_readahead * readahead);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
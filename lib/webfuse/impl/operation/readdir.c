@@ -1,7 +1,12 @@
 #include "webfuse/impl/operation/readdir.h"
 #include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/operation/dirbuffer.h"
+#include "webfuse/impl/operation/singleflight.h"
+#include "webfuse/impl/attr_cache.h"
+#include "webfuse/impl/inode_table.h"
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <errno.h>
 
@@ -15,56 +20,103 @@
 #include "webfuse/impl/util/json_util.h"
 
 
-#define WF_DIRBUFFER_INITIAL_SIZE 1024
-
-struct wf_impl_dirbuffer
+static void wf_impl_operation_readdir_fetch(
+	fuse_req_t request,
+	fuse_ino_t inode,
+	size_t size,
+	off_t offset,
+	struct wf_impl_dirbuffer * buffer,
+	bool is_plus)
 {
-	char * data;
-	size_t position;
-	size_t capacity;
-};
+    struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
+    struct wf_jsonrpc_proxy * rpc = wf_impl_operation_context_get_proxy(user_data);
 
-static void wf_impl_dirbuffer_init(
-	struct wf_impl_dirbuffer * buffer)
-{
-	buffer->data = malloc(WF_DIRBUFFER_INITIAL_SIZE);
-	buffer->position = 0;
-	buffer->capacity = WF_DIRBUFFER_INITIAL_SIZE;
-}
+	uint64_t id = 0;
+	if ((NULL != rpc) && (wf_impl_inode_table_get_id(user_data->inodes, inode, &id)))
+	{
+		struct wf_impl_operation_readdir_context * readdir_context = malloc(sizeof(struct wf_impl_operation_readdir_context));
+		readdir_context->request = request;
+		readdir_context->id = id;
+		readdir_context->size = size;
+		readdir_context->offset = offset;
+		readdir_context->buffer = buffer;
+		readdir_context->cache = user_data->cache;
+		readdir_context->generation = (NULL != user_data->cache) ? wf_impl_attr_cache_get_generation(user_data->cache) : 0;
+		readdir_context->inodes = user_data->inodes;
+		readdir_context->is_plus = is_plus;
+		readdir_context->uid = 0;
+		readdir_context->gid = 0;
+		readdir_context->timeout = user_data->timeout;
 
-static void wf_impl_dirbuffer_dispose(
-	struct wf_impl_dirbuffer * buffer)
-{
-	free(buffer->data);
-}
+		if (is_plus)
+		{
+			struct fuse_ctx const * context = fuse_req_ctx(request);
+			readdir_context->uid = context->uid;
+			readdir_context->gid = context->gid;
+		}
 
-static void wf_impl_dirbuffer_add(
-	fuse_req_t request,
-	struct wf_impl_dirbuffer * buffer,
-	char const * name,
-	fuse_ino_t inode)
-{
-	size_t const size = fuse_add_direntry(request, NULL, 0, name, NULL, 0);
-	size_t remaining = buffer->capacity - buffer->position;
-	while (remaining < size)
-	{
-		buffer->capacity *= 2;
-		buffer->data = realloc(buffer->data, buffer->capacity);
-		remaining = buffer->capacity - buffer->position;
-	}
-
-	struct stat stat_buffer;
-	memset(&stat_buffer, 0, sizeof(struct stat));
-	stat_buffer.st_ino = inode;
-	fuse_add_direntry(request, 
-		&buffer->data[buffer->position], remaining, name,
-		&stat_buffer, buffer->position + size);
-	buffer->position += size;
+		if (NULL == user_data->singleflight)
+		{
+			wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_readdir_finished, readdir_context, "readdir", "sI", user_data->name, (int64_t) id);
+		}
+		else
+		{
+			struct wf_impl_singleflight_call * call = wf_impl_singleflight_add(user_data->singleflight,
+				"readdir", id, NULL, &wf_impl_operation_readdir_finished, readdir_context);
+			if (NULL != call)
+			{
+				wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_singleflight_finished, call, "readdir", "sI", user_data->name, (int64_t) id);
+			}
+			else
+			{
+				// the reply may predate the recorded generation;
+				// it is cached by the request, which was sent
+				readdir_context->cache = NULL;
+			}
+		}
+	}
+	else
+	{
+		fuse_reply_err(request, ENOENT);
+	}	
 }
 
-static size_t wf_impl_min(size_t a, size_t b)
+// Parses the optional attributes of an extended readdir entry.
+static bool wf_impl_operation_readdir_get_attr(
+	struct wf_impl_operation_readdir_context * context,
+	struct wf_json const * entry,
+	uint64_t id,
+	struct stat * attr)
 {
-	return (a < b) ? a : b;
+	struct wf_json const * mode_holder = wf_impl_json_object_get(entry, "mode");
+	struct wf_json const * type_holder = wf_impl_json_object_get(entry, "type");
+	if ((!wf_impl_json_is_int(mode_holder)) || (!wf_impl_json_is_string(type_holder)))
+	{
+		return false;
+	}
+
+	memset(attr, 0, sizeof(struct stat));
+	attr->st_ino = (ino_t) id;
+	attr->st_mode = wf_impl_json_int_get(mode_holder) & 0555;
+	char const * type = wf_impl_json_string_get(type_holder);
+	if (0 == strcmp("file", type)) 
+	{
+		attr->st_mode |= S_IFREG;
+	}
+	else if (0 == strcmp("dir", type))
+	{
+		attr->st_mode |= S_IFDIR;
+	}
+
+	attr->st_uid = context->uid;
+	attr->st_gid = context->gid;
+	attr->st_nlink = 1;
+	attr->st_size = wf_impl_json_get_int64(entry, "size", 0);
+	attr->st_atime = wf_impl_json_get_int64(entry, "atime", 0);
+	attr->st_mtime = wf_impl_json_get_int64(entry, "mtime", 0);
+	attr->st_ctime = wf_impl_json_get_int64(entry, "ctime", 0);
+
+	return true;
 }
 
 void wf_impl_operation_readdir_finished(
@@ -75,8 +127,17 @@ void wf_impl_operation_readdir_finished(
 	wf_status status = wf_impl_jsonrpc_get_status(error);
 	struct wf_impl_operation_readdir_context * context = user_data;
 
-	struct wf_impl_dirbuffer buffer;
-	wf_impl_dirbuffer_init(&buffer);
+	struct wf_impl_dirbuffer local_buffer;
+	struct wf_impl_dirbuffer * buffer = context->buffer;
+	if (NULL == buffer)
+	{
+		wf_impl_dirbuffer_init(&local_buffer);
+		buffer = &local_buffer;
+	}
+	else
+	{
+		wf_impl_dirbuffer_clear(buffer);
+	}
 
 	if ((NULL != result) && (wf_impl_json_is_array(result)))
 	{
@@ -92,8 +153,31 @@ void wf_impl_operation_readdir_finished(
 				if ((wf_impl_json_is_string(name_holder)) && (wf_impl_json_is_int(inode_holder)))
 				{
 					char const * name = wf_impl_json_string_get(name_holder);
-					fuse_ino_t entry_inode = (fuse_ino_t) wf_impl_json_int_get(inode_holder);
-					wf_impl_dirbuffer_add(context->request, &buffer, name, entry_inode);	
+					uint64_t const entry_id = (uint64_t) wf_impl_json_int64_get(inode_holder);
+					bool const is_special = (0 == strcmp(".", name)) || (0 == strcmp("..", name));
+
+					struct stat attr;
+					bool const has_attr = wf_impl_operation_readdir_get_attr(context, entry, entry_id, &attr);
+					if (has_attr)
+					{
+						wf_impl_dirbuffer_add_plus(buffer, name, &attr);
+					}
+					else
+					{
+						wf_impl_dirbuffer_add(buffer, name, entry_id);
+					}
+
+					// replies to requests sent before an invalidation are not cached
+					if ((NULL != context->cache) && (!is_special) &&
+						(!wf_impl_attr_cache_is_invalidated(context->cache, context->id, context->generation)))
+					{
+						bool const is_valid = !wf_impl_attr_cache_is_invalidated(context->cache, entry_id, context->generation);
+						if ((has_attr) && (is_valid))
+						{
+							wf_impl_attr_cache_set_attr(context->cache, entry_id, &attr);
+						}
+						wf_impl_attr_cache_set_entry(context->cache, context->id, name, entry_id);
+					}	
 				}
 				else
 				{
@@ -113,49 +197,77 @@ void wf_impl_operation_readdir_finished(
 		status = WF_BAD_FORMAT;
 	}
 
-	if (WF_GOOD == status)
+	if ((WF_GOOD == status) && (context->is_plus))
 	{
-		if (((size_t) context->offset) < buffer.position)
-		{
-			fuse_reply_buf(context->request, &buffer.data[context->offset],
-				wf_impl_min(buffer.position - context->offset, context->size));
-		}
-		else
-		{
-			fuse_reply_buf(context->request, NULL, 0);			
-		}
-		
+		wf_impl_dirbuffer_reply_plus(context->request, buffer, context->size, context->offset, context->timeout, context->inodes);
+	}
+	else if (WF_GOOD == status)
+	{
+		wf_impl_dirbuffer_reply(context->request, buffer, context->size, context->offset, context->inodes);
 	}
 	else
 	{
+		if (buffer != &local_buffer)
+		{
+			// drop partial contents, so that the next call fetches them again
+			wf_impl_dirbuffer_clear(buffer);
+		}
+
 		fuse_reply_err(context->request, ENOENT);
 	}
 
-	wf_impl_dirbuffer_dispose(&buffer);
+	if (buffer == &local_buffer)
+	{
+		wf_impl_dirbuffer_cleanup(&local_buffer);
+	}
 	free(context);
 }
 
+static struct wf_impl_dirbuffer * wf_impl_operation_readdir_get_buffer(
+	struct fuse_file_info * file_info)
+{
+	return (NULL != file_info) ? ((struct wf_impl_dirbuffer *) (uintptr_t) file_info->fh) : NULL;
+}
+
 void wf_impl_operation_readdir (
 	fuse_req_t request,
 	fuse_ino_t inode,
 	size_t size,
 	off_t offset,
-	struct fuse_file_info * WF_UNUSED_PARAM(file_info))
+	struct fuse_file_info * file_info)
 {
-    struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
-    struct wf_jsonrpc_proxy * rpc = wf_impl_operation_context_get_proxy(user_data);
-
-	if (NULL != rpc)
+	// directory contents are cached per handle (see opendir):
+	// they are fetched at offset 0 and served from cache afterwards
+	struct wf_impl_dirbuffer * buffer = wf_impl_operation_readdir_get_buffer(file_info);
+	if ((NULL != buffer) && (0 < offset) && (0 < buffer->count))
 	{
-		struct wf_impl_operation_readdir_context * readdir_context = malloc(sizeof(struct wf_impl_operation_readdir_context));
-		readdir_context->request = request;
-		readdir_context->size = size;
-		readdir_context->offset = offset;
+		struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
+		struct wf_impl_inode_table * inodes = (NULL != user_data) ? user_data->inodes : NULL;
+		wf_impl_dirbuffer_reply(request, buffer, size, offset, inodes);
+	}
+	else
+	{
+		wf_impl_operation_readdir_fetch(request, inode, size, offset, buffer, false);
+	}
+}
 
-		wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_readdir_finished, readdir_context, "readdir", "si", user_data->name, inode);
+void wf_impl_operation_readdirplus (
+	fuse_req_t request,
+	fuse_ino_t inode,
+	size_t size,
+	off_t offset,
+	struct fuse_file_info * file_info)
+{
+	struct wf_impl_dirbuffer * buffer = wf_impl_operation_readdir_get_buffer(file_info);
+	if ((NULL != buffer) && (0 < offset) && (0 < buffer->count))
+	{
+		struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
+		double const timeout = (NULL != user_data) ? user_data->timeout : 0.0;
+		struct wf_impl_inode_table * inodes = (NULL != user_data) ? user_data->inodes : NULL;
+		wf_impl_dirbuffer_reply_plus(request, buffer, size, offset, timeout, inodes);
 	}
 	else
 	{
-		fuse_reply_err(request, ENOENT);
-	}	
+		wf_impl_operation_readdir_fetch(request, inode, size, offset, buffer, true);
+	}
 }
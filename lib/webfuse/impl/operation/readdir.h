@@ -3,6 +3,13 @@
 
 #include "webfuse/impl/fuse_wrapper.h"
 
+#ifndef __cplusplus
+#include <stdbool.h>
+#include <stdint.h>
+#else
+#include <cstdint>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -10,12 +17,25 @@ extern "C"
 
 struct wf_jsonrpc_error;
 struct wf_json;
+struct wf_impl_dirbuffer;
+struct wf_impl_attr_cache;
+struct wf_impl_inode_table;
 
 struct wf_impl_operation_readdir_context
 {
 	fuse_req_t request;
+	uint64_t id;
 	size_t size;
 	off_t offset;
+	struct wf_impl_dirbuffer * buffer;
+	struct wf_impl_attr_cache * cache;
+	// invalidation generation of the cache when the request was sent
+	uint64_t generation;
+	struct wf_impl_inode_table * inodes;
+	bool is_plus;
+	uid_t uid;
+	gid_t gid;
+	double timeout;
 };
 
 extern void wf_impl_operation_readdir (
@@ -25,6 +45,20 @@ extern void wf_impl_operation_readdir (
 	off_t offset,
 	struct fuse_file_info *file_info);
 
+//------------------------------------------------------------------------------
+/// \brief Reads directory contents including attributes of each entry.
+///
+/// Uses the same readdir request as wf_impl_operation_readdir. Attributes
+/// are provided by the extended readdir result; entries without attributes
+/// are looked up by the kernel on demand.
+//------------------------------------------------------------------------------
+extern void wf_impl_operation_readdirplus (
+	fuse_req_t request,
+	fuse_ino_t inode,
+	size_t size,
+	off_t offset,
+	struct fuse_file_info *file_info);
+
 extern void wf_impl_operation_readdir_finished(
 	void * user_data,
 	struct wf_json const * result,
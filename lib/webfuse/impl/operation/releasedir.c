@@ -0,0 +1,21 @@
+#include "webfuse/impl/operation/releasedir.h"
+#include "webfuse/impl/operation/dirbuffer.h"
+#include "webfuse/impl/util/util.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+void wf_impl_operation_releasedir(
+	fuse_req_t request,
+	fuse_ino_t WF_UNUSED_PARAM(inode),
+	struct fuse_file_info * file_info)
+{
+	struct wf_impl_dirbuffer * buffer = (struct wf_impl_dirbuffer *) (uintptr_t) file_info->fh;
+	if (NULL != buffer)
+	{
+		wf_impl_dirbuffer_dispose(buffer);
+		file_info->fh = 0;
+	}
+
+	fuse_reply_err(request, 0);
+}
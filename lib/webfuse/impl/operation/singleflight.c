@@ -0,0 +1,211 @@
+#include "webfuse/impl/operation/singleflight.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define WF_SINGLEFLIGHT_BUCKETS 64
+
+struct wf_impl_singleflight_waiter
+{
+	struct wf_impl_singleflight_waiter * next;
+	wf_jsonrpc_proxy_finished_fn * finished;
+	void * user_data;
+};
+
+struct wf_impl_singleflight_call
+{
+	struct wf_impl_singleflight_call * next;
+	struct wf_impl_singleflight * singleflight;
+	size_t bucket;
+	char const * method;
+	fuse_ino_t inode;
+	char * name;
+	struct wf_impl_singleflight_waiter first;
+	struct wf_impl_singleflight_waiter * last;
+};
+
+struct wf_impl_singleflight
+{
+	struct wf_impl_singleflight_call * buckets[WF_SINGLEFLIGHT_BUCKETS];
+	size_t count;
+};
+
+static size_t
+wf_impl_singleflight_hash(
+	char const * method,
+	fuse_ino_t inode,
+	char const * name)
+{
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ULL;
+	for (char const * c = method; '\0' != *c; c++)
+	{
+		hash = (hash ^ ((unsigned char) *c)) * 1099511628211ULL;
+	}
+
+	for (size_t i = 0; i < sizeof(fuse_ino_t); i++)
+	{
+		hash = (hash ^ ((inode >> (i * 8)) & 0xff)) * 1099511628211ULL;
+	}
+
+	if (NULL != name)
+	{
+		for (char const * c = name; '\0' != *c; c++)
+		{
+			hash = (hash ^ ((unsigned char) *c)) * 1099511628211ULL;
+		}
+	}
+
+	return (size_t) (hash % WF_SINGLEFLIGHT_BUCKETS);
+}
+
+static bool
+wf_impl_singleflight_call_matches(
+	struct wf_impl_singleflight_call const * call,
+	char const * method,
+	fuse_ino_t inode,
+	char const * name)
+{
+	if ((call->inode != inode) || (0 != strcmp(call->method, method)))
+	{
+		return false;
+	}
+
+	if ((NULL == call->name) || (NULL == name))
+	{
+		return (call->name == name);
+	}
+
+	return (0 == strcmp(call->name, name));
+}
+
+static void
+wf_impl_singleflight_remove(
+	struct wf_impl_singleflight * singleflight,
+	struct wf_impl_singleflight_call * call)
+{
+	struct wf_impl_singleflight_call * * link = &singleflight->buckets[call->bucket];
+	while (NULL != *link)
+	{
+		if (call == *link)
+		{
+			*link = call->next;
+			call->next = NULL;
+			singleflight->count--;
+			break;
+		}
+
+		link = &((*link)->next);
+	}
+}
+
+struct wf_impl_singleflight *
+wf_impl_singleflight_create(void)
+{
+	struct wf_impl_singleflight * singleflight = malloc(sizeof(struct wf_impl_singleflight));
+	memset(singleflight->buckets, 0, sizeof(singleflight->buckets));
+	singleflight->count = 0;
+
+	return singleflight;
+}
+
+void
+wf_impl_singleflight_dispose(
+	struct wf_impl_singleflight * singleflight)
+{
+	for (size_t i = 0; i < WF_SINGLEFLIGHT_BUCKETS; i++)
+	{
+		struct wf_impl_singleflight_call * call = singleflight->buckets[i];
+		while (NULL != call)
+		{
+			struct wf_impl_singleflight_call * next = call->next;
+			call->singleflight = NULL;
+			call->next = NULL;
+			call = next;
+		}
+	}
+
+	free(singleflight);
+}
+
+struct wf_impl_singleflight_call *
+wf_impl_singleflight_add(
+	struct wf_impl_singleflight * singleflight,
+	char const * method,
+	fuse_ino_t inode,
+	char const * name,
+	wf_jsonrpc_proxy_finished_fn * finished,
+	void * user_data)
+{
+	size_t const bucket = wf_impl_singleflight_hash(method, inode, name);
+	for (struct wf_impl_singleflight_call * call = singleflight->buckets[bucket]; NULL != call; call = call->next)
+	{
+		if (wf_impl_singleflight_call_matches(call, method, inode, name))
+		{
+			struct wf_impl_singleflight_waiter * waiter = malloc(sizeof(struct wf_impl_singleflight_waiter));
+			waiter->next = NULL;
+			waiter->finished = finished;
+			waiter->user_data = user_data;
+
+			call->last->next = waiter;
+			call->last = waiter;
+			return NULL;
+		}
+	}
+
+	struct wf_impl_singleflight_call * call = malloc(sizeof(struct wf_impl_singleflight_call));
+	call->singleflight = singleflight;
+	call->bucket = bucket;
+	call->method = method;
+	call->inode = inode;
+	call->name = (NULL != name) ? strdup(name) : NULL;
+	call->first.next = NULL;
+	call->first.finished = finished;
+	call->first.user_data = user_data;
+	call->last = &call->first;
+
+	call->next = singleflight->buckets[bucket];
+	singleflight->buckets[bucket] = call;
+	singleflight->count++;
+
+	return call;
+}
+
+void
+wf_impl_singleflight_finished(
+	void * user_data,
+	struct wf_json const * result,
+	struct wf_jsonrpc_error const * error)
+{
+	struct wf_impl_singleflight_call * call = user_data;
+
+	// remove the call first, so that requests issued by the finished
+	// functions are not attached to a call already answered
+	if (NULL != call->singleflight)
+	{
+		wf_impl_singleflight_remove(call->singleflight, call);
+	}
+
+	call->first.finished(call->first.user_data, result, error);
+
+	struct wf_impl_singleflight_waiter * waiter = call->first.next;
+	while (NULL != waiter)
+	{
+		struct wf_impl_singleflight_waiter * next = waiter->next;
+		waiter->finished(waiter->user_data, result, error);
+		free(waiter);
+		waiter = next;
+	}
+
+	free(call->name);
+	free(call);
+}
+
+size_t
+wf_impl_singleflight_pending_count(
+	struct wf_impl_singleflight * singleflight)
+{
+	return singleflight->count;
+}
@@ -0,0 +1,81 @@
+#ifndef WF_ADAPTER_IMPL_OPERATION_SINGLEFLIGHT_H
+#define WF_ADAPTER_IMPL_OPERATION_SINGLEFLIGHT_H
+
+#include "webfuse/impl/fuse_wrapper.h"
+#include "webfuse/impl/jsonrpc/proxy_finished_fn.h"
+
+#ifndef __cplusplus
+#include <stddef.h>
+#else
+#include <cstddef>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//------------------------------------------------------------------------------
+/// \brief Coalesces identical in-flight requests.
+///
+/// Requests are identified by method name, inode and an optional name
+/// (e.g. lookup). While a request is pending, identical requests are
+/// attached to it instead of being sent to the provider again. The
+/// response is passed to the finished function of each attached request.
+//------------------------------------------------------------------------------
+struct wf_impl_singleflight;
+struct wf_impl_singleflight_call;
+
+extern struct wf_impl_singleflight *
+wf_impl_singleflight_create(void);
+
+//------------------------------------------------------------------------------
+/// \brief Disposes the singleflight table.
+///
+/// Pending calls are detached, their finished functions are still
+/// called when the response arrives.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_singleflight_dispose(
+	struct wf_impl_singleflight * singleflight);
+
+//------------------------------------------------------------------------------
+/// \brief Adds a request.
+///
+/// If an identical request is pending, the request is attached to it
+/// and NULL is returned. Otherwise, a new call is returned, which must be
+/// invoked using wf_impl_singleflight_finished as finished function and
+/// the call as its user data.
+///
+/// \param singleflight pointer to the singleflight table
+/// \param method name of the method (must outlive the call)
+/// \param inode inode the request refers to
+/// \param name optional name the request refers to (may be NULL)
+/// \param finished function to call when the response arrives
+/// \param user_data user data of finished
+/// \return new call or NULL, if the request was attached to a pending call
+//------------------------------------------------------------------------------
+extern struct wf_impl_singleflight_call *
+wf_impl_singleflight_add(
+	struct wf_impl_singleflight * singleflight,
+	char const * method,
+	fuse_ino_t inode,
+	char const * name,
+	wf_jsonrpc_proxy_finished_fn * finished,
+	void * user_data);
+
+extern void
+wf_impl_singleflight_finished(
+	void * user_data,
+	struct wf_json const * result,
+	struct wf_jsonrpc_error const * error);
+
+extern size_t
+wf_impl_singleflight_pending_count(
+	struct wf_impl_singleflight * singleflight);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
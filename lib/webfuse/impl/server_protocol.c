@@ -9,6 +9,7 @@
 #include "webfuse/protocol_names.h"
 
 #include "webfuse/impl/credentials.h"
+#include "webfuse/impl/invalidation.h"
 #include "webfuse/impl/status.h"
 
 #include "webfuse/impl/jsonrpc/request.h"
@@ -16,6 +17,7 @@
 #include "webfuse/impl/json/node.h"
 #include "webfuse/impl/timer/manager.h"
 #include "webfuse/impl/timer/timer.h"
+#include "webfuse/impl/timer_scheduler.h"
 
 static int wf_impl_server_protocol_callback(
 	struct lws * wsi,
@@ -29,13 +31,16 @@ static int wf_impl_server_protocol_callback(
     if (ws_protocol->callback != &wf_impl_server_protocol_callback) { return 0; }
 
     struct wf_server_protocol * protocol = ws_protocol->user;
-    wf_impl_timer_manager_check(protocol->timer_manager);
     struct wf_impl_session * session = wf_impl_session_manager_get(&protocol->session_manager, wsi);
+    int result = 0;
 
     switch (reason)
     {
         case LWS_CALLBACK_PROTOCOL_INIT:
             protocol->is_operational = true;
+            break;
+        case LWS_CALLBACK_PROTOCOL_DESTROY:
+            wf_impl_timer_scheduler_stop(protocol->timer_scheduler);
             break;
 		case LWS_CALLBACK_ESTABLISHED:
             session = wf_impl_session_manager_add(
@@ -55,15 +60,23 @@ static int wf_impl_server_protocol_callback(
             wf_impl_session_manager_remove(&protocol->session_manager, wsi);
             break;
 		case LWS_CALLBACK_SERVER_WRITEABLE:
-			if (NULL != session)
-			{                
-                wf_impl_session_onwritable(session);
+			if ((NULL != session) && (wsi == session->wsi))
+			{
+                bool const success = wf_impl_session_onwritable(session);
+                result = (success) ? 0 : -1;
 			}
     		break;
         case LWS_CALLBACK_RECEIVE:
             if (NULL != session)
             {
-                wf_impl_session_receive(session, in, len, lws_is_final_fragment(wsi));
+                if (lws_frame_is_binary(wsi))
+                {
+                    wf_impl_session_receive_binary(session, in, len, lws_is_first_fragment(wsi), lws_is_final_fragment(wsi));
+                }
+                else
+                {
+                    wf_impl_session_receive(session, in, len, lws_remaining_packet_payload(wsi), lws_is_final_fragment(wsi));
+                }
             }
             break;
         case LWS_CALLBACK_RAW_RX_FILE:
@@ -72,11 +85,20 @@ static int wf_impl_server_protocol_callback(
                 wf_impl_session_process_filesystem_request(session, wsi);
             }
             break;
+        case LWS_CALLBACK_RAW_CLOSE_FILE:
+            if (NULL != session)
+            {
+                wf_impl_session_close_filesystem(session, wsi);
+            }
+            break;
         default:
             break;
     }
 
-    return 0;
+    // requests might be invoked, so their timeouts must be scheduled
+    wf_impl_timer_scheduler_update(protocol->timer_scheduler, lws_get_context(wsi));
+
+    return result;
 }
 
 struct wf_server_protocol * wf_impl_server_protocol_create(
@@ -199,8 +221,31 @@ static void wf_impl_server_protocol_add_filesystem(
 
     if (WF_GOOD == status)
     {
+        // optional: binary mode for read payloads
+        struct wf_json const * options = wf_impl_json_array_get(params, 1);
+        struct wf_json const * binary = wf_impl_json_object_get(options, "binary");
+        if ((wf_impl_json_is_bool(binary)) && (wf_impl_json_bool_get(binary)))
+        {
+            session->is_binary_enabled = true;
+        }
+
+        // optional: pack multiple messages into one frame
+        struct wf_json const * batch = wf_impl_json_object_get(options, "batch");
+        if ((wf_impl_json_is_bool(batch)) && (wf_impl_json_bool_get(batch)))
+        {
+            session->is_batch_enabled = true;
+        }
+
         struct wf_jsonrpc_response_writer * writer = wf_impl_jsonrpc_request_get_response_writer(request);
         wf_impl_jsonrpc_response_add_string(writer, "id", name);
+        if (session->is_binary_enabled)
+        {
+            wf_impl_jsonrpc_response_add_bool(writer, "binary", true);
+        }
+        if (session->is_batch_enabled)
+        {
+            wf_impl_jsonrpc_response_add_bool(writer, "batch", true);
+        }
         wf_impl_jsonrpc_respond(request);
     }
     else
@@ -209,6 +254,34 @@ static void wf_impl_server_protocol_add_filesystem(
     }
 }
 
+static struct wf_impl_filesystem * wf_impl_server_protocol_get_filesystem(
+    void * user_data,
+    char const * name)
+{
+    struct wf_impl_session * session = user_data;
+    return wf_impl_session_get_filesystem_by_name(session, name);
+}
+
+static void wf_impl_server_protocol_invalidate_inode(
+    struct wf_jsonrpc_request * request,
+    char const * WF_UNUSED_PARAM(method_name),
+    struct wf_json const * params,
+    void * WF_UNUSED_PARAM(user_data))
+{
+    struct wf_impl_session * session = wf_impl_jsonrpc_request_get_userdata(request);
+    wf_impl_invalidation_process_inode(request, params, &wf_impl_server_protocol_get_filesystem, session);
+}
+
+static void wf_impl_server_protocol_invalidate_entry(
+    struct wf_jsonrpc_request * request,
+    char const * WF_UNUSED_PARAM(method_name),
+    struct wf_json const * params,
+    void * WF_UNUSED_PARAM(user_data))
+{
+    struct wf_impl_session * session = wf_impl_jsonrpc_request_get_userdata(request);
+    wf_impl_invalidation_process_entry(request, params, &wf_impl_server_protocol_get_filesystem, session);
+}
+
 void wf_impl_server_protocol_init(
     struct wf_server_protocol * protocol,
     struct wf_impl_mountpoint_factory * mountpoint_factory)
@@ -218,12 +291,15 @@ void wf_impl_server_protocol_init(
     wf_impl_mountpoint_factory_clone(mountpoint_factory, &protocol->mountpoint_factory);
 
     protocol->timer_manager = wf_impl_timer_manager_create();
+    protocol->timer_scheduler = wf_impl_timer_scheduler_create(protocol->timer_manager);
     wf_impl_session_manager_init(&protocol->session_manager);
     wf_impl_authenticators_init(&protocol->authenticators);
 
     protocol->server = wf_impl_jsonrpc_server_create();
     wf_impl_jsonrpc_server_add(protocol->server, "authenticate", &wf_impl_server_protocol_authenticate, protocol);
     wf_impl_jsonrpc_server_add(protocol->server, "add_filesystem", &wf_impl_server_protocol_add_filesystem, protocol);
+    wf_impl_jsonrpc_server_add(protocol->server, "invalidate_inode", &wf_impl_server_protocol_invalidate_inode, protocol);
+    wf_impl_jsonrpc_server_add(protocol->server, "invalidate_entry", &wf_impl_server_protocol_invalidate_entry, protocol);
 }
 
 void wf_impl_server_protocol_cleanup(
@@ -232,9 +308,10 @@ void wf_impl_server_protocol_cleanup(
     protocol->is_operational = false;
 
     wf_impl_jsonrpc_server_dispose(protocol->server);
-    wf_impl_timer_manager_dispose(protocol->timer_manager);
+    wf_impl_timer_scheduler_dispose(protocol->timer_scheduler);
     wf_impl_authenticators_cleanup(&protocol->authenticators);
     wf_impl_session_manager_cleanup(&protocol->session_manager);
+    wf_impl_timer_manager_dispose(protocol->timer_manager);
     wf_impl_mountpoint_factory_cleanup(&protocol->mountpoint_factory);
 }
 
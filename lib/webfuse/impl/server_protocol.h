@@ -18,6 +18,7 @@ extern "C"
 
 struct lws_protocols;
 struct wf_timer_manager;
+struct wf_impl_timer_scheduler;
 
 struct wf_server_protocol
 {
@@ -26,6 +27,7 @@ struct wf_server_protocol
     struct wf_impl_session_manager session_manager;
     struct wf_jsonrpc_server * server;
     struct wf_timer_manager * timer_manager;
+    struct wf_impl_timer_scheduler * timer_scheduler;
     bool is_operational;
 };
 
@@ -1,6 +1,6 @@
 #include "webfuse/impl/session.h"
 #include "webfuse/impl/authenticators.h"
-#include "webfuse/impl/message_queue.h"
+#include "webfuse/impl/message_scheduler.h"
 #include "webfuse/impl/message.h"
 #include "webfuse/impl/mountpoint_factory.h"
 #include "webfuse/impl/mountpoint.h"
@@ -12,13 +12,22 @@
 #include "webfuse/impl/jsonrpc/request.h"
 #include "webfuse/impl/jsonrpc/response.h"
 #include "webfuse/impl/json/doc.h"
+#include "webfuse/impl/json/node.h"
 
 #include <libwebsockets.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define WF_DEFAULT_TIMEOUT (10 * 1000)
 #define WF_DEFAULT_MESSAGE_SIZE (8 * 1024)
+#define WF_DEFAULT_BATCH_SIZE (64 * 1024)
+#define WF_DEFAULT_RECV_CHUNK_COUNT 8
+#define WF_DEFAULT_RECV_MAX_SIZE (64 * 1024)
+#define WF_DEFAULT_FRAGMENT_SIZE (64 * 1024)
+#define WF_DEFAULT_POOL_BUFFER_SIZE 1024
+#define WF_DEFAULT_POOL_MAX_BUFFER_SIZE (64 * 1024)
+#define WF_DEFAULT_POOL_MAX_COUNT 256
 
 static bool wf_impl_session_send(
     struct wf_message * message,
@@ -29,7 +38,7 @@ static bool wf_impl_session_send(
 
     if (NULL != session->wsi)
     {
-        wf_impl_slist_append(&session->messages, &message->item);
+        wf_impl_message_sender_enqueue(&session->sender, session->scheduler, message);
         lws_callback_on_writable(session->wsi);
 
         result = true;
@@ -42,6 +51,22 @@ static bool wf_impl_session_send(
     return result;
 }
 
+// requests cancelled by timeout are not in flight anymore
+static void wf_impl_session_on_timeout(
+    void * user_data)
+{
+    struct wf_impl_session * session = user_data;
+    wf_impl_session_update_flow_control(session);
+}
+
+static void wf_impl_session_on_message_taken(
+    void * user_data,
+    struct wf_message const * message)
+{
+    struct wf_impl_session * session = user_data;
+    wf_impl_jsonrpc_proxy_onsent(session->rpc, message);
+}
+
 struct wf_impl_session * wf_impl_session_create(
     struct lws * wsi,
     struct wf_impl_authenticators * authenticators,
@@ -58,9 +83,19 @@ struct wf_impl_session * wf_impl_session_create(
     session->authenticators = authenticators;
     session->server = server;
     session->mountpoint_factory = mountpoint_factory;
+    session->message_pool = wf_impl_message_pool_create(
+        WF_DEFAULT_POOL_BUFFER_SIZE, WF_DEFAULT_POOL_MAX_BUFFER_SIZE, WF_DEFAULT_POOL_MAX_COUNT);
     session->rpc = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &wf_impl_session_send, session);
-    wf_impl_slist_init(&session->messages);
-    wf_impl_buffer_init(&session->recv_buffer, WF_DEFAULT_MESSAGE_SIZE);
+    wf_impl_jsonrpc_proxy_set_message_pool(session->rpc, session->message_pool);
+    wf_impl_jsonrpc_proxy_set_timeout_handler(session->rpc, &wf_impl_session_on_timeout, session);
+    session->scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_set_taken_handler(session->scheduler, &wf_impl_session_on_message_taken, session);
+    wf_impl_message_sender_init(&session->sender, WF_DEFAULT_FRAGMENT_SIZE);
+    wf_impl_chunk_chain_init(&session->recv_buffer, WF_DEFAULT_MESSAGE_SIZE, WF_DEFAULT_RECV_CHUNK_COUNT, WF_DEFAULT_RECV_MAX_SIZE);
+    wf_impl_arena_init(&session->json_arena, WF_DEFAULT_MESSAGE_SIZE);
+    session->is_binary_enabled = false;
+    session->is_batch_enabled = false;
+    wf_impl_jsonrpc_attachment_init(&session->attachment);
 
     return session;
 }
@@ -82,11 +117,19 @@ static void wf_impl_session_dispose_filesystems(
 void wf_impl_session_dispose(
     struct wf_impl_session * session)
 {
+    wf_impl_jsonrpc_proxy_log_stats(session->rpc, "session");
     wf_impl_jsonrpc_proxy_dispose(session->rpc);
-    wf_impl_message_queue_cleanup(&session->messages);
+    wf_impl_message_sender_log_stats(&session->sender, "session");
+    wf_impl_message_scheduler_log_stats(session->scheduler, "session");
+    wf_impl_message_sender_cleanup(&session->sender);
+    wf_impl_message_scheduler_dispose(session->scheduler);
 
     wf_impl_session_dispose_filesystems(&session->filesystems);
-    wf_impl_buffer_cleanup(&session->recv_buffer);
+    wf_impl_chunk_chain_cleanup(&session->recv_buffer);
+    wf_impl_arena_cleanup(&session->json_arena);
+    wf_impl_jsonrpc_attachment_cleanup(&session->attachment);
+    wf_impl_message_pool_log_stats(session->message_pool, "session");
+    wf_impl_message_pool_dispose(session->message_pool);
     free(session);
 } 
 
@@ -115,6 +158,7 @@ bool wf_impl_session_add_filesystem(
         if (result)
         {
             wf_impl_slist_append(&session->filesystems, &filesystem->item);
+            wf_impl_message_scheduler_add_source(session->scheduler, filesystem, mountpoint->message_weights);
         }
     }
     
@@ -131,20 +175,27 @@ bool wf_impl_session_add_filesystem(
 }
 
 
-void wf_impl_session_onwritable(
+bool wf_impl_session_onwritable(
     struct wf_impl_session * session)
 {
-    if (!wf_impl_slist_empty(&session->messages))
-    {
-        struct wf_slist_item * item = wf_impl_slist_remove_first(&session->messages);                
-        struct wf_message * message = wf_container_of(item, struct wf_message, item);
-        lws_write(session->wsi, (unsigned char*) message->data, message->length, LWS_WRITE_TEXT);
-        wf_impl_message_dispose(message);
+    size_t const batch_size = (session->is_batch_enabled) ? WF_DEFAULT_BATCH_SIZE : 0;
+    bool const result = wf_impl_message_sender_write(&session->sender, session->scheduler, session->wsi, batch_size);
+    wf_impl_session_update_flow_control(session);
 
-        if (!wf_impl_slist_empty(&session->messages))
-        {
-            lws_callback_on_writable(session->wsi);
-        }
+    return result;
+}
+
+static void wf_impl_session_dispatch(
+    struct wf_impl_session * session,
+    struct wf_json const * message)
+{
+    if (wf_impl_jsonrpc_is_response(message))
+    {
+        wf_impl_jsonrpc_proxy_onresult(session->rpc, message);
+    }
+    else if ((wf_impl_jsonrpc_is_request(message)) || (wf_impl_jsonrpc_is_notification(message)))
+    {
+        wf_impl_jsonrpc_server_process(session->server, message, &wf_impl_session_send, session);
     }
 }
 
@@ -153,17 +204,24 @@ static void wf_impl_session_process(
     char * data,
     size_t length)
 {
-    struct wf_json_doc * doc = wf_impl_json_doc_loadb(data, length);
+    struct wf_json_doc * doc = wf_impl_json_doc_loadb_arena(&session->json_arena, data, length);
     if (NULL != doc)
     {
+        wf_impl_jsonrpc_attachment_apply(&session->attachment, doc);
+
         struct wf_json const * message = wf_impl_json_doc_root(doc);
-        if (wf_impl_jsonrpc_is_response(message))
+        if (wf_impl_json_is_array(message))
         {
-            wf_impl_jsonrpc_proxy_onresult(session->rpc, message);
+            // batch: messages are dispatched in order
+            size_t const count = wf_impl_json_array_size(message);
+            for(size_t i = 0; i < count; i++)
+            {
+                wf_impl_session_dispatch(session, wf_impl_json_array_get(message, i));
+            }
         }
-        else if (wf_impl_jsonrpc_is_request(message))
+        else
         {
-            wf_impl_jsonrpc_server_process(session->server, message, &wf_impl_session_send, session);
+            wf_impl_session_dispatch(session, message);
         }
 
         wf_impl_json_doc_dispose(doc);
@@ -174,26 +232,49 @@ void wf_impl_session_receive(
     struct wf_impl_session * session,
     char * data,
     size_t length,
+    size_t remaining,
     bool is_final_fragment)
 {
     if (is_final_fragment)
     {
-        if (wf_impl_buffer_is_empty(&session->recv_buffer))
+        if (wf_impl_chunk_chain_is_empty(&session->recv_buffer))
         {
             wf_impl_session_process(session, data, length);
         }
         else
         {
-            wf_impl_buffer_append(&session->recv_buffer, data, length);
-            wf_impl_session_process(session,
-                wf_impl_buffer_data(&session->recv_buffer),
-                wf_impl_buffer_size(&session->recv_buffer));
-            wf_impl_buffer_clear(&session->recv_buffer);
-        }        
+            size_t size;
+            char * message = wf_impl_chunk_chain_join(&session->recv_buffer, data, length, &size);
+            if (NULL != message)
+            {
+                wf_impl_session_process(session, message, size);
+            }
+            wf_impl_chunk_chain_clear(&session->recv_buffer);
+        }
+
+        wf_impl_session_update_flow_control(session);
     }
     else
     {
-        wf_impl_buffer_append(&session->recv_buffer, data, length);
+        // the remaining payload of the current frame is known
+        if (0 < remaining)
+        {
+            wf_impl_chunk_chain_reserve(&session->recv_buffer, length + remaining);
+        }
+        wf_impl_chunk_chain_append(&session->recv_buffer, data, length);
+    }
+}
+
+void wf_impl_session_receive_binary(
+    struct wf_impl_session * session,
+    char const * data,
+    size_t length,
+    bool is_first_fragment,
+    bool is_final_fragment)
+{
+    if (session->is_binary_enabled)
+    {
+        wf_impl_jsonrpc_attachment_receive(&session->attachment, data, length, is_first_fragment, is_final_fragment);
     }
 }
 
@@ -220,6 +301,24 @@ static struct wf_impl_filesystem * wf_impl_session_get_filesystem(
     return result;
 }
 
+struct wf_impl_filesystem * wf_impl_session_get_filesystem_by_name(
+    struct wf_impl_session * session,
+    char const * name)
+{
+    struct wf_slist_item * item = wf_impl_slist_first(&session->filesystems);
+    while (NULL != item)
+    {
+        struct wf_impl_filesystem * filesystem = wf_container_of(item, struct wf_impl_filesystem, item);
+        if (0 == strcmp(name, filesystem->user_data.name))
+        {
+            return filesystem;
+        }
+
+        item = item->next;
+    }
+
+    return NULL;
+}
 
 bool wf_impl_session_contains_wsi(
     struct wf_impl_session * session,
@@ -238,5 +337,33 @@ void wf_impl_session_process_filesystem_request(
     if (NULL != filesystem)
     {
         wf_impl_filesystem_process_request(filesystem);
+        wf_impl_session_update_flow_control(session);
+    }
+}
+
+void wf_impl_session_close_filesystem(
+    struct wf_impl_session * session,
+    struct lws * wsi)
+{
+    struct wf_impl_filesystem * filesystem = wf_impl_session_get_filesystem(session, wsi);
+    if (NULL != filesystem)
+    {
+        filesystem->wsi = NULL;
+    }
+}
+
+void wf_impl_session_update_flow_control(
+    struct wf_impl_session * session)
+{
+    size_t const in_flight = wf_impl_jsonrpc_proxy_get_pending_count(session->rpc);
+    size_t const queued_bytes = session->sender.queued_bytes;
+
+    struct wf_slist_item * item = wf_impl_slist_first(&session->filesystems);
+    while (NULL != item)
+    {
+        struct wf_impl_filesystem * filesystem = wf_container_of(item, struct wf_impl_filesystem, item);
+        wf_impl_filesystem_update_flow_control(filesystem, in_flight, queued_bytes);
+
+        item = item->next;
     }
 }
@@ -9,13 +9,17 @@
 using std::size_t;
 #endif
 
-#include "webfuse/impl/message_queue.h"
+#include "webfuse/impl/message_scheduler.h"
+#include "webfuse/impl/message_sender.h"
+#include "webfuse/impl/message_pool.h"
 #include "webfuse/impl/filesystem.h"
 #include "webfuse/impl/util/slist.h"
-#include "webfuse/impl/util/buffer.h"
+#include "webfuse/impl/util/chunk_chain.h"
+#include "webfuse/impl/util/arena.h"
 
 #include "webfuse/impl/jsonrpc/proxy.h"
 #include "webfuse/impl/jsonrpc/server.h"
+#include "webfuse/impl/jsonrpc/attachment.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -33,13 +37,19 @@ struct wf_impl_session
     struct wf_slist_item item;
     struct lws * wsi;
     bool is_authenticated;
-    struct wf_slist messages;
+    struct wf_message_scheduler * scheduler;
+    struct wf_message_sender sender;
+    struct wf_message_pool * message_pool;
     struct wf_impl_authenticators * authenticators;
     struct wf_impl_mountpoint_factory * mountpoint_factory;
     struct wf_jsonrpc_server * server;
     struct wf_jsonrpc_proxy * rpc;
     struct wf_slist filesystems;
-    struct wf_buffer recv_buffer; 
+    struct wf_chunk_chain recv_buffer;
+    struct wf_arena json_arena;
+    bool is_binary_enabled;
+    bool is_batch_enabled;
+    struct wf_jsonrpc_attachment attachment;
 };
 
 extern struct wf_impl_session * wf_impl_session_create(
@@ -60,23 +70,75 @@ extern bool wf_impl_session_add_filesystem(
     struct wf_impl_session * session,
     char const * name);
 
+//------------------------------------------------------------------------------
+/// \brief Receives a fragment of a text message.
+///
+/// \param session pointer to the session
+/// \param data fragment
+/// \param length length of the fragment
+/// \param remaining remaining payload of the current frame (size hint)
+/// \param is_final_fragment true, if this is the last fragment of the message
+//------------------------------------------------------------------------------
 extern void wf_impl_session_receive(
     struct wf_impl_session * session,
     char * data,
     size_t length,
+    size_t remaining,
     bool is_final_fragment);
 
-extern void wf_impl_session_onwritable(
+//------------------------------------------------------------------------------
+/// \brief Receives a binary frame.
+///
+/// Binary frames are only accepted, if binary mode is negotiated
+/// (see add_filesystem); otherwise they are ignored.
+//------------------------------------------------------------------------------
+extern void wf_impl_session_receive_binary(
+    struct wf_impl_session * session,
+    char const * data,
+    size_t length,
+    bool is_first_fragment,
+    bool is_final_fragment);
+
+//------------------------------------------------------------------------------
+/// \brief Sends queued messages.
+///
+/// \return false, if the connection failed
+//------------------------------------------------------------------------------
+extern bool wf_impl_session_onwritable(
     struct wf_impl_session * session);
 
 extern bool wf_impl_session_contains_wsi(
     struct wf_impl_session * session,
     struct lws * wsi);
 
+extern struct wf_impl_filesystem * wf_impl_session_get_filesystem_by_name(
+    struct wf_impl_session * session,
+    char const * name);
+
 extern void wf_impl_session_process_filesystem_request(
     struct wf_impl_session * session, 
     struct lws * wsi);
 
+//------------------------------------------------------------------------------
+/// \brief Detaches a filesystem from its connection, which is closed.
+///
+/// lws closes the connections of filesystems before the connection of the
+/// session; flow control must not be applied to them meanwhile.
+//------------------------------------------------------------------------------
+extern void wf_impl_session_close_filesystem(
+    struct wf_impl_session * session,
+    struct lws * wsi);
+
+//------------------------------------------------------------------------------
+/// \brief Pauses or resumes receiving requests of all filesystems according
+///        to the requests in flight and the bytes queued for sending.
+///
+/// Called after requests are completed (by response or timeout) and after
+/// queued messages are sent.
+//------------------------------------------------------------------------------
+extern void wf_impl_session_update_flow_control(
+    struct wf_impl_session * session);
+
 
 #ifdef __cplusplus
 }
@@ -11,6 +11,7 @@
 		case WF_BAD_TIMEOUT: return -ETIMEDOUT;
 		case WF_BAD_BUSY: return -ENOENT;
 		case WF_BAD_FORMAT: return -ENOENT;
+		case WF_BAD_INTERRUPTED: return -EINTR;
 		case WF_BAD_NOENTRY: return -ENOENT;
 		case WF_BAD_ACCESS_DENIED: return -EACCES;
 		default: return -ENOENT;
@@ -27,6 +28,7 @@ char const * wf_impl_status_tostring(wf_status status)
 		case WF_BAD_TIMEOUT: return "Bad (timeout)";
 		case WF_BAD_BUSY: return "Bad (busy)";
 		case WF_BAD_FORMAT: return "Bad (format)";
+		case WF_BAD_INTERRUPTED: return "Bad (interrupted)";
 		case WF_BAD_NOENTRY: return "Bad (no entry)";
 		case WF_BAD_ACCESS_DENIED: return "Bad (access denied)";
 		default: return "Bad (unknown)";
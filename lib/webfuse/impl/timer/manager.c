@@ -5,16 +5,95 @@
 #include <stddef.h>
 #include <stdlib.h>
 
+#define WF_TIMER_MANAGER_INITIAL_CAPACITY 16
+
+// Pending timers are kept in a binary min-heap ordered by timeout,
+// so that the next timer to expire is always at index 0.
 struct wf_timer_manager
 {
-    struct wf_timer * timers;
+    struct wf_timer * * timers;
+    size_t size;
+    size_t capacity;
 };
 
+static bool
+wf_impl_timer_manager_is_before(
+    struct wf_timer const * timer,
+    struct wf_timer const * other)
+{
+    return (0 > ((wf_timer_timediff) (timer->timeout - other->timeout)));
+}
+
+static void
+wf_impl_timer_manager_set(
+    struct wf_timer_manager * manager,
+    size_t index,
+    struct wf_timer * timer)
+{
+    manager->timers[index] = timer;
+    timer->index = index;
+}
+
+static void
+wf_impl_timer_manager_sift_up(
+    struct wf_timer_manager * manager,
+    size_t index)
+{
+    struct wf_timer * timer = manager->timers[index];
+    while (0 < index)
+    {
+        size_t const parent = (index - 1) / 2;
+        if (!wf_impl_timer_manager_is_before(timer, manager->timers[parent]))
+        {
+            break;
+        }
+
+        wf_impl_timer_manager_set(manager, index, manager->timers[parent]);
+        index = parent;
+    }
+
+    wf_impl_timer_manager_set(manager, index, timer);
+}
+
+static void
+wf_impl_timer_manager_sift_down(
+    struct wf_timer_manager * manager,
+    size_t index)
+{
+    struct wf_timer * timer = manager->timers[index];
+    for(;;)
+    {
+        size_t child = (2 * index) + 1;
+        if (child >= manager->size)
+        {
+            break;
+        }
+
+        if (((child + 1) < manager->size) &&
+            (wf_impl_timer_manager_is_before(manager->timers[child + 1], manager->timers[child])))
+        {
+            child++;
+        }
+
+        if (!wf_impl_timer_manager_is_before(manager->timers[child], timer))
+        {
+            break;
+        }
+
+        wf_impl_timer_manager_set(manager, index, manager->timers[child]);
+        index = child;
+    }
+
+    wf_impl_timer_manager_set(manager, index, timer);
+}
+
 struct wf_timer_manager *
 wf_impl_timer_manager_create(void)
 {
     struct wf_timer_manager * manager = malloc(sizeof(struct wf_timer_manager));
-    manager->timers = NULL;
+    manager->capacity = WF_TIMER_MANAGER_INITIAL_CAPACITY;
+    manager->size = 0;
+    manager->timers = malloc(sizeof(struct wf_timer *) * manager->capacity);
 
     return manager;
 }
@@ -23,15 +102,15 @@ void
 wf_impl_timer_manager_dispose(
     struct wf_timer_manager * manager)
 {
-    struct wf_timer * timer = manager->timers;
-    while (NULL != timer)
+    while (0 < manager->size)
     {
-        struct wf_timer * next = timer->next;
+        struct wf_timer * timer = manager->timers[0];
 
+        wf_impl_timer_manager_removetimer(manager, timer);
         wf_impl_timer_trigger(timer);
-        timer = next;
     }
 
+    free(manager->timers);
     free(manager);
 }
 
@@ -39,55 +118,86 @@ wf_impl_timer_manager_dispose(
 void wf_impl_timer_manager_check(
     struct wf_timer_manager * manager)
 {
-    struct wf_timer * timer = manager->timers;
-    while (NULL != timer)
-    {
-        struct wf_timer * next = timer->next;
+    wf_timer_timepoint const now = wf_impl_timer_timepoint_now();
 
-        if (wf_impl_timer_is_timeout(timer))
+    while (0 < manager->size)
+    {
+        struct wf_timer * timer = manager->timers[0];
+        if (0 <= ((wf_timer_timediff) (timer->timeout - now)))
         {
-            wf_impl_timer_manager_removetimer(manager, timer);
-            wf_impl_timer_trigger(timer);
+            break;
         }
 
-        timer = next;
-    }    
+        wf_impl_timer_manager_removetimer(manager, timer);
+        wf_impl_timer_trigger(timer);
+    }
 }
 
-void wf_impl_timer_manager_addtimer(
+bool wf_impl_timer_manager_get_next_timeout(
     struct wf_timer_manager * manager,
-    struct wf_timer * timer)
+    wf_timer_timepoint * timeout)
 {
-    if (NULL != manager->timers)
+    bool const result = (0 < manager->size);
+    if (result)
     {
-        manager->timers->prev = timer;
+        *timeout = manager->timers[0]->timeout;
     }
 
-    timer->next = manager->timers;
-    timer->prev = NULL;
-    manager->timers = timer;
+    return result;
 }
 
-void wf_impl_timer_manager_removetimer(
+size_t wf_impl_timer_manager_size(
+    struct wf_timer_manager * manager)
+{
+    return manager->size;
+}
+
+void wf_impl_timer_manager_addtimer(
     struct wf_timer_manager * manager,
     struct wf_timer * timer)
 {
-    struct wf_timer * prev = timer->prev;
-    struct wf_timer * next = timer->next;
+    if (WF_IMPL_TIMER_INVALID_INDEX != timer->index)
+    {
+        wf_impl_timer_manager_removetimer(manager, timer);
+    }
 
-    if (NULL != prev)
+    if (manager->size >= manager->capacity)
     {
-        prev->next = next;
+        manager->capacity *= 2;
+        manager->timers = realloc(manager->timers, sizeof(struct wf_timer *) * manager->capacity);
     }
 
-    if (NULL != next)
+    size_t const index = manager->size;
+    manager->size++;
+    wf_impl_timer_manager_set(manager, index, timer);
+    wf_impl_timer_manager_sift_up(manager, index);
+}
+
+void wf_impl_timer_manager_removetimer(
+    struct wf_timer_manager * manager,
+    struct wf_timer * timer)
+{
+    size_t const index = timer->index;
+    if ((index >= manager->size) || (manager->timers[index] != timer))
     {
-        next->prev = prev;
+        return;
     }
 
-    if (manager->timers == timer)
+    timer->index = WF_IMPL_TIMER_INVALID_INDEX;
+    manager->size--;
+
+    if (index < manager->size)
     {
-        manager->timers = next;
+        struct wf_timer * last = manager->timers[manager->size];
+        wf_impl_timer_manager_set(manager, index, last);
+
+        if ((0 < index) && (wf_impl_timer_manager_is_before(last, manager->timers[(index - 1) / 2])))
+        {
+            wf_impl_timer_manager_sift_up(manager, index);
+        }
+        else
+        {
+            wf_impl_timer_manager_sift_down(manager, index);
+        }
     }
 }
-
@@ -1,6 +1,15 @@
 #ifndef WF_IMPL_TIMER_MANAGER_H
 #define WF_IMPL_TIMER_MANAGER_H
 
+#include "webfuse/impl/timer/timepoint.h"
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#include <stddef.h>
+#else
+#include <cstddef>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -19,6 +28,22 @@ extern void
 wf_impl_timer_manager_check(
     struct wf_timer_manager * manager);
 
+//------------------------------------------------------------------------------
+/// \brief Returns the timepoint of the next timer to expire.
+///
+/// \param manager pointer to the timer manager
+/// \param timeout receives the timepoint of the next timer
+/// \return true, if there is any pending timer, false otherwise
+//------------------------------------------------------------------------------
+extern bool
+wf_impl_timer_manager_get_next_timeout(
+    struct wf_timer_manager * manager,
+    wf_timer_timepoint * timeout);
+
+extern size_t
+wf_impl_timer_manager_size(
+    struct wf_timer_manager * manager);
+
 #ifdef __cplusplus
 }
 #endif
@@ -13,12 +13,7 @@ wf_impl_timer_create(
     void * user_data)
 {
     struct wf_timer * timer = malloc(sizeof(struct wf_timer));
-    timer->manager = manager;
-    timer->timeout = 0;
-    timer->on_timer = on_timer;
-    timer->user_data = user_data;
-    timer->prev = NULL;
-    timer->next = NULL;
+    wf_impl_timer_init(timer, manager, on_timer, user_data);
 
     return timer;
 }
@@ -27,22 +22,63 @@ void
 wf_impl_timer_dispose(
     struct wf_timer * timer)
 {
+    wf_impl_timer_cleanup(timer);
     free(timer);
 }
 
+void
+wf_impl_timer_init(
+    struct wf_timer * timer,
+    struct wf_timer_manager * manager,
+    wf_timer_on_timer_fn * on_timer,
+    void * user_data)
+{
+    timer->manager = manager;
+    timer->timeout = 0;
+    timer->on_timer = on_timer;
+    timer->user_data = user_data;
+    timer->index = WF_IMPL_TIMER_INVALID_INDEX;
+}
+
+void
+wf_impl_timer_cleanup(
+    struct wf_timer * timer)
+{
+    if (WF_IMPL_TIMER_INVALID_INDEX != timer->index)
+    {
+        wf_impl_timer_manager_removetimer(timer->manager, timer);
+    }
+}
+
 void wf_impl_timer_start(
     struct wf_timer * timer,
     int timeout_ms)
 {
-    timer->timeout = wf_impl_timer_timepoint_in_msec(timeout_ms);
+    wf_impl_timer_start_at(timer, wf_impl_timer_timepoint_in_msec(timeout_ms));
+}
+
+void wf_impl_timer_start_at(
+    struct wf_timer * timer,
+    wf_timer_timepoint timeout)
+{
+    timer->timeout = timeout;
 
     wf_impl_timer_manager_addtimer(timer->manager, timer);
 }
 
+bool wf_impl_timer_is_running(
+    struct wf_timer * timer)
+{
+    return (WF_IMPL_TIMER_INVALID_INDEX != timer->index);
+}
+
 void wf_impl_timer_cancel(
     struct wf_timer * timer)
 {
-    wf_impl_timer_manager_removetimer(timer->manager, timer);
+    if (WF_IMPL_TIMER_INVALID_INDEX != timer->index)
+    {
+        wf_impl_timer_manager_removetimer(timer->manager, timer);
+    }
 
     timer->timeout = 0;
 }
@@ -59,9 +95,6 @@ void wf_impl_timer_trigger(
 {
     if (0 != timer->on_timer)
     {
-        timer->prev = NULL;
-        timer->next = NULL;
-
         timer->on_timer(timer, timer->user_data);
     }
 }
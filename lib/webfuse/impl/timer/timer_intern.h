@@ -1,5 +1,5 @@
-#ifndef WF_IMPL_TIMER_TIMER_H
-#define WF_IMPL_TIMER_TIMER_H
+#ifndef WF_IMPL_TIMER_TIMER_INTERN_H
+#define WF_IMPL_TIMER_TIMER_INTERN_H
 
 #include "webfuse/impl/timer/timer.h"
 #include "webfuse/impl/timer/on_timer_fn.h"
@@ -7,8 +7,13 @@
 
 #ifndef __cplusplus
 #include <stdbool.h>
+#include <stddef.h>
+#else
+#include <cstddef>
 #endif
 
+#define WF_IMPL_TIMER_INVALID_INDEX ((size_t) -1)
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -20,10 +25,28 @@ struct wf_timer
     wf_timer_timepoint timeout;
     wf_timer_on_timer_fn * on_timer;
     void * user_data;
-    struct wf_timer * next;
-    struct wf_timer * prev;
+    size_t index;
 };
 
+extern void wf_impl_timer_init(
+    struct wf_timer * timer,
+    struct wf_timer_manager * manager,
+    wf_timer_on_timer_fn * on_timer,
+    void * user_data);
+
+extern void wf_impl_timer_cleanup(
+    struct wf_timer * timer);
+
+//------------------------------------------------------------------------------
+/// \brief Starts a timer with an absolute timeout.
+//------------------------------------------------------------------------------
+extern void wf_impl_timer_start_at(
+    struct wf_timer * timer,
+    wf_timer_timepoint timeout);
+
+extern bool wf_impl_timer_is_running(
+    struct wf_timer * timer);
+
 extern bool wf_impl_timer_is_timeout(
     struct wf_timer * timer);
 
@@ -0,0 +1,98 @@
+#include "webfuse/impl/timer_scheduler.h"
+#include "webfuse/impl/timer/manager.h"
+#include "webfuse/impl/timer/timepoint.h"
+#include "webfuse/impl/util/container_of.h"
+
+#include <libwebsockets.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WF_TIMER_SCHEDULER_USEC_PER_MSEC ((lws_usec_t) 1000)
+
+struct wf_impl_timer_scheduler
+{
+    lws_sorted_usec_list_t sul;
+    struct wf_timer_manager * manager;
+    struct lws_context * context;
+    bool is_stopped;
+    bool is_scheduled;
+    wf_timer_timepoint timeout;
+};
+
+static void
+wf_impl_timer_scheduler_on_wakeup(
+    lws_sorted_usec_list_t * sul)
+{
+    struct wf_impl_timer_scheduler * scheduler = wf_container_of(sul, struct wf_impl_timer_scheduler, sul);
+    scheduler->is_scheduled = false;
+
+    wf_impl_timer_manager_check(scheduler->manager);
+    wf_impl_timer_scheduler_update(scheduler, scheduler->context);
+}
+
+struct wf_impl_timer_scheduler *
+wf_impl_timer_scheduler_create(
+    struct wf_timer_manager * manager)
+{
+    struct wf_impl_timer_scheduler * scheduler = malloc(sizeof(struct wf_impl_timer_scheduler));
+    memset(&scheduler->sul, 0, sizeof(lws_sorted_usec_list_t));
+    scheduler->manager = manager;
+    scheduler->context = NULL;
+    scheduler->is_stopped = false;
+    scheduler->is_scheduled = false;
+    scheduler->timeout = 0;
+
+    return scheduler;
+}
+
+void
+wf_impl_timer_scheduler_dispose(
+    struct wf_impl_timer_scheduler * scheduler)
+{
+    free(scheduler);
+}
+
+void
+wf_impl_timer_scheduler_update(
+    struct wf_impl_timer_scheduler * scheduler,
+    struct lws_context * context)
+{
+    wf_timer_timepoint timeout;
+    if ((scheduler->is_stopped) || (NULL == context) ||
+        (!wf_impl_timer_manager_get_next_timeout(scheduler->manager, &timeout)))
+    {
+        return;
+    }
+
+    // a wakeup scheduled before the next timeout is kept; it re-schedules itself
+    if ((scheduler->is_scheduled) && (0 >= ((wf_timer_timediff) (scheduler->timeout - timeout))))
+    {
+        return;
+    }
+
+    // timers expire, once their timeout has passed (see wf_impl_timer_manager_check)
+    wf_timer_timediff delay = (wf_timer_timediff) (timeout - wf_impl_timer_timepoint_now());
+    delay = (0 < delay) ? (delay + 1) : 1;
+
+    scheduler->context = context;
+    scheduler->is_scheduled = true;
+    scheduler->timeout = timeout;
+    lws_sul_schedule(context, 0, &scheduler->sul, &wf_impl_timer_scheduler_on_wakeup,
+        ((lws_usec_t) delay) * WF_TIMER_SCHEDULER_USEC_PER_MSEC);
+}
+
+void
+wf_impl_timer_scheduler_stop(
+    struct wf_impl_timer_scheduler * scheduler)
+{
+    if (scheduler->is_scheduled)
+    {
+        lws_sul_schedule(scheduler->context, 0, &scheduler->sul, &wf_impl_timer_scheduler_on_wakeup,
+            LWS_SET_TIMER_USEC_CANCEL);
+        scheduler->is_scheduled = false;
+    }
+
+    scheduler->is_stopped = true;
+}
@@ -0,0 +1,62 @@
+#ifndef WF_IMPL_TIMER_SCHEDULER_H
+#define WF_IMPL_TIMER_SCHEDULER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct wf_timer_manager;
+struct lws_context;
+
+//------------------------------------------------------------------------------
+/// \brief Checks timers of a timer manager from the lws event loop.
+///
+/// The service thread is woken when the next timer expires, so that
+/// timeouts are detected even if no connection is serviced meanwhile
+/// (e.g. while a filesystem is paused by flow control and the provider
+/// does not respond).
+//------------------------------------------------------------------------------
+struct wf_impl_timer_scheduler;
+
+extern struct wf_impl_timer_scheduler *
+wf_impl_timer_scheduler_create(
+    struct wf_timer_manager * manager);
+
+//------------------------------------------------------------------------------
+/// \brief Disposes the scheduler.
+///
+/// The scheduler must be stopped before, since it cannot be cancelled once
+/// the lws context is destroyed.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_timer_scheduler_dispose(
+    struct wf_impl_timer_scheduler * scheduler);
+
+//------------------------------------------------------------------------------
+/// \brief Schedules a wakeup for the next timer to expire.
+///
+/// Must be called after timers are started, i.e. at the end of each
+/// protocol callback. Has no effect once the scheduler is stopped.
+///
+/// \param scheduler pointer to the scheduler
+/// \param context lws context of the service thread
+//------------------------------------------------------------------------------
+extern void
+wf_impl_timer_scheduler_update(
+    struct wf_impl_timer_scheduler * scheduler,
+    struct lws_context * context);
+
+//------------------------------------------------------------------------------
+/// \brief Cancels a scheduled wakeup; must be called before the lws context
+///        is destroyed (e.g. on LWS_CALLBACK_PROTOCOL_DESTROY).
+//------------------------------------------------------------------------------
+extern void
+wf_impl_timer_scheduler_stop(
+    struct wf_impl_timer_scheduler * scheduler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,149 @@
+#include "webfuse/impl/util/arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define WF_ARENA_ALIGNMENT (2 * sizeof(void *))
+#define WF_ARENA_MAX_RETAINED_SIZE (1024 * 1024)
+
+struct wf_arena_block
+{
+    struct wf_arena_block * next;
+    size_t capacity;
+    size_t size;
+    size_t last;
+};
+
+#define WF_ARENA_BLOCK_HEADER_SIZE \
+    ((sizeof(struct wf_arena_block) + WF_ARENA_ALIGNMENT - 1) & ~(WF_ARENA_ALIGNMENT - 1))
+
+static size_t
+wf_impl_arena_align(
+    size_t size)
+{
+    return (size + WF_ARENA_ALIGNMENT - 1) & ~(WF_ARENA_ALIGNMENT - 1);
+}
+
+static char *
+wf_impl_arena_block_data(
+    struct wf_arena_block * block)
+{
+    return ((char *) block) + WF_ARENA_BLOCK_HEADER_SIZE;
+}
+
+static struct wf_arena_block *
+wf_impl_arena_block_create(
+    size_t capacity,
+    struct wf_arena_block * next)
+{
+    struct wf_arena_block * block = malloc(WF_ARENA_BLOCK_HEADER_SIZE + capacity);
+    block->next = next;
+    block->capacity = capacity;
+    block->size = 0;
+    block->last = 0;
+
+    return block;
+}
+
+static void
+wf_impl_arena_free_blocks(
+    struct wf_arena_block * block)
+{
+    while (NULL != block)
+    {
+        struct wf_arena_block * next = block->next;
+        free(block);
+        block = next;
+    }
+}
+
+void
+wf_impl_arena_init(
+    struct wf_arena * arena,
+    size_t block_size)
+{
+    arena->block_size = wf_impl_arena_align(block_size);
+    arena->blocks = wf_impl_arena_block_create(arena->block_size, NULL);
+}
+
+void
+wf_impl_arena_cleanup(
+    struct wf_arena * arena)
+{
+    wf_impl_arena_free_blocks(arena->blocks);
+    arena->blocks = NULL;
+}
+
+void
+wf_impl_arena_reset(
+    struct wf_arena * arena)
+{
+    struct wf_arena_block * block = arena->blocks;
+    if (NULL != block->next)
+    {
+        size_t capacity = 0;
+        for(struct wf_arena_block * current = block; NULL != current; current = current->next)
+        {
+            capacity += current->capacity;
+        }
+
+        if (WF_ARENA_MAX_RETAINED_SIZE < capacity)
+        {
+            capacity = arena->block_size;
+        }
+
+        wf_impl_arena_free_blocks(block);
+        block = wf_impl_arena_block_create(capacity, NULL);
+        arena->blocks = block;
+    }
+
+    block->size = 0;
+    block->last = 0;
+}
+
+void *
+wf_impl_arena_alloc(
+    struct wf_arena * arena,
+    size_t size)
+{
+    size = wf_impl_arena_align(size);
+
+    struct wf_arena_block * block = arena->blocks;
+    if (size > (block->capacity - block->size))
+    {
+        size_t const capacity = (size > arena->block_size) ? size : arena->block_size;
+        block = wf_impl_arena_block_create(capacity, block);
+        arena->blocks = block;
+    }
+
+    block->last = block->size;
+    block->size += size;
+
+    return &(wf_impl_arena_block_data(block)[block->last]);
+}
+
+void *
+wf_impl_arena_realloc(
+    struct wf_arena * arena,
+    void * data,
+    size_t old_size,
+    size_t new_size)
+{
+    struct wf_arena_block * block = arena->blocks;
+    char * last = &(wf_impl_arena_block_data(block)[block->last]);
+    size_t const aligned_size = wf_impl_arena_align(new_size);
+
+    if ((data == last) && (aligned_size <= (block->capacity - block->last)))
+    {
+        block->size = block->last + aligned_size;
+        return data;
+    }
+
+    void * result = wf_impl_arena_alloc(arena, new_size);
+    if ((NULL != data) && (0 < old_size))
+    {
+        memcpy(result, data, (old_size < new_size) ? old_size : new_size);
+    }
+
+    return result;
+}
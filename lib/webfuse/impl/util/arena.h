@@ -0,0 +1,69 @@
+#ifndef WF_IMPL_UTIL_ARENA_H
+#define WF_IMPL_UTIL_ARENA_H
+
+#ifndef __cplusplus
+#include <stddef.h>
+#else
+#include <cstddef>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct wf_arena_block;
+
+//------------------------------------------------------------------------------
+/// \brief Bump allocator.
+///
+/// Memory is allocated from blocks and released all at once
+/// by wf_impl_arena_reset or wf_impl_arena_cleanup.
+///
+/// When an arena is reset after it needed multiple blocks, these
+/// blocks are merged into a single one, so that a reused arena
+/// reaches a steady state without any further allocations.
+//------------------------------------------------------------------------------
+struct wf_arena
+{
+    struct wf_arena_block * blocks;
+    size_t block_size;
+};
+
+extern void
+wf_impl_arena_init(
+    struct wf_arena * arena,
+    size_t block_size);
+
+extern void
+wf_impl_arena_cleanup(
+    struct wf_arena * arena);
+
+extern void
+wf_impl_arena_reset(
+    struct wf_arena * arena);
+
+extern void *
+wf_impl_arena_alloc(
+    struct wf_arena * arena,
+    size_t size);
+
+//------------------------------------------------------------------------------
+/// \brief Resizes an allocation.
+///
+/// The allocation is resized in place, if it is the most recent allocation
+/// and there is enough space left in its block. Otherwise, a new
+/// allocation is returned; the old one is not released before reset.
+//------------------------------------------------------------------------------
+extern void *
+wf_impl_arena_realloc(
+    struct wf_arena * arena,
+    void * data,
+    size_t old_size,
+    size_t new_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,4 +1,9 @@
 #include "webfuse/impl/util/base64.h"
+#include "webfuse/impl/util/base64_intern.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define WF_IMPL_BASE64_X86
+#endif
 
 static const uint8_t wf_impl_base64_decode_table[256] = {
     // 0     1     2     3     4     5     6     7     8      9    A     B     C     D     E     F  
@@ -20,7 +25,137 @@ static const uint8_t wf_impl_base64_decode_table[256] = {
     0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // F
 };
 
+static enum wf_impl_base64_impl wf_impl_base64_selected_impl = WF_IMPL_BASE64_AUTO;
+
+static enum wf_impl_base64_impl
+wf_impl_base64_detect_impl(void)
+{
+#if defined(WF_IMPL_BASE64_X86)
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return WF_IMPL_BASE64_AVX2;
+    }
+
+    if (__builtin_cpu_supports("sse4.1"))
+    {
+        return WF_IMPL_BASE64_SSE41;
+    }
+#elif defined(__aarch64__)
+    return WF_IMPL_BASE64_NEON;
+#endif
+
+    return WF_IMPL_BASE64_SCALAR;
+}
+
+bool
+wf_impl_base64_impl_supported(
+    enum wf_impl_base64_impl impl)
+{
+    switch (impl)
+    {
+        case WF_IMPL_BASE64_AUTO:
+            // fall-through
+        case WF_IMPL_BASE64_SCALAR:
+            return true;
+#if defined(WF_IMPL_BASE64_X86)
+        case WF_IMPL_BASE64_SSE41:
+            return __builtin_cpu_supports("sse4.1");
+        case WF_IMPL_BASE64_AVX2:
+            return __builtin_cpu_supports("avx2");
+#elif defined(__aarch64__)
+        case WF_IMPL_BASE64_NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+bool
+wf_impl_base64_set_impl(
+    enum wf_impl_base64_impl impl)
+{
+    bool const result = wf_impl_base64_impl_supported(impl);
+    if (result)
+    {
+        wf_impl_base64_selected_impl = impl;
+    }
+
+    return result;
+}
 
+enum wf_impl_base64_impl
+wf_impl_base64_get_impl(void)
+{
+    return (WF_IMPL_BASE64_AUTO != wf_impl_base64_selected_impl) ?
+        wf_impl_base64_selected_impl : wf_impl_base64_detect_impl();
+}
+
+static size_t
+wf_impl_base64_encode_blocks(
+    uint8_t const * data,
+    size_t length,
+    char * buffer)
+{
+    switch (wf_impl_base64_get_impl())
+    {
+#if defined(WF_IMPL_BASE64_X86)
+        case WF_IMPL_BASE64_AVX2:
+            return wf_impl_base64_encode_avx2(data, length, buffer);
+        case WF_IMPL_BASE64_SSE41:
+            return wf_impl_base64_encode_sse41(data, length, buffer);
+#elif defined(__aarch64__)
+        case WF_IMPL_BASE64_NEON:
+            return wf_impl_base64_encode_neon(data, length, buffer);
+#endif
+        default:
+            return 0;
+    }
+}
+
+static size_t
+wf_impl_base64_decode_blocks(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    size_t buffer_size)
+{
+    switch (wf_impl_base64_get_impl())
+    {
+#if defined(WF_IMPL_BASE64_X86)
+        case WF_IMPL_BASE64_AVX2:
+            return wf_impl_base64_decode_avx2(data, length, buffer, buffer_size);
+        case WF_IMPL_BASE64_SSE41:
+            return wf_impl_base64_decode_sse41(data, length, buffer, buffer_size);
+#elif defined(__aarch64__)
+        case WF_IMPL_BASE64_NEON:
+            return wf_impl_base64_decode_neon(data, length, buffer, buffer_size);
+#endif
+        default:
+            return 0;
+    }
+}
+
+static size_t
+wf_impl_base64_validate_blocks(
+    char const * data,
+    size_t length)
+{
+    switch (wf_impl_base64_get_impl())
+    {
+#if defined(WF_IMPL_BASE64_X86)
+        case WF_IMPL_BASE64_AVX2:
+            return wf_impl_base64_validate_avx2(data, length);
+        case WF_IMPL_BASE64_SSE41:
+            return wf_impl_base64_validate_sse41(data, length);
+#elif defined(__aarch64__)
+        case WF_IMPL_BASE64_NEON:
+            return wf_impl_base64_validate_neon(data, length);
+#endif
+        default:
+            return 0;
+    }
+}
 
 size_t wf_impl_base64_encoded_size(size_t length)
 {
@@ -42,8 +177,8 @@ size_t wf_impl_base64_encode(
         return 0;
     }
 
-    size_t pos = 0;
-    size_t out_pos = 0;
+    size_t pos = wf_impl_base64_encode_blocks(data, length, buffer);
+    size_t out_pos = (pos / 3) * 4;
     for(; (length - pos) >= 3; pos += 3)
     {
         buffer[out_pos++] = table[ data[pos] >> 2 ];
@@ -111,8 +246,9 @@ size_t wf_impl_base64_decode(
         return 0;
     }
 
-    size_t out_pos = 0;
-    size_t pos = 0;
+    // last block is decoded separately, since it may contain padding
+    size_t pos = wf_impl_base64_decode_blocks(data, length - 4, buffer, buffer_size);
+    size_t out_pos = (pos / 4) * 3;
     for(; pos < length - 4; pos += 4)
     {
         uint8_t a = table[ (unsigned char) data[pos    ] ];
@@ -155,7 +291,7 @@ extern bool wf_impl_base64_isvalid(char const * data, size_t length)
         return false;
     }
 
-    size_t pos = 0;
+    size_t pos = wf_impl_base64_validate_blocks(data, length - 2);
     for(; pos < (length - 2); pos++)
     {
         unsigned char c = (unsigned char) data[pos];
@@ -0,0 +1,154 @@
+#include "webfuse/impl/util/base64_intern.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#define WF_BASE64_AVX2 __attribute__((target("avx2")))
+
+// See base64_sse41.c; same algorithms operating on two 128 bit lanes.
+
+static inline WF_BASE64_AVX2 __m256i
+wf_impl_base64_avx2_translate(
+    __m256i indices)
+{
+    __m256i const shift_lut = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+
+    __m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    __m256i const less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+    result = _mm256_shuffle_epi8(shift_lut, result);
+
+    return _mm256_add_epi8(result, indices);
+}
+
+static inline WF_BASE64_AVX2 bool
+wf_impl_base64_avx2_lookup(
+    __m256i * value)
+{
+    __m256i const lut_lo = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    __m256i const lut_hi = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    __m256i const lut_roll = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71,
+        0, 0, 0, 0, 0, 0, 0, 0);
+    __m256i const mask_2f = _mm256_set1_epi8(0x2f);
+
+    __m256i const hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(*value, 4), mask_2f);
+    __m256i const lo_nibbles = _mm256_and_si256(*value, mask_2f);
+    __m256i const lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+    __m256i const hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+
+    if (!_mm256_testz_si256(lo, hi))
+    {
+        return false;
+    }
+
+    __m256i const is_slash = _mm256_cmpeq_epi8(*value, mask_2f);
+    __m256i const roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(is_slash, hi_nibbles));
+    *value = _mm256_add_epi8(*value, roll);
+
+    return true;
+}
+
+WF_BASE64_AVX2 size_t
+wf_impl_base64_encode_avx2(
+    uint8_t const * data,
+    size_t length,
+    char * buffer)
+{
+    size_t pos = 0;
+    size_t out_pos = 0;
+
+    // each lane loads 16 bytes, but only 12 are consumed
+    for(; (pos + 28) <= length; pos += 24)
+    {
+        __m256i value = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((__m128i const *) &data[pos])),
+            _mm_loadu_si128((__m128i const *) &data[pos + 12]), 1);
+        value = _mm256_shuffle_epi8(value, _mm256_setr_epi8(
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+        __m256i const t0 = _mm256_and_si256(value, _mm256_set1_epi32(0x0fc0fc00));
+        __m256i const t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        __m256i const t2 = _mm256_and_si256(value, _mm256_set1_epi32(0x003f03f0));
+        __m256i const t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+
+        __m256i const result = wf_impl_base64_avx2_translate(_mm256_or_si256(t1, t3));
+        _mm256_storeu_si256((__m256i *) &buffer[out_pos], result);
+        out_pos += 32;
+    }
+
+    return pos;
+}
+
+WF_BASE64_AVX2 size_t
+wf_impl_base64_decode_avx2(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    size_t buffer_size)
+{
+    size_t pos = 0;
+    size_t out_pos = 0;
+
+    // 32 bytes are stored, but only 24 are produced
+    for(; ((pos + 32) <= length) && ((out_pos + 32) <= buffer_size); pos += 32)
+    {
+        __m256i value = _mm256_loadu_si256((__m256i const *) &data[pos]);
+        if (!wf_impl_base64_avx2_lookup(&value))
+        {
+            break;
+        }
+
+        value = _mm256_maddubs_epi16(value, _mm256_set1_epi32(0x01400140));
+        value = _mm256_madd_epi16(value, _mm256_set1_epi32(0x00011000));
+        value = _mm256_shuffle_epi8(value, _mm256_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        value = _mm256_permutevar8x32_epi32(value, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+        _mm256_storeu_si256((__m256i *) &buffer[out_pos], value);
+        out_pos += 24;
+    }
+
+    return pos;
+}
+
+WF_BASE64_AVX2 size_t
+wf_impl_base64_validate_avx2(
+    char const * data,
+    size_t length)
+{
+    size_t pos = 0;
+    for(; (pos + 32) <= length; pos += 32)
+    {
+        __m256i value = _mm256_loadu_si256((__m256i const *) &data[pos]);
+        if (!wf_impl_base64_avx2_lookup(&value))
+        {
+            break;
+        }
+    }
+
+    return pos;
+}
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef WF_IMPL_UTIL_BASE64_INTERN_H
+#define WF_IMPL_UTIL_BASE64_INTERN_H
+
+#include "webfuse/impl/util/base64.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//------------------------------------------------------------------------------
+/// \brief Implementations of base64 kernels.
+///
+/// By default, the fastest implementation supported by the CPU is
+/// chosen at runtime (WF_IMPL_BASE64_AUTO).
+//------------------------------------------------------------------------------
+enum wf_impl_base64_impl
+{
+    WF_IMPL_BASE64_AUTO,
+    WF_IMPL_BASE64_SCALAR,
+    WF_IMPL_BASE64_SSE41,
+    WF_IMPL_BASE64_AVX2,
+    WF_IMPL_BASE64_NEON
+};
+
+extern bool
+wf_impl_base64_impl_supported(
+    enum wf_impl_base64_impl impl);
+
+//------------------------------------------------------------------------------
+/// \brief Selects the implementation used by the base64 functions.
+///
+/// Intended for tests and benchmarks only; this is not thread safe.
+///
+/// \param impl implementation to use; WF_IMPL_BASE64_AUTO restores
+///             runtime detection
+/// \return true, if the implementation is supported, false otherwise
+//------------------------------------------------------------------------------
+extern bool
+wf_impl_base64_set_impl(
+    enum wf_impl_base64_impl impl);
+
+extern enum wf_impl_base64_impl
+wf_impl_base64_get_impl(void);
+
+//------------------------------------------------------------------------------
+// Kernels
+//
+// Kernels process complete blocks only and return the count of input bytes
+// processed. The remainder is handled by the scalar implementation.
+//
+// encode:   consumes a multiple of 3 bytes; buffer must provide space
+//           for the complete encoded input
+// decode:   consumes a multiple of 4 characters and stops at the first
+//           block containing a non-alphabet character (including '=');
+//           writes at most buffer_size bytes; data and buffer may be the
+//           same (in place decoding)
+// validate: returns the count of leading characters known to be part
+//           of the alphabet (excluding '=')
+//------------------------------------------------------------------------------
+
+extern size_t
+wf_impl_base64_encode_sse41(
+    uint8_t const * data,
+    size_t length,
+    char * buffer);
+
+extern size_t
+wf_impl_base64_decode_sse41(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    size_t buffer_size);
+
+extern size_t
+wf_impl_base64_validate_sse41(
+    char const * data,
+    size_t length);
+
+extern size_t
+wf_impl_base64_encode_avx2(
+    uint8_t const * data,
+    size_t length,
+    char * buffer);
+
+extern size_t
+wf_impl_base64_decode_avx2(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    size_t buffer_size);
+
+extern size_t
+wf_impl_base64_validate_avx2(
+    char const * data,
+    size_t length);
+
+extern size_t
+wf_impl_base64_encode_neon(
+    uint8_t const * data,
+    size_t length,
+    char * buffer);
+
+extern size_t
+wf_impl_base64_decode_neon(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    size_t buffer_size);
+
+extern size_t
+wf_impl_base64_validate_neon(
+    char const * data,
+    size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
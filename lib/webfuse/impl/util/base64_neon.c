@@ -0,0 +1,143 @@
+#include "webfuse/impl/util/base64_intern.h"
+
+#if defined(__aarch64__)
+
+#include <arm_neon.h>
+
+// NEON is mandatory on AArch64, so no runtime detection is needed.
+// Characters are (de-)interleaved by vld3q / vld4q and translated
+// using 64 byte table lookups.
+
+static uint8_t const wf_impl_base64_neon_encode_table[64] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// maps characters 0..127 to 6 bit values; 0xff marks invalid characters
+static uint8_t const wf_impl_base64_neon_decode_table[128] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,   62, 0xff, 0xff, 0xff,   63,
+      52,   53,   54,   55,   56,   57,   58,   59,   60,   61, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff,    0,    1,    2,    3,    4,    5,    6,    7,    8,    9,   10,   11,   12,   13,   14,
+      15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+      41,   42,   43,   44,   45,   46,   47,   48,   49,   50,   51, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+static inline uint8x16_t
+wf_impl_base64_neon_lookup(
+    uint8x16x4_t const * table_lo,
+    uint8x16x4_t const * table_hi,
+    uint8x16_t value)
+{
+    // indices out of range yield 0 (vqtbl4q) or keep the value (vqtbx4q);
+    // characters >= 128 are detected by the caller
+    uint8x16_t result = vqtbl4q_u8(*table_lo, value);
+    return vqtbx4q_u8(result, *table_hi, vsubq_u8(value, vdupq_n_u8(64)));
+}
+
+static inline bool
+wf_impl_base64_neon_decode_block(
+    uint8x16x4_t const * table_lo,
+    uint8x16x4_t const * table_hi,
+    char const * data,
+    uint8x16x4_t * values)
+{
+    uint8x16x4_t const chars = vld4q_u8((uint8_t const *) data);
+    uint8x16_t invalid = vorrq_u8(vorrq_u8(chars.val[0], chars.val[1]), vorrq_u8(chars.val[2], chars.val[3]));
+
+    for(int i = 0; i < 4; i++)
+    {
+        values->val[i] = wf_impl_base64_neon_lookup(table_lo, table_hi, chars.val[i]);
+        invalid = vorrq_u8(invalid, values->val[i]);
+    }
+
+    return (vmaxvq_u8(invalid) < 0x80);
+}
+
+size_t
+wf_impl_base64_encode_neon(
+    uint8_t const * data,
+    size_t length,
+    char * buffer)
+{
+    uint8x16x4_t const table = vld1q_u8_x4(wf_impl_base64_neon_encode_table);
+    uint8x16_t const mask = vdupq_n_u8(0x3f);
+
+    size_t pos = 0;
+    size_t out_pos = 0;
+    for(; (pos + 48) <= length; pos += 48)
+    {
+        uint8x16x3_t const in = vld3q_u8(&data[pos]);
+        uint8x16x4_t indices;
+        indices.val[0] = vshrq_n_u8(in.val[0], 2);
+        indices.val[1] = vandq_u8(vorrq_u8(vshrq_n_u8(in.val[1], 4), vshlq_n_u8(in.val[0], 4)), mask);
+        indices.val[2] = vandq_u8(vorrq_u8(vshrq_n_u8(in.val[2], 6), vshlq_n_u8(in.val[1], 2)), mask);
+        indices.val[3] = vandq_u8(in.val[2], mask);
+
+        uint8x16x4_t out;
+        for(int i = 0; i < 4; i++)
+        {
+            out.val[i] = vqtbl4q_u8(table, indices.val[i]);
+        }
+
+        vst4q_u8((uint8_t *) &buffer[out_pos], out);
+        out_pos += 64;
+    }
+
+    return pos;
+}
+
+size_t
+wf_impl_base64_decode_neon(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    size_t buffer_size)
+{
+    uint8x16x4_t const table_lo = vld1q_u8_x4(&wf_impl_base64_neon_decode_table[0]);
+    uint8x16x4_t const table_hi = vld1q_u8_x4(&wf_impl_base64_neon_decode_table[64]);
+
+    size_t pos = 0;
+    size_t out_pos = 0;
+    for(; ((pos + 64) <= length) && ((out_pos + 48) <= buffer_size); pos += 64)
+    {
+        uint8x16x4_t values;
+        if (!wf_impl_base64_neon_decode_block(&table_lo, &table_hi, &data[pos], &values))
+        {
+            break;
+        }
+
+        uint8x16x3_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(values.val[0], 2), vshrq_n_u8(values.val[1], 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(values.val[1], 4), vshrq_n_u8(values.val[2], 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(values.val[2], 6), values.val[3]);
+
+        vst3q_u8(&buffer[out_pos], out);
+        out_pos += 48;
+    }
+
+    return pos;
+}
+
+size_t
+wf_impl_base64_validate_neon(
+    char const * data,
+    size_t length)
+{
+    uint8x16x4_t const table_lo = vld1q_u8_x4(&wf_impl_base64_neon_decode_table[0]);
+    uint8x16x4_t const table_hi = vld1q_u8_x4(&wf_impl_base64_neon_decode_table[64]);
+
+    size_t pos = 0;
+    for(; (pos + 64) <= length; pos += 64)
+    {
+        uint8x16x4_t values;
+        if (!wf_impl_base64_neon_decode_block(&table_lo, &table_hi, &data[pos], &values))
+        {
+            break;
+        }
+    }
+
+    return pos;
+}
+
+#endif
@@ -0,0 +1,142 @@
+#include "webfuse/impl/util/base64_intern.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#define WF_BASE64_SSE41 __attribute__((target("sse4.1")))
+
+// Maps 6 bit values to the base64 alphabet.
+// See: Wojciech Muła, Daniel Lemire: Faster Base64 Encoding and Decoding
+//      using AVX2 Instructions
+static inline WF_BASE64_SSE41 __m128i
+wf_impl_base64_sse41_translate(
+    __m128i indices)
+{
+    __m128i const shift_lut = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+
+    __m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    __m128i const less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+    result = _mm_shuffle_epi8(shift_lut, result);
+
+    return _mm_add_epi8(result, indices);
+}
+
+// Checks the characters against the alphabet and maps them to 6 bit values.
+// Returns false if any character is not part of the alphabet.
+static inline WF_BASE64_SSE41 bool
+wf_impl_base64_sse41_lookup(
+    __m128i * value)
+{
+    __m128i const lut_lo = _mm_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    __m128i const lut_hi = _mm_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    __m128i const lut_roll = _mm_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71,
+        0, 0, 0, 0, 0, 0, 0, 0);
+    __m128i const mask_2f = _mm_set1_epi8(0x2f);
+
+    __m128i const hi_nibbles = _mm_and_si128(_mm_srli_epi32(*value, 4), mask_2f);
+    __m128i const lo_nibbles = _mm_and_si128(*value, mask_2f);
+    __m128i const lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+    __m128i const hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+
+    if (!_mm_testz_si128(lo, hi))
+    {
+        return false;
+    }
+
+    __m128i const is_slash = _mm_cmpeq_epi8(*value, mask_2f);
+    __m128i const roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(is_slash, hi_nibbles));
+    *value = _mm_add_epi8(*value, roll);
+
+    return true;
+}
+
+WF_BASE64_SSE41 size_t
+wf_impl_base64_encode_sse41(
+    uint8_t const * data,
+    size_t length,
+    char * buffer)
+{
+    size_t pos = 0;
+    size_t out_pos = 0;
+
+    // 16 bytes are loaded, but only 12 are consumed
+    for(; (pos + 16) <= length; pos += 12)
+    {
+        __m128i value = _mm_loadu_si128((__m128i const *) &data[pos]);
+        value = _mm_shuffle_epi8(value, _mm_setr_epi8(
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+        __m128i const t0 = _mm_and_si128(value, _mm_set1_epi32(0x0fc0fc00));
+        __m128i const t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        __m128i const t2 = _mm_and_si128(value, _mm_set1_epi32(0x003f03f0));
+        __m128i const t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+
+        __m128i const result = wf_impl_base64_sse41_translate(_mm_or_si128(t1, t3));
+        _mm_storeu_si128((__m128i *) &buffer[out_pos], result);
+        out_pos += 16;
+    }
+
+    return pos;
+}
+
+WF_BASE64_SSE41 size_t
+wf_impl_base64_decode_sse41(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    size_t buffer_size)
+{
+    size_t pos = 0;
+    size_t out_pos = 0;
+
+    // 16 bytes are stored, but only 12 are produced
+    for(; ((pos + 16) <= length) && ((out_pos + 16) <= buffer_size); pos += 16)
+    {
+        __m128i value = _mm_loadu_si128((__m128i const *) &data[pos]);
+        if (!wf_impl_base64_sse41_lookup(&value))
+        {
+            break;
+        }
+
+        value = _mm_maddubs_epi16(value, _mm_set1_epi32(0x01400140));
+        value = _mm_madd_epi16(value, _mm_set1_epi32(0x00011000));
+        value = _mm_shuffle_epi8(value, _mm_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+        _mm_storeu_si128((__m128i *) &buffer[out_pos], value);
+        out_pos += 12;
+    }
+
+    return pos;
+}
+
+WF_BASE64_SSE41 size_t
+wf_impl_base64_validate_sse41(
+    char const * data,
+    size_t length)
+{
+    size_t pos = 0;
+    for(; (pos + 16) <= length; pos += 16)
+    {
+        __m128i value = _mm_loadu_si128((__m128i const *) &data[pos]);
+        if (!wf_impl_base64_sse41_lookup(&value))
+        {
+            break;
+        }
+    }
+
+    return pos;
+}
+
+#endif
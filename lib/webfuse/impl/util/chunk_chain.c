@@ -0,0 +1,296 @@
+#include "webfuse/impl/util/chunk_chain.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+struct wf_chunk
+{
+    struct wf_chunk * next;
+    size_t size;
+    char data[];
+};
+
+static size_t
+wf_impl_chunk_chain_round_up(
+    struct wf_chunk_chain * chain,
+    size_t size)
+{
+    if (size > (SIZE_MAX - chain->chunk_size))
+    {
+        return size;
+    }
+
+    return ((size + chain->chunk_size - 1) / chain->chunk_size) * chain->chunk_size;
+}
+
+static bool
+wf_impl_chunk_chain_resize(
+    struct wf_chunk_chain * chain,
+    size_t capacity)
+{
+    // buffer is empty, so there is no need to realloc
+    char * data = (0 == chain->data_size) ? malloc(capacity) : realloc(chain->data, capacity);
+    if (NULL == data)
+    {
+        return false;
+    }
+
+    if (0 == chain->data_size)
+    {
+        free(chain->data);
+    }
+    chain->data = data;
+    chain->data_capacity = capacity;
+
+    return true;
+}
+
+static struct wf_chunk *
+wf_impl_chunk_chain_acquire(
+    struct wf_chunk_chain * chain)
+{
+    struct wf_chunk * chunk = chain->free_chunks;
+    if (NULL != chunk)
+    {
+        chain->free_chunks = chunk->next;
+        chain->free_count--;
+    }
+    else
+    {
+        chunk = malloc(sizeof(struct wf_chunk) + chain->chunk_size);
+        if (NULL == chunk)
+        {
+            return NULL;
+        }
+    }
+
+    chunk->next = NULL;
+    chunk->size = 0;
+
+    return chunk;
+}
+
+static void
+wf_impl_chunk_chain_release(
+    struct wf_chunk_chain * chain,
+    struct wf_chunk * chunk)
+{
+    if (chain->free_count < chain->max_free_count)
+    {
+        chunk->next = chain->free_chunks;
+        chain->free_chunks = chunk;
+        chain->free_count++;
+    }
+    else
+    {
+        free(chunk);
+    }
+}
+
+void
+wf_impl_chunk_chain_init(
+    struct wf_chunk_chain * chain,
+    size_t chunk_size,
+    size_t max_free_count,
+    size_t max_data_capacity)
+{
+    chain->data = NULL;
+    chain->data_size = 0;
+    chain->data_capacity = 0;
+    chain->max_data_capacity = max_data_capacity;
+    chain->first = NULL;
+    chain->last = NULL;
+    chain->free_chunks = NULL;
+    chain->free_count = 0;
+    chain->max_free_count = max_free_count;
+    chain->chunk_size = chunk_size;
+    chain->size = 0;
+    chain->is_truncated = false;
+    chain->copied = 0;
+}
+
+void
+wf_impl_chunk_chain_cleanup(
+    struct wf_chunk_chain * chain)
+{
+    chain->max_free_count = 0;
+    chain->max_data_capacity = 0;
+    wf_impl_chunk_chain_clear(chain);
+}
+
+bool
+wf_impl_chunk_chain_is_empty(
+    struct wf_chunk_chain * chain)
+{
+    return (0 == chain->size);
+}
+
+size_t
+wf_impl_chunk_chain_size(
+    struct wf_chunk_chain * chain)
+{
+    return chain->size;
+}
+
+void
+wf_impl_chunk_chain_reserve(
+    struct wf_chunk_chain * chain,
+    size_t size)
+{
+    if (NULL != chain->first)
+    {
+        return;
+    }
+
+    // size is announced by the peer: the buffer may grow up to four times
+    // the data actually received (or max_data_capacity), but not further
+    size_t limit = chain->max_data_capacity;
+    if (chain->data_size > (limit / 4))
+    {
+        limit = (chain->data_size <= (SIZE_MAX / 4)) ? (4 * chain->data_size) : SIZE_MAX;
+    }
+
+    bool const is_limited = (size > (limit - chain->data_size));
+    size_t const target = (!is_limited) ? (chain->data_size + size) : limit;
+
+    // a limited buffer grows at least by factor 2, to avoid a realloc per fragment
+    if ((target > chain->data_capacity) &&
+        ((!is_limited) || ((target / 2) >= chain->data_capacity)))
+    {
+        // failure is not fatal: data exceeding the buffer is appended to chunks
+        wf_impl_chunk_chain_resize(chain, wf_impl_chunk_chain_round_up(chain, target));
+    }
+}
+
+void
+wf_impl_chunk_chain_append(
+    struct wf_chunk_chain * chain,
+    char const * data,
+    size_t length)
+{
+    if (chain->is_truncated)
+    {
+        return;
+    }
+
+    chain->size += length;
+    chain->copied += length;
+
+    if ((NULL != chain->data) && (NULL == chain->first) &&
+        (length <= (chain->data_capacity - chain->data_size)))
+    {
+        memcpy(&(chain->data[chain->data_size]), data, length);
+        chain->data_size += length;
+        return;
+    }
+
+    while (0 < length)
+    {
+        if ((NULL == chain->last) || (chain->chunk_size == chain->last->size))
+        {
+            struct wf_chunk * chunk = wf_impl_chunk_chain_acquire(chain);
+            if (NULL == chunk)
+            {
+                chain->is_truncated = true;
+                return;
+            }
+
+            if (NULL != chain->last)
+            {
+                chain->last->next = chunk;
+            }
+            else
+            {
+                chain->first = chunk;
+            }
+            chain->last = chunk;
+        }
+
+        struct wf_chunk * chunk = chain->last;
+        size_t const available = chain->chunk_size - chunk->size;
+        size_t const count = (length < available) ? length : available;
+        memcpy(&(chunk->data[chunk->size]), data, count);
+        chunk->size += count;
+        data += count;
+        length -= count;
+    }
+}
+
+char *
+wf_impl_chunk_chain_join(
+    struct wf_chunk_chain * chain,
+    char const * data,
+    size_t length,
+    size_t * size)
+{
+    *size = 0;
+    if ((chain->is_truncated) || (length > (SIZE_MAX - chain->size)))
+    {
+        return NULL;
+    }
+
+    size_t const total = chain->size + length;
+    if (total > chain->data_capacity)
+    {
+        // only the contiguous part is moved (if at all)
+        if (!wf_impl_chunk_chain_resize(chain, wf_impl_chunk_chain_round_up(chain, total)))
+        {
+            return NULL;
+        }
+    }
+
+    struct wf_chunk * chunk = chain->first;
+    while (NULL != chunk)
+    {
+        struct wf_chunk * next = chunk->next;
+        memcpy(&(chain->data[chain->data_size]), chunk->data, chunk->size);
+        chain->data_size += chunk->size;
+        chain->copied += chunk->size;
+        wf_impl_chunk_chain_release(chain, chunk);
+
+        chunk = next;
+    }
+    chain->first = NULL;
+    chain->last = NULL;
+
+    memcpy(&(chain->data[chain->data_size]), data, length);
+    chain->data_size += length;
+    chain->size += length;
+    chain->copied += length;
+    *size = total;
+
+    return chain->data;
+}
+
+void
+wf_impl_chunk_chain_clear(
+    struct wf_chunk_chain * chain)
+{
+    struct wf_chunk * chunk = chain->first;
+    while (NULL != chunk)
+    {
+        struct wf_chunk * next = chunk->next;
+        wf_impl_chunk_chain_release(chain, chunk);
+        chunk = next;
+    }
+    chain->first = NULL;
+    chain->last = NULL;
+    chain->size = 0;
+    chain->data_size = 0;
+    chain->is_truncated = false;
+
+    while (chain->free_count > chain->max_free_count)
+    {
+        chunk = chain->free_chunks;
+        chain->free_chunks = chunk->next;
+        chain->free_count--;
+        free(chunk);
+    }
+
+    if (chain->data_capacity > chain->max_data_capacity)
+    {
+        free(chain->data);
+        chain->data = NULL;
+        chain->data_capacity = 0;
+    }
+}
@@ -0,0 +1,124 @@
+#ifndef WF_IMPL_UTIL_CHUNK_CHAIN_H
+#define WF_IMPL_UTIL_CHUNK_CHAIN_H
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#else
+#include <cstddef>
+#include <cinttypes>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct wf_chunk;
+
+//------------------------------------------------------------------------------
+/// \brief Collects fragments of a message.
+///
+/// Fragments are copied into a contiguous buffer, which is sized in advance
+/// as far as the size of the message is known (see
+/// wf_impl_chunk_chain_reserve). Data exceeding the buffer is appended to a
+/// chain of fixed size chunks, so that data already received is never moved
+/// while the message grows without size hint.
+/// The chunks are merged into the contiguous buffer only once, when the
+/// final fragment is received (see wf_impl_chunk_chain_join); chunks are
+/// released while they are copied.
+///
+/// Released chunks are kept for reuse, up to max_free_count. The contiguous
+/// buffer is kept, unless it exceeds max_data_capacity, so that a single
+/// large message does not pin memory for the lifetime of the chain.
+//------------------------------------------------------------------------------
+struct wf_chunk_chain
+{
+    char * data;
+    size_t data_size;
+    size_t data_capacity;
+    size_t max_data_capacity;
+    struct wf_chunk * first;
+    struct wf_chunk * last;
+    struct wf_chunk * free_chunks;
+    size_t free_count;
+    size_t max_free_count;
+    size_t chunk_size;
+    size_t size;
+    // set, if a chunk could not be allocated; the message is dropped
+    bool is_truncated;
+    // bytes copied into the buffer and chunks
+    uint64_t copied;
+};
+
+extern void
+wf_impl_chunk_chain_init(
+    struct wf_chunk_chain * chain,
+    size_t chunk_size,
+    size_t max_free_count,
+    size_t max_data_capacity);
+
+extern void
+wf_impl_chunk_chain_cleanup(
+    struct wf_chunk_chain * chain);
+
+extern bool
+wf_impl_chunk_chain_is_empty(
+    struct wf_chunk_chain * chain);
+
+extern size_t
+wf_impl_chunk_chain_size(
+    struct wf_chunk_chain * chain);
+
+//------------------------------------------------------------------------------
+/// \brief Makes room for size further bytes in the contiguous buffer.
+///
+/// Since size is a hint announced by the peer, the buffer grows at most to
+/// four times the size of the data already received (or max_data_capacity).
+/// Has no effect, once data was appended to chunks.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_chunk_chain_reserve(
+    struct wf_chunk_chain * chain,
+    size_t size);
+
+extern void
+wf_impl_chunk_chain_append(
+    struct wf_chunk_chain * chain,
+    char const * data,
+    size_t length);
+
+//------------------------------------------------------------------------------
+/// \brief Returns the contents of the chain followed by data as contiguous
+///        (writable) buffer.
+///
+/// The buffer is valid until wf_impl_chunk_chain_clear is called. If memory
+/// could not be allocated, NULL is returned and the message is lost.
+///
+/// \param chain pointer to the chain
+/// \param data final fragment of the message
+/// \param length length of the final fragment
+/// \param size [out] size of the returned buffer
+/// \return pointer to the contiguous message or NULL on failure
+//------------------------------------------------------------------------------
+extern char *
+wf_impl_chunk_chain_join(
+    struct wf_chunk_chain * chain,
+    char const * data,
+    size_t length,
+    size_t * size);
+
+//------------------------------------------------------------------------------
+/// \brief Removes all contents and releases memory exceeding the limits
+///        passed to wf_impl_chunk_chain_init.
+//------------------------------------------------------------------------------
+extern void
+wf_impl_chunk_chain_clear(
+    struct wf_chunk_chain * chain);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
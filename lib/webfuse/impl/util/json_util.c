@@ -20,6 +20,24 @@ wf_impl_json_get_int(
 	return result;
 }
 
+int64_t
+wf_impl_json_get_int64(
+	struct wf_json const * object,
+	char const * key,
+	int64_t default_value)
+{
+	if (NULL == object) { return default_value; }
+	int64_t result = default_value;
+
+	struct wf_json const * holder = wf_impl_json_object_get(object, key);
+	if (wf_impl_json_is_int(holder))
+	{
+		result = wf_impl_json_int64_get(holder);
+	}
+
+	return result;
+}
+
 wf_status 
 wf_impl_jsonrpc_get_status(
 	struct wf_jsonrpc_error const * error)
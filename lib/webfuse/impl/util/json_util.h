@@ -3,6 +3,12 @@
 
 #include "webfuse/status.h"
 
+#ifndef __cplusplus
+#include <stdint.h>
+#else
+#include <cstdint>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -17,6 +23,12 @@ wf_impl_json_get_int(
     char const * key,
     int default_value);
 
+extern int64_t
+wf_impl_json_get_int64(
+    struct wf_json const * object,
+    char const * key,
+    int64_t default_value);
+
 extern wf_status 
 wf_impl_jsonrpc_get_status(
     struct wf_jsonrpc_error const * error);
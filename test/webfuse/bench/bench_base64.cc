@@ -0,0 +1,89 @@
+#include "webfuse/impl/util/base64.h"
+#include "webfuse/impl/util/base64_intern.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using std::size_t;
+
+namespace
+{
+
+size_t const data_size = 1024 * 1024;
+size_t const iterations = 200;
+
+char const * impl_name(wf_impl_base64_impl impl)
+{
+    switch (impl)
+    {
+        case WF_IMPL_BASE64_SCALAR: return "scalar";
+        case WF_IMPL_BASE64_SSE41: return "sse4.1";
+        case WF_IMPL_BASE64_AVX2: return "avx2";
+        case WF_IMPL_BASE64_NEON: return "neon";
+        default: return "auto";
+    }
+}
+
+template<typename Function>
+double measure(Function function)
+{
+    auto const start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < iterations; i++)
+    {
+        function();
+    }
+    auto const end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// throughput is reported in GB/s of base64 encoded data
+void report(char const * impl, char const * name, double sec, size_t size)
+{
+    std::printf("%-8s %-10s %8.2f GB/s\n", impl, name, (static_cast<double>(size) * iterations) / sec / 1e9);
+}
+
+}
+
+int main(int, char* [])
+{
+    std::vector<uint8_t> data(data_size);
+    for(size_t i = 0; i < data_size; i++)
+    {
+        data[i] = static_cast<uint8_t>((i * 7) ^ (i >> 8));
+    }
+
+    size_t const encoded_size = wf_impl_base64_encoded_size(data_size);
+    std::vector<char> encoded(encoded_size + 1);
+    std::vector<uint8_t> decoded(data_size);
+    size_t volatile sink = 0;
+
+    for (auto impl: {WF_IMPL_BASE64_SCALAR, WF_IMPL_BASE64_SSE41, WF_IMPL_BASE64_AVX2, WF_IMPL_BASE64_NEON})
+    {
+        if (!wf_impl_base64_set_impl(impl))
+        {
+            continue;
+        }
+
+        double sec = measure([&]() {
+            sink = sink + wf_impl_base64_encode(data.data(), data.size(), encoded.data(), encoded.size());
+        });
+        report(impl_name(impl), "encode", sec, encoded_size);
+
+        sec = measure([&]() {
+            sink = sink + wf_impl_base64_decode(encoded.data(), encoded_size, decoded.data(), decoded.size());
+        });
+        report(impl_name(impl), "decode", sec, encoded_size);
+
+        sec = measure([&]() {
+            sink = sink + (wf_impl_base64_isvalid(encoded.data(), encoded_size) ? 1 : 0);
+        });
+        report(impl_name(impl), "isvalid", sec, encoded_size);
+    }
+
+    wf_impl_base64_set_impl(WF_IMPL_BASE64_AUTO);
+    return 0;
+}
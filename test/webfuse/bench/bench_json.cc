@@ -0,0 +1,124 @@
+#include "webfuse/impl/json/doc.h"
+#include "webfuse/impl/util/arena.h"
+#include "webfuse/impl/json/node.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using std::size_t;
+
+// count heap allocations by interposing the glibc allocator
+extern "C"
+{
+
+extern void * __libc_malloc(size_t size);
+extern void * __libc_calloc(size_t count, size_t size);
+extern void * __libc_realloc(void * pointer, size_t size);
+extern void __libc_free(void * pointer);
+
+static size_t alloc_count = 0;
+
+void * malloc(size_t size)
+{
+    alloc_count++;
+    return __libc_malloc(size);
+}
+
+void * calloc(size_t count, size_t size)
+{
+    alloc_count++;
+    return __libc_calloc(count, size);
+}
+
+void * realloc(void * pointer, size_t size)
+{
+    alloc_count++;
+    return __libc_realloc(pointer, size);
+}
+
+void free(void * pointer)
+{
+    __libc_free(pointer);
+}
+
+}
+
+namespace
+{
+
+size_t const iterations = 100 * 1000;
+
+std::string create_readdir_response(size_t count)
+{
+    std::string result = "{\"jsonrpc\": \"2.0\", \"result\": [";
+    for(size_t i = 0; i < count; i++)
+    {
+        if (0 < i) { result += ", "; }
+        result += "{\"name\": \"file_" + std::to_string(i) + "\", \"inode\": " + std::to_string(i + 2) + "}";
+    }
+    result += "], \"id\": 42}";
+
+    return result;
+}
+
+std::string create_read_response(size_t size)
+{
+    std::string data(((size + 2) / 3) * 4, 'A');
+    return "{\"jsonrpc\": \"2.0\", \"result\": {\"data\": \"" + data + "\", \"format\": \"base64\", \"count\": " + std::to_string(size) + "}, \"id\": 42}";
+}
+
+void run(char const * name, std::string const & message, wf_arena * arena = nullptr)
+{
+    // the parser modifies data in place (string unescaping)
+    std::vector<char> data(message.size());
+    size_t const allocs_before = alloc_count;
+    auto const start = std::chrono::steady_clock::now();
+
+    for(size_t i = 0; i < iterations; i++)
+    {
+        memcpy(data.data(), message.data(), message.size());
+        wf_json_doc * doc = (nullptr == arena)
+            ? wf_impl_json_doc_loadb(data.data(), data.size())
+            : wf_impl_json_doc_loadb_arena(arena, data.data(), data.size());
+        if (nullptr == doc)
+        {
+            std::printf("error: failed to parse %s\n", name);
+            return;
+        }
+        wf_impl_json_doc_dispose(doc);
+    }
+
+    auto const end = std::chrono::steady_clock::now();
+    double const nsec = std::chrono::duration<double, std::nano>(end - start).count();
+    size_t const allocs = alloc_count - allocs_before;
+
+    std::printf("%-24s %8zu bytes %10.1f ns/message %8.2f allocs/message\n",
+        name, message.size(), nsec / iterations, static_cast<double>(allocs) / iterations);
+}
+
+}
+
+int main(int, char* [])
+{
+    std::printf("wf_impl_json_doc_loadb\n");
+    run("getattr response", "{\"jsonrpc\": \"2.0\", \"result\": {\"mode\": 420, \"type\": \"file\", \"size\": 42, \"atime\": 0, \"mtime\": 0, \"ctime\": 0}, \"id\": 42}");
+    run("readdir response (100)", create_readdir_response(100));
+    run("read response (4k)", create_read_response(4096));
+    run("lookup request", "{\"jsonrpc\": \"2.0\", \"method\": \"lookup\", \"params\": [\"test\", 1, \"some.file\"], \"id\": 42}");
+
+    // reused arena, as used by sessions
+    wf_arena arena;
+    wf_impl_arena_init(&arena, 4096);
+    std::printf("\nwf_impl_json_doc_loadb_arena (reused arena)\n");
+    run("getattr response", "{\"jsonrpc\": \"2.0\", \"result\": {\"mode\": 420, \"type\": \"file\", \"size\": 42, \"atime\": 0, \"mtime\": 0, \"ctime\": 0}, \"id\": 42}", &arena);
+    run("readdir response (100)", create_readdir_response(100), &arena);
+    run("read response (4k)", create_read_response(4096), &arena);
+    run("lookup request", "{\"jsonrpc\": \"2.0\", \"method\": \"lookup\", \"params\": [\"test\", 1, \"some.file\"], \"id\": 42}", &arena);
+    wf_impl_arena_cleanup(&arena);
+
+    return 0;
+}
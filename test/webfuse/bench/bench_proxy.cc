@@ -0,0 +1,162 @@
+#include "webfuse/impl/jsonrpc/proxy.h"
+#include "webfuse/impl/message.h"
+#include "webfuse/impl/message_pool.h"
+#include "webfuse/impl/timer/manager.h"
+#include "webfuse/impl/json/doc.h"
+#include "webfuse/impl/util/arena.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using std::size_t;
+
+// count heap allocations by interposing the glibc allocator
+extern "C"
+{
+
+extern void * __libc_malloc(size_t size);
+extern void * __libc_calloc(size_t count, size_t size);
+extern void * __libc_realloc(void * pointer, size_t size);
+extern void __libc_free(void * pointer);
+
+static size_t alloc_count = 0;
+
+void * malloc(size_t size)
+{
+    alloc_count++;
+    return __libc_malloc(size);
+}
+
+void * calloc(size_t count, size_t size)
+{
+    alloc_count++;
+    return __libc_calloc(count, size);
+}
+
+void * realloc(void * pointer, size_t size)
+{
+    alloc_count++;
+    return __libc_realloc(pointer, size);
+}
+
+void free(void * pointer)
+{
+    __libc_free(pointer);
+}
+
+}
+
+namespace
+{
+
+size_t const iterations = 100 * 1000;
+size_t const warmup = 1000;
+
+int last_id = 0;
+size_t finished_count = 0;
+
+// stands in for the message scheduler: messages are sent and disposed
+// immediately
+extern "C" bool send(wf_message * message, void *)
+{
+    // the id is the last member of a request
+    char const * id = nullptr;
+    char const * position = message->data;
+    char const * const end = &(message->data[message->length]);
+    while (position < end)
+    {
+        char const * found = static_cast<char const *>(memchr(position, ':', end - position));
+        if (nullptr == found) { break; }
+        id = found;
+        position = found + 1;
+    }
+    last_id = (nullptr != id) ? atoi(id + 1) : 0;
+
+    wf_impl_message_dispose(message);
+    return true;
+}
+
+extern "C" void on_finished(void *, wf_json const *, wf_jsonrpc_error const *)
+{
+    finished_count++;
+}
+
+void invoke(wf_jsonrpc_proxy * proxy, wf_arena * arena)
+{
+    wf_impl_jsonrpc_proxy_invoke(proxy, &on_finished, nullptr, "lookup", "sis", "test", 1, "some.file");
+
+    char response[128];
+    int const length = snprintf(response, sizeof(response),
+        "{\"jsonrpc\": \"2.0\", \"result\": {\"inode\": 2, \"mode\": 420, \"type\": \"file\"}, \"id\": %d}", last_id);
+    wf_json_doc * doc = wf_impl_json_doc_loadb_arena(arena, response, length);
+    wf_impl_jsonrpc_proxy_onresult(proxy, wf_impl_json_doc_root(doc));
+    wf_impl_json_doc_dispose(doc);
+}
+
+void notify(wf_jsonrpc_proxy * proxy, wf_arena *)
+{
+    wf_impl_jsonrpc_proxy_notify(proxy, "close", "siii", "test", 2, 42, 0);
+}
+
+void run(char const * name, void (*action)(wf_jsonrpc_proxy *, wf_arena *), bool use_pool)
+{
+    wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+    wf_message_pool * pool = wf_impl_message_pool_create(1024, 64 * 1024, 256);
+    wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, 10 * 1000, &send, nullptr);
+    if (use_pool)
+    {
+        wf_impl_jsonrpc_proxy_set_message_pool(proxy, pool);
+    }
+    wf_arena arena;
+    wf_impl_arena_init(&arena, 4096);
+
+    // steady state: pool, arena and latency estimators are set up
+    for(size_t i = 0; i < warmup; i++)
+    {
+        action(proxy, &arena);
+    }
+
+    size_t const allocs_before = alloc_count;
+    auto const start = std::chrono::steady_clock::now();
+
+    for(size_t i = 0; i < iterations; i++)
+    {
+        action(proxy, &arena);
+    }
+
+    auto const end = std::chrono::steady_clock::now();
+    double const nsec = std::chrono::duration<double, std::nano>(end - start).count();
+    size_t const allocs = alloc_count - allocs_before;
+
+    std::printf("%-24s %10.1f ns/message %8.2f allocs/message\n",
+        name, nsec / iterations, static_cast<double>(allocs) / iterations);
+
+    wf_impl_arena_cleanup(&arena);
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_message_pool_dispose(pool);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+}
+
+int main(int, char* [])
+{
+    std::printf("wf_jsonrpc_proxy (without message pool)\n");
+    run("invoke lookup", &invoke, false);
+    run("notify close", &notify, false);
+
+    std::printf("\nwf_jsonrpc_proxy (with message pool)\n");
+    run("invoke lookup", &invoke, true);
+    run("notify close", &notify, true);
+
+    if ((2 * (warmup + iterations)) != finished_count)
+    {
+        std::printf("error: not all requests finished\n");
+        return 1;
+    }
+
+    return 0;
+}
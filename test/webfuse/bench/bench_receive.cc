@@ -0,0 +1,193 @@
+#include "webfuse/impl/util/buffer.h"
+#include "webfuse/impl/util/chunk_chain.h"
+
+#include <malloc.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+using std::size_t;
+
+// track heap usage and bytes moved by realloc by interposing the glibc
+// allocator (realloc is assumed to copy, if the block is moved)
+extern "C"
+{
+
+extern void * __libc_malloc(size_t size);
+extern void * __libc_calloc(size_t count, size_t size);
+extern void * __libc_realloc(void * pointer, size_t size);
+extern void __libc_free(void * pointer);
+
+static size_t alloc_count = 0;
+static size_t heap_size = 0;
+static size_t heap_peak = 0;
+static size_t realloc_copied = 0;
+
+static void * track(void * pointer)
+{
+    if (nullptr != pointer)
+    {
+        heap_size += malloc_usable_size(pointer);
+        heap_peak = (heap_size > heap_peak) ? heap_size : heap_peak;
+    }
+
+    return pointer;
+}
+
+void * malloc(size_t size)
+{
+    alloc_count++;
+    return track(__libc_malloc(size));
+}
+
+void * calloc(size_t count, size_t size)
+{
+    alloc_count++;
+    return track(__libc_calloc(count, size));
+}
+
+void * realloc(void * pointer, size_t size)
+{
+    alloc_count++;
+    size_t const old_size = (nullptr != pointer) ? malloc_usable_size(pointer) : 0;
+    heap_size -= old_size;
+    void * result = __libc_realloc(pointer, size);
+    if ((nullptr != pointer) && (result != pointer))
+    {
+        realloc_copied += (old_size < size) ? old_size : size;
+    }
+    return track(result);
+}
+
+void free(void * pointer)
+{
+    heap_size -= (nullptr != pointer) ? malloc_usable_size(pointer) : 0;
+    __libc_free(pointer);
+}
+
+}
+
+namespace
+{
+
+size_t const iterations = 100;
+size_t const fragment_size = 4096;
+
+struct result
+{
+    size_t allocs;
+    size_t copied;
+    size_t peak;
+    size_t retained;
+    double nsec;
+};
+
+void print(char const * name, size_t message_size, result const & value)
+{
+    std::printf("%-32s %8zu bytes %8.1f us/message %6.2f allocs/message %5.2f copies/byte %6zu kB peak %6zu kB retained\n",
+        name, message_size, value.nsec / iterations / 1000, static_cast<double>(value.allocs) / iterations,
+        static_cast<double>(value.copied) / iterations / message_size,
+        value.peak / 1024, value.retained / iterations / 1024);
+}
+
+// each message is received by a fresh connection, to include growth of
+// the buffer; retained is the memory still held after the message
+void run_buffer(std::string const & message)
+{
+    result value = {0, 0, 0, 0, 0.0};
+
+    for(size_t i = 0; i < iterations; i++)
+    {
+        size_t const heap_before = heap_size;
+        heap_peak = heap_size;
+        realloc_copied = 0;
+        size_t const allocs_before = alloc_count;
+        auto const start = std::chrono::steady_clock::now();
+
+        wf_buffer buffer;
+        wf_impl_buffer_init(&buffer, 8 * 1024);
+        for(size_t offset = 0; offset < message.size(); offset += fragment_size)
+        {
+            size_t const length = ((message.size() - offset) < fragment_size) ? (message.size() - offset) : fragment_size;
+            wf_impl_buffer_append(&buffer, &(message.data()[offset]), length);
+        }
+        wf_impl_buffer_clear(&buffer);
+
+        auto const end = std::chrono::steady_clock::now();
+        value.nsec += std::chrono::duration<double, std::nano>(end - start).count();
+        value.allocs += alloc_count - allocs_before;
+        value.copied += message.size() + realloc_copied;
+        value.peak = heap_peak - heap_before;
+        value.retained += heap_size - heap_before;
+
+        wf_impl_buffer_cleanup(&buffer);
+    }
+
+    print("wf_buffer", message.size(), value);
+}
+
+// messages are sent in frames of frame_size; the size of a frame is known
+// when receiving its first fragment (see lws_remaining_packet_payload)
+void run_chunk_chain(std::string const & message, size_t frame_size)
+{
+    result value = {0, 0, 0, 0, 0.0};
+
+    for(size_t i = 0; i < iterations; i++)
+    {
+        size_t const heap_before = heap_size;
+        heap_peak = heap_size;
+        realloc_copied = 0;
+        size_t const allocs_before = alloc_count;
+        auto const start = std::chrono::steady_clock::now();
+
+        wf_chunk_chain chain;
+        wf_impl_chunk_chain_init(&chain, 8 * 1024, 8, 64 * 1024);
+        size_t offset = 0;
+        for(; (message.size() - offset) > fragment_size; offset += fragment_size)
+        {
+            // as wf_impl_session_receive
+            size_t const frame_end = ((offset / frame_size) + 1) * frame_size;
+            size_t const remaining = ((frame_end < message.size()) ? frame_end : message.size()) - offset - fragment_size;
+            if (0 < remaining)
+            {
+                wf_impl_chunk_chain_reserve(&chain, fragment_size + remaining);
+            }
+            wf_impl_chunk_chain_append(&chain, &(message.data()[offset]), fragment_size);
+        }
+        size_t size;
+        wf_impl_chunk_chain_join(&chain, &(message.data()[offset]), message.size() - offset, &size);
+        wf_impl_chunk_chain_clear(&chain);
+
+        auto const end = std::chrono::steady_clock::now();
+        value.nsec += std::chrono::duration<double, std::nano>(end - start).count();
+        value.allocs += alloc_count - allocs_before;
+        value.copied += chain.copied + realloc_copied;
+        value.peak = heap_peak - heap_before;
+        value.retained += heap_size - heap_before;
+
+        wf_impl_chunk_chain_cleanup(&chain);
+    }
+
+    char name[80];
+    snprintf(name, sizeof(name), "wf_chunk_chain (%zuk frames)", frame_size / 1024);
+    print(name, message.size(), value);
+}
+
+}
+
+int main(int, char* [])
+{
+    std::printf("receive fragmented messages (%zu byte fragments)\n", fragment_size);
+    for(size_t const size: {6 * 1024, 64 * 1024, 1300 * 1024})
+    {
+        std::string const message(size, 'A');
+        run_buffer(message);
+        run_chunk_chain(message, fragment_size);
+        run_chunk_chain(message, 64 * 1024);
+        run_chunk_chain(message, 16 * 1024 * 1024);
+    }
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "webfuse/impl/timer/timer.h"
+#include "webfuse/impl/timer/manager.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+using std::size_t;
+
+namespace
+{
+
+size_t const timer_count = 100 * 1000;
+size_t const check_count = 100 * 1000;
+
+size_t triggered = 0;
+
+extern "C" void on_timer(wf_timer *, void *)
+{
+    triggered++;
+}
+
+template<typename Function>
+double measure(Function function)
+{
+    auto const start = std::chrono::steady_clock::now();
+    function();
+    auto const end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+void report(char const * name, double usec, size_t count)
+{
+    std::printf("%-24s %10.1f us total %10.3f us/op\n", name, usec, usec / count);
+}
+
+}
+
+int main(int, char* [])
+{
+    wf_timer_manager * manager = wf_impl_timer_manager_create();
+    std::vector<wf_timer *> timers(timer_count);
+    for(size_t i = 0; i < timer_count; i++)
+    {
+        timers[i] = wf_impl_timer_create(manager, &on_timer, nullptr);
+    }
+
+    double usec = measure([&]() {
+        for(size_t i = 0; i < timer_count; i++)
+        {
+            wf_impl_timer_start(timers[i], 60 * 1000 + static_cast<int>(i % 1000));
+        }
+    });
+    report("start", usec, timer_count);
+
+    usec = measure([&]() {
+        for(size_t i = 0; i < check_count; i++)
+        {
+            wf_impl_timer_manager_check(manager);
+        }
+    });
+    report("check (none expired)", usec, check_count);
+
+    usec = measure([&]() {
+        for(size_t i = 0; i < timer_count; i += 2)
+        {
+            wf_impl_timer_cancel(timers[i]);
+        }
+    });
+    report("cancel", usec, timer_count / 2);
+
+    usec = measure([&]() {
+        for(size_t i = 0; i < timer_count; i += 2)
+        {
+            wf_impl_timer_start(timers[i], -1);
+        }
+        wf_impl_timer_manager_check(manager);
+    });
+    report("start + expire", usec, timer_count / 2);
+
+    for(size_t i = 0; i < timer_count; i++)
+    {
+        wf_impl_timer_dispose(timers[i]);
+    }
+    wf_impl_timer_manager_dispose(manager);
+
+    std::printf("triggered: %zu\n", triggered);
+    return (triggered == (timer_count / 2)) ? 0 : 1;
+}
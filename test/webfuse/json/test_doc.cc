@@ -1,6 +1,8 @@
 #include "webfuse/impl/json/doc.h"
 #include "webfuse/impl/json/node.h"
+#include "webfuse/impl/util/arena.h"
 #include <gtest/gtest.h>
+#include <cstring>
 
 TEST(json_doc, loadb)
 {
@@ -20,4 +22,89 @@ TEST(json_doc, loadb_fail_invalid_json)
     char text[] = "true";
     wf_json_doc * doc = wf_impl_json_doc_loadb(text, 3);
     ASSERT_EQ(nullptr, doc);
-}
\ No newline at end of file
+}
+TEST(json_doc, loadb_arena)
+{
+    wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
+
+    for(int i = 0; i < 3; i++)
+    {
+        char text[] = "[1, {\"answer\": 42}, \"text\"]";
+        wf_json_doc * doc = wf_impl_json_doc_loadb_arena(&arena, text, strlen(text));
+        ASSERT_NE(nullptr, doc);
+
+        wf_json const * root = wf_impl_json_doc_root(doc);
+        ASSERT_EQ(WF_JSON_TYPE_ARRAY, wf_impl_json_type(root));
+        ASSERT_EQ(3, wf_impl_json_array_size(root));
+        wf_json const * answer = wf_impl_json_object_get(wf_impl_json_array_get(root, 1), "answer");
+        ASSERT_EQ(42, wf_impl_json_int_get(answer));
+
+        wf_impl_json_doc_dispose(doc);
+    }
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(json_doc, loadb_arena_fail_invalid_json)
+{
+    wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
+
+    char text[] = "[1, 2";
+    wf_json_doc * doc = wf_impl_json_doc_loadb_arena(&arena, text, strlen(text));
+    ASSERT_EQ(nullptr, doc);
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(json_doc, set_string_add)
+{
+    char text[] = "{\"a\": 1}";
+    wf_json_doc * doc = wf_impl_json_doc_loadb(text, strlen(text));
+    ASSERT_NE(nullptr, doc);
+
+    wf_json const * root = wf_impl_json_doc_root(doc);
+    char data[] = "Hello";
+    wf_impl_json_doc_set_string(doc, root, "b", data, 5);
+
+    ASSERT_EQ(2, wf_impl_json_object_size(root));
+    ASSERT_EQ(1, wf_impl_json_int_get(wf_impl_json_object_get(root, "a")));
+    wf_json const * value = wf_impl_json_object_get(root, "b");
+    ASSERT_TRUE(wf_impl_json_is_string(value));
+    ASSERT_EQ(5, wf_impl_json_string_size(value));
+    ASSERT_STREQ("Hello", wf_impl_json_string_get(value));
+
+    wf_impl_json_doc_dispose(doc);
+}
+
+TEST(json_doc, set_string_replace)
+{
+    char text[] = "{\"a\": 1}";
+    wf_json_doc * doc = wf_impl_json_doc_loadb(text, strlen(text));
+    ASSERT_NE(nullptr, doc);
+
+    wf_json const * root = wf_impl_json_doc_root(doc);
+    char data[] = "Hello";
+    wf_impl_json_doc_set_string(doc, root, "a", data, 5);
+
+    ASSERT_EQ(1, wf_impl_json_object_size(root));
+    ASSERT_STREQ("Hello", wf_impl_json_string_get(wf_impl_json_object_get(root, "a")));
+
+    wf_impl_json_doc_dispose(doc);
+}
+
+TEST(json_doc, set_string_ignore_non_object)
+{
+    char text[] = "[1]";
+    wf_json_doc * doc = wf_impl_json_doc_loadb(text, strlen(text));
+    ASSERT_NE(nullptr, doc);
+
+    wf_json const * root = wf_impl_json_doc_root(doc);
+    char data[] = "Hello";
+    wf_impl_json_doc_set_string(doc, root, "a", data, 5);
+
+    ASSERT_EQ(1, wf_impl_json_array_size(root));
+
+    wf_impl_json_doc_dispose(doc);
+}
@@ -2,6 +2,7 @@
 #include "webfuse/test_util/json_doc.hpp"
 
 #include <gtest/gtest.h>
+#include <climits>
 
 using webfuse_test::JsonDoc;
 
@@ -36,6 +37,22 @@ TEST(json_node, int)
     ASSERT_EQ(42, wf_impl_json_int_get(doc.root()));
 }
 
+TEST(json_node, int64)
+{
+    JsonDoc doc("5368709120");
+    ASSERT_TRUE(wf_impl_json_is_int(doc.root()));
+    ASSERT_EQ(INT64_C(5368709120), wf_impl_json_int64_get(doc.root()));
+}
+
+TEST(json_node, int_clamp_out_of_range)
+{
+    JsonDoc positive("5368709120");
+    ASSERT_EQ(INT_MAX, wf_impl_json_int_get(positive.root()));
+
+    JsonDoc negative("-5368709120");
+    ASSERT_EQ(INT_MIN, wf_impl_json_int_get(negative.root()));
+}
+
 TEST(json_node, string)
 {
     JsonDoc doc("\"brummni\"");
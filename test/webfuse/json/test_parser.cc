@@ -1,6 +1,7 @@
 #include "webfuse/impl/json/parser.h"
 #include "webfuse/impl/json/reader.h"
 #include "webfuse/impl/json/node_intern.h"
+#include "webfuse/impl/util/arena.h"
 
 #include <gtest/gtest.h>
 #include <string>
@@ -14,12 +15,11 @@ bool try_parse(std::string const & value)
     struct wf_json_reader reader;
     wf_impl_json_reader_init(&reader, const_cast<char*>(contents.data()), contents.size());
     wf_json json;
+    wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
 
-    bool const result = wf_impl_json_parse_value(&reader, &json);
-    if (result)
-    {
-        wf_impl_json_cleanup(&json);
-    }
+    bool const result = wf_impl_json_parse_value(&reader, &arena, &json);
+    wf_impl_arena_cleanup(&arena);
 
     return result;
 }
@@ -52,6 +52,11 @@ TEST(json_parser, fail_invalid_int)
     ASSERT_FALSE(try_parse("-"));
 }
 
+TEST(json_parser, fail_int_overflow)
+{
+    ASSERT_FALSE(try_parse("9223372036854775808"));
+}
+
 TEST(json_parser, fail_invalid_string)
 {
     ASSERT_FALSE(try_parse("\"invalid"));
@@ -134,6 +134,69 @@ TEST(json_reader, read_int_min)
     ASSERT_EQ(INT_MIN, value);
 }
 
+TEST(json_reader, read_int_fail_out_of_range)
+{
+    std::string text = "2147483648";
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    int value;
+    ASSERT_FALSE(wf_impl_json_reader_read_int(&reader, &value));
+}
+
+TEST(json_reader, read_int64)
+{
+    std::string text = "5368709120";
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    int64_t value;
+    ASSERT_TRUE(wf_impl_json_reader_read_int64(&reader, &value));
+    ASSERT_EQ(INT64_C(5368709120), value);
+}
+
+TEST(json_reader, read_int64_max)
+{
+    std::string text = std::to_string(INT64_MAX);
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    int64_t value;
+    ASSERT_TRUE(wf_impl_json_reader_read_int64(&reader, &value));
+    ASSERT_EQ(INT64_MAX, value);
+}
+
+TEST(json_reader, read_int64_min)
+{
+    std::string text = std::to_string(INT64_MIN);
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    int64_t value;
+    ASSERT_TRUE(wf_impl_json_reader_read_int64(&reader, &value));
+    ASSERT_EQ(INT64_MIN, value);
+}
+
+TEST(json_reader, read_int64_fail_overflow)
+{
+    std::string text = "9223372036854775808";
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    int64_t value;
+    ASSERT_FALSE(wf_impl_json_reader_read_int64(&reader, &value));
+}
+
+TEST(json_reader, read_int64_fail_underflow)
+{
+    std::string text = "-9223372036854775809";
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    int64_t value;
+    ASSERT_FALSE(wf_impl_json_reader_read_int64(&reader, &value));
+}
+
 TEST(json_reader, read_int_fail_invalid)
 {
     std::string text = "brummni";
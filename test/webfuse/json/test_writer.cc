@@ -97,6 +97,32 @@ TEST(json_writer, int_min)
     ASSERT_EQ(int_min, writer.take());
 }
 
+TEST(json_writer, int64)
+{
+    writer writer;
+
+    wf_impl_json_write_int64(writer, INT64_C(5368709120));
+    ASSERT_STREQ("5368709120", writer.take().c_str());
+}
+
+TEST(json_writer, int64_max)
+{
+    writer writer;
+    std::string int64_max = std::to_string(INT64_MAX);
+
+    wf_impl_json_write_int64(writer, INT64_MAX);
+    ASSERT_EQ(int64_max, writer.take());
+}
+
+TEST(json_writer, int64_min)
+{
+    writer writer;
+    std::string int64_min = std::to_string(INT64_MIN);
+
+    wf_impl_json_write_int64(writer, INT64_MIN);
+    ASSERT_EQ(int64_min, writer.take());
+}
+
 TEST(json_writer, write_string)
 {
     writer writer;
@@ -268,3 +294,39 @@ TEST(json_writer, unexpected_end)
     writer writer;
     wf_impl_json_write_array_end(writer);
 }
+
+TEST(json_writer, attach_buffer)
+{
+    wf_json_writer * writer = wf_impl_json_writer_create(16, 4);
+    wf_impl_json_write_int(writer, 1);
+
+    char * buffer = reinterpret_cast<char*>(malloc(4 + 32));
+    wf_impl_json_writer_attach(writer, &buffer[4], 32);
+    ASSERT_EQ(32, wf_impl_json_writer_get_capacity(writer));
+    wf_impl_json_write_int(writer, 42);
+
+    size_t size;
+    char * text = wf_impl_json_writer_take(writer, &size);
+    ASSERT_EQ(&buffer[4], text);
+    ASSERT_EQ(2, size);
+    ASSERT_STREQ("42", text);
+
+    free(text - 4);
+    wf_impl_json_writer_dispose(writer);
+}
+
+TEST(json_writer, attach_buffer_grow)
+{
+    wf_json_writer * writer = wf_impl_json_writer_create(16, 4);
+
+    char * buffer = reinterpret_cast<char*>(malloc(4 + 2));
+    wf_impl_json_writer_attach(writer, &buffer[4], 2);
+    wf_impl_json_write_string(writer, "some longer text");
+    ASSERT_LT(2, wf_impl_json_writer_get_capacity(writer));
+
+    char * text = wf_impl_json_writer_take(writer, nullptr);
+    ASSERT_STREQ("\"some longer text\"", text);
+
+    free(text - 4);
+    wf_impl_json_writer_dispose(writer);
+}
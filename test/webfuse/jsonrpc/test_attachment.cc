@@ -0,0 +1,210 @@
+#include "webfuse/impl/jsonrpc/attachment.h"
+#include "webfuse/impl/json/doc.h"
+#include "webfuse/impl/json/node.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+
+namespace
+{
+
+class Message
+{
+public:
+    explicit Message(std::string const & text)
+    : contents(text)
+    , doc(wf_impl_json_doc_loadb(&contents[0], contents.size()))
+    {
+    }
+
+    ~Message()
+    {
+        wf_impl_json_doc_dispose(doc);
+    }
+
+    wf_json const * result()
+    {
+        return wf_impl_json_object_get(wf_impl_json_doc_root(doc), "result");
+    }
+
+    std::string contents;
+    wf_json_doc * doc;
+};
+
+std::string frame(unsigned int id, std::string const & payload)
+{
+    std::string result;
+    result += static_cast<char>((id >> 24) & 0xff);
+    result += static_cast<char>((id >> 16) & 0xff);
+    result += static_cast<char>((id >>  8) & 0xff);
+    result += static_cast<char>( id        & 0xff);
+    result += payload;
+
+    return result;
+}
+
+}
+
+TEST(wf_jsonrpc_attachment, apply)
+{
+    wf_jsonrpc_attachment attachment;
+    wf_impl_jsonrpc_attachment_init(&attachment);
+
+    std::string const data = frame(42, std::string("\0\x01\x02\xff", 4));
+    wf_impl_jsonrpc_attachment_receive(&attachment, data.c_str(), data.size(), true, true);
+
+    Message message("{\"result\": {\"format\": \"binary\", \"count\": 4}, \"id\": 42}");
+    wf_impl_jsonrpc_attachment_apply(&attachment, message.doc);
+
+    wf_json const * payload = wf_impl_json_object_get(message.result(), "data");
+    ASSERT_TRUE(wf_impl_json_is_string(payload));
+    ASSERT_EQ(4, wf_impl_json_string_size(payload));
+    ASSERT_EQ(0, memcmp("\0\x01\x02\xff", wf_impl_json_string_get(payload), 4));
+
+    wf_impl_jsonrpc_attachment_cleanup(&attachment);
+}
+
+TEST(wf_jsonrpc_attachment, apply_fragmented)
+{
+    wf_jsonrpc_attachment attachment;
+    wf_impl_jsonrpc_attachment_init(&attachment);
+
+    std::string const data = frame(0x01020304, "Hello");
+    wf_impl_jsonrpc_attachment_receive(&attachment, data.c_str(), 3, true, false);
+    wf_impl_jsonrpc_attachment_receive(&attachment, &data.c_str()[3], 4, false, false);
+    wf_impl_jsonrpc_attachment_receive(&attachment, &data.c_str()[7], data.size() - 7, false, true);
+
+    Message message("{\"result\": {\"format\": \"binary\", \"count\": 5}, \"id\": 16909060}");
+    wf_impl_jsonrpc_attachment_apply(&attachment, message.doc);
+
+    wf_json const * payload = wf_impl_json_object_get(message.result(), "data");
+    ASSERT_EQ(5, wf_impl_json_string_size(payload));
+    ASSERT_EQ(0, strncmp("Hello", wf_impl_json_string_get(payload), 5));
+
+    wf_impl_jsonrpc_attachment_cleanup(&attachment);
+}
+
+TEST(wf_jsonrpc_attachment, replace_data)
+{
+    wf_jsonrpc_attachment attachment;
+    wf_impl_jsonrpc_attachment_init(&attachment);
+
+    std::string const data = frame(42, "Hello");
+    wf_impl_jsonrpc_attachment_receive(&attachment, data.c_str(), data.size(), true, true);
+
+    Message message("{\"result\": {\"data\": \"\", \"format\": \"binary\", \"count\": 5}, \"id\": 42}");
+    wf_impl_jsonrpc_attachment_apply(&attachment, message.doc);
+
+    wf_json const * payload = wf_impl_json_object_get(message.result(), "data");
+    ASSERT_EQ(5, wf_impl_json_string_size(payload));
+    ASSERT_EQ(3, wf_impl_json_object_size(message.result()));
+
+    wf_impl_jsonrpc_attachment_cleanup(&attachment);
+}
+
+TEST(wf_jsonrpc_attachment, ignore_other_id)
+{
+    wf_jsonrpc_attachment attachment;
+    wf_impl_jsonrpc_attachment_init(&attachment);
+
+    std::string const data = frame(23, "Hello");
+    wf_impl_jsonrpc_attachment_receive(&attachment, data.c_str(), data.size(), true, true);
+
+    Message message("{\"result\": {\"format\": \"binary\", \"count\": 5}, \"id\": 42}");
+    wf_impl_jsonrpc_attachment_apply(&attachment, message.doc);
+
+    ASSERT_TRUE(wf_impl_json_is_undefined(wf_impl_json_object_get(message.result(), "data")));
+
+    wf_impl_jsonrpc_attachment_cleanup(&attachment);
+}
+
+TEST(wf_jsonrpc_attachment, ignore_other_format)
+{
+    wf_jsonrpc_attachment attachment;
+    wf_impl_jsonrpc_attachment_init(&attachment);
+
+    std::string const data = frame(42, "Hello");
+    wf_impl_jsonrpc_attachment_receive(&attachment, data.c_str(), data.size(), true, true);
+
+    Message message("{\"result\": {\"data\": \"SGVsbG8=\", \"format\": \"base64\", \"count\": 5}, \"id\": 42}");
+    wf_impl_jsonrpc_attachment_apply(&attachment, message.doc);
+
+    ASSERT_STREQ("SGVsbG8=", wf_impl_json_string_get(wf_impl_json_object_get(message.result(), "data")));
+
+    wf_impl_jsonrpc_attachment_cleanup(&attachment);
+}
+
+TEST(wf_jsonrpc_attachment, ignore_incomplete_frame)
+{
+    wf_jsonrpc_attachment attachment;
+    wf_impl_jsonrpc_attachment_init(&attachment);
+
+    std::string const data = frame(42, "Hello");
+    wf_impl_jsonrpc_attachment_receive(&attachment, data.c_str(), 3, true, false);
+
+    Message message("{\"result\": {\"format\": \"binary\", \"count\": 5}, \"id\": 42}");
+    wf_impl_jsonrpc_attachment_apply(&attachment, message.doc);
+
+    ASSERT_TRUE(wf_impl_json_is_undefined(wf_impl_json_object_get(message.result(), "data")));
+
+    wf_impl_jsonrpc_attachment_cleanup(&attachment);
+}
+
+TEST(wf_jsonrpc_attachment, ignore_too_short_frame)
+{
+    wf_jsonrpc_attachment attachment;
+    wf_impl_jsonrpc_attachment_init(&attachment);
+
+    wf_impl_jsonrpc_attachment_receive(&attachment, "\0\0", 2, true, true);
+
+    Message message("{\"result\": {\"format\": \"binary\", \"count\": 0}, \"id\": 0}");
+    wf_impl_jsonrpc_attachment_apply(&attachment, message.doc);
+
+    ASSERT_TRUE(wf_impl_json_is_undefined(wf_impl_json_object_get(message.result(), "data")));
+
+    wf_impl_jsonrpc_attachment_cleanup(&attachment);
+}
+
+TEST(wf_jsonrpc_attachment, apply_to_next_message_only)
+{
+    wf_jsonrpc_attachment attachment;
+    wf_impl_jsonrpc_attachment_init(&attachment);
+
+    std::string const data = frame(42, "Hello");
+    wf_impl_jsonrpc_attachment_receive(&attachment, data.c_str(), data.size(), true, true);
+
+    Message other("{\"method\": \"some_notification\", \"params\": []}");
+    wf_impl_jsonrpc_attachment_apply(&attachment, other.doc);
+
+    Message message("{\"result\": {\"format\": \"binary\", \"count\": 5}, \"id\": 42}");
+    wf_impl_jsonrpc_attachment_apply(&attachment, message.doc);
+
+    ASSERT_TRUE(wf_impl_json_is_undefined(wf_impl_json_object_get(message.result(), "data")));
+
+    wf_impl_jsonrpc_attachment_cleanup(&attachment);
+}
+
+TEST(wf_jsonrpc_attachment, apply_to_batch)
+{
+    wf_jsonrpc_attachment attachment;
+    wf_impl_jsonrpc_attachment_init(&attachment);
+
+    std::string const data = frame(42, std::string("\0\x01\x02\xff", 4));
+    wf_impl_jsonrpc_attachment_receive(&attachment, data.c_str(), data.size(), true, true);
+
+    Message message("[{\"result\": {\"format\": \"binary\", \"count\": 4}, \"id\": 23},"
+        "{\"result\": {\"format\": \"binary\", \"count\": 4}, \"id\": 42}]");
+    wf_impl_jsonrpc_attachment_apply(&attachment, message.doc);
+
+    wf_json const * root = wf_impl_json_doc_root(message.doc);
+    wf_json const * other = wf_impl_json_object_get(wf_impl_json_array_get(root, 0), "result");
+    ASSERT_TRUE(wf_impl_json_is_undefined(wf_impl_json_object_get(other, "data")));
+
+    wf_json const * result = wf_impl_json_object_get(wf_impl_json_array_get(root, 1), "result");
+    wf_json const * payload = wf_impl_json_object_get(result, "data");
+    ASSERT_TRUE(wf_impl_json_is_string(payload));
+    ASSERT_EQ(4, wf_impl_json_string_size(payload));
+    ASSERT_EQ(0, memcmp("\0\x01\x02\xff", wf_impl_json_string_get(payload), 4));
+
+    wf_impl_jsonrpc_attachment_cleanup(&attachment);
+}
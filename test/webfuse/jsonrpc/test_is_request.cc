@@ -71,3 +71,44 @@ TEST(wf_jsonrpc_is_request, invalid_request_due_to_invalid_params)
 
     ASSERT_FALSE(wf_impl_jsonrpc_is_request(doc.root()));
 }
+
+TEST(wf_jsonrpc_is_notification, notification_with_array_params)
+{
+    JsonDoc doc("{\"method\": \"method\", \"params\": []}");
+
+    ASSERT_TRUE(wf_impl_jsonrpc_is_notification(doc.root()));
+    ASSERT_FALSE(wf_impl_jsonrpc_is_request(doc.root()));
+}
+
+TEST(wf_jsonrpc_is_notification, notification_with_object_params)
+{
+    JsonDoc doc("{\"method\": \"method\", \"params\": {}}");
+
+    ASSERT_TRUE(wf_impl_jsonrpc_is_notification(doc.root()));
+}
+
+TEST(wf_jsonrpc_is_notification, null_notification)
+{
+    ASSERT_FALSE(wf_impl_jsonrpc_is_notification(nullptr));
+}
+
+TEST(wf_jsonrpc_is_notification, request_is_no_notification)
+{
+    JsonDoc doc("{\"method\": \"method\", \"params\": [], \"id\": 42}");
+
+    ASSERT_FALSE(wf_impl_jsonrpc_is_notification(doc.root()));
+}
+
+TEST(wf_jsonrpc_is_notification, invalid_notification_without_params)
+{
+    JsonDoc doc("{\"method\": \"method\"}");
+
+    ASSERT_FALSE(wf_impl_jsonrpc_is_notification(doc.root()));
+}
+
+TEST(wf_jsonrpc_is_notification, invalid_notification_due_to_invalid_method)
+{
+    JsonDoc doc("{\"method\": 42, \"params\": []}");
+
+    ASSERT_FALSE(wf_impl_jsonrpc_is_notification(doc.root()));
+}
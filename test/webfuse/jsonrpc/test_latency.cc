@@ -0,0 +1,134 @@
+#include "webfuse/impl/jsonrpc/latency.h"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+
+namespace
+{
+
+void add_samples(wf_jsonrpc_latency * latency, uint64_t duration, size_t count)
+{
+    for(size_t i = 0; i < count; i++)
+    {
+        wf_impl_jsonrpc_latency_add_sample(latency, duration);
+    }
+}
+
+}
+
+TEST(wf_jsonrpc_latency, create_dispose)
+{
+    wf_jsonrpc_latency * latency = wf_impl_jsonrpc_latency_create("getattr", 0);
+    ASSERT_STREQ("getattr", latency->method);
+
+    wf_jsonrpc_latency_stats stats;
+    wf_impl_jsonrpc_latency_get_stats(latency, &stats);
+    ASSERT_EQ(0, stats.samples);
+    ASSERT_EQ(0, stats.timeouts);
+
+    wf_impl_jsonrpc_latency_dispose(latency);
+}
+
+TEST(wf_jsonrpc_latency, use_default_timeout_until_enough_samples)
+{
+    wf_jsonrpc_latency * latency = wf_impl_jsonrpc_latency_create("getattr", 0);
+    add_samples(latency, 10, WF_JSONRPC_LATENCY_MIN_SAMPLES - 1);
+    ASSERT_EQ(10000, wf_impl_jsonrpc_latency_get_timeout(latency, 10000, 100, 60000));
+
+    wf_impl_jsonrpc_latency_add_sample(latency, 10);
+    ASSERT_GT(10000, wf_impl_jsonrpc_latency_get_timeout(latency, 10000, 100, 60000));
+
+    wf_impl_jsonrpc_latency_dispose(latency);
+}
+
+TEST(wf_jsonrpc_latency, clamp_default_timeout)
+{
+    wf_jsonrpc_latency * latency = wf_impl_jsonrpc_latency_create("getattr", 0);
+    ASSERT_EQ(5000, wf_impl_jsonrpc_latency_get_timeout(latency, 10000, 100, 5000));
+    ASSERT_EQ(20000, wf_impl_jsonrpc_latency_get_timeout(latency, 10000, 20000, 60000));
+
+    wf_impl_jsonrpc_latency_dispose(latency);
+}
+
+TEST(wf_jsonrpc_latency, derive_timeout_from_latency)
+{
+    wf_jsonrpc_latency * latency = wf_impl_jsonrpc_latency_create("read", 0);
+    add_samples(latency, 100, 100);
+
+    wf_jsonrpc_latency_stats stats;
+    wf_impl_jsonrpc_latency_get_stats(latency, &stats);
+    ASSERT_EQ(100, stats.samples);
+    ASSERT_EQ(100, stats.average);
+    ASSERT_EQ(0, stats.deviation);
+    ASSERT_EQ(128, stats.percentile_99);
+    ASSERT_EQ(100, stats.max);
+
+    ASSERT_EQ(128, wf_impl_jsonrpc_latency_get_timeout(latency, 10000, 0, 60000));
+    ASSERT_EQ(1000, wf_impl_jsonrpc_latency_get_timeout(latency, 10000, 1000, 60000));
+
+    wf_impl_jsonrpc_latency_dispose(latency);
+}
+
+TEST(wf_jsonrpc_latency, include_slow_responses)
+{
+    wf_jsonrpc_latency * latency = wf_impl_jsonrpc_latency_create("read", 0);
+    add_samples(latency, 10, 90);
+    add_samples(latency, 3000, 10);
+
+    wf_jsonrpc_latency_stats stats;
+    wf_impl_jsonrpc_latency_get_stats(latency, &stats);
+    ASSERT_EQ(4096, stats.percentile_99);
+    ASSERT_EQ(3000, stats.max);
+    ASSERT_LE(4096, wf_impl_jsonrpc_latency_get_timeout(latency, 10000, 0, 60000));
+
+    wf_impl_jsonrpc_latency_dispose(latency);
+}
+
+TEST(wf_jsonrpc_latency, follow_recent_latency)
+{
+    wf_jsonrpc_latency * latency = wf_impl_jsonrpc_latency_create("read", 0);
+    add_samples(latency, 3000, 100);
+    add_samples(latency, 10, 10000);
+
+    wf_jsonrpc_latency_stats stats;
+    wf_impl_jsonrpc_latency_get_stats(latency, &stats);
+    ASSERT_EQ(10, stats.average);
+    ASSERT_EQ(16, stats.percentile_99);
+    ASSERT_EQ(16, wf_impl_jsonrpc_latency_get_timeout(latency, 10000, 0, 60000));
+
+    wf_impl_jsonrpc_latency_dispose(latency);
+}
+
+TEST(wf_jsonrpc_latency, back_off_on_timeout)
+{
+    wf_jsonrpc_latency * latency = wf_impl_jsonrpc_latency_create("read", 0);
+    add_samples(latency, 100, 100);
+    ASSERT_EQ(128, wf_impl_jsonrpc_latency_get_timeout(latency, 10000, 0, 60000));
+
+    wf_impl_jsonrpc_latency_add_timeout(latency);
+    ASSERT_EQ(256, wf_impl_jsonrpc_latency_get_timeout(latency, 10000, 0, 60000));
+    wf_impl_jsonrpc_latency_add_timeout(latency);
+    ASSERT_EQ(512, wf_impl_jsonrpc_latency_get_timeout(latency, 10000, 0, 60000));
+    ASSERT_EQ(300, wf_impl_jsonrpc_latency_get_timeout(latency, 10000, 0, 300));
+
+    wf_jsonrpc_latency_stats stats;
+    wf_impl_jsonrpc_latency_get_stats(latency, &stats);
+    ASSERT_EQ(2, stats.timeouts);
+
+    // next response resets back off
+    wf_impl_jsonrpc_latency_add_sample(latency, 100);
+    ASSERT_EQ(128, wf_impl_jsonrpc_latency_get_timeout(latency, 10000, 0, 60000));
+
+    wf_impl_jsonrpc_latency_dispose(latency);
+}
+
+TEST(wf_jsonrpc_latency, size_class)
+{
+    ASSERT_EQ(0, wf_impl_jsonrpc_latency_get_size_class(0));
+    ASSERT_EQ(4 * 1024, wf_impl_jsonrpc_latency_get_size_class(1));
+    ASSERT_EQ(4 * 1024, wf_impl_jsonrpc_latency_get_size_class(4 * 1024));
+    ASSERT_EQ(16 * 1024, wf_impl_jsonrpc_latency_get_size_class(4 * 1024 + 1));
+    ASSERT_EQ(1024 * 1024, wf_impl_jsonrpc_latency_get_size_class(1024 * 1024));
+    ASSERT_EQ(16 * 1024 * 1024, wf_impl_jsonrpc_latency_get_size_class(16 * 1024 * 1024));
+    ASSERT_EQ(SIZE_MAX, wf_impl_jsonrpc_latency_get_size_class(16 * 1024 * 1024 + 1));
+}
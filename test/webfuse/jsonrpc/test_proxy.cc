@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "webfuse/impl/jsonrpc/proxy.h"
 #include "webfuse/impl/jsonrpc/error.h"
+#include "webfuse/impl/jsonrpc/latency.h"
 #include "webfuse/impl/json/node.h"
 #include "webfuse/impl/message.h"
 #include "webfuse/status.h"
@@ -11,6 +12,7 @@
 
 #include <thread>
 #include <chrono>
+#include <vector>
 
 using namespace std::chrono_literals;
 using wf_jsonrpc_test::MockTimer;
@@ -30,12 +32,16 @@ namespace
         wf_json const * response;
         bool result;
         bool is_called;
+        wf_message_class message_class;
+        void const * source;
 
         explicit SendContext(bool result_ = true)
         : doc("null")
         , response(nullptr)
         , result(result_)
         , is_called(false)
+        , message_class(WF_MESSAGE_CLASS_METADATA)
+        , source(nullptr)
         {
         }
     };
@@ -48,6 +54,8 @@ namespace
         context->is_called = true;
         context->doc = std::move(JsonDoc(std::string(request->data, request->length)));
         context->response = context->doc.root();
+        context->message_class = request->message_class;
+        context->source = request->source;
 
         wf_impl_message_dispose(request);
         return context->result;
@@ -235,6 +243,29 @@ TEST(wf_jsonrpc_proxy, on_result)
     wf_impl_timer_manager_dispose(timer_manager);
 }
 
+TEST(wf_jsonrpc_proxy, pending_count)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+    ASSERT_EQ(0, wf_impl_jsonrpc_proxy_get_pending_count(proxy));
+
+    FinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, finished_data, "foo", "si", "bar", 42);
+    ASSERT_EQ(1, wf_impl_jsonrpc_proxy_get_pending_count(proxy));
+
+    wf_json const * id = wf_impl_json_object_get(send_context.response, "id");
+    JsonDoc response("{\"result\": \"okay\", \"id\": " + std::to_string(wf_impl_json_int_get(id)) + "}");
+    wf_impl_jsonrpc_proxy_onresult(proxy, response.root());
+    ASSERT_EQ(0, wf_impl_jsonrpc_proxy_get_pending_count(proxy));
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
 TEST(wf_jsonrpc_proxy, on_result_reject_response_with_unknown_id)
 {
     struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
@@ -287,6 +318,69 @@ TEST(wf_jsonrpc_proxy, timeout)
     wf_impl_timer_manager_dispose(timer_manager);
 }
 
+TEST(wf_jsonrpc_proxy, call_timeout_handler_after_timeout)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, 0, &jsonrpc_send, send_data);
+
+    struct TimeoutContext
+    {
+        wf_jsonrpc_proxy * proxy;
+        size_t pending_count;
+        int call_count;
+    } timeout_context = { proxy, 1, 0 };
+    wf_impl_jsonrpc_proxy_set_timeout_handler(proxy, [](void * user_data) {
+        auto * context = reinterpret_cast<TimeoutContext*>(user_data);
+        context->pending_count = wf_impl_jsonrpc_proxy_get_pending_count(context->proxy);
+        context->call_count++;
+    }, &timeout_context);
+
+    FinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, finished_data, "foo", "si", "bar", 42);
+
+    std::this_thread::sleep_for(10ms);
+    wf_impl_timer_manager_check(timer_manager);
+
+    ASSERT_TRUE(finished_context.is_called);
+    ASSERT_EQ(1, timeout_context.call_count);
+    ASSERT_EQ(0, timeout_context.pending_count);
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, do_not_call_timeout_handler_on_result)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+
+    int call_count = 0;
+    wf_impl_jsonrpc_proxy_set_timeout_handler(proxy, [](void * user_data) {
+        (*reinterpret_cast<int*>(user_data))++;
+    }, &call_count);
+
+    FinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, finished_data, "foo", "si", "bar", 42);
+
+    wf_json const * id = wf_impl_json_object_get(send_context.response, "id");
+    JsonDoc response("{\"result\": \"okay\", \"id\": " + std::to_string(wf_impl_json_int_get(id)) + "}");
+    wf_impl_jsonrpc_proxy_onresult(proxy, response.root());
+
+    ASSERT_TRUE(finished_context.is_called);
+    ASSERT_EQ(0, call_count);
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
 TEST(wf_jsonrpc_proxy, cleanup_pending_request)
 {
     struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
@@ -345,6 +439,29 @@ TEST(wf_jsonrpc_proxy, notify)
     wf_impl_timer_manager_dispose(timer_manager);
 }
 
+TEST(wf_jsonrpc_proxy, notify_int64)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+
+    int64_t const value = INT64_C(5) * 1024 * 1024 * 1024;
+    wf_impl_jsonrpc_proxy_notify(proxy, "foo", "Ii", value, 42);
+
+    ASSERT_TRUE(send_context.is_called);
+    wf_json const * params = wf_impl_json_object_get(send_context.response, "params");
+    ASSERT_TRUE(wf_impl_json_is_array(params));
+    ASSERT_EQ(2, wf_impl_json_array_size(params));
+    ASSERT_TRUE(wf_impl_json_is_int(wf_impl_json_array_get(params, 0)));
+    ASSERT_EQ(value, wf_impl_json_int64_get(wf_impl_json_array_get(params, 0)));
+    ASSERT_EQ(42, wf_impl_json_int_get(wf_impl_json_array_get(params, 1)));
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
 TEST(wf_jsonrpc_proxy, notify_send_invalid_request)
 {
     struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
@@ -376,3 +493,263 @@ TEST(wf_jsonrpc_proxy, on_result_swallow_if_no_request_pending)
     wf_impl_timer_manager_dispose(timer_manager);
 }
 
+
+TEST(wf_jsonrpc_proxy, on_result_many_pending_requests)
+{
+    static size_t const count = 1000;
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+
+    std::vector<FinishedContext> finished_context(count);
+    std::vector<int> ids(count);
+    for(size_t i = 0; i < count; i++)
+    {
+        wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, reinterpret_cast<void*>(&finished_context[i]), "foo", "si", "bar", 42);
+        ids[i] = wf_impl_json_int_get(wf_impl_json_object_get(send_context.response, "id"));
+    }
+
+    // answer in reverse order
+    for(size_t i = count; i > 0; i--)
+    {
+        JsonDoc response("{\"result\": \"okay\", \"id\": " + std::to_string(ids[i - 1]) + "}");
+        wf_impl_jsonrpc_proxy_onresult(proxy, response.root());
+
+        ASSERT_TRUE(finished_context[i - 1].is_called);
+        ASSERT_EQ(nullptr, finished_context[i - 1].error);
+        if (i > 1)
+        {
+            ASSERT_FALSE(finished_context[i - 2].is_called);
+        }
+    }
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, on_result_ignore_finished_request)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+
+    FinishedContext finished_context;
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, reinterpret_cast<void*>(&finished_context), "foo", "si", "bar", 42);
+    int const id = wf_impl_json_int_get(wf_impl_json_object_get(send_context.response, "id"));
+
+    JsonDoc response("{\"result\": \"okay\", \"id\": " + std::to_string(id) + "}");
+    wf_impl_jsonrpc_proxy_onresult(proxy, response.root());
+    ASSERT_TRUE(finished_context.is_called);
+
+    FinishedContext other_context;
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, reinterpret_cast<void*>(&other_context), "foo", "si", "bar", 42);
+
+    wf_impl_jsonrpc_proxy_onresult(proxy, response.root());
+    ASSERT_FALSE(other_context.is_called);
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    ASSERT_TRUE(other_context.is_called);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, timeout_many_pending_requests)
+{
+    static size_t const count = 200;
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, 0, &jsonrpc_send, send_data);
+
+    std::vector<FinishedContext> finished_context(count);
+    for(size_t i = 0; i < count; i++)
+    {
+        wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, reinterpret_cast<void*>(&finished_context[i]), "foo", "si", "bar", 42);
+    }
+
+    std::this_thread::sleep_for(10ms);
+    wf_impl_timer_manager_check(timer_manager);
+
+    for(size_t i = 0; i < count; i++)
+    {
+        ASSERT_TRUE(finished_context[i].is_called);
+        ASSERT_EQ(WF_BAD_TIMEOUT, wf_impl_jsonrpc_error_code(finished_context[i].error));
+    }
+
+    wf_jsonrpc_latency_stats stats;
+    ASSERT_TRUE(wf_impl_jsonrpc_proxy_get_latency_stats(proxy, "foo", 0, &stats));
+    ASSERT_EQ(0, stats.samples);
+    ASSERT_EQ(count, stats.timeouts);
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, view)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+    int source;
+    struct wf_jsonrpc_proxy * view = wf_impl_jsonrpc_proxy_create_view(proxy, &source, WF_MESSAGE_CLASS_DATA);
+
+    FinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke(view, &jsonrpc_finished, finished_data, "foo", "si", "bar", 42);
+    ASSERT_TRUE(send_context.is_called);
+    ASSERT_EQ(WF_MESSAGE_CLASS_DATA, send_context.message_class);
+    ASSERT_EQ(&source, send_context.source);
+    ASSERT_EQ(1, wf_impl_jsonrpc_proxy_get_pending_count(proxy));
+
+    // responses are dispatched by the proxy
+    wf_json const * id = wf_impl_json_object_get(send_context.response, "id");
+    JsonDoc response("{\"result\": \"okay\", \"id\": " + std::to_string(wf_impl_json_int_get(id)) + "}");
+    wf_impl_jsonrpc_proxy_onresult(proxy, response.root());
+    ASSERT_TRUE(finished_context.is_called);
+    ASSERT_EQ(0, wf_impl_jsonrpc_proxy_get_pending_count(proxy));
+
+    wf_impl_jsonrpc_proxy_notify(view, "close", "si", "bar", 42);
+    ASSERT_EQ(WF_MESSAGE_CLASS_NOTIFICATION, send_context.message_class);
+    ASSERT_EQ(&source, send_context.source);
+
+    wf_impl_jsonrpc_proxy_dispose(view);
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, cancel)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+
+    FinishedContext other_context;
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, reinterpret_cast<void*>(&other_context), "foo", "");
+
+    FinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, finished_data, "foo", "");
+    int const id = wf_impl_json_int_get(wf_impl_json_object_get(send_context.response, "id"));
+    ASSERT_EQ(2, wf_impl_jsonrpc_proxy_get_pending_count(proxy));
+
+    wf_impl_jsonrpc_proxy_cancel(proxy, &jsonrpc_finished, finished_data);
+    ASSERT_TRUE(finished_context.is_called);
+    ASSERT_EQ(WF_BAD_INTERRUPTED, wf_impl_jsonrpc_error_code(finished_context.error));
+    ASSERT_FALSE(other_context.is_called);
+    ASSERT_EQ(1, wf_impl_jsonrpc_proxy_get_pending_count(proxy));
+
+    ASSERT_EQ(WF_MESSAGE_CLASS_NOTIFICATION, send_context.message_class);
+    ASSERT_STREQ("cancel", wf_impl_json_string_get(wf_impl_json_object_get(send_context.response, "method")));
+    wf_json const * params = wf_impl_json_object_get(send_context.response, "params");
+    ASSERT_EQ(1, wf_impl_json_array_size(params));
+    ASSERT_EQ(id, wf_impl_json_int_get(wf_impl_json_array_get(params, 0)));
+    ASSERT_FALSE(wf_impl_json_is_int(wf_impl_json_object_get(send_context.response, "id")));
+
+    // late response is ignored
+    JsonDoc response("{\"result\": \"okay\", \"id\": " + std::to_string(id) + "}");
+    wf_impl_jsonrpc_proxy_onresult(proxy, response.root());
+    ASSERT_EQ(1, wf_impl_jsonrpc_proxy_get_pending_count(proxy));
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+    ASSERT_TRUE(other_context.is_called);
+}
+
+TEST(wf_jsonrpc_proxy, latency_stats)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+    wf_impl_jsonrpc_proxy_set_timeout(proxy, 10, WF_DEFAULT_TIMEOUT);
+
+    wf_jsonrpc_latency_stats stats;
+    ASSERT_FALSE(wf_impl_jsonrpc_proxy_get_latency_stats(proxy, "foo", 0, &stats));
+
+    FinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, finished_data, "foo", "");
+    wf_json const * id = wf_impl_json_object_get(send_context.response, "id");
+    JsonDoc response("{\"result\": \"okay\", \"id\": " + std::to_string(wf_impl_json_int_get(id)) + "}");
+    wf_impl_jsonrpc_proxy_onresult(proxy, response.root());
+    ASSERT_TRUE(finished_context.is_called);
+
+    ASSERT_TRUE(wf_impl_jsonrpc_proxy_get_latency_stats(proxy, "foo", 0, &stats));
+    ASSERT_EQ(1, stats.samples);
+    ASSERT_EQ(0, stats.timeouts);
+    ASSERT_FALSE(wf_impl_jsonrpc_proxy_get_latency_stats(proxy, "bar", 0, &stats));
+
+    wf_impl_jsonrpc_proxy_log_stats(proxy, "test");
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, latency_stats_per_size_class)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+
+    FinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke_sized(proxy, &jsonrpc_finished, finished_data, 1024 * 1024, "read", "i", 1024 * 1024);
+    wf_json const * id = wf_impl_json_object_get(send_context.response, "id");
+    JsonDoc response("{\"result\": \"okay\", \"id\": " + std::to_string(wf_impl_json_int_get(id)) + "}");
+    wf_impl_jsonrpc_proxy_onresult(proxy, response.root());
+    ASSERT_TRUE(finished_context.is_called);
+
+    // small reads do not share the estimator of large reads
+    wf_jsonrpc_latency_stats stats;
+    ASSERT_TRUE(wf_impl_jsonrpc_proxy_get_latency_stats(proxy, "read", 1024 * 1024, &stats));
+    ASSERT_EQ(1, stats.samples);
+    ASSERT_TRUE(wf_impl_jsonrpc_proxy_get_latency_stats(proxy, "read", 600 * 1024, &stats));
+    ASSERT_FALSE(wf_impl_jsonrpc_proxy_get_latency_stats(proxy, "read", 4096, &stats));
+    ASSERT_FALSE(wf_impl_jsonrpc_proxy_get_latency_stats(proxy, "read", 0, &stats));
+
+    wf_impl_jsonrpc_proxy_log_stats(proxy, "test");
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, measure_timeout_from_send_time)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, 100, &jsonrpc_send, send_data);
+
+    FinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, finished_data, "foo", "");
+    wf_json const * id = wf_impl_json_object_get(send_context.response, "id");
+
+    // request is queued for a while before it is sent
+    std::this_thread::sleep_for(60ms);
+    wf_message message;
+    message.request_id = wf_impl_json_int_get(id);
+    wf_impl_jsonrpc_proxy_onsent(proxy, &message);
+
+    std::this_thread::sleep_for(60ms);
+    wf_impl_timer_manager_check(timer_manager);
+    ASSERT_FALSE(finished_context.is_called);
+
+    std::this_thread::sleep_for(60ms);
+    wf_impl_timer_manager_check(timer_manager);
+    ASSERT_TRUE(finished_context.is_called);
+    ASSERT_EQ(WF_BAD_TIMEOUT, wf_impl_jsonrpc_error_code(finished_context.error));
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
@@ -53,6 +53,21 @@ namespace
         wf_impl_jsonrpc_respond(request);
     }
 
+    void setInvoked(
+        struct wf_jsonrpc_request * request,
+        char const * method_name,
+        wf_json const * params,
+        void * user_data)
+    {
+        (void) method_name;
+        (void) params;
+
+        bool * is_invoked = reinterpret_cast<bool*>(user_data);
+        *is_invoked = true;
+
+        wf_impl_jsonrpc_respond(request);
+    }
+
 }
 
 TEST(wf_jsonrpc_server, process_request)
@@ -217,4 +232,34 @@ TEST(wf_jsonrpc_server, skip_invalid_request_wront_method_type)
     ASSERT_FALSE(context.is_called);
 
     wf_impl_jsonrpc_server_dispose(server); 
-}
\ No newline at end of file
+}
+TEST(wf_jsonrpc_server, process_notification)
+{
+    struct wf_jsonrpc_server * server = wf_impl_jsonrpc_server_create();
+    bool is_invoked = false;
+    wf_impl_jsonrpc_server_add(server, "notify", &setInvoked, &is_invoked);
+
+    Context context;
+    void * user_data = reinterpret_cast<void*>(&context);
+    JsonDoc request("{\"method\": \"notify\", \"params\": []}");
+    wf_impl_jsonrpc_server_process(server, request.root(), &jsonrpc_send, user_data);
+
+    ASSERT_TRUE(is_invoked);
+    ASSERT_FALSE(context.is_called);
+
+    wf_impl_jsonrpc_server_dispose(server); 
+}
+
+TEST(wf_jsonrpc_server, discard_error_of_unknown_notification)
+{
+    struct wf_jsonrpc_server * server = wf_impl_jsonrpc_server_create();
+
+    Context context;
+    void * user_data = reinterpret_cast<void*>(&context);
+    JsonDoc request("{\"method\": \"notify\", \"params\": []}");
+    wf_impl_jsonrpc_server_process(server, request.root(), &jsonrpc_send, user_data);
+
+    ASSERT_FALSE(context.is_called);
+
+    wf_impl_jsonrpc_server_dispose(server); 
+}
@@ -9,9 +9,14 @@ WF_WRAP_FUNC1(webfuse_test_FuseMock, void*, fuse_req_userdata, fuse_req_t);
 WF_WRAP_FUNC2(webfuse_test_FuseMock, int, fuse_reply_open, fuse_req_t, const struct fuse_file_info *);
 WF_WRAP_FUNC2(webfuse_test_FuseMock, int, fuse_reply_err, fuse_req_t, int);
 WF_WRAP_FUNC3(webfuse_test_FuseMock, int,  fuse_reply_buf, fuse_req_t, const char *, size_t);
+WF_WRAP_FUNC3(webfuse_test_FuseMock, int, fuse_reply_data, fuse_req_t, struct fuse_bufvec *, enum fuse_buf_copy_flags);
 WF_WRAP_FUNC3(webfuse_test_FuseMock, int, fuse_reply_attr, fuse_req_t, const struct stat *, double);
 WF_WRAP_FUNC1(webfuse_test_FuseMock, const struct fuse_ctx *, fuse_req_ctx, fuse_req_t);
+WF_WRAP_FUNC3(webfuse_test_FuseMock, void, fuse_req_interrupt_func, fuse_req_t, fuse_interrupt_func_t, void *);
 WF_WRAP_FUNC2(webfuse_test_FuseMock, int, fuse_reply_entry, fuse_req_t, const struct fuse_entry_param *);
+WF_WRAP_FUNC1(webfuse_test_FuseMock, void, fuse_reply_none, fuse_req_t);
+WF_WRAP_FUNC4(webfuse_test_FuseMock, int, fuse_lowlevel_notify_inval_inode, struct fuse_session *, fuse_ino_t, off_t, off_t);
+WF_WRAP_FUNC4(webfuse_test_FuseMock, int, fuse_lowlevel_notify_inval_entry, struct fuse_session *, fuse_ino_t, const char *, size_t);
 }
 
 namespace webfuse_test
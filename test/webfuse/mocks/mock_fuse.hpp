@@ -17,9 +17,14 @@ public:
     MOCK_METHOD2(fuse_reply_open, int (fuse_req_t req, const struct fuse_file_info *fi));
     MOCK_METHOD2(fuse_reply_err, int (fuse_req_t req, int err));
     MOCK_METHOD3(fuse_reply_buf, int (fuse_req_t req, const char *buf, size_t size));
+    MOCK_METHOD3(fuse_reply_data, int (fuse_req_t req, struct fuse_bufvec *bufv, enum fuse_buf_copy_flags flags));
     MOCK_METHOD3(fuse_reply_attr, int (fuse_req_t req, const struct stat *attr, double attr_timeout));
     MOCK_METHOD1(fuse_req_ctx, const struct fuse_ctx *(fuse_req_t req));
+    MOCK_METHOD3(fuse_req_interrupt_func, void (fuse_req_t req, fuse_interrupt_func_t func, void *data));
     MOCK_METHOD2(fuse_reply_entry, int (fuse_req_t req, const struct fuse_entry_param *e));
+    MOCK_METHOD1(fuse_reply_none, void (fuse_req_t req));
+    MOCK_METHOD4(fuse_lowlevel_notify_inval_inode, int (struct fuse_session * se, fuse_ino_t ino, off_t off, off_t len));
+    MOCK_METHOD4(fuse_lowlevel_notify_inval_entry, int (struct fuse_session * se, fuse_ino_t parent, const char * name, size_t namelen));
 };
 
 }
@@ -12,10 +12,23 @@ WF_WRAP_VFUNC5(webfuse_test_MockJsonRpcProxy, void, wf_impl_jsonrpc_proxy_vinvok
 	char const *,
 	char const *);
 
+WF_WRAP_VFUNC6(webfuse_test_MockJsonRpcProxy, void, wf_impl_jsonrpc_proxy_vinvoke_sized,
+	struct wf_jsonrpc_proxy *,
+	wf_jsonrpc_proxy_finished_fn *,
+	void *,
+	size_t,
+	char const *,
+	char const *);
+
 WF_WRAP_VFUNC3(webfuse_test_MockJsonRpcProxy, void, wf_impl_jsonrpc_proxy_vnotify,
 	struct wf_jsonrpc_proxy *,
 	char const *,
 	char const *);
+
+WF_WRAP_FUNC3(webfuse_test_MockJsonRpcProxy, void, wf_impl_jsonrpc_proxy_cancel,
+	struct wf_jsonrpc_proxy *,
+	wf_jsonrpc_proxy_finished_fn *,
+	void *);
 }
 
 namespace webfuse_test
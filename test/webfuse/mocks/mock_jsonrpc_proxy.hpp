@@ -18,10 +18,21 @@ public:
         void * user_data,
         char const * method_name,
         char const * param_info));
+    MOCK_METHOD6(wf_impl_jsonrpc_proxy_vinvoke_sized, void (
+        struct wf_jsonrpc_proxy * proxy,
+        wf_jsonrpc_proxy_finished_fn * finished,
+        void * user_data,
+        size_t size,
+        char const * method_name,
+        char const * param_info));
     MOCK_METHOD3(wf_impl_jsonrpc_proxy_vnotify, void (
         struct wf_jsonrpc_proxy * proxy,
         char const * method_name,
         char const * param_info));
+    MOCK_METHOD3(wf_impl_jsonrpc_proxy_cancel, void (
+        struct wf_jsonrpc_proxy * proxy,
+        wf_jsonrpc_proxy_finished_fn * finished,
+        void * user_data));
 
 };
 
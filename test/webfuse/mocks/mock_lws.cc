@@ -0,0 +1,26 @@
+#include "webfuse/mocks/mock_lws.hpp"
+#include "webfuse/test_util/wrap.hpp"
+
+extern "C"
+{
+static webfuse_test::LwsMock * webfuse_test_LwsMock = nullptr;
+
+WF_WRAP_FUNC4(webfuse_test_LwsMock, int, lws_write, struct lws *, unsigned char *, size_t, enum lws_write_protocol);
+WF_WRAP_FUNC1(webfuse_test_LwsMock, int, lws_send_pipe_choked, struct lws *);
+WF_WRAP_FUNC1(webfuse_test_LwsMock, int, lws_callback_on_writable, struct lws *);
+}
+
+namespace webfuse_test
+{
+
+LwsMock::LwsMock()
+{
+    webfuse_test_LwsMock = this;
+}
+
+LwsMock::~LwsMock()
+{
+    webfuse_test_LwsMock = nullptr;
+}
+
+}
@@ -9,6 +9,10 @@ WF_WRAP_FUNC1(webfuse_test_MockOperationContext,
     struct wf_jsonrpc_proxy *,  wf_impl_operation_context_get_proxy,
 	struct wf_impl_operation_context *);
 
+WF_WRAP_FUNC1(webfuse_test_MockOperationContext, 
+    struct wf_jsonrpc_proxy *,  wf_impl_operation_context_get_data_proxy,
+	struct wf_impl_operation_context *);
+
 }
 
 namespace webfuse_test
@@ -14,6 +14,8 @@ public:
     virtual ~MockOperationContext();
     MOCK_METHOD1(wf_impl_operation_context_get_proxy, wf_jsonrpc_proxy * (
 	    struct wf_impl_operation_context * context));
+    MOCK_METHOD1(wf_impl_operation_context_get_data_proxy, wf_jsonrpc_proxy * (
+	    struct wf_impl_operation_context * context));
 
 };
 
@@ -1,4 +1,5 @@
 #include "webfuse/impl/operation/close.h"
+#include "webfuse/impl/operation/readahead.h"
 #include <gtest/gtest.h>
 
 #include "webfuse/mocks/mock_fuse.hpp"
@@ -17,7 +18,7 @@ using testing::StrEq;
 TEST(wf_impl_operation_close, notify_proxy)
 {
     MockJsonRpcProxy proxy;
-    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vnotify(_,StrEq("close"),StrEq("siii"))).Times(1);
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vnotify(_,StrEq("close"),StrEq("sIii"))).Times(1);
 
     MockOperationContext context;
     EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
@@ -25,6 +26,7 @@ TEST(wf_impl_operation_close, notify_proxy)
 
     wf_impl_operation_context op_context;
     op_context.name = nullptr;
+    op_context.inodes = nullptr;
     FuseMock fuse;
     EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
     EXPECT_CALL(fuse, fuse_reply_err(_, 0)).Times(1).WillOnce(Return(0));
@@ -33,7 +35,9 @@ TEST(wf_impl_operation_close, notify_proxy)
     fuse_ino_t inode = 1;
     fuse_file_info file_info;
     file_info.flags = 0;
+    file_info.fh = reinterpret_cast<uint64_t>(wf_impl_readahead_create(42, 1, 0));
     wf_impl_operation_close(request, inode, &file_info);
+    ASSERT_EQ(0, file_info.fh);
 }
 
 TEST(wf_impl_operation_close, fail_rpc_null)
@@ -51,6 +55,9 @@ TEST(wf_impl_operation_close, fail_rpc_null)
 
     fuse_req_t request = nullptr;
     fuse_ino_t inode = 1;
-    fuse_file_info * file_info = nullptr;
-    wf_impl_operation_close(request, inode, file_info);
+    fuse_file_info file_info;
+    file_info.flags = 0;
+    file_info.fh = reinterpret_cast<uint64_t>(wf_impl_readahead_create(42, 1, 0));
+    wf_impl_operation_close(request, inode, &file_info);
+    ASSERT_EQ(0, file_info.fh);
 }
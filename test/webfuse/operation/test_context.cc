@@ -18,4 +18,14 @@ TEST(wf_impl_operation_context, get_proxy_fail_no_session)
 
     ASSERT_EQ(nullptr, wf_impl_operation_context_get_proxy(&context));
     
-}
\ No newline at end of file
+}
+TEST(wf_impl_operation_context, get_data_proxy)
+{
+    wf_jsonrpc_proxy * proxy = reinterpret_cast<wf_jsonrpc_proxy*>(42);
+    wf_jsonrpc_proxy * data_proxy = reinterpret_cast<wf_jsonrpc_proxy*>(23);
+    wf_impl_operation_context context;
+    context.proxy = proxy;
+    context.data_proxy = data_proxy;
+
+    ASSERT_EQ(data_proxy, wf_impl_operation_context_get_data_proxy(&context));
+}
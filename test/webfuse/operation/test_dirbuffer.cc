@@ -0,0 +1,176 @@
+#include "webfuse/impl/operation/dirbuffer.h"
+#include "webfuse/impl/inode_table.h"
+
+#include "webfuse/mocks/mock_fuse.hpp"
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+
+using webfuse_test::FuseMock;
+using testing::_;
+using testing::Return;
+using testing::Invoke;
+using testing::IsNull;
+
+namespace
+{
+
+struct Reply
+{
+    size_t size;
+    std::string data;
+};
+
+int fill_reply(Reply * reply, char const * buffer, size_t size)
+{
+    reply->size = size;
+    reply->data = std::string(buffer, size);
+    return 0;
+}
+
+}
+
+TEST(wf_impl_dirbuffer, add_entries)
+{
+    wf_impl_dirbuffer * buffer = wf_impl_dirbuffer_create();
+    for(int i = 0; i < 100; i++)
+    {
+        std::string name = "file_" + std::to_string(i) + ".txt";
+        wf_impl_dirbuffer_add(buffer, name.c_str(), i + 2);
+    }
+
+    ASSERT_EQ(100, buffer->count);
+    ASSERT_STREQ("file_42.txt", &buffer->names[buffer->entries[42].name_offset]);
+    ASSERT_EQ(44, buffer->entries[42].attr.st_ino);
+    ASSERT_FALSE(buffer->entries[42].has_attr);
+
+    wf_impl_dirbuffer_clear(buffer);
+    ASSERT_EQ(0, buffer->count);
+
+    wf_impl_dirbuffer_dispose(buffer);
+}
+
+TEST(wf_impl_dirbuffer, reply_empty_after_last_entry)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_, IsNull(), 0)).Times(2).WillRepeatedly(Return(0));
+
+    wf_impl_dirbuffer * buffer = wf_impl_dirbuffer_create();
+    wf_impl_dirbuffer_add(buffer, "a.file", 42);
+
+    wf_impl_dirbuffer_reply(nullptr, buffer, 1024, 1, nullptr);
+    wf_impl_dirbuffer_reply_plus(nullptr, buffer, 1024, 1, 1.0, nullptr);
+
+    wf_impl_dirbuffer_dispose(buffer);
+}
+
+TEST(wf_impl_dirbuffer, reply_limited_by_size)
+{
+    Reply all;
+    Reply first;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_, _, _))
+        .WillOnce(Invoke([&all](fuse_req_t, char const * data, size_t size) { return fill_reply(&all, data, size); }))
+        .WillOnce(Invoke([&first](fuse_req_t, char const * data, size_t size) { return fill_reply(&first, data, size); }));
+
+    wf_impl_dirbuffer * buffer = wf_impl_dirbuffer_create();
+    wf_impl_dirbuffer_add(buffer, "a.file", 42);
+    wf_impl_dirbuffer_add(buffer, "b.file", 43);
+
+    wf_impl_dirbuffer_reply(nullptr, buffer, 1024, 0, nullptr);
+    ASSERT_LT(0, all.size);
+
+    // both entries have the same size
+    wf_impl_dirbuffer_reply(nullptr, buffer, all.size - 1, 0, nullptr);
+    ASSERT_EQ(all.size / 2, first.size);
+
+    wf_impl_dirbuffer_dispose(buffer);
+}
+
+TEST(wf_impl_dirbuffer, reply_plus_contains_attributes)
+{
+    Reply plain;
+    Reply plus;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_, _, _))
+        .WillOnce(Invoke([&plain](fuse_req_t, char const * data, size_t size) { return fill_reply(&plain, data, size); }))
+        .WillOnce(Invoke([&plus](fuse_req_t, char const * data, size_t size) { return fill_reply(&plus, data, size); }));
+
+    struct stat attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.st_ino = 42;
+    attr.st_mode = S_IFREG | 0444;
+    attr.st_size = 23;
+
+    wf_impl_dirbuffer * buffer = wf_impl_dirbuffer_create();
+    wf_impl_dirbuffer_add_plus(buffer, "a.file", &attr);
+
+    wf_impl_dirbuffer_reply(nullptr, buffer, 1024, 0, nullptr);
+    wf_impl_dirbuffer_reply_plus(nullptr, buffer, 1024, 0, 1.0, nullptr);
+
+    ASSERT_LT(0, plain.size);
+    ASSERT_LT(plain.size, plus.size);
+
+    wf_impl_dirbuffer_dispose(buffer);
+}
+
+TEST(wf_impl_dirbuffer, reply_plus_references_inodes)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_, _, _)).Times(2).WillRepeatedly(Return(0));
+
+    struct stat attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.st_ino = 42;
+    attr.st_mode = S_IFREG | 0444;
+
+    wf_impl_dirbuffer * buffer = wf_impl_dirbuffer_create();
+    wf_impl_dirbuffer_add(buffer, ".", 1);
+    wf_impl_dirbuffer_add_plus(buffer, "a.file", &attr);
+    wf_impl_dirbuffer_add(buffer, "b.file", 43);
+
+    wf_impl_inode_table * inodes = wf_impl_inode_table_create();
+    wf_impl_dirbuffer_reply(nullptr, buffer, 1024, 0, inodes);
+    ASSERT_EQ(0, wf_impl_inode_table_find(inodes, 42));
+
+    wf_impl_dirbuffer_reply_plus(nullptr, buffer, 1024, 0, 1.0, inodes);
+    fuse_ino_t inode = wf_impl_inode_table_find(inodes, 42);
+    ASSERT_NE(0, inode);
+    ASSERT_EQ(0, wf_impl_inode_table_find(inodes, 43));
+    ASSERT_EQ(2, wf_impl_inode_table_count(inodes));
+
+    ASSERT_TRUE(wf_impl_inode_table_forget(inodes, inode, 1, nullptr));
+
+    wf_impl_inode_table_dispose(inodes);
+    wf_impl_dirbuffer_dispose(buffer);
+}
+
+TEST(wf_impl_dirbuffer, reply_unknown_inode_for_unmapped_entries)
+{
+    Reply reply;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_, _, _))
+        .WillOnce(Invoke([&reply](fuse_req_t, char const * data, size_t size) { return fill_reply(&reply, data, size); }));
+
+    wf_impl_inode_table * inodes = wf_impl_inode_table_create();
+    uint64_t generation;
+    fuse_ino_t const inode = wf_impl_inode_table_ref(inodes, 43, &generation);
+
+    // provider id of a.file equals the kernel inode of b.file
+    wf_impl_dirbuffer * buffer = wf_impl_dirbuffer_create();
+    wf_impl_dirbuffer_add(buffer, "a.file", inode);
+    wf_impl_dirbuffer_add(buffer, "b.file", 43);
+    wf_impl_dirbuffer_reply(nullptr, buffer, 1024, 0, inodes);
+
+    // fuse_dirent starts with the inode number
+    ASSERT_LT(0, reply.size);
+    uint64_t d_ino;
+    memcpy(&d_ino, reply.data.c_str(), sizeof(d_ino));
+    ASSERT_EQ(FUSE_UNKNOWN_INO, d_ino);
+    memcpy(&d_ino, &(reply.data.c_str()[reply.size / 2]), sizeof(d_ino));
+    ASSERT_EQ(inode, d_ino);
+
+    wf_impl_dirbuffer_dispose(buffer);
+    wf_impl_inode_table_dispose(inodes);
+}
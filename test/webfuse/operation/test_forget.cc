@@ -0,0 +1,74 @@
+#include "webfuse/impl/operation/forget.h"
+#include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/inode_table.h"
+#include "webfuse/impl/attr_cache.h"
+
+#include "webfuse/mocks/mock_fuse.hpp"
+
+#include <gtest/gtest.h>
+#include <cstring>
+
+using webfuse_test::FuseMock;
+using testing::_;
+using testing::Return;
+
+TEST(wf_impl_operation_forget, release_inode_and_cached_attributes)
+{
+    wf_impl_operation_context op_context;
+    op_context.inodes = wf_impl_inode_table_create();
+    op_context.cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+
+    struct stat attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.st_ino = 42;
+    wf_impl_attr_cache_set_attr(op_context.cache, 42, &attr);
+    fuse_ino_t inode = wf_impl_inode_table_ref(op_context.inodes, 42, nullptr);
+    wf_impl_inode_table_ref(op_context.inodes, 42, nullptr);
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(2).WillRepeatedly(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_none(_)).Times(2);
+
+    wf_impl_operation_forget(nullptr, inode, 1);
+    ASSERT_EQ(inode, wf_impl_inode_table_find(op_context.inodes, 42));
+    ASSERT_TRUE(wf_impl_attr_cache_get_attr(op_context.cache, 42, &attr));
+
+    wf_impl_operation_forget(nullptr, inode, 1);
+    ASSERT_EQ(0, wf_impl_inode_table_find(op_context.inodes, 42));
+    ASSERT_FALSE(wf_impl_attr_cache_get_attr(op_context.cache, 42, &attr));
+
+    wf_impl_attr_cache_dispose(op_context.cache);
+    wf_impl_inode_table_dispose(op_context.inodes);
+}
+
+TEST(wf_impl_operation_forget, forget_multi)
+{
+    wf_impl_operation_context op_context;
+    op_context.inodes = wf_impl_inode_table_create();
+    op_context.cache = nullptr;
+
+    fuse_forget_data forgets[2];
+    forgets[0].ino = wf_impl_inode_table_ref(op_context.inodes, 42, nullptr);
+    forgets[0].nlookup = 1;
+    forgets[1].ino = wf_impl_inode_table_ref(op_context.inodes, 23, nullptr);
+    forgets[1].nlookup = 1;
+    ASSERT_EQ(3, wf_impl_inode_table_count(op_context.inodes));
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_none(_)).Times(1);
+
+    wf_impl_operation_forget_multi(nullptr, 2, forgets);
+    ASSERT_EQ(1, wf_impl_inode_table_count(op_context.inodes));
+
+    wf_impl_inode_table_dispose(op_context.inodes);
+}
+
+TEST(wf_impl_operation_forget, no_context)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(nullptr));
+    EXPECT_CALL(fuse, fuse_reply_none(_)).Times(1);
+
+    wf_impl_operation_forget(nullptr, 42, 1);
+}
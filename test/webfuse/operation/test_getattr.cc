@@ -1,4 +1,6 @@
 #include "webfuse/impl/operation/getattr.h"
+#include "webfuse/impl/attr_cache.h"
+#include "webfuse/impl/operation/singleflight.h"
 #include "webfuse/impl/jsonrpc/error.h"
 
 #include "webfuse/status.h"
@@ -37,7 +39,7 @@ void free_context(
 TEST(wf_impl_operation_getattr, invoke_proxy)
 {
     MockJsonRpcProxy proxy;
-    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("getattr"),StrEq("si"))).Times(1)
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("getattr"),StrEq("sI"))).Times(1)
         .WillOnce(Invoke(free_context));
 
     MockOperationContext context;
@@ -45,7 +47,10 @@ TEST(wf_impl_operation_getattr, invoke_proxy)
         .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
 
     wf_impl_operation_context op_context;
+    op_context.singleflight = nullptr;
+    op_context.inodes = nullptr;
     op_context.name = nullptr;
+    op_context.cache = nullptr;
     fuse_ctx fuse_context;
     fuse_context.gid = 0;
     fuse_context.uid = 0;
@@ -86,8 +91,31 @@ TEST(wf_impl_operation_getattr, finished_file)
 
     auto * context = reinterpret_cast<wf_impl_operation_getattr_context*>(malloc(sizeof(wf_impl_operation_getattr_context)));
     context->inode = 1;
+    context->id = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    wf_impl_operation_getattr_finished(context, result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_getattr, finished_large_file)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_attr(_,_,_)).Times(1).WillOnce(Invoke(
+        [](fuse_req_t, struct stat const * attr, double) -> int {
+            EXPECT_EQ(INT64_C(5368709120), attr->st_size);
+            EXPECT_EQ(INT64_C(4102444800), attr->st_mtime);
+            return 0;
+        }));
+
+    JsonDoc result("{\"mode\": 493, \"type\": \"file\", \"size\": 5368709120, \"mtime\": 4102444800}");
+
+    auto * context = reinterpret_cast<wf_impl_operation_getattr_context*>(malloc(sizeof(wf_impl_operation_getattr_context)));
+    context->inode = 1;
+    context->id = 1;
+    context->gid = 0;
+    context->uid = 0;
+    context->cache = nullptr;
     wf_impl_operation_getattr_finished(context, result.root(), nullptr);
 }
 
@@ -100,8 +128,10 @@ TEST(wf_impl_operation_getattr, finished_dir)
 
     auto * context = reinterpret_cast<wf_impl_operation_getattr_context*>(malloc(sizeof(wf_impl_operation_getattr_context)));
     context->inode = 1;
+    context->id = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
     wf_impl_operation_getattr_finished(context, result.root(), nullptr);
 }
 
@@ -114,8 +144,10 @@ TEST(wf_impl_operation_getattr, finished_unknown_type)
 
     auto * context = reinterpret_cast<wf_impl_operation_getattr_context*>(malloc(sizeof(wf_impl_operation_getattr_context)));
     context->inode = 1;
+    context->id = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
     wf_impl_operation_getattr_finished(context, result.root(), nullptr);
 }
 
@@ -129,8 +161,10 @@ TEST(wf_impl_operation_getattr, finished_fail_missing_mode)
 
     auto * context = reinterpret_cast<wf_impl_operation_getattr_context*>(malloc(sizeof(wf_impl_operation_getattr_context)));
     context->inode = 1;
+    context->id = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
     wf_impl_operation_getattr_finished(context, result.root(), nullptr);
 }
 
@@ -144,8 +178,10 @@ TEST(wf_impl_operation_getattr, finished_fail_invalid_mode_type)
 
     auto * context = reinterpret_cast<wf_impl_operation_getattr_context*>(malloc(sizeof(wf_impl_operation_getattr_context)));
     context->inode = 1;
+    context->id = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
     wf_impl_operation_getattr_finished(context, result.root(), nullptr);
 }
 
@@ -159,8 +195,10 @@ TEST(wf_impl_operation_getattr, finished_fail_missing_type)
 
     auto * context = reinterpret_cast<wf_impl_operation_getattr_context*>(malloc(sizeof(wf_impl_operation_getattr_context)));
     context->inode = 1;
+    context->id = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
     wf_impl_operation_getattr_finished(context, result.root(), nullptr);
 }
 
@@ -174,8 +212,10 @@ TEST(wf_impl_operation_getattr, finished_fail_invalid_type_type)
 
     auto * context = reinterpret_cast<wf_impl_operation_getattr_context*>(malloc(sizeof(wf_impl_operation_getattr_context)));
     context->inode = 1;
+    context->id = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
     wf_impl_operation_getattr_finished(context, result.root(), nullptr);
 }
 
@@ -189,8 +229,141 @@ TEST(wf_impl_operation_getattr, finished_error)
 
     auto * context = reinterpret_cast<wf_impl_operation_getattr_context*>(malloc(sizeof(wf_impl_operation_getattr_context)));
     context->inode = 1;
+    context->id = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
     wf_impl_operation_getattr_finished(context, nullptr, error);
     wf_impl_jsonrpc_error_dispose(error);
 }
+
+TEST(wf_impl_operation_getattr, reply_from_cache)
+{
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,_,_)).Times(0);
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    struct stat attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.st_ino = 1;
+    attr.st_mode = S_IFDIR | 0555;
+
+    wf_impl_operation_context op_context;
+    op_context.singleflight = nullptr;
+    op_context.inodes = nullptr;
+    op_context.name = nullptr;
+    op_context.timeout = 1.0;
+    op_context.cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+    wf_impl_attr_cache_set_attr(op_context.cache, 1, &attr);
+
+    fuse_ctx fuse_context;
+    fuse_context.gid = 0;
+    fuse_context.uid = 0;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_ctx(_)).Times(1).WillOnce(Return(&fuse_context));
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_attr(_,_,_)).Times(1).WillOnce(Return(0));
+
+    fuse_req_t request = nullptr;
+    wf_impl_operation_getattr(request, 1, nullptr);
+
+    wf_impl_attr_cache_dispose(op_context.cache);
+}
+
+TEST(wf_impl_operation_getattr, finished_fill_cache)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_attr(_,_,_)).Times(1).WillOnce(Return(0));
+
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+
+    JsonDoc result("{\"mode\": 493, \"type\": \"dir\"}");
+    auto * context = reinterpret_cast<wf_impl_operation_getattr_context*>(malloc(sizeof(wf_impl_operation_getattr_context)));
+    context->inode = 1;
+    context->id = 1;
+    context->gid = 0;
+    context->uid = 0;
+    context->cache = cache;
+    context->generation = 0;
+    wf_impl_operation_getattr_finished(context, result.root(), nullptr);
+
+    struct stat attr;
+    ASSERT_TRUE(wf_impl_attr_cache_get_attr(cache, 1, &attr));
+    ASSERT_TRUE(S_ISDIR(attr.st_mode));
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(wf_impl_operation_getattr, finished_skip_cache_after_invalidation)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_attr(_,_,_)).Times(1).WillOnce(Return(0));
+
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+
+    JsonDoc result("{\"mode\": 493, \"type\": \"dir\"}");
+    auto * context = reinterpret_cast<wf_impl_operation_getattr_context*>(malloc(sizeof(wf_impl_operation_getattr_context)));
+    context->inode = 1;
+    context->id = 1;
+    context->gid = 0;
+    context->uid = 0;
+    context->cache = cache;
+    context->generation = wf_impl_attr_cache_get_generation(cache);
+
+    // provider invalidates the inode while the request is pending
+    wf_impl_attr_cache_invalidate_attr(cache, 1);
+    wf_impl_operation_getattr_finished(context, result.root(), nullptr);
+
+    struct stat attr;
+    ASSERT_FALSE(wf_impl_attr_cache_get_attr(cache, 1, &attr));
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(wf_impl_operation_getattr, attached_request_does_not_fill_cache_after_invalidation)
+{
+    void * call = nullptr;
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("getattr"),StrEq("sI"))).Times(1)
+        .WillOnce(Invoke([&call](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn *, void * user_data, char const *, char const *) {
+            call = user_data;
+        }));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(2)
+        .WillRepeatedly(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.singleflight = wf_impl_singleflight_create();
+    op_context.inodes = nullptr;
+    op_context.name = nullptr;
+    op_context.timeout = 1.0;
+    op_context.cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+
+    fuse_ctx fuse_context;
+    fuse_context.gid = 0;
+    fuse_context.uid = 0;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_ctx(_)).Times(2).WillRepeatedly(Return(&fuse_context));
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(2).WillRepeatedly(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_attr(_,_,_)).Times(2).WillRepeatedly(Return(0));
+
+    wf_impl_operation_getattr(nullptr, 1, nullptr);
+    wf_impl_attr_cache_invalidate_attr(op_context.cache, 1);
+
+    // attached to the request sent before the invalidation
+    wf_impl_operation_getattr(nullptr, 1, nullptr);
+    ASSERT_NE(nullptr, call);
+
+    JsonDoc result("{\"mode\": 493, \"type\": \"dir\"}");
+    wf_impl_singleflight_finished(call, result.root(), nullptr);
+
+    struct stat attr;
+    ASSERT_FALSE(wf_impl_attr_cache_get_attr(op_context.cache, 1, &attr));
+
+    wf_impl_singleflight_dispose(op_context.singleflight);
+    wf_impl_attr_cache_dispose(op_context.cache);
+}
@@ -0,0 +1,129 @@
+#include "webfuse/impl/operation/init.h"
+#include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/mountpoint.h"
+
+#include <gtest/gtest.h>
+#include <cstring>
+
+namespace
+{
+
+struct InitEnvironment
+{
+    InitEnvironment()
+    {
+        memset(&conn, 0, sizeof(conn));
+        conn.capable = FUSE_CAP_ASYNC_READ | FUSE_CAP_PARALLEL_DIROPS
+            | FUSE_CAP_READDIRPLUS | FUSE_CAP_READDIRPLUS_AUTO
+            | FUSE_CAP_SPLICE_WRITE | FUSE_CAP_SPLICE_MOVE | FUSE_CAP_SPLICE_READ;
+        conn.max_readahead = 128 * 1024;
+
+        options.capabilities = WF_FUSE_CAP_DEFAULT;
+        options.max_readahead = 0;
+        options.max_background = 0;
+        options.congestion_threshold = 0;
+
+        memset(&context, 0, sizeof(context));
+        context.fuse_options = &options;
+    }
+
+    void init()
+    {
+        wf_impl_operation_init(&context, &conn);
+    }
+
+    fuse_conn_info conn;
+    wf_mountpoint_fuse_options options;
+    wf_impl_operation_context context;
+};
+
+}
+
+TEST(wf_impl_operation_init, enable_default_capabilities)
+{
+    InitEnvironment env;
+    env.init();
+
+    ASSERT_EQ(FUSE_CAP_ASYNC_READ | FUSE_CAP_PARALLEL_DIROPS
+        | FUSE_CAP_READDIRPLUS | FUSE_CAP_READDIRPLUS_AUTO, env.conn.want);
+}
+
+TEST(wf_impl_operation_init, enable_splice)
+{
+    InitEnvironment env;
+    env.options.capabilities = WF_FUSE_CAP_DEFAULT | WF_FUSE_CAP_SPLICE;
+    env.init();
+
+    ASSERT_EQ(FUSE_CAP_ASYNC_READ | FUSE_CAP_PARALLEL_DIROPS
+        | FUSE_CAP_READDIRPLUS | FUSE_CAP_READDIRPLUS_AUTO
+        | FUSE_CAP_SPLICE_WRITE | FUSE_CAP_SPLICE_MOVE, env.conn.want);
+}
+
+TEST(wf_impl_operation_init, skip_capabilities_not_supported_by_kernel)
+{
+    InitEnvironment env;
+    env.conn.capable = FUSE_CAP_ASYNC_READ | FUSE_CAP_SPLICE_WRITE;
+    env.options.capabilities = WF_FUSE_CAP_DEFAULT | WF_FUSE_CAP_SPLICE;
+
+    env.init();
+
+    ASSERT_EQ(FUSE_CAP_ASYNC_READ | FUSE_CAP_SPLICE_WRITE, env.conn.want);
+}
+
+TEST(wf_impl_operation_init, disable_capabilities)
+{
+    InitEnvironment env;
+    env.conn.want = FUSE_CAP_ASYNC_READ | FUSE_CAP_READDIRPLUS | FUSE_CAP_READDIRPLUS_AUTO;
+    env.options.capabilities = WF_FUSE_CAP_SPLICE;
+
+    env.init();
+
+    ASSERT_EQ(FUSE_CAP_SPLICE_WRITE | FUSE_CAP_SPLICE_MOVE, env.conn.want);
+}
+
+TEST(wf_impl_operation_init, set_limits)
+{
+    InitEnvironment env;
+    env.options.max_readahead = 64 * 1024;
+    env.options.max_background = 100;
+    env.options.congestion_threshold = 80;
+
+    env.init();
+
+    ASSERT_EQ(64 * 1024, env.conn.max_readahead);
+    ASSERT_EQ(100, env.conn.max_background);
+    ASSERT_EQ(80, env.conn.congestion_threshold);
+}
+
+TEST(wf_impl_operation_init, derive_congestion_threshold_from_max_background)
+{
+    InitEnvironment env;
+    env.options.max_background = 64;
+
+    env.init();
+
+    ASSERT_EQ(64, env.conn.max_background);
+    ASSERT_EQ(48, env.conn.congestion_threshold);
+}
+
+TEST(wf_impl_operation_init, do_not_raise_max_readahead)
+{
+    InitEnvironment env;
+    env.options.max_readahead = 1024 * 1024;
+
+    env.init();
+
+    ASSERT_EQ(128 * 1024, env.conn.max_readahead);
+}
+
+TEST(wf_impl_operation_init, keep_defaults_without_options)
+{
+    InitEnvironment env;
+    env.context.fuse_options = nullptr;
+    env.conn.want = FUSE_CAP_ASYNC_READ;
+
+    env.init();
+
+    ASSERT_EQ(FUSE_CAP_ASYNC_READ, env.conn.want);
+    ASSERT_EQ(128 * 1024, env.conn.max_readahead);
+}
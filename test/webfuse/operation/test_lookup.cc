@@ -1,4 +1,6 @@
 #include "webfuse/impl/operation/lookup.h"
+#include "webfuse/impl/attr_cache.h"
+#include "webfuse/impl/inode_table.h"
 #include "webfuse/impl/jsonrpc/error.h"
 
 #include "webfuse/status.h"
@@ -37,7 +39,7 @@ void free_context(
 TEST(wf_impl_operation_lookup, invoke_proxy)
 {
     MockJsonRpcProxy proxy;
-    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("lookup"),StrEq("sis"))).Times(1)
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("lookup"),StrEq("sIs"))).Times(1)
         .WillOnce(Invoke(free_context));
 
     MockOperationContext context;
@@ -45,7 +47,10 @@ TEST(wf_impl_operation_lookup, invoke_proxy)
         .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
 
     wf_impl_operation_context op_context;
+    op_context.singleflight = nullptr;
+    op_context.inodes = nullptr;
     op_context.name = nullptr;
+    op_context.cache = nullptr;
     fuse_ctx fuse_context;
     fuse_context.gid = 0;
     fuse_context.uid = 0;
@@ -85,6 +90,10 @@ TEST(wf_impl_operation_lookup, finished_file)
     context->timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->parent = 1;
+    context->name = nullptr;
+    context->cache = nullptr;
+    context->inodes = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -98,6 +107,10 @@ TEST(wf_impl_operation_lookup, finished_dir)
     context->timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->parent = 1;
+    context->name = nullptr;
+    context->cache = nullptr;
+    context->inodes = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -111,6 +124,10 @@ TEST(wf_impl_operation_lookup, finished_unknown_type)
     context->timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->parent = 1;
+    context->name = nullptr;
+    context->cache = nullptr;
+    context->inodes = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -125,6 +142,10 @@ TEST(wf_impl_operation_lookup, finished_fail_missing_inode)
     context->timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->parent = 1;
+    context->name = nullptr;
+    context->cache = nullptr;
+    context->inodes = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -139,6 +160,10 @@ TEST(wf_impl_operation_lookup, finished_fail_invalid_inode_type)
     context->timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->parent = 1;
+    context->name = nullptr;
+    context->cache = nullptr;
+    context->inodes = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -153,6 +178,10 @@ TEST(wf_impl_operation_lookup, finished_fail_missing_mode)
     context->timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->parent = 1;
+    context->name = nullptr;
+    context->cache = nullptr;
+    context->inodes = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -167,6 +196,10 @@ TEST(wf_impl_operation_lookup, finished_fail_invalid_mode_type)
     context->timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->parent = 1;
+    context->name = nullptr;
+    context->cache = nullptr;
+    context->inodes = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -181,6 +214,10 @@ TEST(wf_impl_operation_lookup, finished_fail_missing_type)
     context->timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->parent = 1;
+    context->name = nullptr;
+    context->cache = nullptr;
+    context->inodes = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -195,6 +232,10 @@ TEST(wf_impl_operation_lookup, finished_fail_invalid_type_type)
     context->timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->parent = 1;
+    context->name = nullptr;
+    context->cache = nullptr;
+    context->inodes = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -210,6 +251,205 @@ TEST(wf_impl_operation_lookup, finished_error)
     context->timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->parent = 1;
+    context->name = nullptr;
+    context->cache = nullptr;
+    context->inodes = nullptr;
     wf_impl_operation_lookup_finished(context, nullptr, error);
     wf_impl_jsonrpc_error_dispose(error);
 }
+
+TEST(wf_impl_operation_lookup, reply_from_cache)
+{
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,_,_)).Times(0);
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    struct stat attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.st_ino = 42;
+    attr.st_mode = S_IFREG | 0444;
+
+    wf_impl_operation_context op_context;
+    op_context.singleflight = nullptr;
+    op_context.inodes = nullptr;
+    op_context.name = nullptr;
+    op_context.timeout = 1.0;
+    op_context.cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+    wf_impl_attr_cache_set_attr(op_context.cache, 42, &attr);
+    wf_impl_attr_cache_set_entry(op_context.cache, 1, "some.file", 42);
+
+    fuse_ctx fuse_context;
+    fuse_context.gid = 0;
+    fuse_context.uid = 0;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_ctx(_)).Times(1).WillOnce(Return(&fuse_context));
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_entry(_,_)).Times(1).WillOnce(Return(0));
+
+    fuse_req_t request = nullptr;
+    wf_impl_operation_lookup(request, 1, "some.file");
+
+    wf_impl_attr_cache_dispose(op_context.cache);
+}
+
+TEST(wf_impl_operation_lookup, reply_negative_from_cache)
+{
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,_,_)).Times(0);
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.singleflight = nullptr;
+    op_context.inodes = nullptr;
+    op_context.name = nullptr;
+    op_context.timeout = 1.0;
+    op_context.cache = wf_impl_attr_cache_create(1000, 1000, 1024 * 1024);
+    wf_impl_attr_cache_set_negative_entry(op_context.cache, 1, "some.file");
+
+    fuse_ctx fuse_context;
+    fuse_context.gid = 0;
+    fuse_context.uid = 0;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_ctx(_)).Times(1).WillOnce(Return(&fuse_context));
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
+
+    fuse_req_t request = nullptr;
+    wf_impl_operation_lookup(request, 1, "some.file");
+
+    wf_impl_attr_cache_dispose(op_context.cache);
+}
+
+TEST(wf_impl_operation_lookup, finished_fill_cache)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_entry(_,_)).Times(1).WillOnce(Return(0));
+
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+
+    JsonDoc result("{\"inode\": 42, \"mode\": 493, \"type\": \"file\"}");
+    auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
+    context->timeout = 1.0;
+    context->gid = 0;
+    context->uid = 0;
+    context->parent = 1;
+    context->name = strdup("some.file");
+    context->cache = cache;
+    context->generation = 0;
+    context->inodes = nullptr;
+    wf_impl_operation_lookup_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+
+    struct stat attr;
+    ASSERT_EQ(WF_IMPL_ATTR_CACHE_FOUND, wf_impl_attr_cache_lookup(cache, 1, "some.file", &attr));
+    ASSERT_EQ(42, attr.st_ino);
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(wf_impl_operation_lookup, finished_skip_cache_after_invalidation)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_entry(_,_)).Times(2).WillRepeatedly(Return(0));
+
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+    JsonDoc result("{\"inode\": 42, \"mode\": 493, \"type\": \"file\"}");
+
+    // entry is invalidated while the request is pending
+    auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
+    context->timeout = 1.0;
+    context->gid = 0;
+    context->uid = 0;
+    context->parent = 1;
+    context->name = strdup("some.file");
+    context->cache = cache;
+    context->generation = wf_impl_attr_cache_get_generation(cache);
+    context->inodes = nullptr;
+    wf_impl_attr_cache_invalidate_entry(cache, 1, "some.file");
+    wf_impl_operation_lookup_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+
+    struct stat attr;
+    ASSERT_EQ(WF_IMPL_ATTR_CACHE_MISS, wf_impl_attr_cache_lookup(cache, 1, "some.file", &attr));
+
+    // attributes of the entry are invalidated while the request is pending
+    context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
+    context->timeout = 1.0;
+    context->gid = 0;
+    context->uid = 0;
+    context->parent = 1;
+    context->name = strdup("some.file");
+    context->cache = cache;
+    context->generation = wf_impl_attr_cache_get_generation(cache);
+    context->inodes = nullptr;
+    wf_impl_attr_cache_invalidate_attr(cache, 42);
+    wf_impl_operation_lookup_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+
+    ASSERT_FALSE(wf_impl_attr_cache_get_attr(cache, 42, &attr));
+    ASSERT_EQ(WF_IMPL_ATTR_CACHE_MISS, wf_impl_attr_cache_lookup(cache, 1, "some.file", &attr));
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(wf_impl_operation_lookup, finished_fill_negative_cache)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
+
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 1000, 1024 * 1024);
+
+    struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD_NOENTRY, "");
+    auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
+    context->timeout = 1.0;
+    context->gid = 0;
+    context->uid = 0;
+    context->parent = 1;
+    context->name = strdup("some.file");
+    context->cache = cache;
+    context->generation = 0;
+    context->inodes = nullptr;
+    wf_impl_operation_lookup_finished(reinterpret_cast<void*>(context), nullptr, error);
+    wf_impl_jsonrpc_error_dispose(error);
+
+    struct stat attr;
+    ASSERT_EQ(WF_IMPL_ATTR_CACHE_NOT_FOUND, wf_impl_attr_cache_lookup(cache, 1, "some.file", &attr));
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(wf_impl_operation_lookup, finished_maps_provider_id_to_inode)
+{
+    wf_impl_inode_table * inodes = wf_impl_inode_table_create();
+    uint64_t const id = 0x123456789abcdefULL;
+
+    FuseMock fuse;
+    fuse_entry_param entry;
+    EXPECT_CALL(fuse, fuse_reply_entry(_,_)).Times(1).WillOnce(Invoke(
+        [&entry](fuse_req_t, fuse_entry_param const * e) { entry = *e; return 0; }));
+
+    JsonDoc result("{\"inode\": 81985529216486895, \"mode\": 493, \"type\": \"file\"}");
+    auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
+    context->timeout = 1.0;
+    context->gid = 0;
+    context->uid = 0;
+    context->parent = 1;
+    context->name = nullptr;
+    context->cache = nullptr;
+    context->inodes = inodes;
+    wf_impl_operation_lookup_finished(context, result.root(), nullptr);
+
+    ASSERT_EQ(wf_impl_inode_table_find(inodes, id), entry.ino);
+    ASSERT_EQ(entry.ino, entry.attr.st_ino);
+    ASSERT_NE(id, entry.ino);
+
+    uint64_t mapped_id = 0;
+    ASSERT_TRUE(wf_impl_inode_table_get_id(inodes, entry.ino, &mapped_id));
+    ASSERT_EQ(id, mapped_id);
+
+    wf_impl_inode_table_dispose(inodes);
+}
@@ -1,4 +1,5 @@
 #include "webfuse/impl/operation/open.h"
+#include "webfuse/impl/operation/readahead.h"
 #include "webfuse/impl/jsonrpc/error.h"
 
 #include "webfuse/status.h"
@@ -17,11 +18,41 @@ using webfuse_test::FuseMock;
 using testing::_;
 using testing::Return;
 using testing::StrEq;
+using testing::Invoke;
+
+namespace
+{
+
+void free_context(
+    struct wf_jsonrpc_proxy * ,
+    wf_jsonrpc_proxy_finished_fn * ,
+    void * user_data,
+    char const * ,
+    char const *)
+{
+    free(user_data);
+}
+
+wf_impl_readahead * open_files = nullptr;
+
+wf_impl_operation_open_context * create_context()
+{
+    auto * context = reinterpret_cast<wf_impl_operation_open_context*>(malloc(sizeof(wf_impl_operation_open_context)));
+    context->request = nullptr;
+    context->id = 23;
+    context->readahead = 0;
+    context->open_files = &open_files;
+
+    return context;
+}
+
+}
 
 TEST(wf_impl_operation_open, invoke_proxy)
 {
     MockJsonRpcProxy proxy;
-    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("open"),StrEq("sii"))).Times(1);
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("open"),StrEq("sIi"))).Times(1)
+        .WillOnce(Invoke(free_context));
 
     MockOperationContext context;
     EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
@@ -29,6 +60,8 @@ TEST(wf_impl_operation_open, invoke_proxy)
 
     wf_impl_operation_context op_context;
     op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.readahead = 0;
     FuseMock fuse;
     EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
 
@@ -59,10 +92,20 @@ TEST(wf_impl_operation_open, fail_rpc_null)
 TEST(wf_impl_operation_open, finished)
 {
     FuseMock fuse;
-    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(1).WillOnce(Return(0));
+    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(1).WillOnce(Invoke(
+        [](fuse_req_t, fuse_file_info const * file_info) -> int {
+            auto * readahead = reinterpret_cast<wf_impl_readahead*>(file_info->fh);
+            EXPECT_NE(nullptr, readahead);
+            EXPECT_EQ(42, readahead->handle);
+            EXPECT_EQ(23, readahead->id);
+            EXPECT_EQ(readahead, open_files);
+            wf_impl_readahead_dispose(readahead);
+            EXPECT_EQ(nullptr, open_files);
+            return 0;
+        }));
 
     JsonDoc result("{\"handle\": 42}");
-    wf_impl_operation_open_finished(nullptr, result.root(), nullptr);
+    wf_impl_operation_open_finished(create_context(), result.root(), nullptr);
 }
 
 TEST(wf_impl_operation_open, finished_fail_error)
@@ -72,7 +115,7 @@ TEST(wf_impl_operation_open, finished_fail_error)
     EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
 
     struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD, "");
-    wf_impl_operation_open_finished(nullptr, nullptr, error);
+    wf_impl_operation_open_finished(create_context(), nullptr, error);
     wf_impl_jsonrpc_error_dispose(error);
 }
 
@@ -83,7 +126,7 @@ TEST(wf_impl_operation_open, finished_fail_no_handle)
     EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
 
     JsonDoc result("{}");
-    wf_impl_operation_open_finished(nullptr, result.root(), nullptr);
+    wf_impl_operation_open_finished(create_context(), result.root(), nullptr);
 }
 
 TEST(wf_impl_operation_open, finished_fail_invalid_handle_type)
@@ -93,5 +136,5 @@ TEST(wf_impl_operation_open, finished_fail_invalid_handle_type)
     EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
 
     JsonDoc result("{\"handle\": \"42\"}");
-    wf_impl_operation_open_finished(nullptr, result.root(), nullptr);
+    wf_impl_operation_open_finished(create_context(), result.root(), nullptr);
 }
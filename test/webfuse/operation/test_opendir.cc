@@ -0,0 +1,29 @@
+#include "webfuse/impl/operation/opendir.h"
+#include "webfuse/impl/operation/dirbuffer.h"
+
+#include "webfuse/mocks/mock_fuse.hpp"
+
+#include <gtest/gtest.h>
+
+using webfuse_test::FuseMock;
+using testing::_;
+using testing::Return;
+
+TEST(wf_impl_operation_opendir, create_handle)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(1).WillOnce(Return(0));
+
+    fuse_req_t request = nullptr;
+    fuse_ino_t inode = 1;
+    fuse_file_info file_info;
+    file_info.flags = 0;
+    file_info.fh = 0;
+    wf_impl_operation_opendir(request, inode, &file_info);
+
+    auto * buffer = reinterpret_cast<wf_impl_dirbuffer*>(file_info.fh);
+    ASSERT_NE(nullptr, buffer);
+    ASSERT_EQ(0, buffer->count);
+
+    wf_impl_dirbuffer_dispose(buffer);
+}
@@ -1,32 +1,44 @@
 #include "webfuse/impl/operation/read.h"
+#include "webfuse/impl/operation/readahead.h"
 #include "webfuse/impl/jsonrpc/error.h"
+#include "webfuse/impl/jsonrpc/proxy.h"
+#include "webfuse/impl/session.h"
+#include "webfuse/impl/timer/manager.h"
 
 #include "webfuse/test_util/json_doc.hpp"
 #include "webfuse/mocks/mock_fuse.hpp"
 #include "webfuse/mocks/mock_operation_context.hpp"
 #include "webfuse/mocks/mock_jsonrpc_proxy.hpp"
+#include "webfuse/mocks/mock_lws.hpp"
 
 #include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <cstring>
 
 using webfuse_test::JsonDoc;
 using webfuse_test::MockJsonRpcProxy;
 using webfuse_test::MockOperationContext;
 using webfuse_test::FuseMock;
+using webfuse_test::LwsMock;
 using testing::_;
 using testing::Return;
 using testing::StrEq;
+using testing::Invoke;
 
 TEST(wf_impl_operation_read, invoke_proxy)
 {
     MockJsonRpcProxy proxy;
-    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("read"),StrEq("siiii"))).Times(1);
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_sized(_,_,_,_,StrEq("read"),StrEq("sIiIi"))).Times(1);
 
     MockOperationContext context;
-    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_)).Times(1)
         .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
 
     wf_impl_operation_context op_context;
     op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.read_chunk_size = 1024;
     FuseMock fuse;
     EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
 
@@ -34,39 +46,318 @@ TEST(wf_impl_operation_read, invoke_proxy)
     fuse_ino_t inode = 1;
     size_t size = 42;
     off_t offset = 0;
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 0);
     fuse_file_info file_info;
-    file_info.fh = 1;
+    file_info.fh = reinterpret_cast<uint64_t>(readahead);
     wf_impl_operation_read(request, inode, size, offset, &file_info);
+
+    wf_impl_readahead_dispose(readahead);
 }
 
-TEST(wf_impl_operation_read, invoke_proxy_limit_size)
+TEST(wf_impl_operation_read, invoke_proxy_split_large_read)
 {
+    std::vector<void*> chunks;
     MockJsonRpcProxy proxy;
-    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("read"),StrEq("siiii"))).Times(0);
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_sized(_,&wf_impl_operation_read_chunk_finished,_,_,StrEq("read"),StrEq("sIiIi"))).Times(3)
+        .WillRepeatedly(Invoke(
+            [&chunks](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn *, void * user_data, size_t, char const *, char const *) {
+                chunks.push_back(user_data);
+            }));
 
     MockOperationContext context;
-    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_)).Times(1)
         .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
 
     wf_impl_operation_context op_context;
     op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.read_chunk_size = 4;
     FuseMock fuse;
     EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
-    EXPECT_CALL(fuse, fuse_reply_err(_,_)).Times(1);
 
-    fuse_req_t request = nullptr;
-    fuse_ino_t inode = 1;
-    size_t size = 100 * 1024 * 1024;
-    off_t offset = 0;
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 0);
     fuse_file_info file_info;
-    file_info.fh = 1;
-    wf_impl_operation_read(request, inode, size, offset, &file_info);
+    file_info.fh = reinterpret_cast<uint64_t>(readahead);
+    wf_impl_operation_read(nullptr, 1, 10, 0, &file_info);
+    ASSERT_EQ(3, chunks.size());
+
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,10)).Times(1).WillOnce(Invoke(
+        [](fuse_req_t, char const * buffer, size_t size) -> int {
+            EXPECT_EQ(0, strncmp("0123456789", buffer, size));
+            return 0;
+        }));
+
+    JsonDoc last("{\"data\": \"89\", \"format\": \"identity\", \"count\": 2}");
+    wf_impl_operation_read_chunk_finished(chunks[2], last.root(), nullptr);
+    JsonDoc first("{\"data\": \"0123\", \"format\": \"identity\", \"count\": 4}");
+    wf_impl_operation_read_chunk_finished(chunks[0], first.root(), nullptr);
+    JsonDoc second("{\"data\": \"4567\", \"format\": \"identity\", \"count\": 4}");
+    wf_impl_operation_read_chunk_finished(chunks[1], second.root(), nullptr);
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_operation_read, split_large_read_end_of_file)
+{
+    std::vector<void*> chunks;
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_sized(_,&wf_impl_operation_read_chunk_finished,_,_,StrEq("read"),StrEq("sIiIi"))).Times(3)
+        .WillRepeatedly(Invoke(
+            [&chunks](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn *, void * user_data, size_t, char const *, char const *) {
+                chunks.push_back(user_data);
+            }));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.read_chunk_size = 4;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 0);
+    fuse_file_info file_info;
+    file_info.fh = reinterpret_cast<uint64_t>(readahead);
+    wf_impl_operation_read(nullptr, 1, 12, 0, &file_info);
+    ASSERT_EQ(3, chunks.size());
+
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,6)).Times(1).WillOnce(Return(0));
+
+    JsonDoc first("{\"data\": \"0123\", \"format\": \"identity\", \"count\": 4}");
+    wf_impl_operation_read_chunk_finished(chunks[0], first.root(), nullptr);
+    JsonDoc second("{\"data\": \"45\", \"format\": \"identity\", \"count\": 2}");
+    wf_impl_operation_read_chunk_finished(chunks[1], second.root(), nullptr);
+    JsonDoc third("{\"data\": \"\", \"format\": \"identity\", \"count\": 0}");
+    wf_impl_operation_read_chunk_finished(chunks[2], third.root(), nullptr);
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_operation_read, split_large_read_base64)
+{
+    std::vector<void*> chunks;
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_sized(_,&wf_impl_operation_read_chunk_finished,_,_,StrEq("read"),StrEq("sIiIi"))).Times(2)
+        .WillRepeatedly(Invoke(
+            [&chunks](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn *, void * user_data, size_t, char const *, char const *) {
+                chunks.push_back(user_data);
+            }));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.read_chunk_size = 4;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 0);
+    fuse_file_info file_info;
+    file_info.fh = reinterpret_cast<uint64_t>(readahead);
+    wf_impl_operation_read(nullptr, 1, 8, 0, &file_info);
+    ASSERT_EQ(2, chunks.size());
+
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,8)).Times(1).WillOnce(Invoke(
+        [](fuse_req_t, char const * buffer, size_t size) -> int {
+            EXPECT_EQ(0, strncmp("01234567", buffer, size));
+            return 0;
+        }));
+
+    JsonDoc first("{\"data\": \"MDEyMw==\", \"format\": \"base64\", \"count\": 4}");
+    wf_impl_operation_read_chunk_finished(chunks[0], first.root(), nullptr);
+    JsonDoc second("{\"data\": \"NDU2Nw==\", \"format\": \"base64\", \"count\": 4}");
+    wf_impl_operation_read_chunk_finished(chunks[1], second.root(), nullptr);
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_operation_read, split_large_read_fail_chunk_too_large)
+{
+    std::vector<void*> chunks;
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_sized(_,&wf_impl_operation_read_chunk_finished,_,_,StrEq("read"),StrEq("sIiIi"))).Times(2)
+        .WillRepeatedly(Invoke(
+            [&chunks](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn *, void * user_data, size_t, char const *, char const *) {
+                chunks.push_back(user_data);
+            }));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.read_chunk_size = 4;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 0);
+    fuse_file_info file_info;
+    file_info.fh = reinterpret_cast<uint64_t>(readahead);
+    wf_impl_operation_read(nullptr, 1, 8, 0, &file_info);
+    ASSERT_EQ(2, chunks.size());
+
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(0);
+    EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
+
+    JsonDoc first("{\"data\": \"012345\", \"format\": \"identity\", \"count\": 6}");
+    wf_impl_operation_read_chunk_finished(chunks[0], first.root(), nullptr);
+    JsonDoc second("{\"data\": \"4567\", \"format\": \"identity\", \"count\": 4}");
+    wf_impl_operation_read_chunk_finished(chunks[1], second.root(), nullptr);
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_operation_read, split_large_read_fail_chunk)
+{
+    std::vector<void*> chunks;
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_sized(_,&wf_impl_operation_read_chunk_finished,_,_,StrEq("read"),StrEq("sIiIi"))).Times(2)
+        .WillRepeatedly(Invoke(
+            [&chunks](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn *, void * user_data, size_t, char const *, char const *) {
+                chunks.push_back(user_data);
+            }));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.read_chunk_size = 4;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 0);
+    fuse_file_info file_info;
+    file_info.fh = reinterpret_cast<uint64_t>(readahead);
+    wf_impl_operation_read(nullptr, 1, 8, 0, &file_info);
+    ASSERT_EQ(2, chunks.size());
+
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(0);
+    EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
+
+    struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD, "");
+    wf_impl_operation_read_chunk_finished(chunks[0], nullptr, error);
+    wf_impl_jsonrpc_error_dispose(error);
+    JsonDoc second("{\"data\": \"4567\", \"format\": \"identity\", \"count\": 4}");
+    wf_impl_operation_read_chunk_finished(chunks[1], second.root(), nullptr);
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_operation_read, cancel_on_interrupt)
+{
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_sized(_,&wf_impl_operation_read_finished,_,_,StrEq("read"),StrEq("sIiIi"))).Times(1);
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.read_chunk_size = 1024;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+
+    fuse_interrupt_func_t interrupt = nullptr;
+    void * interrupt_data = nullptr;
+    EXPECT_CALL(fuse, fuse_req_interrupt_func(_,_,_)).Times(1).WillOnce(Invoke(
+        [&interrupt, &interrupt_data](fuse_req_t, fuse_interrupt_func_t func, void * data) {
+            interrupt = func;
+            interrupt_data = data;
+        }));
+
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 0);
+    fuse_file_info file_info;
+    file_info.fh = reinterpret_cast<uint64_t>(readahead);
+    wf_impl_operation_read(nullptr, 1, 42, 0, &file_info);
+    ASSERT_NE(nullptr, interrupt);
+
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_cancel(_, &wf_impl_operation_read_finished, nullptr)).Times(1)
+        .WillOnce(Invoke([](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn * finished, void * user_data) {
+            struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD_INTERRUPTED, "");
+            finished(user_data, nullptr, error);
+            wf_impl_jsonrpc_error_dispose(error);
+        }));
+    EXPECT_CALL(fuse, fuse_reply_err(_, EINTR)).Times(1).WillOnce(Return(0));
+    interrupt(nullptr, interrupt_data);
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_operation_read, split_large_read_cancel_chunks_on_interrupt)
+{
+    std::vector<void*> chunks;
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_sized(_,&wf_impl_operation_read_chunk_finished,_,_,StrEq("read"),StrEq("sIiIi"))).Times(3)
+        .WillRepeatedly(Invoke(
+            [&chunks](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn *, void * user_data, size_t, char const *, char const *) {
+                chunks.push_back(user_data);
+            }));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.read_chunk_size = 4;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+
+    fuse_interrupt_func_t interrupt = nullptr;
+    void * interrupt_data = nullptr;
+    EXPECT_CALL(fuse, fuse_req_interrupt_func(_,_,_)).Times(1).WillOnce(Invoke(
+        [&interrupt, &interrupt_data](fuse_req_t, fuse_interrupt_func_t func, void * data) {
+            interrupt = func;
+            interrupt_data = data;
+        }));
+
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 0);
+    fuse_file_info file_info;
+    file_info.fh = reinterpret_cast<uint64_t>(readahead);
+    wf_impl_operation_read(nullptr, 1, 10, 0, &file_info);
+    ASSERT_EQ(3, chunks.size());
+
+    // first chunk is already finished, so only the others are pending
+    JsonDoc first("{\"data\": \"0123\", \"format\": \"identity\", \"count\": 4}");
+    wf_impl_operation_read_chunk_finished(chunks[0], first.root(), nullptr);
+
+    std::vector<void*> cancelled;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_cancel(_, &wf_impl_operation_read_chunk_finished, _)).Times(3)
+        .WillRepeatedly(Invoke([&chunks, &cancelled](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn * finished, void * user_data) {
+            if (user_data != chunks[0])
+            {
+                cancelled.push_back(user_data);
+                struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD_INTERRUPTED, "");
+                finished(user_data, nullptr, error);
+                wf_impl_jsonrpc_error_dispose(error);
+            }
+        }));
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(0);
+    EXPECT_CALL(fuse, fuse_reply_err(_, EINTR)).Times(1).WillOnce(Return(0));
+    interrupt(nullptr, interrupt_data);
+    ASSERT_EQ(2, cancelled.size());
+
+    wf_impl_readahead_dispose(readahead);
 }
 
 TEST(wf_impl_operation_read, fail_rpc_null)
 {
     MockOperationContext context;
-    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_)).Times(1)
         .WillOnce(Return(nullptr));
 
     FuseMock fuse;
@@ -98,6 +389,23 @@ TEST(wf_impl_operation_read, fill_buffer_identity_fail_inconsistent_size)
     ASSERT_NE(WF_GOOD, status);
 }
 
+TEST(wf_impl_operation_read, fill_buffer_binary)
+{
+    wf_status status;
+    char text[] = "\xff\x00\x01\x02";
+    char * buffer = wf_impl_operation_read_transform(text, 4, "binary", 4, &status);
+    ASSERT_EQ(WF_GOOD, status);
+    ASSERT_EQ(0, memcmp("\xff\x00\x01\x02", buffer, 4));
+}
+
+TEST(wf_impl_operation_read, fill_buffer_binary_fail_inconsistent_size)
+{
+    wf_status status;
+    char text[] = "\xff\x00\x01\x02";
+    wf_impl_operation_read_transform(text, 4, "binary", 3, &status);
+    ASSERT_NE(WF_GOOD, status);
+}
+
 TEST(wf_impl_operation_read, fill_buffer_base64)
 {
     wf_status status;
@@ -141,6 +449,26 @@ TEST(wf_impl_operation_read, finished)
     wf_impl_operation_read_finished(nullptr, result.root(), nullptr);
 }
 
+TEST(wf_impl_operation_read, finished_large_payload_uses_splice)
+{
+    std::string data(16 * 1024, 'x');
+    std::string json = "{\"data\": \"" + data + "\", \"format\": \"identity\", \"count\": " + std::to_string(data.size()) + "}";
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(0);
+    EXPECT_CALL(fuse, fuse_reply_data(_,_,FUSE_BUF_SPLICE_MOVE)).Times(1).WillOnce(Invoke(
+        [&data](fuse_req_t, struct fuse_bufvec * buffer, enum fuse_buf_copy_flags) -> int {
+            EXPECT_EQ(1, buffer->count);
+            EXPECT_EQ(data.size(), buffer->buf[0].size);
+            EXPECT_EQ(0, buffer->buf[0].flags & FUSE_BUF_IS_FD);
+            EXPECT_EQ(0, memcmp(data.c_str(), buffer->buf[0].mem, data.size()));
+            return 0;
+        }));
+
+    JsonDoc result(json);
+    wf_impl_operation_read_finished(nullptr, result.root(), nullptr);
+}
+
 TEST(wf_impl_operation_read, finished_fail_no_data)
 {
     FuseMock fuse;
@@ -211,3 +539,236 @@ TEST(wf_impl_operation_read, finished_fail_error)
     wf_impl_operation_read_finished(nullptr, nullptr, error);
     wf_impl_jsonrpc_error_dispose(error);
 }
+
+TEST(wf_impl_operation_read, finished_fail_interrupted)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(0);
+    EXPECT_CALL(fuse, fuse_reply_err(_, EINTR)).Times(1).WillOnce(Return(0));
+
+    struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD_INTERRUPTED, "");
+    wf_impl_operation_read_finished(nullptr, nullptr, error);
+    wf_impl_jsonrpc_error_dispose(error);
+}
+
+TEST(wf_impl_operation_read, read_ahead_on_sequential_access)
+{
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_sized(_,&wf_impl_operation_read_finished,_,_,StrEq("read"),StrEq("sIiIi"))).Times(2);
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_sized(_,&wf_impl_operation_read_ahead_finished,_,_,StrEq("read"),StrEq("sIiIi"))).Times(1);
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_)).Times(3)
+        .WillRepeatedly(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.read_chunk_size = 1024;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(3).WillRepeatedly(Return(&op_context));
+
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 64);
+    fuse_file_info file_info;
+    file_info.fh = reinterpret_cast<uint64_t>(readahead);
+    wf_impl_operation_read(nullptr, 1, 8, 0, &file_info);
+    wf_impl_operation_read(nullptr, 1, 8, 8, &file_info);
+
+    ASSERT_TRUE(readahead->is_pending);
+    ASSERT_EQ(16, readahead->pending_offset);
+
+    // request is covered by pending read ahead
+    wf_impl_operation_read(nullptr, 1, 8, 16, &file_info);
+
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,8)).Times(1).WillOnce(Return(0));
+    JsonDoc result("{\"data\": \"0123456789\", \"format\": \"identity\", \"count\": 10}");
+    wf_impl_operation_read_ahead_finished(readahead, result.root(), nullptr);
+
+    ASSERT_FALSE(readahead->is_pending);
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_operation_read, reply_from_read_ahead_buffer)
+{
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_sized(_,_,_,_,_,_)).Times(0);
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.read_chunk_size = 1024;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,4)).Times(1).WillOnce(Return(0));
+
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 64);
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 0, 4);
+    wf_impl_readahead_access(readahead, 4, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+    wf_impl_readahead_fill(readahead, "0123456789", 10);
+
+    fuse_file_info file_info;
+    file_info.fh = reinterpret_cast<uint64_t>(readahead);
+    wf_impl_operation_read(nullptr, 1, 4, 8, &file_info);
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_operation_read, read_ahead_finished_fail_read_waiting)
+{
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_sized(_,&wf_impl_operation_read_finished,nullptr,_,StrEq("read"),StrEq("sIiIi"))).Times(1);
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.read_chunk_size = 1024;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_err(_, _)).Times(0);
+
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 64);
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 0, 4);
+    wf_impl_readahead_access(readahead, 4, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+    ASSERT_TRUE(wf_impl_readahead_wait(readahead, nullptr, 8, 4));
+
+    struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD, "");
+    wf_impl_operation_read_ahead_finished(readahead, nullptr, error);
+    wf_impl_jsonrpc_error_dispose(error);
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_operation_read, read_ahead_finished_short_read_waiting)
+{
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_sized(_,&wf_impl_operation_read_finished,nullptr,_,StrEq("read"),StrEq("sIiIi"))).Times(1);
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.read_chunk_size = 1024;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_err(_, _)).Times(0);
+
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 64);
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 0, 4);
+    wf_impl_readahead_access(readahead, 4, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+    ASSERT_TRUE(wf_impl_readahead_wait(readahead, nullptr, 40, 4));
+
+    // short read does not cover the waiting request
+    JsonDoc result("{\"data\": \"0123456789\", \"format\": \"identity\", \"count\": 10}");
+    wf_impl_operation_read_ahead_finished(readahead, result.root(), nullptr);
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_operation_read, read_ahead_finished_fail_waiting_without_proxy)
+{
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_)).Times(1)
+        .WillOnce(Return(nullptr));
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(nullptr));
+    EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
+
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 64);
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 0, 4);
+    wf_impl_readahead_access(readahead, 4, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+    ASSERT_TRUE(wf_impl_readahead_wait(readahead, nullptr, 8, 4));
+
+    struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD, "");
+    wf_impl_operation_read_ahead_finished(readahead, nullptr, error);
+    wf_impl_jsonrpc_error_dispose(error);
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_operation_read, read_ahead_finished_dispose_released)
+{
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 64);
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 0, 4);
+    wf_impl_readahead_access(readahead, 4, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+    ASSERT_FALSE(wf_impl_readahead_release(readahead));
+
+    JsonDoc result("{\"data\": \"0123456789\", \"format\": \"identity\", \"count\": 10}");
+    wf_impl_operation_read_ahead_finished(readahead, result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_read, dispose_session_while_read_ahead_has_waiters)
+{
+    LwsMock lws;
+    EXPECT_CALL(lws, lws_callback_on_writable(_)).WillRepeatedly(Return(0));
+
+    wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+    struct lws * wsi = reinterpret_cast<struct lws *>(&lws);
+    wf_impl_session * session = wf_impl_session_create(wsi, nullptr, timer_manager, nullptr, nullptr);
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_data_proxy(_))
+        .WillRepeatedly(Return(session->rpc));
+
+    wf_impl_operation_context op_context;
+    op_context.name = const_cast<char*>("test");
+    op_context.inodes = nullptr;
+    op_context.read_chunk_size = 2;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).WillRepeatedly(Return(&op_context));
+    // waiters are not read again, since the session is gone
+    EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(2);
+
+    wf_impl_readahead * readahead = wf_impl_readahead_create(1, 1, 64);
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 0, 4);
+    wf_impl_readahead_access(readahead, 4, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+
+    // advance request ids, so that further requests wrap around to slots
+    // which were already visited during dispose
+    wf_jsonrpc_proxy_finished_fn * finished = [](void *, wf_json const *, wf_jsonrpc_error const *) {};
+    for(int i = 0; i < 61; i++)
+    {
+        wf_impl_jsonrpc_proxy_invoke(session->rpc, finished, nullptr, "getattr", "si", "test", i);
+        wf_impl_jsonrpc_proxy_cancel(session->rpc, finished, nullptr);
+    }
+
+    wf_impl_jsonrpc_proxy_invoke(session->rpc, &wf_impl_operation_read_ahead_finished, readahead,
+        "read", "sIiIi", "test", (int64_t) 1, 1, (int64_t) offset, (int) size);
+
+    // single and chunked fallback
+    ASSERT_TRUE(wf_impl_readahead_wait(readahead, reinterpret_cast<fuse_req_t>(1), 8, 2));
+    ASSERT_TRUE(wf_impl_readahead_wait(readahead, reinterpret_cast<fuse_req_t>(2), 40, 4));
+
+    wf_impl_session_dispose(session);
+    wf_impl_readahead_dispose(readahead);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
@@ -0,0 +1,322 @@
+#include "webfuse/impl/operation/readahead.h"
+
+#include <gtest/gtest.h>
+#include <cstring>
+
+namespace
+{
+
+void fill(wf_impl_readahead * readahead, char const * data)
+{
+    wf_impl_readahead_fill(readahead, data, strlen(data));
+}
+
+}
+
+TEST(wf_impl_readahead, create_dispose)
+{
+    wf_impl_readahead * readahead = wf_impl_readahead_create(42, 1, 1024);
+    ASSERT_EQ(42, readahead->handle);
+    ASSERT_EQ(1024, readahead->window);
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_readahead, limit_window)
+{
+    wf_impl_readahead * readahead = wf_impl_readahead_create(42, 1, 100 * 1024 * 1024);
+    ASSERT_EQ(1024 * 1024, readahead->window);
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_readahead, disabled)
+{
+    wf_impl_readahead * readahead = wf_impl_readahead_create(42, 1, 0);
+
+    off_t offset;
+    size_t size;
+    for(int i = 0; i < 10; i++)
+    {
+        wf_impl_readahead_access(readahead, i * 4, 4);
+        ASSERT_FALSE(wf_impl_readahead_next(readahead, &offset, &size));
+    }
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_readahead, detect_sequential_access)
+{
+    wf_impl_readahead * readahead = wf_impl_readahead_create(42, 1, 16);
+
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 0, 4);
+    ASSERT_FALSE(wf_impl_readahead_next(readahead, &offset, &size));
+
+    wf_impl_readahead_access(readahead, 4, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+    ASSERT_EQ(8, offset);
+    ASSERT_EQ(16, size);
+    ASSERT_TRUE(readahead->is_pending);
+
+    // only one speculative read at a time
+    wf_impl_readahead_access(readahead, 8, 4);
+    ASSERT_FALSE(wf_impl_readahead_next(readahead, &offset, &size));
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_readahead, no_read_ahead_on_random_access)
+{
+    wf_impl_readahead * readahead = wf_impl_readahead_create(42, 1, 16);
+
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 100, 4);
+    ASSERT_FALSE(wf_impl_readahead_next(readahead, &offset, &size));
+    wf_impl_readahead_access(readahead, 20, 4);
+    ASSERT_FALSE(wf_impl_readahead_next(readahead, &offset, &size));
+    wf_impl_readahead_access(readahead, 50, 4);
+    ASSERT_FALSE(wf_impl_readahead_next(readahead, &offset, &size));
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_readahead, get_buffered_data)
+{
+    wf_impl_readahead * readahead = wf_impl_readahead_create(42, 1, 16);
+
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 0, 4);
+    wf_impl_readahead_access(readahead, 4, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+    fill(readahead, "0123456789abcdef");
+    ASSERT_FALSE(readahead->is_eof);
+
+    char const * data;
+    size_t length;
+    ASSERT_TRUE(wf_impl_readahead_get(readahead, 8, 4, &data, &length));
+    ASSERT_EQ(4, length);
+    ASSERT_EQ(0, strncmp("0123", data, 4));
+
+    ASSERT_TRUE(wf_impl_readahead_get(readahead, 20, 4, &data, &length));
+    ASSERT_EQ(0, strncmp("cdef", data, 4));
+
+    ASSERT_FALSE(wf_impl_readahead_get(readahead, 4, 4, &data, &length));
+    ASSERT_FALSE(wf_impl_readahead_get(readahead, 22, 4, &data, &length));
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_readahead, get_buffered_data_at_eof)
+{
+    wf_impl_readahead * readahead = wf_impl_readahead_create(42, 1, 16);
+
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 0, 4);
+    wf_impl_readahead_access(readahead, 4, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+    fill(readahead, "012345");
+    ASSERT_TRUE(readahead->is_eof);
+
+    char const * data;
+    size_t length;
+    ASSERT_TRUE(wf_impl_readahead_get(readahead, 12, 4, &data, &length));
+    ASSERT_EQ(2, length);
+    ASSERT_EQ(0, strncmp("45", data, 2));
+
+    ASSERT_TRUE(wf_impl_readahead_get(readahead, 14, 4, &data, &length));
+    ASSERT_EQ(0, length);
+
+    // no read ahead beyond end of file
+    wf_impl_readahead_access(readahead, 8, 4);
+    ASSERT_FALSE(wf_impl_readahead_next(readahead, &offset, &size));
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_readahead, pipeline)
+{
+    wf_impl_readahead * readahead = wf_impl_readahead_create(42, 1, 8);
+
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 0, 2);
+    wf_impl_readahead_access(readahead, 2, 2);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+    ASSERT_EQ(4, offset);
+    fill(readahead, "01234567");
+
+    // more than half of the window is buffered
+    wf_impl_readahead_access(readahead, 4, 2);
+    ASSERT_FALSE(wf_impl_readahead_next(readahead, &offset, &size));
+
+    wf_impl_readahead_access(readahead, 6, 2);
+    ASSERT_FALSE(wf_impl_readahead_next(readahead, &offset, &size));
+
+    wf_impl_readahead_access(readahead, 8, 2);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+    ASSERT_EQ(12, offset);
+    ASSERT_EQ(8, size);
+
+    fill(readahead, "89abcdef");
+
+    char const * data;
+    size_t length;
+    ASSERT_TRUE(wf_impl_readahead_get(readahead, 10, 8, &data, &length));
+    ASSERT_EQ(0, strncmp("6789abcd", data, 8));
+    ASSERT_EQ(10, readahead->data_offset);
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_readahead, drop_buffer_on_random_access)
+{
+    wf_impl_readahead * readahead = wf_impl_readahead_create(42, 1, 16);
+
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 0, 4);
+    wf_impl_readahead_access(readahead, 4, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+    fill(readahead, "0123456789abcdef");
+
+    wf_impl_readahead_access(readahead, 100, 4);
+
+    char const * data;
+    size_t length;
+    ASSERT_FALSE(wf_impl_readahead_get(readahead, 8, 4, &data, &length));
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_readahead, wait_for_pending_read)
+{
+    wf_impl_readahead * readahead = wf_impl_readahead_create(42, 1, 16);
+
+    off_t offset;
+    size_t size;
+    ASSERT_FALSE(wf_impl_readahead_wait(readahead, nullptr, 8, 4));
+
+    wf_impl_readahead_access(readahead, 0, 4);
+    wf_impl_readahead_access(readahead, 4, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+
+    fuse_req_t request = reinterpret_cast<fuse_req_t>(42);
+    ASSERT_TRUE(wf_impl_readahead_wait(readahead, request, 8, 4));
+    ASSERT_FALSE(wf_impl_readahead_wait(readahead, request, 4, 4));
+    ASSERT_FALSE(wf_impl_readahead_wait(readahead, request, 20, 8));
+
+    fuse_req_t waiting;
+    ASSERT_TRUE(wf_impl_readahead_pop_waiting(readahead, &waiting, &offset, &size));
+    ASSERT_EQ(request, waiting);
+    ASSERT_EQ(8, offset);
+    ASSERT_EQ(4, size);
+    ASSERT_FALSE(wf_impl_readahead_pop_waiting(readahead, &waiting, &offset, &size));
+
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_readahead, release)
+{
+    wf_impl_readahead * readahead = wf_impl_readahead_create(42, 1, 16);
+    ASSERT_TRUE(wf_impl_readahead_release(readahead));
+}
+
+TEST(wf_impl_readahead, defer_release_while_pending)
+{
+    wf_impl_readahead * readahead = wf_impl_readahead_create(42, 1, 16);
+
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 0, 4);
+    wf_impl_readahead_access(readahead, 4, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+
+    ASSERT_FALSE(wf_impl_readahead_release(readahead));
+    ASSERT_TRUE(readahead->is_released);
+
+    wf_impl_readahead_fail(readahead);
+    wf_impl_readahead_dispose(readahead);
+}
+
+TEST(wf_impl_readahead, unlink_on_release)
+{
+    wf_impl_readahead * list = nullptr;
+    wf_impl_readahead * first = wf_impl_readahead_create(1, 1, 16);
+    wf_impl_readahead * second = wf_impl_readahead_create(2, 1, 16);
+    wf_impl_readahead_link(first, &list);
+    wf_impl_readahead_link(second, &list);
+    ASSERT_EQ(second, list);
+    ASSERT_EQ(first, list->next);
+
+    ASSERT_TRUE(wf_impl_readahead_release(second));
+    ASSERT_EQ(first, list);
+    ASSERT_EQ(nullptr, list->next);
+
+    wf_impl_readahead_dispose(first);
+    ASSERT_EQ(nullptr, list);
+}
+
+TEST(wf_impl_readahead, invalidate_drops_buffered_data)
+{
+    wf_impl_readahead * list = nullptr;
+    wf_impl_readahead * readahead = wf_impl_readahead_create(42, 1, 16);
+    wf_impl_readahead * other = wf_impl_readahead_create(42, 2, 16);
+    wf_impl_readahead_link(readahead, &list);
+    wf_impl_readahead_link(other, &list);
+
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 0, 4);
+    wf_impl_readahead_access(readahead, 4, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+    fill(readahead, "0123456789");
+
+    char const * data;
+    size_t length;
+    ASSERT_TRUE(wf_impl_readahead_get(readahead, 8, 4, &data, &length));
+
+    wf_impl_readahead_invalidate(list, 2);
+    ASSERT_TRUE(wf_impl_readahead_get(readahead, 8, 4, &data, &length));
+
+    wf_impl_readahead_invalidate(list, 1);
+    ASSERT_FALSE(wf_impl_readahead_get(readahead, 8, 4, &data, &length));
+
+    wf_impl_readahead_dispose(readahead);
+    wf_impl_readahead_dispose(other);
+}
+
+TEST(wf_impl_readahead, invalidate_discards_pending_read)
+{
+    wf_impl_readahead * list = nullptr;
+    wf_impl_readahead * readahead = wf_impl_readahead_create(42, 1, 16);
+    wf_impl_readahead_link(readahead, &list);
+
+    off_t offset;
+    size_t size;
+    wf_impl_readahead_access(readahead, 0, 4);
+    wf_impl_readahead_access(readahead, 4, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+
+    wf_impl_readahead_invalidate(list, 1);
+    ASSERT_FALSE(wf_impl_readahead_wait(readahead, nullptr, 8, 4));
+
+    fill(readahead, "0123456789");
+    ASSERT_FALSE(readahead->is_pending);
+
+    char const * data;
+    size_t length;
+    ASSERT_FALSE(wf_impl_readahead_get(readahead, 8, 4, &data, &length));
+
+    // subsequent reads ahead are buffered again
+    wf_impl_readahead_access(readahead, 8, 4);
+    ASSERT_TRUE(wf_impl_readahead_next(readahead, &offset, &size));
+    fill(readahead, "0123456789");
+    ASSERT_TRUE(wf_impl_readahead_get(readahead, 12, 4, &data, &length));
+
+    wf_impl_readahead_dispose(readahead);
+}
@@ -1,4 +1,7 @@
 #include "webfuse/impl/operation/readdir.h"
+#include "webfuse/impl/operation/dirbuffer.h"
+#include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/attr_cache.h"
 #include "webfuse/impl/jsonrpc/error.h"
 
 #include "webfuse/status.h"
@@ -10,6 +13,7 @@
 
 #include <gtest/gtest.h>
 #include <sstream>
+#include <cstring>
 
 using webfuse_test::JsonDoc;
 using webfuse_test::MockJsonRpcProxy;
@@ -19,6 +23,7 @@ using testing::_;
 using testing::Return;
 using testing::Invoke;
 using testing::StrEq;
+using testing::Gt;
 
 namespace
 {
@@ -38,7 +43,7 @@ void free_context(
 TEST(wf_impl_operation_readdir, invoke_proxy)
 {
     MockJsonRpcProxy proxy;
-    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("readdir"),StrEq("si")))
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("readdir"),StrEq("sI")))
         .Times(1).WillOnce(Invoke(free_context));
 
     MockOperationContext context;
@@ -46,7 +51,10 @@ TEST(wf_impl_operation_readdir, invoke_proxy)
         .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
 
     wf_impl_operation_context op_context;
+    op_context.singleflight = nullptr;
+    op_context.inodes = nullptr;
     op_context.name = nullptr;
+    op_context.cache = nullptr;
     FuseMock fuse;
     EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
 
@@ -57,9 +65,71 @@ TEST(wf_impl_operation_readdir, invoke_proxy)
     size_t offset = 0;
     fuse_file_info file_info;
     file_info.flags = 0;
+    file_info.fh = 0;
     wf_impl_operation_readdir(request, inode, size, offset, &file_info);
 }
 
+TEST(wf_impl_operation_readdir, invoke_proxy_at_offset_0_with_cache)
+{
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("readdir"),StrEq("sI")))
+        .Times(1).WillOnce(Invoke(free_context));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.singleflight = nullptr;
+    op_context.inodes = nullptr;
+    op_context.name = nullptr;
+    op_context.cache = nullptr;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+
+    wf_impl_dirbuffer * buffer = wf_impl_dirbuffer_create();
+    wf_impl_dirbuffer_add(buffer, "a.file", 42);
+
+    fuse_req_t request = nullptr;
+    fuse_ino_t inode = 1;
+    size_t size = 10;
+    size_t offset = 0;
+    fuse_file_info file_info;
+    file_info.flags = 0;
+    file_info.fh = reinterpret_cast<uint64_t>(buffer);
+    wf_impl_operation_readdir(request, inode, size, offset, &file_info);
+
+    wf_impl_dirbuffer_dispose(buffer);
+}
+
+TEST(wf_impl_operation_readdir, reply_from_cache)
+{
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,_,_)).Times(0);
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(0);
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(nullptr));
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(1).WillOnce(Return(0));
+
+    wf_impl_dirbuffer * buffer = wf_impl_dirbuffer_create();
+    wf_impl_dirbuffer_add(buffer, "a.file", 42);
+    wf_impl_dirbuffer_add(buffer, "b.file", 43);
+
+    fuse_req_t request = nullptr;
+    fuse_ino_t inode = 1;
+    size_t size = 10;
+    size_t offset = 1;
+    fuse_file_info file_info;
+    file_info.flags = 0;
+    file_info.fh = reinterpret_cast<uint64_t>(buffer);
+    wf_impl_operation_readdir(request, inode, size, offset, &file_info);
+
+    wf_impl_dirbuffer_dispose(buffer);
+}
+
 TEST(wf_impl_operation_readdir, fail_rpc_null)
 {
     MockOperationContext context;
@@ -76,6 +146,7 @@ TEST(wf_impl_operation_readdir, fail_rpc_null)
     size_t offset = 0;
     fuse_file_info file_info;
     file_info.flags = 0;
+    file_info.fh = 0;
     wf_impl_operation_readdir(request, inode, size, offset, &file_info);
 }
 
@@ -87,9 +158,37 @@ TEST(wf_impl_operation_readdir, finished)
     JsonDoc result("[{\"name\": \"a.file\", \"inode\": 42}]");
     auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
     context->request = nullptr;
+    context->id = 1;
+    context->inodes = nullptr;
+    context->cache = nullptr;
+    context->size = 1;
+    context->offset = 0;
+    context->buffer = nullptr;
+    context->is_plus = false;
+    wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_readdir, finished_fill_cache)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(1).WillOnce(Return(0));
+
+    wf_impl_dirbuffer * buffer = wf_impl_dirbuffer_create();
+
+    JsonDoc result("[{\"name\": \"a.file\", \"inode\": 42}]");
+    auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
+    context->request = nullptr;
+    context->id = 1;
+    context->inodes = nullptr;
+    context->cache = nullptr;
     context->size = 1;
     context->offset = 0;
+    context->buffer = buffer;
+    context->is_plus = false;
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+
+    ASSERT_LT(0, buffer->count);
+    wf_impl_dirbuffer_dispose(buffer);
 }
 
 TEST(wf_impl_operation_readdir, finished_many_items)
@@ -108,8 +207,13 @@ TEST(wf_impl_operation_readdir, finished_many_items)
     JsonDoc result(stream.str());
     auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
     context->request = nullptr;
+    context->id = 1;
+    context->inodes = nullptr;
+    context->cache = nullptr;
     context->size = 100;
     context->offset = 0;
+    context->buffer = nullptr;
+    context->is_plus = false;
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -121,8 +225,13 @@ TEST(wf_impl_operation_readdir, finished_read_after_end)
     JsonDoc result("[{\"name\": \"a.file\", \"inode\": 42}]");
     auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
     context->request = nullptr;
+    context->id = 1;
+    context->inodes = nullptr;
+    context->cache = nullptr;
     context->size = 10;
     context->offset = 2;
+    context->buffer = nullptr;
+    context->is_plus = false;
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -136,8 +245,13 @@ TEST(wf_impl_operation_readdir, finished_fail_error)
 
     auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
     context->request = nullptr;
+    context->id = 1;
+    context->inodes = nullptr;
+    context->cache = nullptr;
     context->size = 1;
     context->offset = 0;
+    context->buffer = nullptr;
+    context->is_plus = false;
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), nullptr, error);
     wf_impl_jsonrpc_error_dispose(error);
 }
@@ -151,8 +265,13 @@ TEST(wf_impl_operation_readdir, finished_fail_invalid_result_type)
     JsonDoc result("{}");
     auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
     context->request = nullptr;
+    context->id = 1;
+    context->inodes = nullptr;
+    context->cache = nullptr;
     context->size = 1;
     context->offset = 0;
+    context->buffer = nullptr;
+    context->is_plus = false;
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -165,8 +284,13 @@ TEST(wf_impl_operation_readdir, finished_fail_missing_name)
     JsonDoc result("[{\"inode\": 42}]");
     auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
     context->request = nullptr;
+    context->id = 1;
+    context->inodes = nullptr;
+    context->cache = nullptr;
     context->size = 1;
     context->offset = 0;
+    context->buffer = nullptr;
+    context->is_plus = false;
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -179,8 +303,13 @@ TEST(wf_impl_operation_readdir, finished_fail_invalid_name_type)
     JsonDoc result("[{\"name\": 42, \"inode\": 42}]");
     auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
     context->request = nullptr;
+    context->id = 1;
+    context->inodes = nullptr;
+    context->cache = nullptr;
     context->size = 1;
     context->offset = 0;
+    context->buffer = nullptr;
+    context->is_plus = false;
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -193,8 +322,13 @@ TEST(wf_impl_operation_readdir, finished_fail_missing_inode)
     JsonDoc result("[{\"name\": \"a.file\"}]");
     auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
     context->request = nullptr;
+    context->id = 1;
+    context->inodes = nullptr;
+    context->cache = nullptr;
     context->size = 1;
     context->offset = 0;
+    context->buffer = nullptr;
+    context->is_plus = false;
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -207,8 +341,13 @@ TEST(wf_impl_operation_readdir, finished_fail_invalid_inode_type)
     JsonDoc result("[{\"name\": \"a.file\", \"inode\": \"42\"}]");
     auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
     context->request = nullptr;
+    context->id = 1;
+    context->inodes = nullptr;
+    context->cache = nullptr;
     context->size = 1;
     context->offset = 0;
+    context->buffer = nullptr;
+    context->is_plus = false;
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -221,7 +360,143 @@ TEST(wf_impl_operation_readdir, finished_fail_invalid_item_type)
     JsonDoc result("[\"item\"]");
     auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
     context->request = nullptr;
+    context->id = 1;
+    context->inodes = nullptr;
+    context->cache = nullptr;
     context->size = 1;
     context->offset = 0;
+    context->buffer = nullptr;
+    context->is_plus = false;
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
+
+TEST(wf_impl_operation_readdir, finished_fill_cache_with_attributes)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(1).WillOnce(Return(0));
+
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+
+    JsonDoc result("[{\"name\": \"a.file\", \"inode\": 42, \"mode\": 420, \"type\": \"file\", \"size\": 23}]");
+    auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
+    context->request = nullptr;
+    context->id = 1;
+    context->inodes = nullptr;
+    context->cache = cache;
+    context->generation = 0;
+    context->size = 1024;
+    context->offset = 0;
+    context->buffer = nullptr;
+    context->is_plus = false;
+    context->uid = 0;
+    context->gid = 0;
+    context->timeout = 1.0;
+    wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+
+    struct stat attr;
+    ASSERT_EQ(WF_IMPL_ATTR_CACHE_FOUND, wf_impl_attr_cache_lookup(cache, 1, "a.file", &attr));
+    ASSERT_EQ(42, attr.st_ino);
+    ASSERT_EQ(23, attr.st_size);
+    ASSERT_TRUE(S_ISREG(attr.st_mode));
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(wf_impl_operation_readdirplus, invoke_proxy)
+{
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("readdir"),StrEq("sI")))
+        .Times(1).WillOnce(Invoke(free_context));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.singleflight = nullptr;
+    op_context.inodes = nullptr;
+    op_context.name = nullptr;
+    op_context.cache = nullptr;
+    op_context.timeout = 1.0;
+    fuse_ctx fuse_context;
+    fuse_context.uid = 0;
+    fuse_context.gid = 0;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_req_ctx(_)).Times(1).WillOnce(Return(&fuse_context));
+
+    fuse_req_t request = nullptr;
+    fuse_ino_t inode = 1;
+    size_t size = 10;
+    size_t offset = 0;
+    fuse_file_info file_info;
+    file_info.flags = 0;
+    file_info.fh = 0;
+    wf_impl_operation_readdirplus(request, inode, size, offset, &file_info);
+}
+
+TEST(wf_impl_operation_readdirplus, reply_from_cache)
+{
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,_,_)).Times(0);
+
+    wf_impl_operation_context op_context;
+    op_context.singleflight = nullptr;
+    op_context.inodes = nullptr;
+    op_context.timeout = 1.0;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(1).WillOnce(Return(0));
+
+    struct stat attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.st_ino = 42;
+    attr.st_mode = S_IFREG | 0444;
+    wf_impl_dirbuffer * buffer = wf_impl_dirbuffer_create();
+    wf_impl_dirbuffer_add_plus(buffer, "a.file", &attr);
+    wf_impl_dirbuffer_add(buffer, "b.file", 43);
+
+    fuse_req_t request = nullptr;
+    fuse_ino_t inode = 1;
+    size_t size = 1024;
+    size_t offset = 1;
+    fuse_file_info file_info;
+    file_info.flags = 0;
+    file_info.fh = reinterpret_cast<uint64_t>(buffer);
+    wf_impl_operation_readdirplus(request, inode, size, offset, &file_info);
+
+    wf_impl_dirbuffer_dispose(buffer);
+}
+
+TEST(wf_impl_operation_readdirplus, finished)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,Gt(0))).Times(1).WillOnce(Return(0));
+
+    wf_impl_dirbuffer * buffer = wf_impl_dirbuffer_create();
+
+    JsonDoc result("[{\"name\": \"a.file\", \"inode\": 42, \"mode\": 420, \"type\": \"file\", \"size\": 23}, {\"name\": \"b.file\", \"inode\": 43}]");
+    auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
+    context->request = nullptr;
+    context->id = 1;
+    context->inodes = nullptr;
+    context->cache = nullptr;
+    context->size = 1024;
+    context->offset = 0;
+    context->buffer = buffer;
+    context->is_plus = true;
+    context->uid = 1000;
+    context->gid = 1000;
+    context->timeout = 1.0;
+    wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+
+    ASSERT_EQ(2, buffer->count);
+    ASSERT_TRUE(buffer->entries[0].has_attr);
+    ASSERT_EQ(42, buffer->entries[0].attr.st_ino);
+    ASSERT_EQ(23, buffer->entries[0].attr.st_size);
+    ASSERT_EQ(1000, buffer->entries[0].attr.st_uid);
+    ASSERT_FALSE(buffer->entries[1].has_attr);
+    ASSERT_EQ(43, buffer->entries[1].attr.st_ino);
+
+    wf_impl_dirbuffer_dispose(buffer);
+}
@@ -0,0 +1,38 @@
+#include "webfuse/impl/operation/releasedir.h"
+#include "webfuse/impl/operation/dirbuffer.h"
+
+#include "webfuse/mocks/mock_fuse.hpp"
+
+#include <gtest/gtest.h>
+
+using webfuse_test::FuseMock;
+using testing::_;
+using testing::Return;
+
+TEST(wf_impl_operation_releasedir, dispose_handle)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_err(_, 0)).Times(1).WillOnce(Return(0));
+
+    fuse_req_t request = nullptr;
+    fuse_ino_t inode = 1;
+    fuse_file_info file_info;
+    file_info.flags = 0;
+    file_info.fh = reinterpret_cast<uint64_t>(wf_impl_dirbuffer_create());
+    wf_impl_operation_releasedir(request, inode, &file_info);
+
+    ASSERT_EQ(0, file_info.fh);
+}
+
+TEST(wf_impl_operation_releasedir, no_handle)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_err(_, 0)).Times(1).WillOnce(Return(0));
+
+    fuse_req_t request = nullptr;
+    fuse_ino_t inode = 1;
+    fuse_file_info file_info;
+    file_info.flags = 0;
+    file_info.fh = 0;
+    wf_impl_operation_releasedir(request, inode, &file_info);
+}
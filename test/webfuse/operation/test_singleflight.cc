@@ -0,0 +1,225 @@
+#include "webfuse/impl/operation/singleflight.h"
+#include "webfuse/impl/operation/lookup.h"
+#include "webfuse/impl/operation/getattr.h"
+#include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/jsonrpc/error.h"
+#include "webfuse/status.h"
+
+#include "webfuse/test_util/json_doc.hpp"
+#include "webfuse/mocks/mock_fuse.hpp"
+#include "webfuse/mocks/mock_operation_context.hpp"
+#include "webfuse/mocks/mock_jsonrpc_proxy.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using webfuse_test::JsonDoc;
+using webfuse_test::MockJsonRpcProxy;
+using webfuse_test::MockOperationContext;
+using webfuse_test::FuseMock;
+using testing::_;
+using testing::Return;
+using testing::Invoke;
+using testing::StrEq;
+
+namespace
+{
+
+struct Waiter
+{
+    int calls = 0;
+    wf_json const * result = nullptr;
+    wf_jsonrpc_error const * error = nullptr;
+};
+
+void on_finished(
+    void * user_data,
+    wf_json const * result,
+    wf_jsonrpc_error const * error)
+{
+    auto * waiter = reinterpret_cast<Waiter*>(user_data);
+    waiter->calls++;
+    waiter->result = result;
+    waiter->error = error;
+}
+
+struct PendingCall
+{
+    wf_jsonrpc_proxy_finished_fn * finished = nullptr;
+    void * user_data = nullptr;
+};
+
+}
+
+TEST(wf_impl_singleflight, create_dispose)
+{
+    wf_impl_singleflight * singleflight = wf_impl_singleflight_create();
+    ASSERT_NE(nullptr, singleflight);
+    ASSERT_EQ(0, wf_impl_singleflight_pending_count(singleflight));
+
+    wf_impl_singleflight_dispose(singleflight);
+}
+
+TEST(wf_impl_singleflight, attach_identical_requests)
+{
+    wf_impl_singleflight * singleflight = wf_impl_singleflight_create();
+    Waiter first, second, third;
+
+    wf_impl_singleflight_call * call = wf_impl_singleflight_add(singleflight, "lookup", 1, "a.file", &on_finished, &first);
+    ASSERT_NE(nullptr, call);
+    ASSERT_EQ(nullptr, wf_impl_singleflight_add(singleflight, "lookup", 1, "a.file", &on_finished, &second));
+    ASSERT_EQ(nullptr, wf_impl_singleflight_add(singleflight, "lookup", 1, "a.file", &on_finished, &third));
+    ASSERT_EQ(1, wf_impl_singleflight_pending_count(singleflight));
+
+    JsonDoc result("{}");
+    wf_impl_singleflight_finished(call, result.root(), nullptr);
+    ASSERT_EQ(0, wf_impl_singleflight_pending_count(singleflight));
+
+    for (auto const * waiter: {&first, &second, &third})
+    {
+        ASSERT_EQ(1, waiter->calls);
+        ASSERT_EQ(result.root(), waiter->result);
+        ASSERT_EQ(nullptr, waiter->error);
+    }
+
+    wf_impl_singleflight_dispose(singleflight);
+}
+
+TEST(wf_impl_singleflight, distinguish_requests)
+{
+    wf_impl_singleflight * singleflight = wf_impl_singleflight_create();
+    Waiter waiter;
+
+    std::vector<wf_impl_singleflight_call *> calls;
+    calls.push_back(wf_impl_singleflight_add(singleflight, "lookup", 1, "a.file", &on_finished, &waiter));
+    calls.push_back(wf_impl_singleflight_add(singleflight, "lookup", 1, "b.file", &on_finished, &waiter));
+    calls.push_back(wf_impl_singleflight_add(singleflight, "lookup", 2, "a.file", &on_finished, &waiter));
+    calls.push_back(wf_impl_singleflight_add(singleflight, "getattr", 1, nullptr, &on_finished, &waiter));
+    calls.push_back(wf_impl_singleflight_add(singleflight, "getattr", 2, nullptr, &on_finished, &waiter));
+    calls.push_back(wf_impl_singleflight_add(singleflight, "readdir", 1, nullptr, &on_finished, &waiter));
+    ASSERT_EQ(calls.size(), wf_impl_singleflight_pending_count(singleflight));
+
+    for(auto * call: calls)
+    {
+        ASSERT_NE(nullptr, call);
+        wf_impl_singleflight_finished(call, nullptr, nullptr);
+    }
+    ASSERT_EQ(calls.size(), waiter.calls);
+
+    wf_impl_singleflight_dispose(singleflight);
+}
+
+TEST(wf_impl_singleflight, start_new_call_after_finished)
+{
+    wf_impl_singleflight * singleflight = wf_impl_singleflight_create();
+    Waiter waiter;
+
+    wf_impl_singleflight_call * call = wf_impl_singleflight_add(singleflight, "getattr", 1, nullptr, &on_finished, &waiter);
+    wf_impl_singleflight_finished(call, nullptr, nullptr);
+
+    call = wf_impl_singleflight_add(singleflight, "getattr", 1, nullptr, &on_finished, &waiter);
+    ASSERT_NE(nullptr, call);
+    wf_impl_singleflight_finished(call, nullptr, nullptr);
+
+    ASSERT_EQ(2, waiter.calls);
+    wf_impl_singleflight_dispose(singleflight);
+}
+
+TEST(wf_impl_singleflight, finish_call_after_dispose)
+{
+    wf_impl_singleflight * singleflight = wf_impl_singleflight_create();
+    Waiter first, second;
+
+    wf_impl_singleflight_call * call = wf_impl_singleflight_add(singleflight, "getattr", 1, nullptr, &on_finished, &first);
+    wf_impl_singleflight_add(singleflight, "getattr", 1, nullptr, &on_finished, &second);
+    wf_impl_singleflight_dispose(singleflight);
+
+    wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD, "Bad");
+    wf_impl_singleflight_finished(call, nullptr, error);
+
+    ASSERT_EQ(1, first.calls);
+    ASSERT_EQ(error, first.error);
+    ASSERT_EQ(1, second.calls);
+    ASSERT_EQ(error, second.error);
+
+    wf_impl_jsonrpc_error_dispose(error);
+}
+
+TEST(wf_impl_singleflight, coalesce_lookup)
+{
+    PendingCall pending;
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("lookup"),StrEq("sIs"))).Times(1)
+        .WillOnce(Invoke([&pending](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn * finished, void * user_data, char const *, char const *) {
+            pending.finished = finished;
+            pending.user_data = user_data;
+        }));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(2)
+        .WillRepeatedly(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.cache = nullptr;
+    op_context.timeout = 1.0;
+    op_context.singleflight = wf_impl_singleflight_create();
+    fuse_ctx fuse_context;
+    fuse_context.gid = 0;
+    fuse_context.uid = 0;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_ctx(_)).Times(2).WillRepeatedly(Return(&fuse_context));
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(2).WillRepeatedly(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_entry(_, _)).Times(2).WillRepeatedly(Return(0));
+
+    wf_impl_operation_lookup(nullptr, 1, "some.file");
+    wf_impl_operation_lookup(nullptr, 1, "some.file");
+    ASSERT_NE(nullptr, pending.finished);
+
+    JsonDoc result("{\"inode\": 2, \"mode\": 420, \"type\": \"file\", \"size\": 42}");
+    pending.finished(pending.user_data, result.root(), nullptr);
+
+    wf_impl_singleflight_dispose(op_context.singleflight);
+}
+
+TEST(wf_impl_singleflight, coalesce_getattr)
+{
+    PendingCall pending;
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("getattr"),StrEq("sI"))).Times(1)
+        .WillOnce(Invoke([&pending](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn * finished, void * user_data, char const *, char const *) {
+            pending.finished = finished;
+            pending.user_data = user_data;
+        }));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(3)
+        .WillRepeatedly(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.inodes = nullptr;
+    op_context.cache = nullptr;
+    op_context.timeout = 1.0;
+    op_context.singleflight = wf_impl_singleflight_create();
+    fuse_ctx fuse_context;
+    fuse_context.gid = 0;
+    fuse_context.uid = 0;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_ctx(_)).Times(3).WillRepeatedly(Return(&fuse_context));
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(3).WillRepeatedly(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(3).WillRepeatedly(Return(0));
+
+    for (int i = 0; i < 3; i++)
+    {
+        wf_impl_operation_getattr(nullptr, 1, nullptr);
+    }
+    ASSERT_NE(nullptr, pending.finished);
+
+    wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD_NOENTRY, "Bad");
+    pending.finished(pending.user_data, nullptr, error);
+    wf_impl_jsonrpc_error_dispose(error);
+
+    wf_impl_singleflight_dispose(op_context.singleflight);
+}
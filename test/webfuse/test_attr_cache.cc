@@ -0,0 +1,249 @@
+#include "webfuse/impl/attr_cache.h"
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+
+namespace
+{
+
+struct stat create_attr(fuse_ino_t inode)
+{
+    struct stat attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.st_ino = inode;
+    attr.st_mode = S_IFREG | 0644;
+    attr.st_size = 42;
+
+    return attr;
+}
+
+}
+
+TEST(attr_cache, create_dispose)
+{
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 0, 1024);
+    ASSERT_NE(nullptr, cache);
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(attr_cache, get_attr)
+{
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+
+    struct stat attr;
+    ASSERT_FALSE(wf_impl_attr_cache_get_attr(cache, 2, &attr));
+
+    struct stat expected = create_attr(2);
+    wf_impl_attr_cache_set_attr(cache, 2, &expected);
+
+    ASSERT_TRUE(wf_impl_attr_cache_get_attr(cache, 2, &attr));
+    ASSERT_EQ(2, attr.st_ino);
+    ASSERT_EQ(42, attr.st_size);
+    ASSERT_FALSE(wf_impl_attr_cache_get_attr(cache, 3, &attr));
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(attr_cache, update_attr)
+{
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+
+    struct stat expected = create_attr(2);
+    wf_impl_attr_cache_set_attr(cache, 2, &expected);
+    expected.st_size = 23;
+    wf_impl_attr_cache_set_attr(cache, 2, &expected);
+
+    struct stat attr;
+    ASSERT_TRUE(wf_impl_attr_cache_get_attr(cache, 2, &attr));
+    ASSERT_EQ(23, attr.st_size);
+
+    wf_impl_attr_cache_stats stats;
+    wf_impl_attr_cache_get_stats(cache, &stats);
+    ASSERT_EQ(1, stats.count);
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(attr_cache, lookup)
+{
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+
+    struct stat attr;
+    ASSERT_EQ(WF_IMPL_ATTR_CACHE_MISS, wf_impl_attr_cache_lookup(cache, 1, "a.file", &attr));
+
+    wf_impl_attr_cache_set_entry(cache, 1, "a.file", 2);
+    ASSERT_EQ(WF_IMPL_ATTR_CACHE_MISS, wf_impl_attr_cache_lookup(cache, 1, "a.file", &attr));
+
+    struct stat expected = create_attr(2);
+    wf_impl_attr_cache_set_attr(cache, 2, &expected);
+    ASSERT_EQ(WF_IMPL_ATTR_CACHE_FOUND, wf_impl_attr_cache_lookup(cache, 1, "a.file", &attr));
+    ASSERT_EQ(2, attr.st_ino);
+
+    ASSERT_EQ(WF_IMPL_ATTR_CACHE_MISS, wf_impl_attr_cache_lookup(cache, 2, "a.file", &attr));
+    ASSERT_EQ(WF_IMPL_ATTR_CACHE_MISS, wf_impl_attr_cache_lookup(cache, 1, "b.file", &attr));
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(attr_cache, negative_entry)
+{
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 1000, 1024 * 1024);
+
+    wf_impl_attr_cache_set_negative_entry(cache, 1, "a.file");
+
+    struct stat attr;
+    ASSERT_EQ(WF_IMPL_ATTR_CACHE_NOT_FOUND, wf_impl_attr_cache_lookup(cache, 1, "a.file", &attr));
+
+    wf_impl_attr_cache_stats stats;
+    wf_impl_attr_cache_get_stats(cache, &stats);
+    ASSERT_EQ(1, stats.negative_hits);
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(attr_cache, negative_entry_disabled)
+{
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+
+    wf_impl_attr_cache_set_negative_entry(cache, 1, "a.file");
+
+    struct stat attr;
+    ASSERT_EQ(WF_IMPL_ATTR_CACHE_MISS, wf_impl_attr_cache_lookup(cache, 1, "a.file", &attr));
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(attr_cache, negative_entry_replaced_by_entry)
+{
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 1000, 1024 * 1024);
+
+    wf_impl_attr_cache_set_negative_entry(cache, 1, "a.file");
+    struct stat expected = create_attr(2);
+    wf_impl_attr_cache_set_attr(cache, 2, &expected);
+    wf_impl_attr_cache_set_entry(cache, 1, "a.file", 2);
+
+    struct stat attr;
+    ASSERT_EQ(WF_IMPL_ATTR_CACHE_FOUND, wf_impl_attr_cache_lookup(cache, 1, "a.file", &attr));
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(attr_cache, invalidate)
+{
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+
+    struct stat expected = create_attr(2);
+    wf_impl_attr_cache_set_attr(cache, 2, &expected);
+    wf_impl_attr_cache_set_entry(cache, 1, "a.file", 2);
+
+    wf_impl_attr_cache_invalidate_entry(cache, 1, "a.file");
+
+    struct stat attr;
+    ASSERT_EQ(WF_IMPL_ATTR_CACHE_MISS, wf_impl_attr_cache_lookup(cache, 1, "a.file", &attr));
+    ASSERT_TRUE(wf_impl_attr_cache_get_attr(cache, 2, &attr));
+
+    wf_impl_attr_cache_invalidate_attr(cache, 2);
+    ASSERT_FALSE(wf_impl_attr_cache_get_attr(cache, 2, &attr));
+
+    wf_impl_attr_cache_stats stats;
+    wf_impl_attr_cache_get_stats(cache, &stats);
+    ASSERT_EQ(0, stats.count);
+    ASSERT_EQ(0, stats.size);
+
+    wf_impl_attr_cache_log_stats(cache, "test");
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(attr_cache, invalidation_generation)
+{
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 0, 1024 * 1024);
+
+    uint64_t const generation = wf_impl_attr_cache_get_generation(cache);
+    ASSERT_FALSE(wf_impl_attr_cache_is_invalidated(cache, 1, generation));
+    ASSERT_FALSE(wf_impl_attr_cache_is_invalidated(cache, 2, generation));
+
+    wf_impl_attr_cache_invalidate_attr(cache, 2);
+    ASSERT_TRUE(wf_impl_attr_cache_is_invalidated(cache, 2, generation));
+
+    // entries are tracked by their parent
+    wf_impl_attr_cache_invalidate_entry(cache, 1, "a.file");
+    ASSERT_TRUE(wf_impl_attr_cache_is_invalidated(cache, 1, generation));
+
+    // requests sent afterwards are not affected
+    uint64_t const later = wf_impl_attr_cache_get_generation(cache);
+    ASSERT_LT(generation, later);
+    ASSERT_FALSE(wf_impl_attr_cache_is_invalidated(cache, 1, later));
+    ASSERT_FALSE(wf_impl_attr_cache_is_invalidated(cache, 2, later));
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(attr_cache, expire)
+{
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1, 0, 1024 * 1024);
+
+    struct stat expected = create_attr(2);
+    wf_impl_attr_cache_set_attr(cache, 2, &expected);
+
+    struct timespec delay = { 0, 10 * 1000 * 1000 };
+    nanosleep(&delay, nullptr);
+
+    struct stat attr;
+    ASSERT_FALSE(wf_impl_attr_cache_get_attr(cache, 2, &attr));
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(attr_cache, evict_least_recently_used)
+{
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 0, 1024);
+
+    for (fuse_ino_t inode = 1; inode <= 1000; inode++)
+    {
+        struct stat expected = create_attr(inode);
+        wf_impl_attr_cache_set_attr(cache, inode, &expected);
+    }
+
+    wf_impl_attr_cache_stats stats;
+    wf_impl_attr_cache_get_stats(cache, &stats);
+    ASSERT_LE(stats.size, 1024);
+    ASSERT_LT(stats.count, 1000);
+    ASSERT_EQ(1000, stats.count + stats.evictions);
+
+    struct stat attr;
+    ASSERT_FALSE(wf_impl_attr_cache_get_attr(cache, 1, &attr));
+    ASSERT_TRUE(wf_impl_attr_cache_get_attr(cache, 1000, &attr));
+
+    wf_impl_attr_cache_dispose(cache);
+}
+
+TEST(attr_cache, many_entries)
+{
+    wf_impl_attr_cache * cache = wf_impl_attr_cache_create(1000, 0, 16 * 1024 * 1024);
+
+    for (fuse_ino_t inode = 2; inode < 10000; inode++)
+    {
+        std::string name = "file_" + std::to_string(inode);
+        struct stat expected = create_attr(inode);
+        wf_impl_attr_cache_set_attr(cache, inode, &expected);
+        wf_impl_attr_cache_set_entry(cache, 1, name.c_str(), inode);
+    }
+
+    for (fuse_ino_t inode = 2; inode < 10000; inode++)
+    {
+        std::string name = "file_" + std::to_string(inode);
+        struct stat attr;
+        ASSERT_EQ(WF_IMPL_ATTR_CACHE_FOUND, wf_impl_attr_cache_lookup(cache, 1, name.c_str(), &attr));
+        ASSERT_EQ(inode, attr.st_ino);
+    }
+
+    wf_impl_attr_cache_stats stats;
+    wf_impl_attr_cache_get_stats(cache, &stats);
+    ASSERT_EQ(9998, stats.hits);
+    ASSERT_EQ(0, stats.misses);
+    ASSERT_EQ(0, stats.evictions);
+
+    wf_impl_attr_cache_dispose(cache);
+}
@@ -0,0 +1,66 @@
+#include "webfuse/impl/flow_control.h"
+
+#include <gtest/gtest.h>
+
+TEST(flow_control, init)
+{
+    wf_impl_flow_control flow_control;
+    wf_impl_flow_control_init(&flow_control, 10, 1000);
+
+    ASSERT_FALSE(wf_impl_flow_control_is_paused(&flow_control));
+}
+
+TEST(flow_control, pause_if_max_in_flight_is_reached)
+{
+    wf_impl_flow_control flow_control;
+    wf_impl_flow_control_init(&flow_control, 10, 1000);
+
+    ASSERT_FALSE(wf_impl_flow_control_update(&flow_control, 9, 0));
+    ASSERT_FALSE(wf_impl_flow_control_is_paused(&flow_control));
+
+    ASSERT_TRUE(wf_impl_flow_control_update(&flow_control, 10, 0));
+    ASSERT_TRUE(wf_impl_flow_control_is_paused(&flow_control));
+}
+
+TEST(flow_control, pause_if_max_queued_bytes_is_reached)
+{
+    wf_impl_flow_control flow_control;
+    wf_impl_flow_control_init(&flow_control, 10, 1000);
+
+    ASSERT_FALSE(wf_impl_flow_control_update(&flow_control, 0, 999));
+    ASSERT_TRUE(wf_impl_flow_control_update(&flow_control, 0, 1000));
+    ASSERT_TRUE(wf_impl_flow_control_is_paused(&flow_control));
+}
+
+TEST(flow_control, resume_if_drained_to_half)
+{
+    wf_impl_flow_control flow_control;
+    wf_impl_flow_control_init(&flow_control, 10, 1000);
+    wf_impl_flow_control_update(&flow_control, 10, 1000);
+
+    ASSERT_FALSE(wf_impl_flow_control_update(&flow_control, 9, 999));
+    ASSERT_FALSE(wf_impl_flow_control_update(&flow_control, 5, 501));
+    ASSERT_TRUE(wf_impl_flow_control_is_paused(&flow_control));
+
+    ASSERT_TRUE(wf_impl_flow_control_update(&flow_control, 5, 500));
+    ASSERT_FALSE(wf_impl_flow_control_is_paused(&flow_control));
+}
+
+TEST(flow_control, zero_disables_limit)
+{
+    wf_impl_flow_control flow_control;
+    wf_impl_flow_control_init(&flow_control, 0, 0);
+
+    ASSERT_FALSE(wf_impl_flow_control_update(&flow_control, 100000, 100000000));
+    ASSERT_FALSE(wf_impl_flow_control_is_paused(&flow_control));
+}
+
+TEST(flow_control, resume_with_limit_of_one)
+{
+    wf_impl_flow_control flow_control;
+    wf_impl_flow_control_init(&flow_control, 1, 0);
+
+    ASSERT_TRUE(wf_impl_flow_control_update(&flow_control, 1, 0));
+    ASSERT_FALSE(wf_impl_flow_control_update(&flow_control, 1, 0));
+    ASSERT_TRUE(wf_impl_flow_control_update(&flow_control, 0, 0));
+}
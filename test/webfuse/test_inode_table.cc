@@ -0,0 +1,157 @@
+#include "webfuse/impl/inode_table.h"
+
+#include <gtest/gtest.h>
+
+TEST(inode_table, create_dispose)
+{
+    wf_impl_inode_table * table = wf_impl_inode_table_create();
+    ASSERT_NE(nullptr, table);
+    ASSERT_EQ(1, wf_impl_inode_table_count(table));
+
+    wf_impl_inode_table_dispose(table);
+}
+
+TEST(inode_table, root_is_mapped_to_fuse_root_id)
+{
+    wf_impl_inode_table * table = wf_impl_inode_table_create();
+
+    ASSERT_EQ(FUSE_ROOT_ID, wf_impl_inode_table_find(table, 1));
+
+    uint64_t id = 0;
+    ASSERT_TRUE(wf_impl_inode_table_get_id(table, FUSE_ROOT_ID, &id));
+    ASSERT_EQ(1, id);
+
+    ASSERT_FALSE(wf_impl_inode_table_forget(table, FUSE_ROOT_ID, 1, nullptr));
+    ASSERT_EQ(FUSE_ROOT_ID, wf_impl_inode_table_find(table, 1));
+
+    wf_impl_inode_table_dispose(table);
+}
+
+TEST(inode_table, map_64bit_id)
+{
+    wf_impl_inode_table * table = wf_impl_inode_table_create();
+    uint64_t const large_id = 0x123456789abcdefULL;
+
+    ASSERT_EQ(0, wf_impl_inode_table_find(table, large_id));
+
+    uint64_t generation = 42;
+    fuse_ino_t inode = wf_impl_inode_table_ref(table, large_id, &generation);
+    ASSERT_NE(0, inode);
+    ASSERT_NE(FUSE_ROOT_ID, inode);
+    ASSERT_EQ(0, generation);
+    ASSERT_EQ(inode, wf_impl_inode_table_find(table, large_id));
+
+    uint64_t id = 0;
+    ASSERT_TRUE(wf_impl_inode_table_get_id(table, inode, &id));
+    ASSERT_EQ(large_id, id);
+
+    wf_impl_inode_table_dispose(table);
+}
+
+TEST(inode_table, get_id_fails_for_unknown_inode)
+{
+    wf_impl_inode_table * table = wf_impl_inode_table_create();
+
+    uint64_t id = 0;
+    ASSERT_FALSE(wf_impl_inode_table_get_id(table, 0, &id));
+    ASSERT_FALSE(wf_impl_inode_table_get_id(table, 42, &id));
+
+    wf_impl_inode_table_dispose(table);
+}
+
+TEST(inode_table, release_after_all_lookups_are_forgotten)
+{
+    wf_impl_inode_table * table = wf_impl_inode_table_create();
+
+    fuse_ino_t inode = wf_impl_inode_table_ref(table, 42, nullptr);
+    ASSERT_EQ(inode, wf_impl_inode_table_ref(table, 42, nullptr));
+    ASSERT_EQ(inode, wf_impl_inode_table_ref(table, 42, nullptr));
+    ASSERT_EQ(2, wf_impl_inode_table_count(table));
+
+    uint64_t id = 0;
+    ASSERT_FALSE(wf_impl_inode_table_forget(table, inode, 2, &id));
+    ASSERT_EQ(inode, wf_impl_inode_table_find(table, 42));
+
+    ASSERT_TRUE(wf_impl_inode_table_forget(table, inode, 1, &id));
+    ASSERT_EQ(42, id);
+    ASSERT_EQ(0, wf_impl_inode_table_find(table, 42));
+    ASSERT_FALSE(wf_impl_inode_table_get_id(table, inode, &id));
+    ASSERT_EQ(1, wf_impl_inode_table_count(table));
+
+    wf_impl_inode_table_dispose(table);
+}
+
+TEST(inode_table, forget_unknown_inode)
+{
+    wf_impl_inode_table * table = wf_impl_inode_table_create();
+
+    ASSERT_FALSE(wf_impl_inode_table_forget(table, 42, 1, nullptr));
+
+    wf_impl_inode_table_dispose(table);
+}
+
+TEST(inode_table, reused_inode_gets_new_generation)
+{
+    wf_impl_inode_table * table = wf_impl_inode_table_create();
+
+    uint64_t generation;
+    fuse_ino_t inode = wf_impl_inode_table_ref(table, 42, &generation);
+    ASSERT_EQ(0, generation);
+    ASSERT_TRUE(wf_impl_inode_table_forget(table, inode, 1, nullptr));
+
+    ASSERT_EQ(inode, wf_impl_inode_table_ref(table, 23, &generation));
+    ASSERT_EQ(1, generation);
+
+    uint64_t id = 0;
+    ASSERT_TRUE(wf_impl_inode_table_get_id(table, inode, &id));
+    ASSERT_EQ(23, id);
+
+    wf_impl_inode_table_dispose(table);
+}
+
+TEST(inode_table, grow)
+{
+    wf_impl_inode_table * table = wf_impl_inode_table_create();
+
+    for(uint64_t id = 2; id < 1002; id++)
+    {
+        wf_impl_inode_table_ref(table, id * 1000, nullptr);
+    }
+    ASSERT_EQ(1001, wf_impl_inode_table_count(table));
+
+    for(uint64_t id = 2; id < 1002; id++)
+    {
+        fuse_ino_t inode = wf_impl_inode_table_find(table, id * 1000);
+        ASSERT_NE(0, inode);
+
+        uint64_t value = 0;
+        ASSERT_TRUE(wf_impl_inode_table_get_id(table, inode, &value));
+        ASSERT_EQ(id * 1000, value);
+    }
+
+    for(uint64_t id = 2; id < 1002; id++)
+    {
+        fuse_ino_t inode = wf_impl_inode_table_find(table, id * 1000);
+        ASSERT_TRUE(wf_impl_inode_table_forget(table, inode, 1, nullptr));
+    }
+    ASSERT_EQ(1, wf_impl_inode_table_count(table));
+
+    wf_impl_inode_table_dispose(table);
+}
+
+TEST(inode_table, null_table_maps_identity)
+{
+    uint64_t generation = 42;
+    ASSERT_EQ(42, wf_impl_inode_table_ref(nullptr, 42, &generation));
+    ASSERT_EQ(0, generation);
+    ASSERT_EQ(42, wf_impl_inode_table_find(nullptr, 42));
+
+    uint64_t id = 0;
+    ASSERT_TRUE(wf_impl_inode_table_get_id(nullptr, 42, &id));
+    ASSERT_EQ(42, id);
+
+    ASSERT_FALSE(wf_impl_inode_table_forget(nullptr, 42, 1, &id));
+    ASSERT_EQ(0, wf_impl_inode_table_count(nullptr));
+
+    wf_impl_inode_table_dispose(nullptr);
+}
@@ -0,0 +1,147 @@
+#include "webfuse/impl/invalidation.h"
+#include "webfuse/impl/jsonrpc/request.h"
+#include "webfuse/impl/json/node.h"
+#include "webfuse/impl/message.h"
+#include "webfuse/status.h"
+#include "webfuse/test_util/json_doc.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+using webfuse_test::JsonDoc;
+
+namespace
+{
+
+struct Context
+{
+    std::string response;
+    std::string requested_name;
+};
+
+bool jsonrpc_send(
+    wf_message * message,
+    void * user_data)
+{
+    Context * context = reinterpret_cast<Context*>(user_data);
+    context->response = std::string(message->data, message->length);
+
+    wf_impl_message_dispose(message);
+    return true;
+}
+
+struct wf_impl_filesystem * get_no_filesystem(
+    void * user_data,
+    char const * name)
+{
+    Context * context = reinterpret_cast<Context*>(user_data);
+    context->requested_name = name;
+
+    return nullptr;
+}
+
+int get_error_code(std::string const & response)
+{
+    JsonDoc doc(response);
+    wf_json const * error = wf_impl_json_object_get(doc.root(), "error");
+    wf_json const * code = wf_impl_json_object_get(error, "code");
+
+    return wf_impl_json_is_int(code) ? wf_impl_json_int_get(code) : 0;
+}
+
+}
+
+TEST(invalidation, inode_fail_unknown_filesystem)
+{
+    Context context;
+    wf_jsonrpc_request * request = wf_impl_jsonrpc_request_create(42, &jsonrpc_send, &context);
+
+    JsonDoc params("[\"test\", 2, 0, 0]");
+    wf_impl_invalidation_process_inode(request, params.root(), &get_no_filesystem, &context);
+
+    ASSERT_EQ("test", context.requested_name);
+    ASSERT_EQ(WF_BAD_NOENTRY, get_error_code(context.response));
+}
+
+TEST(invalidation, inode_fail_invalid_params)
+{
+    char const * invalid_params[] =
+    {
+        "[]",
+        "[\"test\"]",
+        "[\"test\", \"2\", 0, 0]",
+        "[\"test\", 2, \"0\", 0]",
+        "[\"test\", 2, 0, \"0\"]",
+        "[\"test\", 2, 0]",
+    };
+
+    for (auto const * text: invalid_params)
+    {
+        Context context;
+        wf_jsonrpc_request * request = wf_impl_jsonrpc_request_create(42, &jsonrpc_send, &context);
+
+        JsonDoc params(text);
+        wf_impl_invalidation_process_inode(request, params.root(), &get_no_filesystem, &context);
+
+        ASSERT_EQ(WF_BAD_FORMAT, get_error_code(context.response)) << text;
+    }
+}
+
+TEST(invalidation, inode_fail_invalid_filesystem_name)
+{
+    Context context;
+    wf_jsonrpc_request * request = wf_impl_jsonrpc_request_create(42, &jsonrpc_send, &context);
+
+    JsonDoc params("[42, 2, 0, 0]");
+    wf_impl_invalidation_process_inode(request, params.root(), &get_no_filesystem, &context);
+
+    ASSERT_EQ("", context.requested_name);
+    ASSERT_EQ(WF_BAD_NOENTRY, get_error_code(context.response));
+}
+
+TEST(invalidation, entry_fail_unknown_filesystem)
+{
+    Context context;
+    wf_jsonrpc_request * request = wf_impl_jsonrpc_request_create(42, &jsonrpc_send, &context);
+
+    JsonDoc params("[\"test\", 1, \"some.file\"]");
+    wf_impl_invalidation_process_entry(request, params.root(), &get_no_filesystem, &context);
+
+    ASSERT_EQ("test", context.requested_name);
+    ASSERT_EQ(WF_BAD_NOENTRY, get_error_code(context.response));
+}
+
+TEST(invalidation, entry_fail_invalid_params)
+{
+    char const * invalid_params[] =
+    {
+        "[]",
+        "[\"test\"]",
+        "[\"test\", \"1\", \"some.file\"]",
+        "[\"test\", 1, 42]",
+        "[\"test\", 1]",
+    };
+
+    for (auto const * text: invalid_params)
+    {
+        Context context;
+        wf_jsonrpc_request * request = wf_impl_jsonrpc_request_create(42, &jsonrpc_send, &context);
+
+        JsonDoc params(text);
+        wf_impl_invalidation_process_entry(request, params.root(), &get_no_filesystem, &context);
+
+        ASSERT_EQ(WF_BAD_FORMAT, get_error_code(context.response)) << text;
+    }
+}
+
+TEST(invalidation, discard_response_of_notification)
+{
+    Context context;
+    wf_jsonrpc_request * request = wf_impl_jsonrpc_request_create(-1, nullptr, &context);
+
+    JsonDoc params("[\"test\", 1, \"some.file\"]");
+    wf_impl_invalidation_process_entry(request, params.root(), &get_no_filesystem, &context);
+
+    ASSERT_EQ("test", context.requested_name);
+    ASSERT_EQ("", context.response);
+}
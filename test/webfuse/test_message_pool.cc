@@ -0,0 +1,147 @@
+#include "webfuse/impl/message_pool.h"
+#include "webfuse/impl/message.h"
+#include "webfuse/impl/json/writer.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace
+{
+
+wf_message * create_message(
+    wf_message_pool * pool,
+    std::string const & content)
+{
+    wf_json_writer * writer = wf_impl_message_pool_get_writer(pool);
+    wf_impl_json_write_string(writer, content.c_str());
+
+    return wf_impl_message_pool_take(pool, writer);
+}
+
+}
+
+TEST(wf_message_pool, create_dispose)
+{
+    wf_message_pool * pool = wf_impl_message_pool_create(64, 1024, 8);
+
+    wf_message_pool_stats stats;
+    wf_impl_message_pool_get_stats(pool, &stats);
+    ASSERT_EQ(0, stats.allocations);
+    ASSERT_EQ(0, stats.reuses);
+    ASSERT_EQ(0, stats.in_use);
+    ASSERT_EQ(0, stats.available);
+
+    wf_impl_message_pool_dispose(pool);
+}
+
+TEST(wf_message_pool, create_message)
+{
+    wf_message_pool * pool = wf_impl_message_pool_create(64, 1024, 8);
+
+    wf_message * message = create_message(pool, "foo");
+    ASSERT_EQ("\"foo\"", std::string(message->data, message->length));
+    ASSERT_EQ(WF_MESSAGE_CLASS_METADATA, message->message_class);
+
+    wf_message_pool_stats stats;
+    wf_impl_message_pool_get_stats(pool, &stats);
+    ASSERT_EQ(1, stats.allocations);
+    ASSERT_EQ(1, stats.in_use);
+
+    wf_impl_message_dispose(message);
+    wf_impl_message_pool_get_stats(pool, &stats);
+    ASSERT_EQ(0, stats.in_use);
+    ASSERT_EQ(1, stats.available);
+
+    wf_impl_message_pool_dispose(pool);
+}
+
+TEST(wf_message_pool, reuse_messages)
+{
+    wf_message_pool * pool = wf_impl_message_pool_create(64, 1024, 8);
+
+    for(int i = 0; i < 10; i++)
+    {
+        wf_message * message = create_message(pool, std::to_string(i));
+        ASSERT_EQ("\"" + std::to_string(i) + "\"", std::string(message->data, message->length));
+        wf_impl_message_dispose(message);
+    }
+
+    wf_message_pool_stats stats;
+    wf_impl_message_pool_get_stats(pool, &stats);
+    ASSERT_EQ(1, stats.allocations);
+    ASSERT_EQ(9, stats.reuses);
+
+    wf_impl_message_pool_dispose(pool);
+}
+
+TEST(wf_message_pool, keep_at_most_max_count_messages)
+{
+    wf_message_pool * pool = wf_impl_message_pool_create(64, 1024, 2);
+
+    wf_message * messages[3];
+    for(auto & message: messages)
+    {
+        message = create_message(pool, "foo");
+    }
+    for(auto & message: messages)
+    {
+        wf_impl_message_dispose(message);
+    }
+
+    wf_message_pool_stats stats;
+    wf_impl_message_pool_get_stats(pool, &stats);
+    ASSERT_EQ(3, stats.allocations);
+    ASSERT_EQ(2, stats.available);
+
+    wf_impl_message_pool_dispose(pool);
+}
+
+TEST(wf_message_pool, do_not_recycle_large_buffers)
+{
+    wf_message_pool * pool = wf_impl_message_pool_create(16, 64, 8);
+
+    wf_message * message = create_message(pool, std::string(100, 'x'));
+    ASSERT_EQ(102, message->length);
+    wf_impl_message_dispose(message);
+
+    wf_message_pool_stats stats;
+    wf_impl_message_pool_get_stats(pool, &stats);
+    ASSERT_EQ(0, stats.available);
+
+    wf_impl_message_pool_dispose(pool);
+}
+
+TEST(wf_message_pool, defer_dispose_until_messages_are_released)
+{
+    wf_message_pool * pool = wf_impl_message_pool_create(64, 1024, 8);
+
+    wf_message * message = create_message(pool, "foo");
+    wf_impl_message_pool_dispose(pool);
+
+    ASSERT_EQ("\"foo\"", std::string(message->data, message->length));
+    wf_impl_message_dispose(message);
+}
+
+TEST(wf_message_pool, fallback_to_unpooled_writer_if_busy)
+{
+    wf_message_pool * pool = wf_impl_message_pool_create(64, 1024, 8);
+
+    wf_json_writer * outer = wf_impl_message_pool_get_writer(pool);
+    wf_json_writer * inner = wf_impl_message_pool_get_writer(pool);
+    ASSERT_NE(outer, inner);
+
+    wf_impl_json_write_string(inner, "inner");
+    wf_message * inner_message = wf_impl_message_pool_take(pool, inner);
+    ASSERT_EQ(nullptr, inner_message->pool);
+    ASSERT_EQ("\"inner\"", std::string(inner_message->data, inner_message->length));
+
+    wf_impl_json_write_string(outer, "outer");
+    wf_message * outer_message = wf_impl_message_pool_take(pool, outer);
+    ASSERT_EQ(pool, outer_message->pool);
+    ASSERT_EQ("\"outer\"", std::string(outer_message->data, outer_message->length));
+
+    wf_impl_message_dispose(inner_message);
+    wf_impl_message_dispose(outer_message);
+    wf_impl_message_pool_dispose(pool);
+}
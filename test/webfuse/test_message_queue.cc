@@ -54,4 +54,81 @@ TEST(wf_message_queue, cleanup_multiple_element)
 
     wf_impl_message_queue_cleanup(&queue);
     ASSERT_TRUE(wf_impl_slist_empty(&queue));
-}
\ No newline at end of file
+}
+
+TEST(wf_message_queue, take_batch_empty)
+{
+    struct wf_slist queue;
+    wf_impl_slist_init(&queue);
+
+    ASSERT_EQ(nullptr, wf_impl_message_queue_take_batch(&queue, 1024, nullptr));
+}
+
+TEST(wf_message_queue, take_batch_single_message)
+{
+    struct wf_slist queue;
+    wf_impl_slist_init(&queue);
+
+    wf_impl_slist_append(&queue, create_message("Hello"));
+
+    size_t size = 0;
+    struct wf_message * message = wf_impl_message_queue_take_batch(&queue, 1024, &size);
+    ASSERT_EQ("{\"content\": \"Hello\"}", std::string(message->data, message->length));
+    ASSERT_EQ(20, size);
+    ASSERT_TRUE(wf_impl_slist_empty(&queue));
+
+    wf_impl_message_dispose(message);
+}
+
+TEST(wf_message_queue, take_batch_multiple_messages)
+{
+    struct wf_slist queue;
+    wf_impl_slist_init(&queue);
+
+    wf_impl_slist_append(&queue, create_message("Hello"));
+    wf_impl_slist_append(&queue, create_message("World"));
+
+    size_t size = 0;
+    struct wf_message * message = wf_impl_message_queue_take_batch(&queue, 1024, &size);
+    ASSERT_EQ("[{\"content\": \"Hello\"},{\"content\": \"World\"}]", std::string(message->data, message->length));
+    ASSERT_EQ(40, size);
+    ASSERT_TRUE(wf_impl_slist_empty(&queue));
+
+    wf_impl_message_dispose(message);
+}
+
+TEST(wf_message_queue, take_batch_limited_by_size)
+{
+    struct wf_slist queue;
+    wf_impl_slist_init(&queue);
+
+    wf_impl_slist_append(&queue, create_message("Hello"));
+    wf_impl_slist_append(&queue, create_message("World"));
+    wf_impl_slist_append(&queue, create_message("!"));
+
+    // fits "[" + 2 * (20 bytes + 1)
+    struct wf_message * message = wf_impl_message_queue_take_batch(&queue, 43, nullptr);
+    ASSERT_EQ("[{\"content\": \"Hello\"},{\"content\": \"World\"}]", std::string(message->data, message->length));
+    wf_impl_message_dispose(message);
+
+    message = wf_impl_message_queue_take_batch(&queue, 43, nullptr);
+    ASSERT_EQ("{\"content\": \"!\"}", std::string(message->data, message->length));
+    wf_impl_message_dispose(message);
+
+    ASSERT_TRUE(wf_impl_slist_empty(&queue));
+}
+
+TEST(wf_message_queue, take_batch_disabled)
+{
+    struct wf_slist queue;
+    wf_impl_slist_init(&queue);
+
+    wf_impl_slist_append(&queue, create_message("Hello"));
+    wf_impl_slist_append(&queue, create_message("World"));
+
+    struct wf_message * message = wf_impl_message_queue_take_batch(&queue, 0, nullptr);
+    ASSERT_EQ("{\"content\": \"Hello\"}", std::string(message->data, message->length));
+    wf_impl_message_dispose(message);
+
+    wf_impl_message_queue_cleanup(&queue);
+}
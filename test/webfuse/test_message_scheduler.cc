@@ -0,0 +1,249 @@
+#include "webfuse/impl/message_scheduler.h"
+#include "webfuse/impl/message.h"
+
+#include <gtest/gtest.h>
+
+#include <libwebsockets.h>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+wf_message * create_message(
+    std::string const & content,
+    wf_message_class message_class = WF_MESSAGE_CLASS_METADATA,
+    void const * source = nullptr)
+{
+    char * data = (char*) malloc(LWS_PRE + content.size());
+    memcpy(&(data[LWS_PRE]), content.c_str(), content.size());
+    wf_message * message = wf_impl_message_create(&(data[LWS_PRE]), content.size());
+    message->message_class = message_class;
+    message->source = source;
+
+    return message;
+}
+
+std::string take(wf_message_scheduler * scheduler)
+{
+    wf_message * message = wf_impl_message_scheduler_take_batch(scheduler, 0, nullptr);
+    if (nullptr == message)
+    {
+        return "<none>";
+    }
+
+    std::string const result(message->data, message->length);
+    wf_impl_message_dispose(message);
+
+    return result;
+}
+
+}
+
+TEST(wf_message_scheduler, create_dispose)
+{
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    ASSERT_TRUE(wf_impl_message_scheduler_empty(scheduler));
+    ASSERT_EQ(nullptr, wf_impl_message_scheduler_take_batch(scheduler, 1024, nullptr));
+
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+TEST(wf_message_scheduler, dispose_queued_messages)
+{
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_add(scheduler, create_message("1"));
+    wf_impl_message_scheduler_add(scheduler, create_message("2", WF_MESSAGE_CLASS_DATA));
+    ASSERT_FALSE(wf_impl_message_scheduler_empty(scheduler));
+
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+TEST(wf_message_scheduler, keep_order_within_class)
+{
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_add(scheduler, create_message("1"));
+    wf_impl_message_scheduler_add(scheduler, create_message("2"));
+    wf_impl_message_scheduler_add(scheduler, create_message("3"));
+
+    ASSERT_EQ("1", take(scheduler));
+    ASSERT_EQ("2", take(scheduler));
+    ASSERT_EQ("3", take(scheduler));
+    ASSERT_EQ("<none>", take(scheduler));
+    ASSERT_TRUE(wf_impl_message_scheduler_empty(scheduler));
+
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+TEST(wf_message_scheduler, metadata_is_not_stuck_behind_data)
+{
+    int filesystem;
+    unsigned int const weights[WF_MESSAGE_CLASS_COUNT] = {4, 1, 1};
+
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_add_source(scheduler, &filesystem, weights);
+    wf_impl_message_scheduler_add(scheduler, create_message("read 1", WF_MESSAGE_CLASS_DATA, &filesystem));
+    wf_impl_message_scheduler_add(scheduler, create_message("read 2", WF_MESSAGE_CLASS_DATA, &filesystem));
+    wf_impl_message_scheduler_add(scheduler, create_message("read 3", WF_MESSAGE_CLASS_DATA, &filesystem));
+    wf_impl_message_scheduler_add(scheduler, create_message("getattr", WF_MESSAGE_CLASS_METADATA, &filesystem));
+
+    ASSERT_EQ("getattr", take(scheduler));
+    ASSERT_EQ("read 1", take(scheduler));
+    ASSERT_EQ("read 2", take(scheduler));
+    ASSERT_EQ("read 3", take(scheduler));
+
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+TEST(wf_message_scheduler, weighted_round_robin)
+{
+    int filesystem;
+    unsigned int const weights[WF_MESSAGE_CLASS_COUNT] = {2, 1, 1};
+
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_add_source(scheduler, &filesystem, weights);
+    for(auto const & content: {"m1", "m2", "m3", "m4"})
+    {
+        wf_impl_message_scheduler_add(scheduler, create_message(content, WF_MESSAGE_CLASS_METADATA, &filesystem));
+    }
+    wf_impl_message_scheduler_add(scheduler, create_message("d1", WF_MESSAGE_CLASS_DATA, &filesystem));
+    wf_impl_message_scheduler_add(scheduler, create_message("d2", WF_MESSAGE_CLASS_DATA, &filesystem));
+    wf_impl_message_scheduler_add(scheduler, create_message("n1", WF_MESSAGE_CLASS_NOTIFICATION, &filesystem));
+
+    ASSERT_EQ("m1", take(scheduler));
+    ASSERT_EQ("m2", take(scheduler));
+    ASSERT_EQ("d1", take(scheduler));
+    ASSERT_EQ("n1", take(scheduler));
+    ASSERT_EQ("m3", take(scheduler));
+    ASSERT_EQ("m4", take(scheduler));
+    ASSERT_EQ("d2", take(scheduler));
+    ASSERT_EQ("<none>", take(scheduler));
+
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+TEST(wf_message_scheduler, round_robin_between_sources)
+{
+    int first;
+    int second;
+    unsigned int const weights[WF_MESSAGE_CLASS_COUNT] = {4, 1, 1};
+
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_add_source(scheduler, &first, weights);
+    wf_impl_message_scheduler_add_source(scheduler, &second, weights);
+    wf_impl_message_scheduler_add(scheduler, create_message("a1", WF_MESSAGE_CLASS_DATA, &first));
+    wf_impl_message_scheduler_add(scheduler, create_message("a2", WF_MESSAGE_CLASS_DATA, &first));
+    wf_impl_message_scheduler_add(scheduler, create_message("a3", WF_MESSAGE_CLASS_DATA, &first));
+    wf_impl_message_scheduler_add(scheduler, create_message("b1", WF_MESSAGE_CLASS_DATA, &second));
+    wf_impl_message_scheduler_add(scheduler, create_message("b2", WF_MESSAGE_CLASS_DATA, &second));
+
+    ASSERT_EQ("a1", take(scheduler));
+    ASSERT_EQ("b1", take(scheduler));
+    ASSERT_EQ("a2", take(scheduler));
+    ASSERT_EQ("b2", take(scheduler));
+    ASSERT_EQ("a3", take(scheduler));
+
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+TEST(wf_message_scheduler, unknown_source_is_queued_with_connection)
+{
+    int unknown;
+
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_add(scheduler, create_message("1", WF_MESSAGE_CLASS_METADATA, &unknown));
+    wf_impl_message_scheduler_add(scheduler, create_message("2"));
+
+    ASSERT_EQ("1", take(scheduler));
+    ASSERT_EQ("2", take(scheduler));
+
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+TEST(wf_message_scheduler, take_batch_in_schedule_order)
+{
+    int filesystem;
+    unsigned int const weights[WF_MESSAGE_CLASS_COUNT] = {4, 1, 1};
+
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_add_source(scheduler, &filesystem, weights);
+    wf_impl_message_scheduler_add(scheduler, create_message("{\"id\":1}", WF_MESSAGE_CLASS_DATA, &filesystem));
+    wf_impl_message_scheduler_add(scheduler, create_message("{\"id\":2}", WF_MESSAGE_CLASS_METADATA, &filesystem));
+    wf_impl_message_scheduler_add(scheduler, create_message("{\"id\":3}", WF_MESSAGE_CLASS_DATA, &filesystem));
+
+    // fits "[" + 2 * (8 bytes + 1)
+    size_t size = 0;
+    wf_message * message = wf_impl_message_scheduler_take_batch(scheduler, 19, &size);
+    ASSERT_EQ("[{\"id\":2},{\"id\":1}]", std::string(message->data, message->length));
+    ASSERT_EQ(16, size);
+    wf_impl_message_dispose(message);
+
+    message = wf_impl_message_scheduler_take_batch(scheduler, 19, &size);
+    ASSERT_EQ("{\"id\":3}", std::string(message->data, message->length));
+    ASSERT_EQ(8, size);
+    wf_impl_message_dispose(message);
+
+    ASSERT_TRUE(wf_impl_message_scheduler_empty(scheduler));
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+TEST(wf_message_scheduler, record_queue_delay_per_class)
+{
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_add(scheduler, create_message("1", WF_MESSAGE_CLASS_DATA));
+    wf_impl_message_scheduler_add(scheduler, create_message("2", WF_MESSAGE_CLASS_DATA));
+    take(scheduler);
+    take(scheduler);
+
+    wf_message_scheduler_stats const * stats = wf_impl_message_scheduler_get_stats(scheduler, WF_MESSAGE_CLASS_DATA);
+    ASSERT_EQ(2, stats->messages);
+    uint64_t count = 0;
+    for(size_t i = 0; i < WF_MESSAGE_SCHEDULER_HISTOGRAM_SIZE; i++)
+    {
+        count += stats->histogram[i];
+    }
+    ASSERT_EQ(2, count);
+
+    ASSERT_EQ(0, wf_impl_message_scheduler_get_stats(scheduler, WF_MESSAGE_CLASS_METADATA)->messages);
+
+    wf_impl_message_scheduler_log_stats(scheduler, "test");
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+namespace
+{
+
+void on_message_taken(void * user_data, wf_message const * message)
+{
+    std::vector<int> * taken = reinterpret_cast<std::vector<int>*>(user_data);
+    taken->push_back(message->request_id);
+}
+
+}
+
+TEST(wf_message_scheduler, notify_each_taken_message)
+{
+    std::vector<int> taken;
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_set_taken_handler(scheduler, &on_message_taken, reinterpret_cast<void*>(&taken));
+
+    wf_message * message = create_message("{\"id\":1}");
+    message->request_id = 1;
+    wf_impl_message_scheduler_add(scheduler, message);
+    message = create_message("{\"id\":2}");
+    message->request_id = 2;
+    wf_impl_message_scheduler_add(scheduler, message);
+    ASSERT_TRUE(taken.empty());
+
+    // messages are reported individually, even if they are sent as batch
+    message = wf_impl_message_scheduler_take_batch(scheduler, 1024, nullptr);
+    ASSERT_EQ("[{\"id\":1},{\"id\":2}]", std::string(message->data, message->length));
+    wf_impl_message_dispose(message);
+    ASSERT_EQ(2, taken.size());
+    ASSERT_EQ(1, taken[0]);
+    ASSERT_EQ(2, taken[1]);
+
+    wf_impl_message_scheduler_dispose(scheduler);
+}
@@ -0,0 +1,241 @@
+#include "webfuse/impl/message_sender.h"
+#include "webfuse/impl/message.h"
+#include "webfuse/impl/message_scheduler.h"
+
+#include "webfuse/mocks/mock_lws.hpp"
+
+#include <gtest/gtest.h>
+
+#include <libwebsockets.h>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using webfuse_test::LwsMock;
+using testing::_;
+using testing::Return;
+using testing::Invoke;
+
+namespace
+{
+
+struct wf_message * create_message(std::string const & content)
+{
+    char * data = (char*) malloc(LWS_PRE + content.size());
+    memcpy(&(data[LWS_PRE]), content.c_str(), content.size());
+    return wf_impl_message_create(&(data[LWS_PRE]), content.size());
+}
+
+struct Frame
+{
+    std::string data;
+    int protocol;
+};
+
+class FrameRecorder
+{
+public:
+    int write(struct lws *, unsigned char * buf, size_t len, enum lws_write_protocol protocol)
+    {
+        frames.push_back({std::string(reinterpret_cast<char*>(buf), len), static_cast<int>(protocol)});
+        return static_cast<int>(len);
+    }
+
+    std::vector<Frame> frames;
+};
+
+}
+
+TEST(wf_message_sender, drain_queue_in_one_callback)
+{
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_add(scheduler, create_message("{\"id\": 1}"));
+    wf_impl_message_scheduler_add(scheduler, create_message("{\"id\": 2}"));
+    wf_impl_message_scheduler_add(scheduler, create_message("{\"id\": 3}"));
+
+    FrameRecorder recorder;
+    LwsMock lws;
+    EXPECT_CALL(lws, lws_send_pipe_choked(_)).WillRepeatedly(Return(0));
+    EXPECT_CALL(lws, lws_write(_,_,_,_)).Times(3).WillRepeatedly(Invoke(&recorder, &FrameRecorder::write));
+    EXPECT_CALL(lws, lws_callback_on_writable(_)).Times(0);
+
+    wf_message_sender sender;
+    wf_impl_message_sender_init(&sender, 1024);
+    ASSERT_TRUE(wf_impl_message_sender_write(&sender, scheduler, nullptr, 0));
+
+    ASSERT_TRUE(wf_impl_message_scheduler_empty(scheduler));
+    ASSERT_EQ(3, recorder.frames.size());
+    ASSERT_EQ("{\"id\": 1}", recorder.frames[0].data);
+    ASSERT_EQ(LWS_WRITE_TEXT, recorder.frames[0].protocol);
+    ASSERT_EQ("{\"id\": 3}", recorder.frames[2].data);
+
+    ASSERT_EQ(3, sender.stats.messages);
+    ASSERT_EQ(3, sender.stats.frames);
+    ASSERT_EQ(27, sender.stats.bytes);
+    ASSERT_EQ(1, sender.stats.writable_callbacks);
+
+    wf_impl_message_sender_cleanup(&sender);
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+TEST(wf_message_sender, stop_when_choked)
+{
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_add(scheduler, create_message("{\"id\": 1}"));
+    wf_impl_message_scheduler_add(scheduler, create_message("{\"id\": 2}"));
+
+    FrameRecorder recorder;
+    LwsMock lws;
+    EXPECT_CALL(lws, lws_send_pipe_choked(_))
+        .WillOnce(Return(0))
+        .WillOnce(Return(1))
+        .WillRepeatedly(Return(0));
+    EXPECT_CALL(lws, lws_write(_,_,_,_)).Times(2).WillRepeatedly(Invoke(&recorder, &FrameRecorder::write));
+    EXPECT_CALL(lws, lws_callback_on_writable(_)).Times(1).WillOnce(Return(0));
+
+    wf_message_sender sender;
+    wf_impl_message_sender_init(&sender, 1024);
+
+    ASSERT_TRUE(wf_impl_message_sender_write(&sender, scheduler, nullptr, 0));
+    ASSERT_EQ(1, recorder.frames.size());
+    ASSERT_EQ(1, sender.stats.choked);
+
+    ASSERT_TRUE(wf_impl_message_sender_write(&sender, scheduler, nullptr, 0));
+    ASSERT_EQ(2, recorder.frames.size());
+    ASSERT_TRUE(wf_impl_message_scheduler_empty(scheduler));
+
+    wf_impl_message_sender_cleanup(&sender);
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+TEST(wf_message_sender, fragment_large_messages)
+{
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_add(scheduler, create_message("0123456789"));
+
+    FrameRecorder recorder;
+    LwsMock lws;
+    EXPECT_CALL(lws, lws_send_pipe_choked(_)).WillRepeatedly(Return(0));
+    EXPECT_CALL(lws, lws_write(_,_,_,_)).Times(3).WillRepeatedly(Invoke(&recorder, &FrameRecorder::write));
+
+    wf_message_sender sender;
+    wf_impl_message_sender_init(&sender, 4);
+    ASSERT_TRUE(wf_impl_message_sender_write(&sender, scheduler, nullptr, 0));
+
+    ASSERT_EQ(3, recorder.frames.size());
+    ASSERT_EQ("0123", recorder.frames[0].data);
+    ASSERT_EQ(LWS_WRITE_TEXT | LWS_WRITE_NO_FIN, recorder.frames[0].protocol);
+    ASSERT_EQ("4567", recorder.frames[1].data);
+    ASSERT_EQ(LWS_WRITE_CONTINUATION | LWS_WRITE_NO_FIN, recorder.frames[1].protocol);
+    ASSERT_EQ("89", recorder.frames[2].data);
+    ASSERT_EQ(LWS_WRITE_CONTINUATION, recorder.frames[2].protocol);
+
+    ASSERT_EQ(1, sender.stats.messages);
+    ASSERT_EQ(3, sender.stats.frames);
+
+    wf_impl_message_sender_cleanup(&sender);
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+TEST(wf_message_sender, continue_fragmented_message_after_choke)
+{
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_add(scheduler, create_message("01234567"));
+
+    FrameRecorder recorder;
+    LwsMock lws;
+    EXPECT_CALL(lws, lws_send_pipe_choked(_))
+        .WillOnce(Return(0))
+        .WillOnce(Return(1))
+        .WillRepeatedly(Return(0));
+    EXPECT_CALL(lws, lws_write(_,_,_,_)).Times(2).WillRepeatedly(Invoke(&recorder, &FrameRecorder::write));
+    EXPECT_CALL(lws, lws_callback_on_writable(_)).Times(1).WillOnce(Return(0));
+
+    wf_message_sender sender;
+    wf_impl_message_sender_init(&sender, 4);
+
+    ASSERT_TRUE(wf_impl_message_sender_write(&sender, scheduler, nullptr, 0));
+    ASSERT_EQ(1, recorder.frames.size());
+
+    ASSERT_TRUE(wf_impl_message_sender_write(&sender, scheduler, nullptr, 0));
+    ASSERT_EQ(2, recorder.frames.size());
+    ASSERT_EQ("4567", recorder.frames[1].data);
+    ASSERT_EQ(LWS_WRITE_CONTINUATION, recorder.frames[1].protocol);
+
+    wf_impl_message_sender_cleanup(&sender);
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+TEST(wf_message_sender, fail_on_write_error)
+{
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_add(scheduler, create_message("{\"id\": 1}"));
+
+    LwsMock lws;
+    EXPECT_CALL(lws, lws_send_pipe_choked(_)).WillRepeatedly(Return(0));
+    EXPECT_CALL(lws, lws_write(_,_,_,_)).Times(1).WillOnce(Return(-1));
+    EXPECT_CALL(lws, lws_callback_on_writable(_)).Times(0);
+
+    wf_message_sender sender;
+    wf_impl_message_sender_init(&sender, 1024);
+    ASSERT_FALSE(wf_impl_message_sender_write(&sender, scheduler, nullptr, 0));
+
+    wf_impl_message_sender_cleanup(&sender);
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+TEST(wf_message_sender, send_batch)
+{
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+    wf_impl_message_scheduler_add(scheduler, create_message("{\"id\": 1}"));
+    wf_impl_message_scheduler_add(scheduler, create_message("{\"id\": 2}"));
+
+    FrameRecorder recorder;
+    LwsMock lws;
+    EXPECT_CALL(lws, lws_send_pipe_choked(_)).WillRepeatedly(Return(0));
+    EXPECT_CALL(lws, lws_write(_,_,_,_)).Times(1).WillRepeatedly(Invoke(&recorder, &FrameRecorder::write));
+
+    wf_message_sender sender;
+    wf_impl_message_sender_init(&sender, 1024);
+    ASSERT_TRUE(wf_impl_message_sender_write(&sender, scheduler, nullptr, 1024));
+
+    ASSERT_EQ(1, recorder.frames.size());
+    ASSERT_EQ("[{\"id\": 1},{\"id\": 2}]", recorder.frames[0].data);
+
+    wf_impl_message_sender_cleanup(&sender);
+    wf_impl_message_scheduler_dispose(scheduler);
+}
+
+TEST(wf_message_sender, account_queued_bytes)
+{
+    wf_message_scheduler * scheduler = wf_impl_message_scheduler_create();
+
+    wf_message_sender sender;
+    wf_impl_message_sender_init(&sender, 1024);
+    ASSERT_EQ(0, sender.queued_bytes);
+
+    for(auto const & content: {"{\"id\": 1}", "{\"id\": 2}", "{\"id\": 3}"})
+    {
+        wf_impl_message_sender_enqueue(&sender, scheduler, create_message(content));
+    }
+    ASSERT_EQ(27, sender.queued_bytes);
+
+    FrameRecorder recorder;
+    LwsMock lws;
+    EXPECT_CALL(lws, lws_send_pipe_choked(_))
+        .WillOnce(Return(0))
+        .WillOnce(Return(1))
+        .WillRepeatedly(Return(0));
+    EXPECT_CALL(lws, lws_write(_,_,_,_)).Times(3).WillRepeatedly(Invoke(&recorder, &FrameRecorder::write));
+    EXPECT_CALL(lws, lws_callback_on_writable(_)).Times(1).WillOnce(Return(0));
+
+    ASSERT_TRUE(wf_impl_message_sender_write(&sender, scheduler, nullptr, 0));
+    ASSERT_EQ(18, sender.queued_bytes);
+
+    ASSERT_TRUE(wf_impl_message_sender_write(&sender, scheduler, nullptr, 0));
+    ASSERT_EQ(0, sender.queued_bytes);
+
+    wf_impl_message_sender_cleanup(&sender);
+    wf_impl_message_scheduler_dispose(scheduler);
+}
@@ -91,3 +91,114 @@ TEST(mountpoint, add_many_mountoption)
 
     wf_mountpoint_dispose(mountpoint);
 }
+
+TEST(mountpoint, attr_cache)
+{
+    wf_mountpoint * mountpoint = wf_mountpoint_create("/some/path");
+    ASSERT_NE(nullptr, mountpoint);
+
+    ASSERT_LT(0, mountpoint->attr_cache.timeout);
+    ASSERT_EQ(0, mountpoint->attr_cache.negative_timeout);
+
+    wf_mountpoint_set_attr_cache(mountpoint, 500, 250, 1024);
+    ASSERT_EQ(500, mountpoint->attr_cache.timeout);
+    ASSERT_EQ(250, mountpoint->attr_cache.negative_timeout);
+    ASSERT_EQ(1024, mountpoint->attr_cache.max_size);
+
+    wf_mountpoint_dispose(mountpoint);
+}
+
+TEST(mountpoint, read_options)
+{
+    wf_mountpoint * mountpoint = wf_mountpoint_create("/some/path");
+    ASSERT_NE(nullptr, mountpoint);
+
+    wf_mountpoint_set_readahead(mountpoint, 42);
+    ASSERT_EQ(42, mountpoint->readahead);
+
+    wf_mountpoint_set_read_chunk_size(mountpoint, 23);
+    ASSERT_EQ(23, mountpoint->read_chunk_size);
+
+    wf_mountpoint_dispose(mountpoint);
+}
+
+TEST(mountpoint, kernel_cache_timeout)
+{
+    wf_mountpoint * mountpoint = wf_mountpoint_create("/some/path");
+    ASSERT_NE(nullptr, mountpoint);
+
+    ASSERT_EQ(1000, mountpoint->kernel_cache_timeout);
+
+    wf_mountpoint_set_kernel_cache_timeout(mountpoint, 60 * 1000);
+    ASSERT_EQ(60 * 1000, mountpoint->kernel_cache_timeout);
+
+    wf_mountpoint_dispose(mountpoint);
+}
+
+TEST(mountpoint, fuse_options)
+{
+    wf_mountpoint * mountpoint = wf_mountpoint_create("/some/path");
+    ASSERT_NE(nullptr, mountpoint);
+
+    ASSERT_EQ(WF_FUSE_CAP_DEFAULT, mountpoint->fuse.capabilities);
+    ASSERT_EQ(0, mountpoint->fuse.max_readahead);
+    ASSERT_EQ(64, mountpoint->fuse.max_background);
+    ASSERT_EQ(48, mountpoint->fuse.congestion_threshold);
+
+    wf_mountpoint_set_fuse_capabilities(mountpoint, WF_FUSE_CAP_ASYNC_READ);
+    ASSERT_EQ(WF_FUSE_CAP_ASYNC_READ, mountpoint->fuse.capabilities);
+
+    wf_mountpoint_set_fuse_limits(mountpoint, 65536, 128, 96);
+    ASSERT_EQ(65536, mountpoint->fuse.max_readahead);
+    ASSERT_EQ(128, mountpoint->fuse.max_background);
+    ASSERT_EQ(96, mountpoint->fuse.congestion_threshold);
+
+    wf_mountpoint_dispose(mountpoint);
+}
+
+TEST(mountpoint, flow_control)
+{
+    wf_mountpoint * mountpoint = wf_mountpoint_create("/some/path");
+    ASSERT_NE(nullptr, mountpoint);
+
+    ASSERT_EQ(1024, mountpoint->flow_control.max_in_flight);
+    ASSERT_EQ(4 * 1024 * 1024, mountpoint->flow_control.max_queued_bytes);
+
+    wf_mountpoint_set_flow_control(mountpoint, 16, 64 * 1024);
+    ASSERT_EQ(16, mountpoint->flow_control.max_in_flight);
+    ASSERT_EQ(64 * 1024, mountpoint->flow_control.max_queued_bytes);
+
+    wf_mountpoint_dispose(mountpoint);
+}
+
+TEST(mountpoint, message_weights)
+{
+    wf_mountpoint * mountpoint = wf_mountpoint_create("/some/path");
+    ASSERT_NE(nullptr, mountpoint);
+
+    ASSERT_EQ(4, mountpoint->message_weights[WF_MESSAGE_CLASS_METADATA]);
+    ASSERT_EQ(1, mountpoint->message_weights[WF_MESSAGE_CLASS_DATA]);
+    ASSERT_EQ(1, mountpoint->message_weights[WF_MESSAGE_CLASS_NOTIFICATION]);
+
+    wf_mountpoint_set_message_weights(mountpoint, 8, 2, 3);
+    ASSERT_EQ(8, mountpoint->message_weights[WF_MESSAGE_CLASS_METADATA]);
+    ASSERT_EQ(2, mountpoint->message_weights[WF_MESSAGE_CLASS_DATA]);
+    ASSERT_EQ(3, mountpoint->message_weights[WF_MESSAGE_CLASS_NOTIFICATION]);
+
+    wf_mountpoint_dispose(mountpoint);
+}
+
+TEST(mountpoint, request_timeout)
+{
+    wf_mountpoint * mountpoint = wf_mountpoint_create("/some/path");
+    ASSERT_NE(nullptr, mountpoint);
+
+    ASSERT_EQ(10 * 1000, mountpoint->request_timeout.min_timeout);
+    ASSERT_EQ(60 * 1000, mountpoint->request_timeout.max_timeout);
+
+    wf_mountpoint_set_request_timeout(mountpoint, 500, 30 * 1000);
+    ASSERT_EQ(500, mountpoint->request_timeout.min_timeout);
+    ASSERT_EQ(30 * 1000, mountpoint->request_timeout.max_timeout);
+
+    wf_mountpoint_dispose(mountpoint);
+}
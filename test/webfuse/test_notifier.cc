@@ -0,0 +1,80 @@
+#include "webfuse/impl/notifier.h"
+#include "webfuse/mocks/mock_fuse.hpp"
+
+#include <gtest/gtest.h>
+
+using webfuse_test::FuseMock;
+using testing::_;
+using testing::StrEq;
+using testing::Return;
+using testing::InSequence;
+
+namespace
+{
+
+struct fuse_session * fake_session()
+{
+    return reinterpret_cast<struct fuse_session *>(0x42);
+}
+
+}
+
+TEST(notifier, create_dispose)
+{
+    wf_impl_notifier * notifier = wf_impl_notifier_create(fake_session());
+    ASSERT_NE(nullptr, notifier);
+
+    wf_impl_notifier_dispose(notifier);
+}
+
+TEST(notifier, inval_inode)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_lowlevel_notify_inval_inode(fake_session(), 42, 0, -1)).Times(1).WillOnce(Return(0));
+
+    wf_impl_notifier * notifier = wf_impl_notifier_create(fake_session());
+    wf_impl_notifier_inval_inode(notifier, 42, 0, -1);
+    wf_impl_notifier_dispose(notifier);
+}
+
+TEST(notifier, inval_entry)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_lowlevel_notify_inval_entry(fake_session(), 1, StrEq("some.file"), 9)).Times(1).WillOnce(Return(0));
+
+    wf_impl_notifier * notifier = wf_impl_notifier_create(fake_session());
+    wf_impl_notifier_inval_entry(notifier, 1, "some.file");
+    wf_impl_notifier_dispose(notifier);
+}
+
+TEST(notifier, deliver_pending_notifications_in_order_on_dispose)
+{
+    FuseMock fuse;
+    {
+        InSequence seq;
+        for (int i = 1; i <= 100; i++)
+        {
+            EXPECT_CALL(fuse, fuse_lowlevel_notify_inval_inode(fake_session(), i, 0, 0)).WillOnce(Return(0));
+        }
+        EXPECT_CALL(fuse, fuse_lowlevel_notify_inval_entry(fake_session(), 1, StrEq("x"), 1)).WillOnce(Return(0));
+    }
+
+    wf_impl_notifier * notifier = wf_impl_notifier_create(fake_session());
+    for (int i = 1; i <= 100; i++)
+    {
+        wf_impl_notifier_inval_inode(notifier, i, 0, 0);
+    }
+    wf_impl_notifier_inval_entry(notifier, 1, "x");
+    wf_impl_notifier_dispose(notifier);
+}
+
+TEST(notifier, ignore_failed_notifications)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_lowlevel_notify_inval_inode(_, _, _, _)).Times(2).WillRepeatedly(Return(-ENOENT));
+
+    wf_impl_notifier * notifier = wf_impl_notifier_create(fake_session());
+    wf_impl_notifier_inval_inode(notifier, 42, 0, 0);
+    wf_impl_notifier_inval_inode(notifier, 43, 0, 0);
+    wf_impl_notifier_dispose(notifier);
+}
@@ -65,6 +65,79 @@ TEST(server_protocol, add_filesystem)
     ASSERT_TRUE(disconnected);
 }
 
+TEST(server_protocol, add_filesystem_binary)
+{
+    ServerProtocol server;
+    MockInvokationHander handler;
+    EXPECT_CALL(handler, Invoke(StrEq("lookup"), _)).Times(AnyNumber());
+    EXPECT_CALL(handler, Invoke(StrEq("getattr"), GetAttr(1))).Times(AnyNumber())
+        .WillOnce(Return("{\"mode\": 420, \"type\": \"dir\"}"));
+    WsClient client(handler, WF_PROTOCOL_NAME_PROVIDER_CLIENT);
+
+    auto connected = client.Connect(server.GetPort(), WF_PROTOCOL_NAME_ADAPTER_SERVER, false);
+    ASSERT_TRUE(connected);
+
+    {
+        std::string response_text = client.Invoke("{\"method\": \"authenticate\", \"params\": [\"username\", {\"username\": \"bob\", \"password\": \"secret\"}], \"id\": 23}");
+        JsonDoc doc(response_text);
+        wf_json const * response = doc.root();
+        ASSERT_TRUE(wf_impl_json_is_object(wf_impl_json_object_get(response, "result")));
+    }
+
+    {
+        std::string response_text = client.Invoke("{\"method\": \"add_filesystem\", \"params\": [\"test\", {\"binary\": true}], \"id\": 42}");
+        JsonDoc doc(response_text);
+        wf_json const * response = doc.root();
+        wf_json const * result = wf_impl_json_object_get(response, "result");
+        ASSERT_TRUE(wf_impl_json_is_object(result));
+        wf_json const * binary = wf_impl_json_object_get(result, "binary");
+        ASSERT_TRUE(wf_impl_json_is_bool(binary));
+        ASSERT_TRUE(wf_impl_json_bool_get(binary));
+    }
+
+    auto disconnected = client.Disconnect();
+    ASSERT_TRUE(disconnected);
+}
+
+TEST(server_protocol, add_filesystem_batch)
+{
+    ServerProtocol server;
+    MockInvokationHander handler;
+    EXPECT_CALL(handler, Invoke(StrEq("lookup"), _)).Times(AnyNumber());
+    EXPECT_CALL(handler, Invoke(StrEq("getattr"), GetAttr(1))).Times(AnyNumber())
+        .WillOnce(Return("{\"mode\": 420, \"type\": \"dir\"}"));
+    WsClient client(handler, WF_PROTOCOL_NAME_PROVIDER_CLIENT);
+
+    auto connected = client.Connect(server.GetPort(), WF_PROTOCOL_NAME_ADAPTER_SERVER, false);
+    ASSERT_TRUE(connected);
+
+    {
+        // both responses are queued before the next write, so they are batched
+        std::string response_text = client.Invoke("["
+            "{\"method\": \"authenticate\", \"params\": [\"username\", {\"username\": \"bob\", \"password\": \"secret\"}], \"id\": 23},"
+            "{\"method\": \"add_filesystem\", \"params\": [\"test\", {\"batch\": true}], \"id\": 42}"
+            "]");
+        JsonDoc doc(response_text);
+        wf_json const * batch = doc.root();
+        ASSERT_TRUE(wf_impl_json_is_array(batch));
+        ASSERT_EQ(2, wf_impl_json_array_size(batch));
+
+        wf_json const * authenticate_response = wf_impl_json_array_get(batch, 0);
+        ASSERT_EQ(23, wf_impl_json_int_get(wf_impl_json_object_get(authenticate_response, "id")));
+        ASSERT_TRUE(wf_impl_json_is_object(wf_impl_json_object_get(authenticate_response, "result")));
+
+        wf_json const * add_filesystem_response = wf_impl_json_array_get(batch, 1);
+        ASSERT_EQ(42, wf_impl_json_int_get(wf_impl_json_object_get(add_filesystem_response, "id")));
+        wf_json const * result = wf_impl_json_object_get(add_filesystem_response, "result");
+        wf_json const * batch_enabled = wf_impl_json_object_get(result, "batch");
+        ASSERT_TRUE(wf_impl_json_is_bool(batch_enabled));
+        ASSERT_TRUE(wf_impl_json_bool_get(batch_enabled));
+    }
+
+    auto disconnected = client.Disconnect();
+    ASSERT_TRUE(disconnected);
+}
+
 TEST(server_protocol, add_filesystem_fail_without_authentication)
 {
     ServerProtocol server;
@@ -9,6 +9,7 @@ TEST(wf_status, tostring)
     ASSERT_STREQ("Bad (busy)", wf_impl_status_tostring(WF_BAD_BUSY));
     ASSERT_STREQ("Bad (timeout)", wf_impl_status_tostring(WF_BAD_TIMEOUT));
     ASSERT_STREQ("Bad (format)", wf_impl_status_tostring(WF_BAD_FORMAT));
+    ASSERT_STREQ("Bad (interrupted)", wf_impl_status_tostring(WF_BAD_INTERRUPTED));
     ASSERT_STREQ("Bad (no entry)", wf_impl_status_tostring(WF_BAD_NOENTRY));
     ASSERT_STREQ("Bad (access denied)", wf_impl_status_tostring(WF_BAD_ACCESS_DENIED));
 
@@ -23,6 +24,7 @@ TEST(wf_status, to_rc)
     ASSERT_EQ(-ENOENT, wf_impl_status_to_rc(WF_BAD_BUSY));
     ASSERT_EQ(-ETIMEDOUT, wf_impl_status_to_rc(WF_BAD_TIMEOUT));
     ASSERT_EQ(-ENOENT, wf_impl_status_to_rc(WF_BAD_FORMAT));
+    ASSERT_EQ(-EINTR, wf_impl_status_to_rc(WF_BAD_INTERRUPTED));
     ASSERT_EQ(-ENOENT, wf_impl_status_to_rc(WF_BAD_NOENTRY));
     ASSERT_EQ(-EACCES, wf_impl_status_to_rc(WF_BAD_ACCESS_DENIED));
 
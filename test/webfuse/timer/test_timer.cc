@@ -146,3 +146,83 @@ TEST(wf_timer, dont_trigger_null_callback)
     wf_impl_timer_dispose(timer);
     wf_impl_timer_manager_dispose(manager);
 }
+
+TEST(wf_timer, restart)
+{
+    bool triggered = false;
+    struct wf_timer_manager * manager = wf_impl_timer_manager_create();
+    struct wf_timer * timer = wf_impl_timer_create(manager, &on_timeout, reinterpret_cast<void*>(&triggered));
+
+    wf_impl_timer_start(timer, -1);
+    wf_impl_timer_start(timer, (5 * 60 * 1000));
+    ASSERT_EQ(1, wf_impl_timer_manager_size(manager));
+
+    wf_impl_timer_manager_check(manager);
+    ASSERT_FALSE(triggered);
+
+    wf_impl_timer_dispose(timer);
+    ASSERT_EQ(0, wf_impl_timer_manager_size(manager));
+    wf_impl_timer_manager_dispose(manager);
+}
+
+TEST(wf_timer, get_next_timeout)
+{
+    struct wf_timer_manager * manager = wf_impl_timer_manager_create();
+    struct wf_timer * first = wf_impl_timer_create(manager, nullptr, nullptr);
+    struct wf_timer * second = wf_impl_timer_create(manager, nullptr, nullptr);
+
+    wf_timer_timepoint timeout;
+    ASSERT_FALSE(wf_impl_timer_manager_get_next_timeout(manager, &timeout));
+
+    wf_timer_timepoint const now = wf_impl_timer_timepoint_now();
+    wf_impl_timer_start(first, (10 * 60 * 1000));
+    wf_impl_timer_start(second, (5 * 60 * 1000));
+
+    ASSERT_TRUE(wf_impl_timer_manager_get_next_timeout(manager, &timeout));
+    ASSERT_LE(now + (5 * 60 * 1000), timeout);
+    ASSERT_GT(now + (10 * 60 * 1000), timeout);
+
+    wf_impl_timer_cancel(second);
+    ASSERT_TRUE(wf_impl_timer_manager_get_next_timeout(manager, &timeout));
+    ASSERT_LE(now + (10 * 60 * 1000), timeout);
+
+    wf_impl_timer_dispose(first);
+    wf_impl_timer_dispose(second);
+    wf_impl_timer_manager_dispose(manager);
+}
+
+TEST(wf_timer, trigger_elapsed_timers_only)
+{
+    static size_t const count = 1000;
+    struct wf_timer_manager * manager = wf_impl_timer_manager_create();
+    struct wf_timer * timer[count];
+    bool triggered[count];
+
+    for(size_t i = 0; i < count; i++)
+    {
+        triggered[i] = false;
+        timer[i] = wf_impl_timer_create(manager, &on_timeout, reinterpret_cast<void*>(&triggered[i]));
+        int const timeout = ((i % 3) == 0) ? -1 - static_cast<int>(i) : (60 * 1000) + static_cast<int>(i);
+        wf_impl_timer_start(timer[i], timeout);
+    }
+
+    for(size_t i = 0; i < count; i += 6)
+    {
+        wf_impl_timer_cancel(timer[i]);
+    }
+
+    wf_impl_timer_manager_check(manager);
+
+    for(size_t i = 0; i < count; i++)
+    {
+        bool const expected = ((i % 3) == 0) && ((i % 6) != 0);
+        ASSERT_EQ(expected, triggered[i]);
+    }
+
+    for(size_t i = 0; i < count; i++)
+    {
+        wf_impl_timer_dispose(timer[i]);
+    }
+    ASSERT_EQ(0, wf_impl_timer_manager_size(manager));
+    wf_impl_timer_manager_dispose(manager);
+}
@@ -0,0 +1,137 @@
+#include "webfuse/impl/util/arena.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+
+TEST(wf_arena, alloc)
+{
+    wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
+
+    char * first = reinterpret_cast<char*>(wf_impl_arena_alloc(&arena, 5));
+    char * second = reinterpret_cast<char*>(wf_impl_arena_alloc(&arena, 5));
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    ASSERT_NE(first, second);
+
+    strcpy(first, "Hello");
+    strcpy(second, "Hi!");
+    ASSERT_STREQ("Hello", first);
+    ASSERT_STREQ("Hi!", second);
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, alloc_aligned)
+{
+    wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
+
+    for(size_t size = 1; size < 40; size++)
+    {
+        void * data = wf_impl_arena_alloc(&arena, size);
+        ASSERT_EQ(0, reinterpret_cast<uintptr_t>(data) % (2 * sizeof(void*)));
+    }
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, alloc_larger_than_block_size)
+{
+    wf_arena arena;
+    wf_impl_arena_init(&arena, 16);
+
+    char * data = reinterpret_cast<char*>(wf_impl_arena_alloc(&arena, 1024));
+    memset(data, 42, 1024);
+    ASSERT_EQ(42, data[1023]);
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, realloc_in_place)
+{
+    wf_arena arena;
+    wf_impl_arena_init(&arena, 256);
+
+    void * data = wf_impl_arena_alloc(&arena, 16);
+    void * resized = wf_impl_arena_realloc(&arena, data, 16, 64);
+    ASSERT_EQ(data, resized);
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, realloc_copy_if_not_last)
+{
+    wf_arena arena;
+    wf_impl_arena_init(&arena, 256);
+
+    char * data = reinterpret_cast<char*>(wf_impl_arena_alloc(&arena, 6));
+    strcpy(data, "Hello");
+    wf_impl_arena_alloc(&arena, 16);
+
+    char * resized = reinterpret_cast<char*>(wf_impl_arena_realloc(&arena, data, 6, 32));
+    ASSERT_NE(data, resized);
+    ASSERT_STREQ("Hello", resized);
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, realloc_copy_if_block_exhausted)
+{
+    wf_arena arena;
+    wf_impl_arena_init(&arena, 32);
+
+    char * data = reinterpret_cast<char*>(wf_impl_arena_alloc(&arena, 6));
+    strcpy(data, "Hello");
+
+    char * resized = reinterpret_cast<char*>(wf_impl_arena_realloc(&arena, data, 6, 128));
+    ASSERT_NE(data, resized);
+    ASSERT_STREQ("Hello", resized);
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, realloc_null)
+{
+    wf_arena arena;
+    wf_impl_arena_init(&arena, 32);
+
+    void * data = wf_impl_arena_realloc(&arena, nullptr, 0, 8);
+    ASSERT_NE(nullptr, data);
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, reset_reuses_memory)
+{
+    wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
+
+    void * first = wf_impl_arena_alloc(&arena, 8);
+    wf_impl_arena_reset(&arena);
+    void * second = wf_impl_arena_alloc(&arena, 8);
+    ASSERT_EQ(first, second);
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, reset_merges_blocks)
+{
+    wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
+
+    for(size_t i = 0; i < 10; i++)
+    {
+        wf_impl_arena_alloc(&arena, 48);
+    }
+    wf_impl_arena_reset(&arena);
+
+    char * first = reinterpret_cast<char*>(wf_impl_arena_alloc(&arena, 48));
+    for(size_t i = 1; i < 10; i++)
+    {
+        char * data = reinterpret_cast<char*>(wf_impl_arena_alloc(&arena, 48));
+        ASSERT_EQ(first + (i * 48), data);
+    }
+
+    wf_impl_arena_cleanup(&arena);
+}
@@ -1,6 +1,49 @@
 #include <gtest/gtest.h>
 #include "webfuse/impl/util/base64.h"
+#include "webfuse/impl/util/base64_intern.h"
 #include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+std::vector<wf_impl_base64_impl> supported_impls()
+{
+    std::vector<wf_impl_base64_impl> impls;
+    for (auto impl: {WF_IMPL_BASE64_SCALAR, WF_IMPL_BASE64_SSE41, WF_IMPL_BASE64_AVX2, WF_IMPL_BASE64_NEON})
+    {
+        if (wf_impl_base64_impl_supported(impl))
+        {
+            impls.push_back(impl);
+        }
+    }
+
+    return impls;
+}
+
+std::vector<uint8_t> create_data(size_t length)
+{
+    std::vector<uint8_t> data(length);
+    uint32_t value = 42;
+    for(size_t i = 0; i < length; i++)
+    {
+        value = (value * 1103515245) + 12345;
+        data[i] = static_cast<uint8_t>(value >> 16);
+    }
+
+    return data;
+}
+
+std::string encode(std::vector<uint8_t> const & data)
+{
+    std::string result(wf_impl_base64_encoded_size(data.size()) + 1, '\0');
+    size_t length = wf_impl_base64_encode(data.data(), data.size(), &result[0], result.size());
+    result.resize(length);
+    return result;
+}
+
+}
 
 TEST(Base64, EncodedSize)
 {
@@ -142,3 +185,84 @@ TEST(Base64, FailToDecodeInvalid)
     size_t length = wf_impl_base64_decode(in.c_str(), in.size(), (uint8_t*) buffer, 42);
     ASSERT_EQ(0, length);
 }
+
+TEST(Base64, Impls)
+{
+    for (auto impl: supported_impls())
+    {
+        ASSERT_TRUE(wf_impl_base64_set_impl(impl));
+        ASSERT_EQ(impl, wf_impl_base64_get_impl());
+    }
+
+    ASSERT_TRUE(wf_impl_base64_set_impl(WF_IMPL_BASE64_AUTO));
+    ASSERT_NE(WF_IMPL_BASE64_AUTO, wf_impl_base64_get_impl());
+}
+
+TEST(Base64, ImplsMatchScalar)
+{
+    for (size_t length = 0; length < 300; length++)
+    {
+        auto const data = create_data(length);
+
+        wf_impl_base64_set_impl(WF_IMPL_BASE64_SCALAR);
+        std::string const expected = encode(data);
+
+        for (auto impl: supported_impls())
+        {
+            wf_impl_base64_set_impl(impl);
+            std::string const encoded = encode(data);
+            ASSERT_EQ(expected, encoded) << "impl=" << impl << " length=" << length;
+
+            if (0 < length)
+            {
+                ASSERT_TRUE(wf_impl_base64_isvalid(encoded.c_str(), encoded.size()));
+
+                std::vector<uint8_t> decoded(length);
+                size_t const decoded_length = wf_impl_base64_decode(encoded.c_str(), encoded.size(), decoded.data(), decoded.size());
+                ASSERT_EQ(length, decoded_length) << "impl=" << impl;
+                ASSERT_EQ(data, decoded) << "impl=" << impl << " length=" << length;
+            }
+        }
+    }
+
+    wf_impl_base64_set_impl(WF_IMPL_BASE64_AUTO);
+}
+
+TEST(Base64, ImplsDecodeInPlace)
+{
+    auto const data = create_data(4096);
+    std::string const encoded = encode(data);
+
+    for (auto impl: supported_impls())
+    {
+        wf_impl_base64_set_impl(impl);
+        std::string buffer = encoded;
+        size_t const length = wf_impl_base64_decode(buffer.c_str(), buffer.size(), (uint8_t *) &buffer[0], data.size());
+        ASSERT_EQ(data.size(), length);
+        ASSERT_EQ(0, memcmp(data.data(), buffer.data(), length)) << "impl=" << impl;
+    }
+
+    wf_impl_base64_set_impl(WF_IMPL_BASE64_AUTO);
+}
+
+TEST(Base64, ImplsDetectInvalidCharacters)
+{
+    std::string const encoded = encode(create_data(300));
+    char const invalid[] = { '?', '=', ' ', '\0', '\x80', '\xff', '@', '[', '`', '{' };
+
+    for (auto impl: supported_impls())
+    {
+        wf_impl_base64_set_impl(impl);
+        for (size_t pos = 0; pos < (encoded.size() - 2); pos++)
+        {
+            for (char c: invalid)
+            {
+                std::string value = encoded;
+                value[pos] = c;
+                ASSERT_FALSE(wf_impl_base64_isvalid(value.c_str(), value.size())) << "impl=" << impl << " pos=" << pos;
+            }
+        }
+    }
+
+    wf_impl_base64_set_impl(WF_IMPL_BASE64_AUTO);
+}
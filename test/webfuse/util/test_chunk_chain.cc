@@ -0,0 +1,227 @@
+#include "webfuse/impl/util/chunk_chain.h"
+#include <gtest/gtest.h>
+
+#include <string>
+#include <cstdint>
+
+TEST(wf_chunk_chain, init_cleanup)
+{
+    wf_chunk_chain chain;
+    wf_impl_chunk_chain_init(&chain, 4, 2, 16);
+
+    ASSERT_TRUE(wf_impl_chunk_chain_is_empty(&chain));
+    ASSERT_EQ(0, wf_impl_chunk_chain_size(&chain));
+
+    wf_impl_chunk_chain_cleanup(&chain);
+}
+
+TEST(wf_chunk_chain, append_and_join)
+{
+    wf_chunk_chain chain;
+    wf_impl_chunk_chain_init(&chain, 4, 2, 16);
+
+    wf_impl_chunk_chain_append(&chain, "Hello", 5);
+    wf_impl_chunk_chain_append(&chain, ", ", 2);
+    ASSERT_FALSE(wf_impl_chunk_chain_is_empty(&chain));
+    ASSERT_EQ(7, wf_impl_chunk_chain_size(&chain));
+
+    size_t size;
+    char * data = wf_impl_chunk_chain_join(&chain, "World", 5, &size);
+    ASSERT_EQ("Hello, World", std::string(data, size));
+
+    wf_impl_chunk_chain_clear(&chain);
+    ASSERT_TRUE(wf_impl_chunk_chain_is_empty(&chain));
+
+    wf_impl_chunk_chain_cleanup(&chain);
+}
+
+TEST(wf_chunk_chain, copy_once_if_size_is_known)
+{
+    wf_chunk_chain chain;
+    wf_impl_chunk_chain_init(&chain, 4, 2, 16);
+
+    wf_impl_chunk_chain_reserve(&chain, 12);
+    wf_impl_chunk_chain_append(&chain, "Hello", 5);
+    wf_impl_chunk_chain_append(&chain, ", ", 2);
+    ASSERT_EQ(nullptr, chain.first);
+
+    size_t size;
+    char * data = wf_impl_chunk_chain_join(&chain, "World", 5, &size);
+    ASSERT_EQ("Hello, World", std::string(data, size));
+    ASSERT_EQ(12, chain.copied);
+
+    wf_impl_chunk_chain_cleanup(&chain);
+}
+
+TEST(wf_chunk_chain, copy_each_byte_at_most_twice)
+{
+    wf_chunk_chain chain;
+    wf_impl_chunk_chain_init(&chain, 4, 2, 1024);
+
+    std::string const fragment(10, 'x');
+    std::string expected;
+    for(int i = 0; i < 10; i++)
+    {
+        wf_impl_chunk_chain_append(&chain, fragment.c_str(), fragment.size());
+        expected += fragment;
+    }
+
+    size_t size;
+    char * data = wf_impl_chunk_chain_join(&chain, "end", 3, &size);
+    ASSERT_EQ(expected + "end", std::string(data, size));
+    ASSERT_EQ(100 + 100 + 3, chain.copied);
+
+    wf_impl_chunk_chain_cleanup(&chain);
+}
+
+TEST(wf_chunk_chain, append_to_chunks_if_size_exceeds_reserved)
+{
+    wf_chunk_chain chain;
+    wf_impl_chunk_chain_init(&chain, 4, 2, 1024);
+
+    wf_impl_chunk_chain_reserve(&chain, 4);
+    wf_impl_chunk_chain_append(&chain, "1234", 4);
+    wf_impl_chunk_chain_append(&chain, "5678", 4);
+    ASSERT_NE(nullptr, chain.first);
+
+    size_t size;
+    char * data = wf_impl_chunk_chain_join(&chain, "9", 1, &size);
+    ASSERT_EQ("123456789", std::string(data, size));
+    ASSERT_EQ(nullptr, chain.first);
+
+    wf_impl_chunk_chain_cleanup(&chain);
+}
+
+TEST(wf_chunk_chain, reserve_grows_buffer)
+{
+    wf_chunk_chain chain;
+    wf_impl_chunk_chain_init(&chain, 4, 2, 1024);
+
+    wf_impl_chunk_chain_reserve(&chain, 4);
+    wf_impl_chunk_chain_append(&chain, "12", 2);
+    wf_impl_chunk_chain_reserve(&chain, 2);
+    ASSERT_EQ(4, chain.data_capacity);
+    wf_impl_chunk_chain_reserve(&chain, 6);
+    ASSERT_EQ(8, chain.data_capacity);
+    wf_impl_chunk_chain_append(&chain, "345678", 6);
+    ASSERT_EQ(nullptr, chain.first);
+
+    size_t size;
+    char * data = wf_impl_chunk_chain_join(&chain, "9", 1, &size);
+    ASSERT_EQ("123456789", std::string(data, size));
+
+    wf_impl_chunk_chain_cleanup(&chain);
+}
+
+TEST(wf_chunk_chain, limit_reserve_to_max_data_capacity)
+{
+    wf_chunk_chain chain;
+    wf_impl_chunk_chain_init(&chain, 4, 2, 16);
+
+    wf_impl_chunk_chain_reserve(&chain, ((size_t) 1) << 62);
+    ASSERT_EQ(16, chain.data_capacity);
+
+    wf_impl_chunk_chain_append(&chain, "12", 2);
+    wf_impl_chunk_chain_reserve(&chain, SIZE_MAX);
+    ASSERT_EQ(16, chain.data_capacity);
+
+    size_t size;
+    char * data = wf_impl_chunk_chain_join(&chain, "3", 1, &size);
+    ASSERT_EQ("123", std::string(data, size));
+
+    wf_impl_chunk_chain_cleanup(&chain);
+}
+
+TEST(wf_chunk_chain, limit_reserve_to_data_received)
+{
+    wf_chunk_chain chain;
+    wf_impl_chunk_chain_init(&chain, 4, 2, 16);
+
+    std::string const fragment(12, 'x');
+    wf_impl_chunk_chain_reserve(&chain, 1000);
+    wf_impl_chunk_chain_append(&chain, fragment.c_str(), fragment.size());
+    ASSERT_EQ(16, chain.data_capacity);
+
+    wf_impl_chunk_chain_reserve(&chain, 1000);
+    ASSERT_EQ(48, chain.data_capacity);
+    wf_impl_chunk_chain_append(&chain, fragment.c_str(), fragment.size());
+    ASSERT_EQ(nullptr, chain.first);
+
+    size_t size;
+    char * data = wf_impl_chunk_chain_join(&chain, "!", 1, &size);
+    ASSERT_EQ(fragment + fragment + "!", std::string(data, size));
+
+    wf_impl_chunk_chain_cleanup(&chain);
+}
+
+TEST(wf_chunk_chain, reserve_has_no_effect_once_chunks_are_used)
+{
+    wf_chunk_chain chain;
+    wf_impl_chunk_chain_init(&chain, 4, 2, 1024);
+
+    wf_impl_chunk_chain_append(&chain, "12", 2);
+    wf_impl_chunk_chain_reserve(&chain, 100);
+    ASSERT_EQ(0, chain.data_capacity);
+
+    size_t size;
+    char * data = wf_impl_chunk_chain_join(&chain, "3", 1, &size);
+    ASSERT_EQ("123", std::string(data, size));
+
+    wf_impl_chunk_chain_cleanup(&chain);
+}
+
+TEST(wf_chunk_chain, reuse_chunks)
+{
+    wf_chunk_chain chain;
+    wf_impl_chunk_chain_init(&chain, 4, 2, 16);
+
+    for(int i = 0; i < 3; i++)
+    {
+        wf_impl_chunk_chain_append(&chain, "12345678", 8);
+        size_t size;
+        char * data = wf_impl_chunk_chain_join(&chain, "9", 1, &size);
+        ASSERT_EQ("123456789", std::string(data, size));
+        wf_impl_chunk_chain_clear(&chain);
+        ASSERT_EQ(2, chain.free_count);
+    }
+
+    wf_impl_chunk_chain_cleanup(&chain);
+}
+
+TEST(wf_chunk_chain, shrink_after_large_message)
+{
+    wf_chunk_chain chain;
+    wf_impl_chunk_chain_init(&chain, 4, 2, 16);
+
+    std::string const message(100, 'x');
+    wf_impl_chunk_chain_append(&chain, message.c_str(), 99);
+    size_t size;
+    char * data = wf_impl_chunk_chain_join(&chain, "x", 1, &size);
+    ASSERT_EQ(message, std::string(data, size));
+    ASSERT_LE(100, chain.data_capacity);
+
+    wf_impl_chunk_chain_clear(&chain);
+    ASSERT_EQ(0, chain.data_capacity);
+    ASSERT_EQ(nullptr, chain.data);
+    ASSERT_EQ(2, chain.free_count);
+
+    wf_impl_chunk_chain_cleanup(&chain);
+}
+
+TEST(wf_chunk_chain, keep_small_buffer)
+{
+    wf_chunk_chain chain;
+    wf_impl_chunk_chain_init(&chain, 4, 2, 16);
+
+    wf_impl_chunk_chain_append(&chain, "Hello", 5);
+    size_t size;
+    wf_impl_chunk_chain_join(&chain, "!", 1, &size);
+    wf_impl_chunk_chain_clear(&chain);
+    ASSERT_EQ(8, chain.data_capacity);
+
+    // subsequent messages are collected in the kept buffer
+    wf_impl_chunk_chain_append(&chain, "Hi", 2);
+    ASSERT_EQ(nullptr, chain.first);
+
+    wf_impl_chunk_chain_cleanup(&chain);
+}
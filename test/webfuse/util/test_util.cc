@@ -38,4 +38,17 @@ TEST(jsonrpc_util, failed_to_get_invalid_value_type)
     JsonDoc doc("{\"key\": \"42\"}");
     int value = wf_impl_json_get_int(doc.root(), "key", 42);
     ASSERT_EQ(42, value);
-}
\ No newline at end of file
+}
+TEST(jsonrpc_util, get_int64)
+{
+    JsonDoc doc("{\"key\": 5368709120}");
+    int64_t value = wf_impl_json_get_int64(doc.root(), "key", 42);
+    ASSERT_EQ(INT64_C(5368709120), value);
+}
+
+TEST(jsonrpc_util, failed_to_get_int64_invalid_value_type)
+{
+    JsonDoc doc("{\"key\": \"42\"}");
+    int64_t value = wf_impl_json_get_int64(doc.root(), "key", 42);
+    ASSERT_EQ(42, value);
+}